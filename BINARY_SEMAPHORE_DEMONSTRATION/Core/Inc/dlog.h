@@ -0,0 +1,137 @@
+/**
+ ******************************************************************************
+ * @file           : dlog.h
+ * @brief          : Deferred binary logging: call sites store a format-string
+ *                   ID plus raw 32-bit arguments in a RAM ring, a low-priority
+ *                   task streams the records out over UART, and
+ *                   Tools/dlog_decode.py rebuilds the text on the host.
+ *
+ * @description    : Every DLOG() format string is placed in its own ".dlog_fmt"
+ *                   section.  The linker script keeps that section in the ELF
+ *                   as an INFO (non-loaded) section at address 0, so it costs
+ *                   no flash and the address of a string is its offset in the
+ *                   section - that offset is the record's format ID.
+ *
+ *                   Record on the wire (little-endian 32-bit words):
+ *
+ *                     word 0   [31:16] format ID
+ *                              [15:12] argument count (0..DLOG_MAX_ARGS)
+ *                              [11:8]  DLOG_SYNC, lets the decoder resync
+ *                              [7:0]   sequence number, gaps = lost records
+ *                     word 1   DWT cycle counter when the record was made
+ *                     word 2+  arguments, each cast to uint32_t
+ *
+ *                   Format ID DLOG_ID_DROPPED is reserved for the drain
+ *                   task: one argument, the number of records dropped
+ *                   because the ring was full.
+ *
+ *                   Arguments are copied as values, never dereferenced.  A
+ *                   %s argument is sent as a pointer and the decoder reads
+ *                   the string out of the ELF, so it must point at constant
+ *                   data in flash (string literals, const tables).  Strings
+ *                   built at run time cannot be logged this way.
+ ******************************************************************************
+ */
+
+#ifndef DLOG_H
+#define DLOG_H
+
+#include "main.h"
+#include <stdint.h>
+
+/* ========================== Configuration ================================ */
+#define DLOG_RING_WORDS         256U   /* 1 KiB ring, power of two           */
+#define DLOG_MAX_ARGS           4U     /* Per record                         */
+#define DLOG_DRAIN_PERIOD_MS    10U    /* Drain task poll interval           */
+#define DLOG_DRAIN_STACK_WORDS  128U
+
+/* ========================== Wire Format ================================== */
+#define DLOG_SYNC               0xAU
+#define DLOG_ID_DROPPED         0xFFFFU
+
+#define DLOG_HDR(id, nargs)                                                   \
+    (((uint32_t)(id) << 16) | ((uint32_t)(nargs) << 12) |                     \
+     ((uint32_t)DLOG_SYNC << 8))
+
+/* ========================== Call-Site Macro ============================== */
+
+/* Argument count, 0..4 (GNU ## swallows the comma when there are none) */
+#define DLOG_NARG_(_0, _1, _2, _3, _4, n, ...)  n
+#define DLOG_NARG(...)      DLOG_NARG_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+
+#define DLOG_W(x)           ((uint32_t)(uintptr_t)(x))
+#define DLOG_CAT_(a, b)     a##b
+#define DLOG_CAT(a, b)      DLOG_CAT_(a, b)
+#define DLOG_ARGS_0()
+#define DLOG_ARGS_1(a)             , DLOG_W(a)
+#define DLOG_ARGS_2(a, b)          , DLOG_W(a), DLOG_W(b)
+#define DLOG_ARGS_3(a, b, c)       , DLOG_W(a), DLOG_W(b), DLOG_W(c)
+#define DLOG_ARGS_4(a, b, c, d)    , DLOG_W(a), DLOG_W(b), DLOG_W(c), DLOG_W(d)
+
+/**
+ * @brief  Log a printf-style message without formatting it on the target.
+ *         The format must be a string literal; arguments are integers,
+ *         characters or pointers to constant strings (see the file header).
+ *         Task or ISR context (ISR priority at or below
+ *         configMAX_SYSCALL_INTERRUPT_PRIORITY); never blocks.
+ */
+#define DLOG(fmt, ...)                                                        \
+    do {                                                                      \
+        static const char dlog_fmt_[]                                         \
+            __attribute__((section(".dlog_fmt"), used)) = fmt;               \
+        const uint32_t dlog_args_[DLOG_NARG(__VA_ARGS__) + 1U] = {            \
+            0U DLOG_CAT(DLOG_ARGS_, DLOG_NARG(__VA_ARGS__))(__VA_ARGS__)      \
+        };                                                                    \
+        dlog_write(DLOG_HDR((uintptr_t)dlog_fmt_,                             \
+                            DLOG_NARG(__VA_ARGS__)), &dlog_args_[1]);         \
+    } while (0)
+
+/* ========================== Public API =================================== */
+
+/**
+ * @brief  Counters for sizing the ring; read them in the debugger.
+ */
+typedef struct {
+    uint32_t records;              /* Records accepted                       */
+    uint32_t dropped;              /* Records refused, ring full             */
+    uint32_t max_fill;             /* Highest ring occupancy seen, words     */
+    uint32_t send_fails;           /* Transmits that failed; span kept       */
+} dlog_stats_t;
+
+/**
+ * @brief  Writes raw record bytes.  Called from the drain task only; may
+ *         block, and has to keep the bytes whole against the demo's other
+ *         UART writers.
+ * @return HAL_OK once every byte is out.  Anything else and the drain task
+ *         keeps the bytes in the ring and sends them again later.
+ */
+typedef HAL_StatusTypeDef (*dlog_send_t)(const void *data, uint32_t len);
+
+/**
+ * @brief  Start the DWT cycle counter used for timestamps.  Call before the
+ *         first DLOG().  Records made before dlog_start() wait in the ring.
+ */
+void dlog_init(void);
+
+/**
+ * @brief  Create the drain task that writes the records out.
+ * @param  send      Byte output: the demo's console UART.
+ * @param  priority  Drain task priority; keep it at or below the lowest
+ *                   application task so logging never delays real work.
+ * @return pdPASS, or the xTaskCreate() error.
+ */
+int32_t dlog_start(dlog_send_t send, uint32_t priority);
+
+/**
+ * @brief  Append one record.  Used by DLOG(); not meant to be called directly.
+ * @param  hdr   Header word from DLOG_HDR() (sequence bits are filled here).
+ * @param  args  Argument words, count taken from hdr.
+ */
+void dlog_write(uint32_t hdr, const uint32_t *args);
+
+/**
+ * @brief  Snapshot of the counters.
+ */
+void dlog_get_stats(dlog_stats_t *out);
+
+#endif /* DLOG_H */
@@ -0,0 +1,47 @@
+/**
+ ******************************************************************************
+ * @file           : fmt_lite.h
+ * @brief          : Small reentrant snprintf replacement for console text.
+ *
+ * @description    : Covers what the console helpers actually use:
+ *
+ *                     %d %i %u %x %X %c %s %%
+ *                     '0' and '-' flags, a decimal field width, and the
+ *                     'l' length modifier (accepted and ignored on a 32-bit
+ *                     core, so "%lu" keeps working)
+ *
+ *                   No global state, no heap, no locale and no newlib
+ *                   reentrancy structure: the only memory touched is the
+ *                   caller's buffer plus an 11-byte digit scratch on the
+ *                   stack.  Safe from any task and from ISRs.
+ *
+ *                   Unknown conversions are copied through as text, so a
+ *                   bad format is visible on the console instead of
+ *                   reading a wrong argument.
+ ******************************************************************************
+ */
+
+#ifndef FMT_LITE_H
+#define FMT_LITE_H
+
+#include <stdarg.h>
+#include <stddef.h>
+
+/**
+ * @brief  Format into dst, always null-terminated when size > 0.
+ * @param  dst   Destination buffer.
+ * @param  size  Capacity of dst including the terminator.
+ * @param  fmt   Format string (see the file header for the subset).
+ * @param  ap    Arguments.
+ * @return Characters written, excluding the terminator.  Unlike
+ *         vsnprintf this is the truncated length, ready to transmit.
+ */
+int fmt_vsnprintf(char *dst, size_t size, const char *fmt, va_list ap);
+
+/**
+ * @brief  Variadic form of fmt_vsnprintf().
+ */
+int fmt_snprintf(char *dst, size_t size, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#endif /* FMT_LITE_H */
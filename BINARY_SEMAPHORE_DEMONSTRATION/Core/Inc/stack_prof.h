@@ -0,0 +1,70 @@
+/**
+ ******************************************************************************
+ * @file           : stack_prof.h
+ * @brief          : Stack profiler.  A low-priority task reports the peak
+ *                   stack use of every task as text lines, and
+ *                   Host/Tools/stack_size.py turns them, together with the
+ *                   compiler's call graph, into Core/Inc/stack_sizes.h.
+ *
+ * @description    : Enabled by APP_STACK_PROFILE in app_config.h, which also
+ *                   turns on configRECORD_STACK_HIGH_ADDRESS so that the
+ *                   kernel reports each task's stack size.  Tasks created
+ *                   with static_alloc.h are registered with the name of
+ *                   their storage and their entry function; the idle and
+ *                   timer service tasks are known by name.  A task that has
+ *                   been deleted keeps the peak it reached.
+ *
+ *                   Every STACK_PROF_PERIOD_MS, one line each:
+ *
+ *                     @stk begin <version> <word bytes> <uptime ms> <tasks>
+ *                     @stk task <object> <entry> <words> <peak> <alive> <name>
+ *                     @stk end <tasks>
+ *
+ *                   <words> is the stack size and <peak> the most of it
+ *                   ever used, both in stack words; <object> and <entry>
+ *                   are "-" for a task that was not registered.  The
+ *                   numbers only grow, so the last report is the one to
+ *                   keep.  Lines without "@stk" are skipped by the tool,
+ *                   so the report can share the console with the demo.
+ ******************************************************************************
+ */
+
+#ifndef STACK_PROF_H
+#define STACK_PROF_H
+
+#include <stdint.h>
+
+/* ========================== Configuration ================================ */
+#define STACK_PROF_MAX_TASKS    16U    /* Tasks tracked, alive or deleted    */
+#define STACK_PROF_PERIOD_MS    10000U /* One report this often              */
+#define STACK_PROF_STACK_WORDS  192U   /* Report task: one formatted line    */
+
+/* ========================== Public API =================================== */
+
+/**
+ * @brief  Writes one report line (no terminator).  Called from the report
+ *         task only; may block.
+ */
+typedef void (*stack_prof_send_t)(const char *line, uint32_t len);
+
+/**
+ * @brief  Record the storage and entry function names of a task, by task
+ *         name.  static_task_create() (static_alloc.h) calls this for every
+ *         task it creates when APP_STACK_PROFILE is 1.
+ * @param  name    Task name as passed to the create call.
+ * @param  object  STATIC_TASK() storage name, e.g. "print_task".
+ * @param  entry   Entry function name, e.g. "task_print".
+ */
+void stack_prof_task(const char *name, const char *object, const char *entry);
+
+/**
+ * @brief  Create the report task.
+ * @param  send      Line output: the demo's console.
+ * @param  priority  Report task priority; keep it at or below the lowest
+ *                   application task.
+ * @return pdPASS, or the create error.  pdPASS without a task when
+ *         APP_STACK_PROFILE is 0.
+ */
+int32_t stack_prof_start(stack_prof_send_t send, uint32_t priority);
+
+#endif /* STACK_PROF_H */
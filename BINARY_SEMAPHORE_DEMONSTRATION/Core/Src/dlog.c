@@ -0,0 +1,200 @@
+/**
+ ******************************************************************************
+ * @file           : dlog.c
+ * @brief          : Deferred binary logging: RAM ring and UART drain task.
+ *
+ * @description    : The ring holds whole records as 32-bit words.  head and
+ *                   tail are free-running word counters (index = count &
+ *                   mask), so full and empty never look alike.
+ *
+ *                     producers (any task, ISRs)      drain task (low prio)
+ *                       mask interrupts                  span = [tail, head)
+ *                       check space, else drop++         UART <- span
+ *                       store header, stamp, args        sent? tail = head
+ *                       head += words
+ *                       unmask
+ *
+ *                   A producer only holds BASEPRI for the copy of two to
+ *                   six words, which is what keeps a DLOG() call in the
+ *                   tens of cycles.  The drain task is the only writer of
+ *                   tail and moves it after the UART has finished with
+ *                   the span, so producers never overwrite bytes that are
+ *                   still being sent.  A transmit that fails leaves tail
+ *                   where it was, so the span goes out again next round;
+ *                   if the UART stays down the ring fills and the records
+ *                   that do not fit are counted as dropped.  Because every record is stored
+ *                   inside one critical section, [tail, head) always ends
+ *                   on a record boundary.
+ ******************************************************************************
+ */
+
+#include "dlog.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "static_alloc.h"
+
+#define DLOG_RING_MASK      (DLOG_RING_WORDS - 1U)
+
+#if (DLOG_RING_WORDS & DLOG_RING_MASK) != 0U
+#error "DLOG_RING_WORDS must be a power of two"
+#endif
+
+/* ========================== Private Data ================================= */
+static uint32_t              dlog_ring[DLOG_RING_WORDS];
+static volatile uint32_t     dlog_head;       /* Producers, under BASEPRI    */
+static volatile uint32_t     dlog_tail;       /* Drain task only             */
+static uint32_t              dlog_seq;
+static volatile uint32_t     dlog_pending_drops;
+static dlog_stats_t          dlog_stats;
+static dlog_send_t           dlog_out;
+STATIC_TASK(dlog, DLOG_DRAIN_STACK_WORDS);
+
+/* ========================== Private Helpers ============================== */
+
+/**
+ * @brief  Send one contiguous run of ring words.
+ * @return 1 when it went out, 0 when the transmit failed (counted).
+ */
+static uint32_t dlog_send(const uint32_t *words, uint32_t count)
+{
+    if (dlog_out(words, count * sizeof(uint32_t)) != HAL_OK) {
+        dlog_stats.send_fails++;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief  Report records lost to a full ring since the last report.
+ *         Built on the drain task's stack, so it needs no ring space.
+ */
+static void dlog_send_drops(void)
+{
+    uint32_t    frame[3];
+    UBaseType_t mask;
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    frame[2]           = dlog_pending_drops;
+    dlog_pending_drops = 0;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+
+    frame[0] = DLOG_HDR(DLOG_ID_DROPPED, 1U);
+    frame[1] = DWT->CYCCNT;
+    if (!dlog_send(frame, 3U)) {
+        /* Not reported: keep the count for the next report */
+        mask = taskENTER_CRITICAL_FROM_ISR();
+        dlog_pending_drops += frame[2];
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+    }
+}
+
+/**
+ * @brief  Drain task: ship everything between tail and head, then sleep.
+ * @param  pvParameters  (unused).
+ */
+static void dlog_drain_task(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;) {
+        uint32_t head = dlog_head;
+        uint32_t tail = dlog_tail;
+        uint32_t first;
+        uint32_t count;
+        uint32_t run;
+
+        if (head != tail) {
+            /* The span may wrap: send up to the end of the array, then the
+             * rest.  tail only passes what has gone out */
+            first = tail & DLOG_RING_MASK;
+            count = head - tail;
+            run   = DLOG_RING_WORDS - first;
+            if (run > count) {
+                run = count;
+            }
+            if (!dlog_send(&dlog_ring[first], run)) {
+                vTaskDelay(pdMS_TO_TICKS(DLOG_DRAIN_PERIOD_MS));
+                continue;
+            }
+            dlog_tail = tail + run;
+            if (count > run) {
+                if (!dlog_send(&dlog_ring[0], count - run)) {
+                    vTaskDelay(pdMS_TO_TICKS(DLOG_DRAIN_PERIOD_MS));
+                    continue;
+                }
+                dlog_tail = head;
+            }
+        }
+
+        /* Drops happened after everything that was in the ring, so they
+         * are reported after it */
+        if (dlog_pending_drops != 0U) {
+            dlog_send_drops();
+        }
+
+        if (head == tail) {
+            vTaskDelay(pdMS_TO_TICKS(DLOG_DRAIN_PERIOD_MS));
+        }
+    }
+}
+
+/* ========================== Public API =================================== */
+
+void dlog_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT       = 0;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+int32_t dlog_start(dlog_send_t send, uint32_t priority)
+{
+    dlog_out = send;
+
+    return (int32_t)STATIC_TASK_CREATE(dlog, dlog_drain_task, "DLog", NULL,
+                                       (UBaseType_t)priority, NULL);
+}
+
+void dlog_write(uint32_t hdr, const uint32_t *args)
+{
+    uint32_t    nargs = (hdr >> 12) & 0xFU;
+    uint32_t    words = 2U + nargs;
+    uint32_t    head;
+    uint32_t    fill;
+    UBaseType_t mask;
+
+    /* Usable before the scheduler starts and from ISRs, and nests safely */
+    mask = taskENTER_CRITICAL_FROM_ISR();
+
+    head = dlog_head;
+    fill = head - dlog_tail;
+    if (fill + words > DLOG_RING_WORDS) {
+        dlog_pending_drops++;
+        dlog_stats.dropped++;
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+        return;
+    }
+
+    dlog_ring[head++ & DLOG_RING_MASK] = hdr | (dlog_seq++ & 0xFFU);
+    dlog_ring[head++ & DLOG_RING_MASK] = DWT->CYCCNT;
+    while (nargs-- > 0U) {
+        dlog_ring[head++ & DLOG_RING_MASK] = *args++;
+    }
+    dlog_head = head;
+
+    dlog_stats.records++;
+    if (fill + words > dlog_stats.max_fill) {
+        dlog_stats.max_fill = fill + words;
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+void dlog_get_stats(dlog_stats_t *out)
+{
+    UBaseType_t mask;
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    *out = dlog_stats;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
@@ -16,8 +16,6 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-#include <string.h>
-#include <stdio.h>
 #include <stdarg.h>       /* va_list, va_start, va_end              */
 #include <stdlib.h>       /* rand()                                 */
 #include "FreeRTOS.h"
@@ -25,6 +23,13 @@
 #include "queue.h"
 #include "timers.h"
 #include "semphr.h"
+#include "fmt_lite.h"     /* fmt_vsnprintf: reentrant, no newlib    */
+#include "dlog.h"         /* DLOG: deferred binary records          */
+#include "ktrace.h"       /* Kernel event trace (APP_KTRACE)        */
+#include "static_alloc.h" /* Static or heap kernel object storage   */
+#include "stack_sizes.h"  /* STACK_WORDS_*: task stack sizes        */
+#include "stack_prof.h"   /* Stack use reports (APP_STACK_PROFILE)  */
+#include "ccm_ram.h"      /* Heap regions in CCM RAM (APP_CCM_RAM)  */
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -56,26 +61,47 @@ typedef struct
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-#define UART_TX_BUF_SIZE          256U   /* vConsolePrint() buffer    */
+#define UART_TX_BUF_SIZE          128U   /* vConsolePrint() line, on stack */
 #define ORDER_QUEUE_DEPTH         1U     /* single-slot queue (back-pressure) */
-#define MASTER_TASK_STACK_WORDS   500U   /* 500 words = 2000 bytes           */
-#define SLAVE_TASK_STACK_WORDS    500U
 #define MASTER_TASK_PRIORITY      3U     /* higher number = higher priority   */
 #define SLAVE_TASK_PRIORITY       1U
 #define MAX_ORDER_QUANTITY        15U    /* max units per order               */
+#define DLOG_TASK_PRIORITY        tskIDLE_PRIORITY  /* drains when both sleep */
+#define KTRACE_TASK_PRIORITY      tskIDLE_PRIORITY  /* dumps when both sleep  */
+#define STACK_PROF_TASK_PRIORITY  tskIDLE_PRIORITY  /* reports when both sleep */
+
+/* 1 = tasks log through DLOG (binary records, decode with
+ *     Tools/dlog_decode.py); 0 = tasks format text and wait on the UART.
+ *     The host build (Host/Makefile) sets 0: DLOG format IDs are target
+ *     addresses and mean nothing in a 64-bit Linux executable. */
+#ifndef USE_DEFERRED_LOG
+#define USE_DEFERRED_LOG          1
+#endif
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
 /* USER CODE BEGIN PM */
+#if USE_DEFERRED_LOG
+#define LOG(...)    DLOG(__VA_ARGS__)
+#else
+#define LOG(...)    vConsolePrint(__VA_ARGS__)
+#endif
 /* USER CODE END PM */
 
 /* Private variables ---------------------------------------------------------*/
 UART_HandleTypeDef huart2;
 
 /* USER CODE BEGIN PV */
-static char              g_acPrintBuffer[UART_TX_BUF_SIZE]; /* shared format buffer        */
 static SemaphoreHandle_t g_xOrderReadySemaphore = NULL;     /* binary sem: order-ready flag */
 static QueueHandle_t     g_xOrderQueue          = NULL;     /* carries WorkOrder_t structs  */
+static SemaphoreHandle_t g_xUartMutex           = NULL;     /* one UART2 writer at a time   */
+
+/* Their storage and the tasks': static with APP_STATIC_ALLOC, else heap */
+STATIC_SEMAPHORE(order_ready);
+STATIC_QUEUE(order_queue, ORDER_QUEUE_DEPTH, sizeof(WorkOrder_t));
+STATIC_SEMAPHORE(uart_mutex);
+STATIC_TASK(master, STACK_WORDS_MASTER);
+STATIC_TASK(slave, STACK_WORDS_SLAVE);
 
 /* Enum-indexed lookup table for printable item names. */
 static const char *const g_apcItemNames[ITEM_COUNT] =
@@ -119,18 +145,71 @@ void vApplicationMallocFailedHook(void)
     for (;;);
 }
 
+/* Idle and timer service task memory (configSUPPORT_STATIC_ALLOCATION):
+ * with APP_STATIC_ALLOC there is no heap for the scheduler to take it from. */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+STATIC_TASK(idle_task, configMINIMAL_STACK_SIZE);
+STATIC_TASK(timer_task, configTIMER_TASK_STACK_DEPTH);
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   configSTACK_DEPTH_TYPE *puxIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer   = STATIC_TASK_TCB(idle_task);
+    *ppxIdleTaskStackBuffer = STATIC_TASK_STACK(idle_task);
+    *puxIdleTaskStackSize   = kobj_idle_task_words;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                    StackType_t **ppxTimerTaskStackBuffer,
+                                    configSTACK_DEPTH_TYPE *puxTimerTaskStackSize)
+{
+    *ppxTimerTaskTCBBuffer   = STATIC_TASK_TCB(timer_task);
+    *ppxTimerTaskStackBuffer = STATIC_TASK_STACK(timer_task);
+    *puxTimerTaskStackSize   = kobj_timer_task_words;
+}
+#endif
+
+/* ---- UART2 output ---- */
+
+/* The one way onto UART2.  The tasks, the DLog drain, the trace dump and
+ * the stack profiler all write here, and the idle-priority ones take turns
+ * on the CPU, so a transfer must never start while another is running:
+ * the HAL's busy check and lock on huart2 are not atomic between tasks.
+ * Before the scheduler starts the mutex is free and never blocks. */
+static HAL_StatusTypeDef xUartWrite(const void *pvData, uint32_t ulLen)
+{
+    HAL_StatusTypeDef xStatus;
+
+    xSemaphoreTake(g_xUartMutex, portMAX_DELAY);
+    xStatus = HAL_UART_Transmit(&huart2, (const uint8_t *)pvData,
+                                (uint16_t)ulLen, HAL_MAX_DELAY);
+    xSemaphoreGive(g_xUartMutex);
+
+    return xStatus;
+}
+
+/* One trace dump line (ktrace.c) or stack profile line (stack_prof.c). */
+static void vUartSendLine(const char *pcLine, uint32_t ulLen)
+{
+    (void)xUartWrite(pcLine, ulLen);
+}
+
 /* ---- UART formatted print () ---- */
 
-/* printf-style output over UART2. Uses vsnprintf */
+/* printf-style output over UART2.  Formats with fmt_vsnprintf into a
+ * buffer on the caller's stack, so master and slave never share one. */
 static void vConsolePrint(const char *pcFormat, ...)
 {
+    char    acLine[UART_TX_BUF_SIZE];
+    int     iLen;
     va_list xArgs;
+
     va_start(xArgs, pcFormat);
-    vsnprintf(g_acPrintBuffer, sizeof(g_acPrintBuffer), pcFormat, xArgs);
+    iLen = fmt_vsnprintf(acLine, sizeof(acLine), pcFormat, xArgs);
     va_end(xArgs);
 
-    HAL_UART_Transmit(&huart2, (uint8_t *)g_acPrintBuffer,
-                       (uint16_t)strlen(g_acPrintBuffer), HAL_MAX_DELAY);
+    (void)xUartWrite(acLine, (uint32_t)iLen);
 }
 
 /* ---- Master task (priority 3 — producer) ---- */
@@ -160,18 +239,18 @@ static void vMasterTask(void *pvParameters)
         xOrder.eItem      = (SupplyItem_e)(rand() % (int)ITEM_COUNT);
         xOrder.ucQuantity = (uint8_t)((rand() % MAX_ORDER_QUANTITY) + 1U);
 
-        vConsolePrint("[MASTER] Order #%u  ->  Distribute %u x %s\r\n",
-                      xOrder.usOrderId,
-                      xOrder.ucQuantity,
-                      g_apcItemNames[xOrder.eItem]);
+        LOG("[MASTER] Order #%u  ->  Distribute %u x %s\r\n",
+            xOrder.usOrderId,
+            xOrder.ucQuantity,
+            g_apcItemNames[xOrder.eItem]);
 
         /* Enqueue order; blocks indefinitely if queue full */
         xQueueStatus = xQueueSend(g_xOrderQueue, &xOrder, portMAX_DELAY);
 
         if (xQueueStatus != pdPASS)
         {
-            vConsolePrint("[MASTER] ERROR: enqueue failed for order #%u\r\n",
-                          xOrder.usOrderId);
+            LOG("[MASTER] ERROR: enqueue failed for order #%u\r\n",
+                xOrder.usOrderId);
         }
         else
         {
@@ -212,24 +291,24 @@ static void vSlaveTask(void *pvParameters)
             /* Hand out items one at a time */
             for (uint8_t ucUnit = 1U; ucUnit <= xReceivedOrder.ucQuantity; ucUnit++)
             {
-                vConsolePrint("  [SLAVE] Handing out %s %u of %u ...\r\n",
-                              g_apcItemNames[xReceivedOrder.eItem],
-                              ucUnit,
-                              xReceivedOrder.ucQuantity);
+                LOG("  [SLAVE] Handing out %s %u of %u ...\r\n",
+                    g_apcItemNames[xReceivedOrder.eItem],
+                    ucUnit,
+                    xReceivedOrder.ucQuantity);
 
 
                 vTaskDelay(pdMS_TO_TICKS(50));
             }
 
-            vConsolePrint("  [SLAVE] Order #%u COMPLETE  (%u x %s delivered)\r\n\r\n",
-                          xReceivedOrder.usOrderId,
-                          xReceivedOrder.ucQuantity,
-                          g_apcItemNames[xReceivedOrder.eItem]);
+            LOG("  [SLAVE] Order #%u COMPLETE  (%u x %s delivered)\r\n\r\n",
+                xReceivedOrder.usOrderId,
+                xReceivedOrder.ucQuantity,
+                g_apcItemNames[xReceivedOrder.eItem]);
         }
         else
         {
             /* Semaphore fired but queue empty — should not happen */
-            vConsolePrint("  [SLAVE] WARNING: semaphore received but queue empty\r\n");
+            LOG("  [SLAVE] WARNING: semaphore received but queue empty\r\n");
         }
     }
 }
@@ -263,25 +342,47 @@ int main(void)
   MX_GPIO_Init();
   MX_USART2_UART_Init();
   /* USER CODE BEGIN 2 */
+  /* Heap regions before the first create (no-op unless APP_CCM_RAM) */
+  ccm_ram_heap_init();
+#if USE_DEFERRED_LOG
+  dlog_init();
+#endif
+  /* Before anything is created, so the trace can name it */
+  ktrace_init();
+
+  /* Before the first LOG: every UART2 writer goes through it */
+  g_xUartMutex = STATIC_SEMAPHORE_CREATE_MUTEX(uart_mutex);
+  configASSERT(g_xUartMutex != NULL);
+  vQueueAddToRegistry(g_xUartMutex, "UartMutex");
 
-  vConsolePrint("\r\n===== Master-Slave Stationery Distribution Demo =====\r\n\r\n");
+  LOG("\r\n===== Master-Slave Stationery Distribution Demo =====\r\n\r\n");
 
   /* Create synchronization primitives */
-  g_xOrderReadySemaphore = xSemaphoreCreateBinary();
-  g_xOrderQueue          = xQueueCreate(ORDER_QUEUE_DEPTH, sizeof(WorkOrder_t));
+  g_xOrderReadySemaphore = STATIC_SEMAPHORE_CREATE_BINARY(order_ready);
+  g_xOrderQueue          = STATIC_QUEUE_CREATE(order_queue);
 
   if ((g_xOrderReadySemaphore != NULL) && (g_xOrderQueue != NULL))
   {
-      xTaskCreate(vMasterTask, "Master", MASTER_TASK_STACK_WORDS,
-                  NULL, MASTER_TASK_PRIORITY, NULL);
-      xTaskCreate(vSlaveTask,  "Slave",  SLAVE_TASK_STACK_WORDS,
-                  NULL, SLAVE_TASK_PRIORITY,  NULL);
+      /* Names for the debugger's queue view and the kernel trace */
+      vQueueAddToRegistry(g_xOrderReadySemaphore, "OrderReady");
+      vQueueAddToRegistry(g_xOrderQueue, "OrderQueue");
+
+      STATIC_TASK_CREATE(master, vMasterTask, "Master",
+                         NULL, MASTER_TASK_PRIORITY, NULL);
+      STATIC_TASK_CREATE(slave,  vSlaveTask,  "Slave",
+                         NULL, SLAVE_TASK_PRIORITY,  NULL);
+#if USE_DEFERRED_LOG
+      dlog_start(xUartWrite, DLOG_TASK_PRIORITY);
+#endif
+      ktrace_start(vUartSendLine, KTRACE_TASK_PRIORITY);
+      stack_prof_start(vUartSendLine, STACK_PROF_TASK_PRIORITY);
 
       /* Start scheduler; does not return on success */
       vTaskStartScheduler();
   }
 
-  /* Scheduler failed to start (insufficient heap, etc.) */
+  /* Scheduler failed to start (insufficient heap, etc.).  Plain text even
+   * with USE_DEFERRED_LOG: the drain task will never run. */
   vConsolePrint("[ERROR] Failed to create semaphore or queue.\r\n");
 
   /* USER CODE END 2 */
@@ -47,9 +47,9 @@
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
-#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
-    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
-#endif
+/* heap_5.c replaces this file when configUSE_HEAP_5 is 1, and a
+ * static-only build (configSUPPORT_DYNAMIC_ALLOCATION 0) has no heap. */
+#if ( configUSE_HEAP_5 == 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 
 #ifndef configHEAP_CLEAR_MEMORY_ON_FREE
     #define configHEAP_CLEAR_MEMORY_ON_FREE    0
@@ -624,3 +624,5 @@ void vPortHeapResetState( void )
     xNumberOfSuccessfulFrees = ( size_t ) 0U;
 }
 /*-----------------------------------------------------------*/
+
+#endif /* configUSE_HEAP_5, configSUPPORT_DYNAMIC_ALLOCATION */
@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+"""
+dlog_decode.py - rebuild DLOG text from the binary UART stream.
+
+The firmware sends records of little-endian 32-bit words (see Core/Inc/dlog.h):
+
+    word 0   [31:16] format ID   [15:12] arg count   [11:8] 0xA   [7:0] seq
+    word 1   DWT cycle counter
+    word 2+  arguments
+
+The format ID is the offset of the format string in the ELF's .dlog_fmt
+section.  %s arguments are addresses of constant strings, read back from the
+ELF's loadable sections.
+
+Usage:
+    stty -F /dev/ttyACM0 115200 raw -echo
+    ./Tools/dlog_decode.py Debug/BINARY_SEMAPHORE_DEMONSTRATION.elf /dev/ttyACM0
+
+    ./Tools/dlog_decode.py firmware.elf capture.bin     # saved stream
+    ... | ./Tools/dlog_decode.py firmware.elf -          # stdin
+
+Standard library only.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+DLOG_SYNC = 0xA
+DLOG_ID_DROPPED = 0xFFFF
+DLOG_MAX_ARGS = 4
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+# The conversions fmt_lite supports on the target, so both paths agree
+SPEC_RE = re.compile(r"%([-0]*)(\d*)l*([diuxXcs%])")
+
+
+class Elf:
+    """Just enough ELF reading to find sections by name and by address."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError(f"{path}: not an ELF file")
+
+        is64 = self.data[4] == 2
+        endian = "<" if self.data[5] == 1 else ">"
+        if is64:
+            shoff, = struct.unpack_from(endian + "Q", self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", self.data, 0x3A)
+            sh_fmt = endian + "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(endian + "I", self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", self.data, 0x2E)
+            sh_fmt = endian + "IIIIIIIIII"
+
+        raw = [struct.unpack_from(sh_fmt, self.data, shoff + i * shentsize)
+               for i in range(shnum)]
+        names = raw[shstrndx]
+        self.sections = []
+        for name, stype, flags, addr, offset, size, *_ in raw:
+            self.sections.append({
+                "name": self._cstr(names[4] + name),
+                "type": stype, "flags": flags,
+                "addr": addr, "offset": offset, "size": size,
+            })
+
+    def _cstr(self, offset, limit=None):
+        end = self.data.index(b"\0", offset)
+        if limit is not None:
+            end = min(end, limit)
+        return self.data[offset:end].decode("latin-1")
+
+    def section(self, name):
+        for sec in self.sections:
+            if sec["name"] == name:
+                return sec
+        raise KeyError(f"section {name} not found; is the linker script up to date?")
+
+    def section_string(self, sec, offset):
+        if offset >= sec["size"]:
+            return None
+        return self._cstr(sec["offset"] + offset, sec["offset"] + sec["size"])
+
+    def string_at(self, addr):
+        """Constant string at a target address, as a %s argument would see it."""
+        for sec in self.sections:
+            if (sec["type"] == SHT_PROGBITS and sec["flags"] & SHF_ALLOC
+                    and sec["addr"] <= addr < sec["addr"] + sec["size"]):
+                return self.section_string(sec, addr - sec["addr"])
+        return f"<str@0x{addr:08x}>"
+
+
+def render(elf, fmt, args):
+    """printf-style rendering of one record with 32-bit argument words."""
+    args = list(args)
+
+    def one(m):
+        flags, width, conv = m.groups()
+        if conv == "%":
+            return "%"
+        if not args:
+            return m.group(0)
+        word = args.pop(0)
+        if conv in "di":
+            value, conv = word - (1 << 32) if word & 0x80000000 else word, "d"
+        elif conv == "s":
+            value = elf.string_at(word)
+        elif conv == "c":
+            value = chr(word & 0xFF)
+        else:
+            value = word
+        return f"%{flags}{width}{'d' if conv == 'u' else conv}" % value
+
+    return SPEC_RE.sub(one, fmt)
+
+
+class Reader:
+    """Byte reader that can step back, for resynchronising on a bad header.
+    A tty read may return fewer bytes than asked; only b"" means the end."""
+
+    def __init__(self, stream):
+        self.stream = stream
+        self.buf = bytearray()
+
+    def peek_word(self, index=0):
+        need = 4 * (index + 1)
+        while len(self.buf) < need:
+            chunk = self.stream.read(need - len(self.buf))
+            if not chunk:
+                raise EOFError
+            self.buf += chunk
+        return struct.unpack_from("<I", self.buf, 4 * index)[0]
+
+    def consume(self, count):
+        del self.buf[:count]
+
+
+def decode(elf, stream, out, cpu_hz, show_time):
+    fmt_sec = elf.section(".dlog_fmt")
+    rd = Reader(stream)
+    last_seq = None
+    stamp_hi = 0
+    last_stamp = None
+
+    while True:
+        try:
+            hdr = rd.peek_word()
+        except EOFError:
+            return
+
+        fmt_id = hdr >> 16
+        nargs = (hdr >> 12) & 0xF
+        seq = hdr & 0xFF
+        fmt = None
+        if fmt_id != DLOG_ID_DROPPED:
+            fmt = elf.section_string(fmt_sec, fmt_id)
+
+        # Not a header (started mid-stream, or text from the target): slide
+        # one byte and try again
+        if (((hdr >> 8) & 0xF) != DLOG_SYNC or nargs > DLOG_MAX_ARGS
+                or (fmt_id == DLOG_ID_DROPPED and nargs != 1)
+                or (fmt_id != DLOG_ID_DROPPED and fmt is None)):
+            rd.consume(1)
+            continue
+
+        try:
+            stamp = rd.peek_word(1)
+            args = [rd.peek_word(2 + i) for i in range(nargs)]
+        except EOFError:
+            return
+        rd.consume(4 * (2 + nargs))
+
+        # Unwrap the 32-bit cycle counter (wraps every ~25 s at 168 MHz)
+        if last_stamp is not None and stamp < last_stamp:
+            stamp_hi += 1 << 32
+        last_stamp = stamp
+        prefix = f"[{(stamp_hi + stamp) / cpu_hz:12.6f}] " if show_time else ""
+
+        if fmt_id == DLOG_ID_DROPPED:
+            out.write(f"{prefix}<{args[0]} records dropped, ring full>\n")
+            out.flush()
+            continue
+
+        if last_seq is not None and seq != (last_seq + 1) & 0xFF:
+            out.write(f"{prefix}<{(seq - last_seq - 1) & 0xFF} records lost>\n")
+        last_seq = seq
+
+        # Keep the message's own leading blank lines ahead of the timestamp
+        text = render(elf, fmt, args).replace("\r\n", "\n")
+        lead = len(text) - len(text.lstrip("\n"))
+        out.write("\n" * lead + prefix + text[lead:])
+        out.flush()
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Decode DLOG binary records.")
+    ap.add_argument("elf", help="firmware ELF built from the same sources")
+    ap.add_argument("input", help="serial device, capture file, or - for stdin")
+    ap.add_argument("--cpu-hz", type=float, default=168e6,
+                    help="core clock for timestamps (default 168 MHz)")
+    ap.add_argument("--no-time", action="store_true",
+                    help="omit the timestamp column")
+    opts = ap.parse_args()
+
+    elf = Elf(opts.elf)
+    stream = sys.stdin.buffer if opts.input == "-" else open(opts.input, "rb", buffering=0)
+    try:
+        decode(elf, stream, sys.stdout, opts.cpu_hz, not opts.no_time)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,128 @@
+/**
+ ******************************************************************************
+ * @file           : app_config.h
+ * @brief          : Application feature switches for the parking lot demo.
+ *
+ * @description    : Kernel options, trace and benchmark modes are selected
+ *                   here with a 0/1 switch.  FreeRTOSConfig.h includes this
+ *                   file so that kernel settings can follow the switches.
+ ******************************************************************************
+ */
+
+#ifndef APP_CONFIG_H
+#define APP_CONFIG_H
+
+/* ============================================================
+ *  KERNEL OBJECT ALLOCATION
+ * ============================================================ */
+
+/* 1 = Static profile: the cars, the parking semaphore and the ktrace task
+     (plus the idle and timer tasks) get their memory from variables
+     declared with static_alloc.h, and the kernel is built without a heap
+     (configSUPPORT_DYNAMIC_ALLOCATION 0); Host/Tools/ram_report.py lists
+     the RAM per object from the map file.  The car benchmark creates cars
+     at run time and refuses to build
+ 0 = Objects are taken from the configTOTAL_HEAP_SIZE heap at creation */
+#ifndef APP_STATIC_ALLOC
+#define APP_STATIC_ALLOC                0
+#endif
+
+/* ============================================================
+ *  STACK PROFILE
+ * ============================================================ */
+
+/* 1 = A task at idle priority prints the peak stack use of every task as
+     "@stk" lines on USART2 every 10 s (stack_prof.c); feed the last report
+     and the compiler's call graph to Host/Tools/stack_size.py to rewrite
+     Core/Inc/stack_sizes.h.  Turns on configRECORD_STACK_HIGH_ADDRESS.
+     Not together with APP_BENCH_CARS: its cars overflow the report table
+ 0 = Stack sizes stay as stack_sizes.h has them, with no profiler */
+#ifndef APP_STACK_PROFILE
+#define APP_STACK_PROFILE               0
+#endif
+
+/* ============================================================
+ *  CCM RAM
+ * ============================================================ */
+
+/* 1 = Task stacks and TCBs go to the 64 KB core-coupled RAM, which only
+     the CPU can reach (ccm_ram.h): with the heap, heap_5.c spreads it over
+     APP_CCM_HEAP_SIZE bytes of CCM plus main SRAM and fills CCM first;
+     with APP_STATIC_ALLOC the STATIC_TASK() storage is placed there
+ 0 = Everything in main SRAM */
+#ifndef APP_CCM_RAM
+#define APP_CCM_RAM                     0
+#endif
+
+/* Bytes of the heap (configTOTAL_HEAP_SIZE) placed in CCM RAM when
+   APP_CCM_RAM = 1; the rest stays in main SRAM.  At most 64 KB, and less
+   than the whole heap */
+#ifndef APP_CCM_HEAP_SIZE
+#define APP_CCM_HEAP_SIZE               (32 * 1024)
+#endif
+
+/* ============================================================
+ *  BLOCKED TASKS
+ * ============================================================ */
+
+/* 1 = Tasks blocked with a timeout wait in a hierarchical timing wheel
+     (configUSE_DELAYED_WHEEL): vTaskDelay() costs the same with 10 or 1,000
+     tasks asleep, but the tick does the sorting instead and costs more the
+     more tasks are asleep; that work is spread over the ticks, not bunched
+ 0 = Stock sorted delayed lists; the better choice for a handful of tasks */
+#ifndef APP_DELAYED_WHEEL
+#define APP_DELAYED_WHEEL               0
+#endif
+
+/* ============================================================
+ *  KERNEL EVENT TRACE
+ * ============================================================ */
+
+/* 1 = Record context switches, queue and semaphore traffic, interrupts and
+ timer commands in a RAM ring (ktrace.c) and dump it as text; turn the dump
+ into a timeline with Host/Tools/ktrace_export.py.  8 KiB of RAM and a few
+ dozen cycles per kernel event.  Host/Makefile's counting_trace target sets
+ it.  Not together with APP_BENCH_CARS: both hook vTaskDelay()
+ 0 = The kernel trace hooks stay empty */
+#ifndef APP_KTRACE
+#define APP_KTRACE                      0
+#endif
+
+/* 1 = Dump over SWO (ITM port 0)
+ 0 = Dump over USART2, between the demo's own lines */
+#ifndef APP_KTRACE_SWO
+#define APP_KTRACE_SWO                  0
+#endif
+
+/* 1 = Stop recording when the ring is full: the trace covers start-up
+ 0 = Flight recorder: keep overwriting the oldest events until
+     ktrace_trigger() is called */
+#ifndef APP_KTRACE_SNAPSHOT
+#define APP_KTRACE_SNAPSHOT             1
+#endif
+
+/* ============================================================
+ *  BENCHMARK MODE
+ * ============================================================ */
+
+/* 1 = Run the parking lot scaling benchmark (car_bench.c) once after the
+ scheduler starts: tick interrupt and vTaskDelay() cycles with 10 up to
+ APP_BENCH_CARS_MAX extra car tasks driving around.  Printed with printf
+ (ITM on the board).  Host/Makefile's cbench and cbench_wheel targets set
+ it from the command line */
+#ifndef APP_BENCH_CARS
+#define APP_BENCH_CARS                  0
+#endif
+
+/* Most cars in the largest row.  Each costs ~600 bytes of heap, so the
+ board stops at 50; the host runs 1,000 */
+#ifndef APP_BENCH_CARS_MAX
+#define APP_BENCH_CARS_MAX              50U
+#endif
+
+/* 1 = exit() once the table and chart are printed (host build) */
+#ifndef APP_BENCH_CARS_EXIT
+#define APP_BENCH_CARS_EXIT             0
+#endif
+
+#endif /* APP_CONFIG_H */
@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * @file           : bench_stats.h
+ * @brief          : What the cycle benchmarks share: counter-read overhead,
+ *                   sample summaries (min, median, avg, p99, max) and the
+ *                   power-of-two histogram charts.
+ *
+ * @description    : A benchmark takes its samples with dwt_cycles_now() /
+ *                   dwt_cycles_since(), passes each through bench_net(),
+ *                   and once a case is done hands the array to
+ *                   bench_summarise().  Everything here runs in task
+ *                   context except bench_net(), which is also safe from
+ *                   an interrupt or a trace hook.
+ ******************************************************************************
+ */
+
+#ifndef BENCH_STATS_H
+#define BENCH_STATS_H
+
+#include "main.h"
+
+/* ========================== Public Defines =============================== */
+#define BENCH_BUCKETS       33U    /* Histogram: 0, then one per power of 2  */
+#define BENCH_BAR_WIDTH     40U    /* Characters of the longest chart bar    */
+
+/* ========================== Public Types ================================= */
+typedef struct {
+    uint32_t count;                /* Samples summarised; 0: no row          */
+    uint32_t min;
+    uint32_t med;
+    uint32_t avg;
+    uint32_t p99;                  /* Nearest rank                           */
+    uint32_t max;
+    uint32_t hist[BENCH_BUCKETS];  /* Samples per bench_bucket()             */
+} bench_stats_t;
+
+/* ========================== Public API =================================== */
+
+/**
+ * @brief  Measure the cost of an empty now/since pair, which bench_net()
+ *         subtracts from every sample.  Call once the DWT counter runs,
+ *         before the first sample.
+ * @return The overhead in cycles, for the benchmark's header line.
+ */
+uint32_t bench_calibrate(void);
+
+/**
+ * @brief  One sample less the counter-read overhead (0 if below it).
+ * @param  cycles  dwt_cycles_since() of the sample.
+ */
+uint32_t bench_net(uint32_t cycles);
+
+/**
+ * @brief  Sort samples in place, ascending (insertion sort: small n, no
+ *         heap).
+ */
+void bench_sort(uint32_t *v, uint32_t n);
+
+/**
+ * @brief  Histogram bucket: 0 for 0, else b for 2^(b-1) <= v < 2^b.
+ */
+uint32_t bench_bucket(uint32_t v);
+
+/**
+ * @brief  Sort the samples and fill in every field of *s.  With n = 0
+ *         only count is set (to 0), so the caller prints a "-" row.
+ * @param  s  Cleared first.
+ * @param  v  Samples; left sorted.
+ * @param  n  Samples in v.
+ */
+void bench_summarise(bench_stats_t *s, uint32_t *v, uint32_t n);
+
+/**
+ * @brief  Fill bar with the '#' run for value, scaled so that scale is
+ *         BENCH_BAR_WIDTH characters, and terminate it.
+ * @param  bar  BENCH_BAR_WIDTH + 1 characters.
+ */
+void bench_bar(char *bar, uint32_t value, uint32_t scale);
+
+/**
+ * @brief  Print the histogram of *s as comment lines, one bar per
+ *         power-of-two range from the smallest sample's to the largest's:
+ *
+ *           #
+ *           # <name> (<unit> per cycle range)
+ *           #       64-127      |#########                      120
+ *
+ *         Prints nothing when s->count is 0.
+ * @param  unit  What one sample is: "wakeups", "calls" ...
+ */
+void bench_print_chart(const char *name, const char *unit,
+                       const bench_stats_t *s);
+
+#endif /* BENCH_STATS_H */
@@ -0,0 +1,28 @@
+/**
+ ******************************************************************************
+ * @file           : car_bench.h
+ * @brief          : Parking lot scaling benchmark: tick interrupt and
+ *                   vTaskDelay() cost with 10 up to APP_BENCH_CARS_MAX car
+ *                   tasks asleep.
+ *
+ * @description    : Enabled by APP_BENCH_CARS in app_config.h.  Prints a
+ *                   table with one row per car count on the console and a
+ *                   bar chart of it.  Run it once with APP_DELAYED_WHEEL = 0
+ *                   and once with 1 and diff the two outputs to compare the
+ *                   sorted delayed lists with the timing wheel.
+ ******************************************************************************
+ */
+
+#ifndef CAR_BENCH_H
+#define CAR_BENCH_H
+
+#include "main.h"
+
+/**
+ * @brief  Start the DWT counter and create the benchmark task.
+ *         Call once, before the scheduler starts.  Does nothing when
+ *         APP_BENCH_CARS is 0.
+ */
+void car_bench_init(void);
+
+#endif /* CAR_BENCH_H */
@@ -0,0 +1,140 @@
+/**
+ ******************************************************************************
+ * @file           : ktrace_freertos.h
+ * @brief          : Kernel trace hooks for the ktrace event recorder.
+ *
+ * @description    : FreeRTOSConfig.h includes this file at its end when
+ *                   APP_KTRACE is 1, the way SEGGER's SystemView patch
+ *                   header is included.  The macros expand inside tasks.c,
+ *                   queue.c, timers.c and the port, so they read kernel
+ *                   fields directly:
+ *
+ *                     uxTaskNumber       ktrace id given to the task when it
+ *                                        was created
+ *                     uxQueueNumber      ktrace id given to the queue,
+ *                                        semaphore or mutex when created
+ *                     uxMessagesWaiting  items (semaphore count) before the
+ *                                        operation
+ *
+ *                   Both numbers exist only with configUSE_TRACE_FACILITY.
+ *                   Each hook costs one call and a two-word store with
+ *                   interrupts masked (ktrace.c).
+ *
+ *                   Event record, two 32-bit words:
+ *
+ *                     word 0   [31:24] event code (KTRACE_EV_*)
+ *                              [23:0]  argument, as listed below
+ *                     word 1   DWT cycle counter
+ ******************************************************************************
+ */
+
+#ifndef KTRACE_FREERTOS_H
+#define KTRACE_FREERTOS_H
+
+#include <stdint.h>
+
+#if ( configUSE_TRACE_FACILITY != 1 )
+#error "ktrace needs configUSE_TRACE_FACILITY = 1 for task and queue numbers"
+#endif
+
+/* ========================== Event Codes ================================== */
+                                          /* Argument                        */
+#define KTRACE_EV_SWITCH_IN         0x01U /* task id                         */
+#define KTRACE_EV_SWITCH_OUT        0x02U /* task id                         */
+#define KTRACE_EV_READY             0x03U /* task id                         */
+#define KTRACE_EV_DELAY             0x04U /* ticks to sleep                  */
+#define KTRACE_EV_DELAY_UNTIL       0x05U /* wake tick, low 24 bits          */
+#define KTRACE_EV_TASK_DELETE       0x06U /* task id                         */
+#define KTRACE_EV_PRIO_INHERIT      0x07U /* task id << 8 | new priority     */
+#define KTRACE_EV_PRIO_DISINHERIT   0x08U /* task id << 8 | new priority     */
+#define KTRACE_EV_SEND              0x10U /* object id << 16 | count before  */
+#define KTRACE_EV_SEND_FAILED       0x11U /*   "                             */
+#define KTRACE_EV_SEND_FROM_ISR     0x12U /*   "                             */
+#define KTRACE_EV_RECEIVE           0x13U /*   "                             */
+#define KTRACE_EV_RECEIVE_FAILED    0x14U /*   "                             */
+#define KTRACE_EV_RECEIVE_FROM_ISR  0x15U /*   "                             */
+#define KTRACE_EV_BLOCK_SEND        0x16U /*   "                             */
+#define KTRACE_EV_BLOCK_RECEIVE     0x17U /*   "  (receive, take and peek)   */
+#define KTRACE_EV_ISR_ENTER         0x20U /* exception number (IPSR)         */
+#define KTRACE_EV_ISR_EXIT          0x21U /* 1 = a context switch follows    */
+#define KTRACE_EV_TIMER_COMMAND     0x30U /* command << 8 | pdPASS / pdFAIL  */
+
+/* ========================== Recorder Entry Points ======================== */
+void     ktrace_event(uint32_t event, uint32_t arg);
+void     ktrace_isr_enter(void);
+void     ktrace_isr_exit(uint32_t to_scheduler);
+uint32_t ktrace_task_create(const char *name, uint32_t priority);
+uint32_t ktrace_object_create(uint32_t type);
+void     ktrace_object_name(uint32_t id, const char *name);
+
+#define KTRACE_TASK_ID( pxTCB )     ( ( uint32_t ) ( pxTCB )->uxTaskNumber )
+
+#define KTRACE_QUEUE_ARG( pxQueue )                                          \
+    ( ( ( uint32_t ) ( pxQueue )->uxQueueNumber << 16 ) |                    \
+      ( ( uint32_t ) ( pxQueue )->uxMessagesWaiting & 0xFFFFU ) )
+
+/* ========================== Tasks ======================================== */
+#define traceTASK_CREATE( pxNewTCB )                                         \
+    ( pxNewTCB )->uxTaskNumber = ( UBaseType_t ) ktrace_task_create(         \
+        ( pxNewTCB )->pcTaskName, ( uint32_t ) ( pxNewTCB )->uxPriority )
+#define traceTASK_DELETE( pxTCB )                                            \
+    ktrace_event( KTRACE_EV_TASK_DELETE, KTRACE_TASK_ID( pxTCB ) )
+#define traceTASK_SWITCHED_IN()                                              \
+    ktrace_event( KTRACE_EV_SWITCH_IN, KTRACE_TASK_ID( pxCurrentTCB ) )
+#define traceTASK_SWITCHED_OUT()                                             \
+    ktrace_event( KTRACE_EV_SWITCH_OUT, KTRACE_TASK_ID( pxCurrentTCB ) )
+#define traceMOVED_TASK_TO_READY_STATE( pxTCB )                              \
+    ktrace_event( KTRACE_EV_READY, KTRACE_TASK_ID( pxTCB ) )
+#define traceTASK_DELAY()                                                    \
+    ktrace_event( KTRACE_EV_DELAY, ( uint32_t ) xTicksToDelay )
+#define traceTASK_DELAY_UNTIL( xTimeToWake )                                 \
+    ktrace_event( KTRACE_EV_DELAY_UNTIL, ( uint32_t ) ( xTimeToWake ) )
+#define traceTASK_PRIORITY_INHERIT( pxTCBOfMutexHolder, uxInheritedPriority ) \
+    ktrace_event( KTRACE_EV_PRIO_INHERIT,                                    \
+                  ( KTRACE_TASK_ID( pxTCBOfMutexHolder ) << 8 ) |            \
+                  ( ( uint32_t ) ( uxInheritedPriority ) & 0xFFU ) )
+#define traceTASK_PRIORITY_DISINHERIT( pxTCBOfMutexHolder, uxOriginalPriority ) \
+    ktrace_event( KTRACE_EV_PRIO_DISINHERIT,                                 \
+                  ( KTRACE_TASK_ID( pxTCBOfMutexHolder ) << 8 ) |            \
+                  ( ( uint32_t ) ( uxOriginalPriority ) & 0xFFU ) )
+
+/* ========================== Queues, Semaphores, Mutexes ================== */
+#define traceQUEUE_CREATE( pxNewQueue )                                      \
+    ( pxNewQueue )->uxQueueNumber = ( UBaseType_t ) ktrace_object_create(    \
+        ( uint32_t ) ( pxNewQueue )->ucQueueType )
+#define traceQUEUE_REGISTRY_ADD( xQueue, pcQueueName )                       \
+    ktrace_object_name( ( uint32_t ) ( xQueue )->uxQueueNumber, ( pcQueueName ) )
+#define traceQUEUE_SEND( pxQueue )                                           \
+    ktrace_event( KTRACE_EV_SEND, KTRACE_QUEUE_ARG( pxQueue ) )
+#define traceQUEUE_SEND_FAILED( pxQueue )                                    \
+    ktrace_event( KTRACE_EV_SEND_FAILED, KTRACE_QUEUE_ARG( pxQueue ) )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )                                  \
+    ktrace_event( KTRACE_EV_SEND_FROM_ISR, KTRACE_QUEUE_ARG( pxQueue ) )
+#define traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue )                           \
+    ktrace_event( KTRACE_EV_SEND_FAILED, KTRACE_QUEUE_ARG( pxQueue ) )
+#define traceQUEUE_RECEIVE( pxQueue )                                        \
+    ktrace_event( KTRACE_EV_RECEIVE, KTRACE_QUEUE_ARG( pxQueue ) )
+#define traceQUEUE_RECEIVE_FAILED( pxQueue )                                 \
+    ktrace_event( KTRACE_EV_RECEIVE_FAILED, KTRACE_QUEUE_ARG( pxQueue ) )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )                               \
+    ktrace_event( KTRACE_EV_RECEIVE_FROM_ISR, KTRACE_QUEUE_ARG( pxQueue ) )
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue )                        \
+    ktrace_event( KTRACE_EV_RECEIVE_FAILED, KTRACE_QUEUE_ARG( pxQueue ) )
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )                               \
+    ktrace_event( KTRACE_EV_BLOCK_SEND, KTRACE_QUEUE_ARG( pxQueue ) )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )                            \
+    ktrace_event( KTRACE_EV_BLOCK_RECEIVE, KTRACE_QUEUE_ARG( pxQueue ) )
+#define traceBLOCKING_ON_QUEUE_PEEK( pxQueue )                               \
+    ktrace_event( KTRACE_EV_BLOCK_RECEIVE, KTRACE_QUEUE_ARG( pxQueue ) )
+
+/* ========================== Interrupts and Timers ======================== */
+#define traceISR_ENTER()                ktrace_isr_enter()
+#define traceISR_EXIT()                 ktrace_isr_exit( 0U )
+#define traceISR_EXIT_TO_SCHEDULER()    ktrace_isr_exit( 1U )
+
+#define traceTIMER_COMMAND_SEND( xTimer, xMessageID, xMessageValueValue, xReturn ) \
+    ktrace_event( KTRACE_EV_TIMER_COMMAND,                                   \
+                  ( ( uint32_t ) ( xMessageID ) << 8 ) |                     \
+                  ( ( uint32_t ) ( xReturn ) & 0xFFU ) )
+
+#endif /* KTRACE_FREERTOS_H */
@@ -0,0 +1,227 @@
+/**
+ ******************************************************************************
+ * @file           : static_alloc.h
+ * @brief          : Declare kernel objects with static storage, or with heap
+ *                   storage, from one source line each.
+ *
+ * @description    : With APP_STATIC_ALLOC = 1 (app_config.h) the kernel is
+ *                   built with configSUPPORT_STATIC_ALLOCATION only: there is
+ *                   no FreeRTOS heap, and every task stack, TCB, queue
+ *                   buffer, semaphore and timer is a variable the linker
+ *                   places and counts.  With 0 the same lines create the
+ *                   objects with pvPortMalloc, as before.
+ *
+ *                   Each object is declared at file scope and created at
+ *                   run time, both by name:
+ *
+ *                     STATIC_TASK(print_task, 250);
+ *                     ...
+ *                     status = STATIC_TASK_CREATE(print_task, task_print,
+ *                                                 "print_task", NULL, 2,
+ *                                                 &handle);
+ *
+ *                   The storage is named kobj_<name>_<part>, so
+ *                   Host/Tools/ram_report.py can add up the RAM of each
+ *                   object from the linker map file.  With
+ *                   APP_STACK_PROFILE = 1 each task created here is also
+ *                   registered with stack_prof.c under its storage and
+ *                   entry function names, for Host/Tools/stack_size.py.
+ *                   With APP_CCM_RAM = 1 task stacks and TCBs are placed in
+ *                   CCM RAM (ccm_ram.h); queue storage and the rest stay in
+ *                   main SRAM, where DMA can reach them.
+ ******************************************************************************
+ */
+
+#ifndef STATIC_ALLOC_H
+#define STATIC_ALLOC_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+#include "stream_buffer.h"
+#include "stack_prof.h"
+#include "ccm_ram.h"
+
+/* ========================== Storage ====================================== */
+
+#if APP_STATIC_ALLOC
+
+/* Task: stack of 'words' StackType_t plus its TCB */
+#define STATIC_TASK(name, words)                                              \
+    enum { kobj_##name##_words = (words) };                                   \
+    static StackType_t  kobj_##name##_stack[(words)]                          \
+        CCM_TASK_BSS(kobj_##name##_stack);                                    \
+    static StaticTask_t kobj_##name##_tcb CCM_TASK_BSS(kobj_##name##_tcb)
+
+/* 'count' tasks of 'words' each, created by index */
+#define STATIC_TASK_ARRAY(name, count, words)                                 \
+    enum { kobj_##name##_words = (words) };                                   \
+    static StackType_t  kobj_##name##_stack[(count)][(words)]                 \
+        CCM_TASK_BSS(kobj_##name##_stack);                                    \
+    static StaticTask_t kobj_##name##_tcb[(count)]                            \
+        CCM_TASK_BSS(kobj_##name##_tcb)
+
+/* Queue: 'length' items of 'item_size' bytes plus the queue structure */
+#define STATIC_QUEUE(name, length, item_size)                                 \
+    enum { kobj_##name##_length = (length),                                   \
+           kobj_##name##_item_size = (item_size) };                           \
+    static uint8_t       kobj_##name##_storage[(length) * (item_size)];       \
+    static StaticQueue_t kobj_##name##_queue
+
+/* Binary / counting semaphore or mutex */
+#define STATIC_SEMAPHORE(name)                                                \
+    static StaticSemaphore_t kobj_##name##_sem
+
+/* Software timer */
+#define STATIC_TIMER(name)                                                    \
+    static StaticTimer_t kobj_##name##_timer
+
+/* Stream buffer of 'size' bytes (the kernel needs one byte more) */
+#define STATIC_STREAM_BUFFER(name, size)                                      \
+    enum { kobj_##name##_size = (size) };                                     \
+    static uint8_t              kobj_##name##_storage[(size) + 1];            \
+    static StaticStreamBuffer_t kobj_##name##_stream
+
+#define STATIC_TASK_STACK(name)         (kobj_##name##_stack)
+#define STATIC_TASK_TCB(name)           (&kobj_##name##_tcb)
+#define STATIC_TASK_STACK_AT(name, i)   (kobj_##name##_stack[(i)])
+#define STATIC_TASK_TCB_AT(name, i)     (&kobj_##name##_tcb[(i)])
+#define STATIC_QUEUE_STORAGE(name)      (kobj_##name##_storage)
+#define STATIC_QUEUE_STRUCT(name)       (&kobj_##name##_queue)
+
+#else  /* !APP_STATIC_ALLOC */
+
+/* Only the sizes are kept; the create calls below take them from the heap */
+#define STATIC_TASK(name, words)                                              \
+    enum { kobj_##name##_words = (words) }
+#define STATIC_TASK_ARRAY(name, count, words)                                 \
+    enum { kobj_##name##_words = (words) }
+#define STATIC_QUEUE(name, length, item_size)                                 \
+    enum { kobj_##name##_length = (length),                                   \
+           kobj_##name##_item_size = (item_size) }
+#define STATIC_SEMAPHORE(name)                                                \
+    extern StaticSemaphore_t kobj_##name##_sem
+#define STATIC_TIMER(name)                                                    \
+    extern StaticTimer_t kobj_##name##_timer
+#define STATIC_STREAM_BUFFER(name, size)                                      \
+    enum { kobj_##name##_size = (size) }
+
+#define STATIC_TASK_STACK(name)         ((StackType_t *)NULL)
+#define STATIC_TASK_TCB(name)           ((StaticTask_t *)NULL)
+#define STATIC_TASK_STACK_AT(name, i)   ((StackType_t *)NULL)
+#define STATIC_TASK_TCB_AT(name, i)     ((StaticTask_t *)NULL)
+#define STATIC_QUEUE_STORAGE(name)      ((uint8_t *)NULL)
+#define STATIC_QUEUE_STRUCT(name)       ((StaticQueue_t *)NULL)
+
+#endif /* APP_STATIC_ALLOC */
+
+/* ========================== Creation ===================================== */
+
+/**
+ * @brief  xTaskCreate with the stack and TCB passed in.  Both are ignored
+ *         (and may be NULL) when APP_STATIC_ALLOC is 0.  'object' and
+ *         'entry' name the storage and the entry function for the stack
+ *         profiler.
+ * @return pdPASS, or pdFAIL when the task could not be created.
+ */
+static inline BaseType_t static_task_create(TaskFunction_t fn,
+                                            const char *label,
+                                            configSTACK_DEPTH_TYPE words,
+                                            void *param,
+                                            UBaseType_t priority,
+                                            TaskHandle_t *handle,
+                                            StackType_t *stack,
+                                            StaticTask_t *tcb,
+                                            const char *object,
+                                            const char *entry)
+{
+#if APP_STACK_PROFILE
+    /* Before the task exists: it may run and delete itself at once */
+    stack_prof_task(label, object, entry);
+#else
+    (void)object;
+    (void)entry;
+#endif
+#if APP_STATIC_ALLOC
+    TaskHandle_t task = xTaskCreateStatic(fn, label, words, param, priority,
+                                          stack, tcb);
+
+    if (handle != NULL) {
+        *handle = task;
+    }
+    return (task != NULL) ? pdPASS : pdFAIL;
+#else
+    (void)stack;
+    (void)tcb;
+    return xTaskCreate(fn, label, words, param, priority, handle);
+#endif
+}
+
+/**
+ * @brief  xQueueCreate with the item storage and queue structure passed
+ *         in.  Both are ignored (and may be NULL) when APP_STATIC_ALLOC is 0.
+ * @return The queue, or NULL.
+ */
+static inline QueueHandle_t static_queue_create(UBaseType_t length,
+                                                UBaseType_t item_size,
+                                                uint8_t *storage,
+                                                StaticQueue_t *queue)
+{
+#if APP_STATIC_ALLOC
+    return xQueueCreateStatic(length, item_size, storage, queue);
+#else
+    (void)storage;
+    (void)queue;
+    return xQueueCreate(length, item_size);
+#endif
+}
+
+/* Each returns what the matching dynamic create call returns */
+#define STATIC_TASK_CREATE(name, fn, label, param, priority, handle)          \
+    static_task_create((fn), (label), kobj_##name##_words, (param),           \
+                       (priority), (handle), STATIC_TASK_STACK(name),         \
+                       STATIC_TASK_TCB(name), #name, #fn)
+
+/* Task 'index' of a STATIC_TASK_ARRAY */
+#define STATIC_TASK_CREATE_AT(name, index, fn, label, param, priority, handle) \
+    static_task_create((fn), (label), kobj_##name##_words, (param),           \
+                       (priority), (handle), STATIC_TASK_STACK_AT(name, index),\
+                       STATIC_TASK_TCB_AT(name, index), #name, #fn)
+
+#define STATIC_QUEUE_CREATE(name)                                             \
+    static_queue_create(kobj_##name##_length, kobj_##name##_item_size,        \
+                        STATIC_QUEUE_STORAGE(name), STATIC_QUEUE_STRUCT(name))
+
+#if APP_STATIC_ALLOC
+
+#define STATIC_SEMAPHORE_CREATE_BINARY(name)                                  \
+    xSemaphoreCreateBinaryStatic(&kobj_##name##_sem)
+#define STATIC_SEMAPHORE_CREATE_COUNTING(name, max, initial)                  \
+    xSemaphoreCreateCountingStatic((max), (initial), &kobj_##name##_sem)
+#define STATIC_SEMAPHORE_CREATE_MUTEX(name)                                   \
+    xSemaphoreCreateMutexStatic(&kobj_##name##_sem)
+#define STATIC_TIMER_CREATE(name, label, period, reload, id, callback)        \
+    xTimerCreateStatic((label), (period), (reload), (id), (callback),         \
+                       &kobj_##name##_timer)
+#define STATIC_STREAM_BUFFER_CREATE(name, trigger)                            \
+    xStreamBufferCreateStatic(kobj_##name##_size, (trigger),                  \
+                              kobj_##name##_storage, &kobj_##name##_stream)
+
+#else  /* !APP_STATIC_ALLOC */
+
+#define STATIC_SEMAPHORE_CREATE_BINARY(name)                                  \
+    xSemaphoreCreateBinary()
+#define STATIC_SEMAPHORE_CREATE_COUNTING(name, max, initial)                  \
+    xSemaphoreCreateCounting((max), (initial))
+#define STATIC_SEMAPHORE_CREATE_MUTEX(name)                                   \
+    xSemaphoreCreateMutex()
+#define STATIC_TIMER_CREATE(name, label, period, reload, id, callback)        \
+    xTimerCreate((label), (period), (reload), (id), (callback))
+#define STATIC_STREAM_BUFFER_CREATE(name, trigger)                            \
+    xStreamBufferCreate(kobj_##name##_size, (trigger))
+
+#endif /* APP_STATIC_ALLOC */
+
+#endif /* STATIC_ALLOC_H */
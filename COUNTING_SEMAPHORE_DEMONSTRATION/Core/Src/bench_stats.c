@@ -0,0 +1,136 @@
+/**
+ ******************************************************************************
+ * @file           : bench_stats.c
+ * @brief          : Counter-read overhead, sample summaries and histogram
+ *                   charts for the cycle benchmarks.
+ *
+ * @description    : Linked into every build; only the benchmarks call it.
+ ******************************************************************************
+ */
+
+#include "bench_stats.h"
+#include "dwt_cycles.h"
+
+#include <stdio.h>                 /* printf -> ITM / host stdout            */
+#include <string.h>
+
+/* ========================== Private Defines ============================== */
+#define BENCH_CALIBRATE_RUNS    64U
+
+/* ========================== Private Data ================================= */
+static uint32_t bench_overhead;    /* Cycles to read the counter             */
+
+/* ========================== Overhead ===================================== */
+
+uint32_t bench_calibrate(void)
+{
+    uint32_t best = UINT32_MAX;
+
+    for (uint32_t i = 0; i < BENCH_CALIBRATE_RUNS; i++) {
+        uint32_t start = dwt_cycles_now();
+        uint32_t cycles = dwt_cycles_since(start);
+
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    bench_overhead = best;
+    return best;
+}
+
+uint32_t bench_net(uint32_t cycles)
+{
+    return (cycles > bench_overhead) ? cycles - bench_overhead : 0U;
+}
+
+/* ========================== Summaries ==================================== */
+
+void bench_sort(uint32_t *v, uint32_t n)
+{
+    for (uint32_t i = 1; i < n; i++) {
+        uint32_t x = v[i];
+        uint32_t j = i;
+
+        while (j > 0U && v[j - 1U] > x) {
+            v[j] = v[j - 1U];
+            j--;
+        }
+        v[j] = x;
+    }
+}
+
+uint32_t bench_bucket(uint32_t v)
+{
+    uint32_t b = 0U;
+
+    while (v != 0U) {
+        v >>= 1;
+        b++;
+    }
+    return b;
+}
+
+void bench_summarise(bench_stats_t *s, uint32_t *v, uint32_t n)
+{
+    uint64_t sum = 0U;
+
+    memset(s, 0, sizeof(*s));
+    s->count = n;
+    if (n == 0U) {
+        return;
+    }
+
+    bench_sort(v, n);
+    for (uint32_t i = 0; i < n; i++) {
+        sum += v[i];
+        s->hist[bench_bucket(v[i])]++;
+    }
+    s->min = v[0];
+    s->med = v[n / 2U];
+    s->avg = (uint32_t)(sum / n);
+    s->p99 = v[(n * 99U + 99U) / 100U - 1U];
+    s->max = v[n - 1U];
+}
+
+/* ========================== Charts ======================================= */
+
+void bench_bar(char *bar, uint32_t value, uint32_t scale)
+{
+    uint32_t len = (uint32_t)(((uint64_t)value * BENCH_BAR_WIDTH +
+                               scale / 2U) / scale);
+
+    for (uint32_t j = 0; j < len; j++) {
+        bar[j] = '#';
+    }
+    bar[len] = '\0';
+}
+
+void bench_print_chart(const char *name, const char *unit,
+                       const bench_stats_t *s)
+{
+    uint32_t first = bench_bucket(s->min);
+    uint32_t last  = bench_bucket(s->max);
+    uint32_t scale = 1U;
+
+    if (s->count == 0U) {
+        return;
+    }
+    for (uint32_t b = first; b <= last; b++) {
+        if (s->hist[b] > scale) {
+            scale = s->hist[b];
+        }
+    }
+
+    printf("#\n# %s (%s per cycle range)\n", name, unit);
+    for (uint32_t b = first; b <= last; b++) {
+        uint32_t lo = (b == 0U) ? 0U : 1UL << (b - 1U);
+        uint32_t hi = (b == 0U) ? 0U : (b == 32U) ? UINT32_MAX
+                                                  : (1UL << b) - 1U;
+        char     bar[BENCH_BAR_WIDTH + 1U];
+
+        bench_bar(bar, s->hist[b], scale);
+        printf("# %8lu-%-10lu |%-*s %lu\n", (unsigned long)lo,
+               (unsigned long)hi, (int)BENCH_BAR_WIDTH, bar,
+               (unsigned long)s->hist[b]);
+    }
+}
@@ -0,0 +1,361 @@
+/**
+ ******************************************************************************
+ * @file           : car_bench.c
+ * @brief          : Parking lot scaling benchmark (APP_BENCH_CARS).
+ *
+ * @description    : cbench_task fills a second parking lot with car tasks,
+ *                   10 up to APP_BENCH_CARS_MAX of them, and prints one row
+ *                   per car count, then a bar chart of the same numbers:
+ *
+ *                     # car_bench V11.1.0 backend=list cpu_hz=... ...
+ *                     # cars    tick_avg tick_max delay_avg delay_max
+ *                     10              ..       ..        ..        ..
+ *                     ...
+ *                     # end
+ *
+ *                   tick   CPU cycles of xTaskIncrementTick(), the kernel's
+ *                          share of the tick interrupt: advancing the tick
+ *                          and moving the cars that are due to the ready
+ *                          list.  Pended ticks replayed by xTaskResumeAll()
+ *                          count too.
+ *                   delay  CPU cycles from vTaskDelay() filing the calling
+ *                          car as blocked until it resumes the scheduler:
+ *                          the delayed-list insert, which the sorted list
+ *                          pays for by walking past the cars due earlier.
+ *
+ *                   Both are averaged, and their maximum kept, over
+ *                   CB_WINDOW_MS per row, minus the cost of reading the
+ *                   counter.  A tick or a car that interrupts a delay is
+ *                   counted in it, which mostly shows in delay_max.
+ *
+ *                   Car i drives for CB_DRIVE_MIN_MS + (13 i mod
+ *                   CB_DRIVE_SPREAD_MS) ms, queues for one of CB_SPOTS
+ *                   spots for at most CB_WAIT_MS, and stays parked for
+ *                   CB_PARK_MIN_MS + (7 i mod CB_PARK_SPREAD_MS) ms.  Almost
+ *                   every car is asleep at any moment, and most of the time
+ *                   a few of them are queueing with a timeout.
+ ******************************************************************************
+ */
+
+#include "car_bench.h"
+#include "app_config.h"
+
+#if APP_BENCH_CARS
+
+#include "dwt_cycles.h"
+#include "bench_stats.h"
+
+#include <stdio.h>                 /* printf -> ITM / host stdout            */
+#include <stdlib.h>                /* exit (APP_BENCH_CARS_EXIT)             */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#if APP_STATIC_ALLOC
+#error "car_bench creates its cars at run time: build it with APP_STATIC_ALLOC = 0"
+#endif
+
+/* ========================== Private Defines ============================== */
+#define CB_PRIO_BENCH       ( configMAX_PRIORITIES - 2U )
+#define CB_PRIO_CAR         1U     /* Below the demo's own cars             */
+#define CB_STACK_WORDS      256U   /* cbench_task: printf                    */
+#define CB_CAR_STACK_WORDS  configMINIMAL_STACK_SIZE
+
+#define CB_SPOTS            16U    /* Spots in the benchmark's parking lot   */
+#define CB_DRIVE_MIN_MS     20U
+#define CB_DRIVE_SPREAD_MS  80U
+#define CB_PARK_MIN_MS      30U
+#define CB_PARK_SPREAD_MS   50U
+#define CB_WAIT_MS          50U    /* Give up queueing for a spot after this */
+
+#define CB_SETTLE_MS        300U   /* After adding cars, before measuring    */
+#define CB_WINDOW_MS        1000U  /* Measurement window per row             */
+#define CB_ROWS             6U
+
+/* cbench_task outranks the console, so after each row it sleeps long
+ * enough for the output to drain */
+#define CB_ROW_GAP_MS       20U
+
+/* ========================== Private Types ================================ */
+typedef struct {
+    uint32_t count;
+    uint32_t max;
+    uint64_t sum;
+} cb_stat_t;
+
+typedef struct {
+    uint32_t cars;
+    uint32_t tick_avg;
+    uint32_t tick_max;
+    uint32_t delay_avg;
+    uint32_t delay_max;
+} cb_row_t;
+
+/* ========================== Private Data ================================= */
+static const uint32_t    cb_sizes[CB_ROWS] = { 10U, 50U, 100U, 200U, 500U, 1000U };
+
+static SemaphoreHandle_t cb_lot;
+static TaskHandle_t      cb_cars[APP_BENCH_CARS_MAX];
+static uint32_t          cb_count;          /* Benchmark cars running        */
+static cb_row_t          cb_rows[CB_ROWS];
+static uint32_t          cb_nrows;
+static uint32_t          cb_overhead;       /* bench_calibrate(), header     */
+
+/* Written by the trace hooks: the tick pair from the tick interrupt, the
+ * delay pair by whichever car is in vTaskDelay() with the scheduler
+ * suspended.  cbench_task only resets and reads them with both masked. */
+static volatile uint32_t cb_armed;
+static uint32_t          cb_tick_start;
+static uint32_t          cb_delay_start;
+static uint32_t          cb_delay_open;
+static cb_stat_t         cb_tick;
+static cb_stat_t         cb_delay;
+
+/* ========================== Trace Hooks ================================== */
+
+static void cb_stat_add(cb_stat_t *stat, uint32_t cycles)
+{
+    stat->count++;
+    stat->sum += cycles;
+    if (cycles > stat->max) {
+        stat->max = cycles;
+    }
+}
+
+void car_bench_tick_start(void)
+{
+    cb_tick_start = dwt_cycles_now();
+}
+
+void car_bench_tick_end(void)
+{
+    if (cb_armed != 0U) {
+        cb_stat_add(&cb_tick, bench_net(dwt_cycles_since(cb_tick_start)));
+    }
+}
+
+void car_bench_delay_start(void)
+{
+    cb_delay_start = dwt_cycles_now();
+    cb_delay_open  = 1U;
+}
+
+/* Every xTaskResumeAll() lands here; only the one closing a vTaskDelay()
+ * ends a sample */
+void car_bench_delay_end(void)
+{
+    if (cb_delay_open != 0U) {
+        cb_delay_open = 0U;
+        if (cb_armed != 0U) {
+            cb_stat_add(&cb_delay, bench_net(dwt_cycles_since(cb_delay_start)));
+        }
+    }
+}
+
+/* ========================== Cars ========================================= */
+
+/**
+ * @brief  One benchmark car: drive, queue for a spot, park, leave.
+ * @param  param  Car index.
+ */
+static void cb_car_task(void *param)
+{
+    const uint32_t   id    = (uint32_t)param;
+    const TickType_t drive = pdMS_TO_TICKS(CB_DRIVE_MIN_MS + (id * 13U) % CB_DRIVE_SPREAD_MS);
+    const TickType_t park  = pdMS_TO_TICKS(CB_PARK_MIN_MS + (id * 7U) % CB_PARK_SPREAD_MS);
+
+    for (;;) {
+        vTaskDelay(drive);
+
+        if (xSemaphoreTake(cb_lot, pdMS_TO_TICKS(CB_WAIT_MS)) == pdTRUE) {
+            vTaskDelay(park);
+            (void)xSemaphoreGive(cb_lot);
+        }
+    }
+}
+
+/**
+ * @brief  Create car tasks until n are running.
+ * @return 1 if all n run, 0 if the heap ran out first.
+ */
+static int cb_grow(uint32_t n)
+{
+    while (cb_count < n) {
+        TaskHandle_t car;
+
+        if (xTaskCreate(cb_car_task, "cb_car", CB_CAR_STACK_WORDS,
+                        (void *)cb_count, CB_PRIO_CAR, &car) != pdPASS) {
+            return 0;
+        }
+        cb_cars[cb_count++] = car;
+    }
+    return 1;
+}
+
+/* ========================== Measurement ================================== */
+
+static uint32_t cb_avg(const cb_stat_t *stat)
+{
+    return (stat->count != 0U) ? (uint32_t)(stat->sum / stat->count) : 0U;
+}
+
+/**
+ * @brief  Collect tick and delay samples for CB_WINDOW_MS into one row.
+ */
+static void cb_measure(cb_row_t *row)
+{
+    taskENTER_CRITICAL();
+    cb_tick  = (cb_stat_t){ 0 };
+    cb_delay = (cb_stat_t){ 0 };
+    cb_armed = 1U;
+    taskEXIT_CRITICAL();
+
+    vTaskDelay(pdMS_TO_TICKS(CB_WINDOW_MS));
+
+    taskENTER_CRITICAL();
+    cb_armed = 0U;
+    taskEXIT_CRITICAL();
+
+    row->cars      = cb_count;
+    row->tick_avg  = cb_avg(&cb_tick);
+    row->tick_max  = cb_tick.max;
+    row->delay_avg = cb_avg(&cb_delay);
+    row->delay_max = cb_delay.max;
+}
+
+/* ========================== Report ======================================= */
+
+static void cb_print_header(void)
+{
+    printf("# car_bench %s backend=%s cpu_hz=%lu tick_hz=%lu spots=%lu "
+           "window_ms=%lu overhead=%lu\n",
+           tskKERNEL_VERSION_NUMBER,
+           (configUSE_DELAYED_WHEEL == 1) ? "wheel" : "list",
+           (unsigned long)SystemCoreClock,
+           (unsigned long)configTICK_RATE_HZ,
+           (unsigned long)CB_SPOTS,
+           (unsigned long)CB_WINDOW_MS,
+           (unsigned long)cb_overhead);
+    printf("# %-6s %8s %8s %9s %9s\n",
+           "cars", "tick_avg", "tick_max", "delay_avg", "delay_max");
+}
+
+static void cb_print_row(const cb_row_t *row)
+{
+    printf("%-8lu %8lu %8lu %9lu %9lu\n",
+           (unsigned long)row->cars,
+           (unsigned long)row->tick_avg, (unsigned long)row->tick_max,
+           (unsigned long)row->delay_avg, (unsigned long)row->delay_max);
+}
+
+static uint32_t cb_chart_value(const cb_row_t *row, int delay)
+{
+    return delay ? row->delay_avg : row->tick_avg;
+}
+
+/**
+ * @brief  Bar chart of the tick or delay averages, scaled so the largest
+ *         is BENCH_BAR_WIDTH characters.  Comment lines, so the output still
+ *         parses as a table.
+ * @param  delay  0 = tick_avg column, 1 = delay_avg column.
+ */
+static void cb_print_chart(int delay)
+{
+    uint32_t scale = 1U;
+
+    for (uint32_t i = 0; i < cb_nrows; i++) {
+        uint32_t v = cb_chart_value(&cb_rows[i], delay);
+
+        if (v > scale) {
+            scale = v;
+        }
+    }
+
+    printf("#\n# %s (avg cycles)\n", delay ? "delay" : "tick");
+    for (uint32_t i = 0; i < cb_nrows; i++) {
+        uint32_t v = cb_chart_value(&cb_rows[i], delay);
+        char     bar[BENCH_BAR_WIDTH + 1U];
+
+        bench_bar(bar, v, scale);
+        printf("# %6lu |%-*s %lu\n", (unsigned long)cb_rows[i].cars,
+               (int)BENCH_BAR_WIDTH, bar, (unsigned long)v);
+    }
+}
+
+/* ========================== Task ========================================= */
+
+/**
+ * @brief  Measure every car count, print the table and chart, delete the
+ *         cars, then exit (host build, APP_BENCH_CARS_EXIT) or delete
+ *         itself.
+ * @param  param  (unused)
+ */
+static void cbench_task(void *param)
+{
+    (void)param;
+
+    cb_lot = xSemaphoreCreateCounting(CB_SPOTS, CB_SPOTS);
+    configASSERT(cb_lot != NULL);
+
+    /* Let the start-up work of the other tasks finish first */
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    cb_overhead = bench_calibrate();
+    cb_print_header();
+
+    for (uint32_t i = 0; i < CB_ROWS; i++) {
+        uint32_t n = (cb_sizes[i] < APP_BENCH_CARS_MAX) ? cb_sizes[i] : APP_BENCH_CARS_MAX;
+
+        if (!cb_grow(n)) {
+            printf("# heap full at %lu cars\n", (unsigned long)cb_count);
+            break;
+        }
+
+        /* Until the new cars' start-up delays are spread out */
+        vTaskDelay(pdMS_TO_TICKS(CB_SETTLE_MS));
+
+        cb_measure(&cb_rows[cb_nrows]);
+        cb_print_row(&cb_rows[cb_nrows]);
+        cb_nrows++;
+        vTaskDelay(pdMS_TO_TICKS(CB_ROW_GAP_MS));
+
+        if (n == APP_BENCH_CARS_MAX) {
+            break;
+        }
+    }
+
+    cb_print_chart(0);
+    cb_print_chart(1);
+    printf("# end\n");
+
+#if APP_BENCH_CARS_EXIT
+    exit(0);
+#endif
+
+    while (cb_count > 0U) {
+        vTaskDelete(cb_cars[--cb_count]);
+    }
+    vSemaphoreDelete(cb_lot);
+    vTaskDelete(NULL);
+}
+
+/* ========================== Public API =================================== */
+
+void car_bench_init(void)
+{
+    BaseType_t status;
+
+    dwt_cycles_init();
+
+    status = xTaskCreate(cbench_task, "cbench_task", CB_STACK_WORDS,
+                         NULL, CB_PRIO_BENCH, NULL);
+    configASSERT(status == pdPASS);
+}
+
+#else  /* !APP_BENCH_CARS */
+
+void car_bench_init(void)
+{
+}
+
+#endif /* APP_BENCH_CARS */
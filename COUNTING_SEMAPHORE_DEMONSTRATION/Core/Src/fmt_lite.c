@@ -0,0 +1,220 @@
+/**
+ ******************************************************************************
+ * @file           : fmt_lite.c
+ * @brief          : Small reentrant snprintf replacement for console text.
+ *
+ * @description    : One pass over the format string.  Numbers are built
+ *                   backwards in a stack scratch buffer and then copied out
+ *                   with padding; everything is bounds-checked against the
+ *                   destination, so output is truncated, never overrun.
+ ******************************************************************************
+ */
+
+#include "fmt_lite.h"
+#include <stdint.h>
+
+/* ========================== Private Types ================================ */
+
+/* Output cursor: next byte to write and the last usable byte */
+typedef struct {
+    char *pos;
+    char *end;                     /* Reserved for the terminator            */
+} fmt_out_t;
+
+#define FMT_FLAG_ZERO       0x01U  /* '0': pad numbers with zeros            */
+#define FMT_FLAG_LEFT       0x02U  /* '-': pad on the right                  */
+
+/* 32-bit decimal needs 10 digits; a sign makes 11 */
+#define FMT_DIGITS_MAX      11U
+
+/* ========================== Private Helpers ============================== */
+
+static void out_char(fmt_out_t *out, char c)
+{
+    if (out->pos < out->end) {
+        *out->pos++ = c;
+    }
+}
+
+static void out_repeat(fmt_out_t *out, char c, uint32_t count)
+{
+    while (count-- > 0U) {
+        out_char(out, c);
+    }
+}
+
+/**
+ * @brief  Emit len bytes of text padded to width.  With zero padding the
+ *         sign (if any) goes before the zeros.
+ */
+static void out_field(fmt_out_t *out, const char *text, uint32_t len,
+                      uint32_t width, uint32_t flags)
+{
+    uint32_t pad = (width > len) ? width - len : 0U;
+
+    if ((flags & FMT_FLAG_LEFT) == 0U) {
+        if ((flags & FMT_FLAG_ZERO) != 0U) {
+            if (len > 0U && text[0] == '-') {
+                out_char(out, '-');
+                text++;
+                len--;
+            }
+            out_repeat(out, '0', pad);
+        } else {
+            out_repeat(out, ' ', pad);
+        }
+    }
+
+    while (len-- > 0U) {
+        out_char(out, *text++);
+    }
+
+    if ((flags & FMT_FLAG_LEFT) != 0U) {
+        out_repeat(out, ' ', pad);
+    }
+}
+
+/**
+ * @brief  Unsigned value to text, right-aligned in scratch.
+ * @return Pointer to the first digit inside scratch.
+ */
+static char *utoa_rev(char *scratch_end, uint32_t value, uint32_t base,
+                      int upper)
+{
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char       *p      = scratch_end;
+
+    do {
+        *--p   = digits[value % base];
+        value /= base;
+    } while (value != 0U);
+
+    return p;
+}
+
+/* ========================== Public API =================================== */
+
+int fmt_vsnprintf(char *dst, size_t size, const char *fmt, va_list ap)
+{
+    fmt_out_t out;
+    char      scratch[FMT_DIGITS_MAX];
+    char     *scratch_end = scratch + sizeof(scratch);
+
+    if (dst == NULL || size == 0U) {
+        return 0;
+    }
+    out.pos = dst;
+    out.end = dst + size - 1U;
+
+    while (*fmt != '\0') {
+        const char *spec = fmt;
+        uint32_t    flags = 0;
+        uint32_t    width = 0;
+        int         is_long = 0;
+        char       *text;
+        uint32_t    uval;
+
+        if (*fmt != '%') {
+            out_char(&out, *fmt++);
+            continue;
+        }
+        fmt++;
+
+        /* Flags */
+        for (;; fmt++) {
+            if (*fmt == '0') {
+                flags |= FMT_FLAG_ZERO;
+            } else if (*fmt == '-') {
+                flags |= FMT_FLAG_LEFT;
+            } else {
+                break;
+            }
+        }
+
+        /* Width */
+        while (*fmt >= '0' && *fmt <= '9') {
+            width = width * 10U + (uint32_t)(*fmt++ - '0');
+        }
+
+        /* Length: 'l' is the same width as int on Cortex-M */
+        while (*fmt == 'l') {
+            is_long = 1;
+            fmt++;
+        }
+
+        switch (*fmt) {
+        case 'd':
+        case 'i': {
+            int32_t sval = is_long ? (int32_t)va_arg(ap, long)
+                                   : (int32_t)va_arg(ap, int);
+
+            uval = (sval < 0) ? 0U - (uint32_t)sval : (uint32_t)sval;
+            text = utoa_rev(scratch_end, uval, 10U, 0);
+            if (sval < 0) {
+                *--text = '-';
+            }
+            out_field(&out, text, (uint32_t)(scratch_end - text), width, flags);
+            break;
+        }
+
+        case 'u':
+        case 'x':
+        case 'X':
+            uval = is_long ? (uint32_t)va_arg(ap, unsigned long)
+                           : (uint32_t)va_arg(ap, unsigned int);
+            text = utoa_rev(scratch_end, uval, (*fmt == 'u') ? 10U : 16U,
+                            *fmt == 'X');
+            out_field(&out, text, (uint32_t)(scratch_end - text), width, flags);
+            break;
+
+        case 'c':
+            scratch[0] = (char)va_arg(ap, int);
+            out_field(&out, scratch, 1U, width, flags & FMT_FLAG_LEFT);
+            break;
+
+        case 's': {
+            const char *str = va_arg(ap, const char *);
+            uint32_t    len = 0;
+
+            if (str == NULL) {
+                str = "(null)";
+            }
+            while (str[len] != '\0') {
+                len++;
+            }
+            out_field(&out, str, len, width, flags & FMT_FLAG_LEFT);
+            break;
+        }
+
+        case '%':
+            out_char(&out, '%');
+            break;
+
+        default:
+            /* Unsupported or truncated spec: show it as written */
+            while (spec != fmt) {
+                out_char(&out, *spec++);
+            }
+            if (*fmt == '\0') {
+                continue;
+            }
+            out_char(&out, *fmt);
+            break;
+        }
+        fmt++;
+    }
+
+    *out.pos = '\0';
+    return (int)(out.pos - dst);
+}
+
+int fmt_snprintf(char *dst, size_t size, const char *fmt, ...)
+{
+    va_list ap;
+    int     len;
+
+    va_start(ap, fmt);
+    len = fmt_vsnprintf(dst, size, fmt, ap);
+    va_end(ap);
+    return len;
+}
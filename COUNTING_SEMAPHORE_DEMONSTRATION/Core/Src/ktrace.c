@@ -0,0 +1,342 @@
+/**
+ ******************************************************************************
+ * @file           : ktrace.c
+ * @brief          : Kernel event tracer: RAM ring recorder and dump task
+ *                   (APP_KTRACE).
+ *
+ * @description    : The ring holds two-word records (ktrace_freertos.h).
+ *                   head is a free-running record counter (slot = head &
+ *                   mask) and only moves under interrupt masking, so
+ *                   kernel hooks in tasks and ISRs can share it:
+ *
+ *                     kernel hook                    ktrace_task (low prio)
+ *                       recording? else return         sleep until stopped
+ *                       mask interrupts                 table lines
+ *                       store event word, CYCCNT        the last events in
+ *                       head++, full? stop              the ring, oldest
+ *                       unmask                          first; then delete
+ *
+ *                   The ring is only read once recording has stopped, so
+ *                   the dump needs no locking and the demo keeps running
+ *                   while it is sent.
+ *
+ *                   The tick interrupt records an enter / exit pair on
+ *                   every tick.  When it did nothing else - no task woke,
+ *                   no switch followed - ktrace_isr_exit() takes the enter
+ *                   record back instead, so an idle system does not fill
+ *                   the ring with empty ticks.
+ *
+ *                   Task and object ids are handed out at creation and
+ *                   kept in the TCB / queue (uxTaskNumber, uxQueueNumber).
+ *                   Id 0 means "not in the table": it was already full.
+ ******************************************************************************
+ */
+
+#include "ktrace.h"
+#include "app_config.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if APP_KTRACE
+
+#include <string.h>
+#include "fmt_lite.h"
+#include "static_alloc.h"
+
+#define KTRACE_RING_MASK    (KTRACE_RING_EVENTS - 1U)
+#define KTRACE_VERSION      1U
+#define KTRACE_PER_LINE     8U     /* Events per "@kt ev" line               */
+#define KTRACE_LINE_SIZE    160U   /* "@kt ev" + 8 x 17 characters + CRLF   */
+
+#if (KTRACE_RING_EVENTS & KTRACE_RING_MASK) != 0U
+#error "KTRACE_RING_EVENTS must be a power of two"
+#endif
+
+/* ========================== Private Types ================================ */
+typedef enum {
+    KT_IDLE = 0,                   /* Before ktrace_init()                   */
+    KT_RECORDING,
+    KT_STOPPED,                    /* Full or triggered; dump pending        */
+    KT_DUMPED
+} kt_state_e;
+
+typedef struct {
+    char     name[KTRACE_NAME_LEN];
+    uint32_t value;                /* Task priority or queue type           */
+} kt_entry_t;
+
+/* ========================== Private Data ================================= */
+static uint32_t              kt_ring[KTRACE_RING_EVENTS * 2U];
+static volatile uint32_t     kt_head;         /* Records stored, ever      */
+static volatile uint32_t     kt_state;        /* kt_state_e                */
+static uint32_t              kt_isr_mark;     /* kt_head after ISR entry,
+                                                 0 = none open              */
+static kt_entry_t            kt_tasks[KTRACE_MAX_TASKS];
+static uint32_t              kt_task_count;
+static kt_entry_t            kt_objects[KTRACE_MAX_OBJECTS];
+static uint32_t              kt_object_count;
+static ktrace_send_t         kt_out;
+STATIC_TASK(ktrace, KTRACE_STACK_WORDS);
+
+/* ========================== Recording ==================================== */
+
+/**
+ * @brief  Store one record.  Caller holds the interrupt mask and has
+ *         checked that recording is on.
+ */
+static void kt_put(uint32_t event, uint32_t arg)
+{
+    uint32_t slot = (kt_head & KTRACE_RING_MASK) * 2U;
+
+    kt_ring[slot]      = (event << 24) | (arg & 0x00FFFFFFU);
+    kt_ring[slot + 1U] = DWT->CYCCNT;
+    kt_head++;
+
+#if APP_KTRACE_SNAPSHOT
+    if (kt_head == KTRACE_RING_EVENTS) {
+        kt_state = KT_STOPPED;
+    }
+#endif
+}
+
+static void kt_copy_name(char *dst, const char *name)
+{
+    if (name == NULL) {
+        name = "-";
+    }
+    strncpy(dst, name, KTRACE_NAME_LEN - 1U);
+    dst[KTRACE_NAME_LEN - 1U] = '\0';
+}
+
+/* ========================== Dump ========================================= */
+
+/**
+ * @brief  Send one line, over SWO or through the demo's console.
+ */
+static void kt_send(char *line, int len)
+{
+#if APP_KTRACE_SWO
+    for (int i = 0; i < len; i++) {
+        (void)ITM_SendChar((uint32_t)(uint8_t)line[i]);
+    }
+#else
+    kt_out(line, (uint32_t)len);
+#endif
+}
+
+static char *kt_hex(char *p, uint32_t value)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    for (int shift = 28; shift >= 0; shift -= 4) {
+        *p++ = digits[(value >> shift) & 0xFU];
+    }
+    return p;
+}
+
+static void kt_dump(void)
+{
+    char     line[KTRACE_LINE_SIZE];
+    uint32_t head = kt_head;
+    uint32_t count;
+    uint32_t sum = 0U;
+    int      len;
+
+    /* Once the ring has wrapped, the slot at head may hold an ISR entry
+     * record that ktrace_isr_exit() took back after it had overwritten the
+     * oldest event; leave that slot out */
+#if APP_KTRACE_SNAPSHOT
+    count = (head < KTRACE_RING_EVENTS) ? head : KTRACE_RING_EVENTS;
+#else
+    count = (head < KTRACE_RING_EVENTS) ? head : KTRACE_RING_EVENTS - 1U;
+#endif
+
+    len = fmt_snprintf(line, sizeof(line), "\r\n@kt begin %u %u %u %u %u\r\n",
+                       (unsigned int)KTRACE_VERSION,
+                       (unsigned int)SystemCoreClock,
+                       (unsigned int)configTICK_RATE_HZ,
+                       (unsigned int)count, (unsigned int)(head - count));
+    kt_send(line, len);
+
+    for (uint32_t i = 0; i < kt_task_count; i++) {
+        len = fmt_snprintf(line, sizeof(line), "@kt task %u %u %s\r\n",
+                           (unsigned int)(i + 1U),
+                           (unsigned int)kt_tasks[i].value, kt_tasks[i].name);
+        kt_send(line, len);
+    }
+    for (uint32_t i = 0; i < kt_object_count; i++) {
+        len = fmt_snprintf(line, sizeof(line), "@kt obj %u %u %s\r\n",
+                           (unsigned int)(i + 1U),
+                           (unsigned int)kt_objects[i].value,
+                           kt_objects[i].name);
+        kt_send(line, len);
+    }
+
+    for (uint32_t done = 0; done < count; ) {
+        char *p = line;
+
+        memcpy(p, "@kt ev", 6U);
+        p += 6;
+        for (uint32_t n = 0; n < KTRACE_PER_LINE && done < count; n++, done++) {
+            uint32_t slot = ((head - count + done) & KTRACE_RING_MASK) * 2U;
+
+            *p++ = ' ';
+            p = kt_hex(p, kt_ring[slot]);
+            p = kt_hex(p, kt_ring[slot + 1U]);
+            sum += kt_ring[slot] + kt_ring[slot + 1U];
+        }
+        *p++ = '\r';
+        *p++ = '\n';
+        kt_send(line, (int)(p - line));
+    }
+
+    len = fmt_snprintf(line, sizeof(line), "@kt end %u %08x\r\n",
+                       (unsigned int)count, (unsigned int)sum);
+    kt_send(line, len);
+}
+
+/* ========================== Task ========================================= */
+
+/**
+ * @brief  Wait for recording to stop, dump the ring once, then delete itself.
+ * @param  param  (unused)
+ */
+static void ktrace_task(void *param)
+{
+    (void)param;
+
+    while (kt_state != KT_STOPPED) {
+        vTaskDelay(pdMS_TO_TICKS(KTRACE_POLL_MS));
+    }
+    kt_dump();
+    kt_state = KT_DUMPED;
+    vTaskDelete(NULL);
+}
+
+/* ========================== Kernel Hooks ================================= */
+
+void ktrace_event(uint32_t event, uint32_t arg)
+{
+    UBaseType_t mask;
+
+    if (kt_state != KT_RECORDING) {
+        return;
+    }
+
+    /* Hooks run in tasks, ISRs and inside kernel critical sections */
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    if (kt_state == KT_RECORDING) {
+        kt_put(event, arg);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+void ktrace_isr_enter(void)
+{
+    UBaseType_t mask;
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    if (kt_state == KT_RECORDING) {
+        kt_put(KTRACE_EV_ISR_ENTER, __get_IPSR());
+        kt_isr_mark = kt_head;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+void ktrace_isr_exit(uint32_t to_scheduler)
+{
+    UBaseType_t mask;
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    if (kt_state == KT_RECORDING) {
+        if (to_scheduler == 0U && kt_isr_mark != 0U && kt_head == kt_isr_mark) {
+            kt_head--;             /* Empty interrupt: forget its entry      */
+        } else {
+            kt_put(KTRACE_EV_ISR_EXIT, to_scheduler);
+        }
+    }
+    kt_isr_mark = 0U;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+uint32_t ktrace_task_create(const char *name, uint32_t priority)
+{
+    if (kt_task_count == KTRACE_MAX_TASKS) {
+        return 0U;
+    }
+    kt_copy_name(kt_tasks[kt_task_count].name, name);
+    kt_tasks[kt_task_count].value = priority;
+    return ++kt_task_count;
+}
+
+uint32_t ktrace_object_create(uint32_t type)
+{
+    UBaseType_t mask;
+    uint32_t    id = 0U;
+
+    /* Queues are created outside the kernel's critical sections */
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    if (kt_object_count < KTRACE_MAX_OBJECTS) {
+        kt_copy_name(kt_objects[kt_object_count].name, NULL);
+        kt_objects[kt_object_count].value = type;
+        id = ++kt_object_count;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+    return id;
+}
+
+void ktrace_object_name(uint32_t id, const char *name)
+{
+    if (id != 0U && id <= kt_object_count) {
+        kt_copy_name(kt_objects[id - 1U].name, name);
+    }
+}
+
+/* ========================== Public API =================================== */
+
+void ktrace_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT       = 0;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+    kt_state = KT_RECORDING;
+}
+
+int32_t ktrace_start(ktrace_send_t send, uint32_t priority)
+{
+    kt_out = send;
+
+    return (int32_t)STATIC_TASK_CREATE(ktrace, ktrace_task, "KTrace", NULL,
+                                       (UBaseType_t)priority, NULL);
+}
+
+void ktrace_trigger(void)
+{
+    UBaseType_t mask;
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    if (kt_state == KT_RECORDING) {
+        kt_state = KT_STOPPED;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+#else  /* !APP_KTRACE */
+
+void ktrace_init(void)
+{
+}
+
+int32_t ktrace_start(ktrace_send_t send, uint32_t priority)
+{
+    (void)send;
+    (void)priority;
+    return (int32_t)pdPASS;
+}
+
+void ktrace_trigger(void)
+{
+}
+
+#endif /* APP_KTRACE */
@@ -14,9 +14,7 @@
 /* USER CODE END Header */
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
-#include <stdio.h>
 #include <stdlib.h>      /* for rand()    - generates random numbers */
-#include <string.h>      /* for strlen()  - counts string length    */
 #include <stdarg.h>      /* for va_list   - lets us make printf-like functions */
 
 /* Private includes ----------------------------------------------------------*/
@@ -25,6 +23,13 @@
 #include "task.h"
 #include "semphr.h"
 #include "queue.h"
+#include "fmt_lite.h"    /* fmt_vsnprintf - small reentrant printf subset */
+#include "car_bench.h"   /* car_bench_init - APP_BENCH_CARS in app_config.h */
+#include "ktrace.h"      /* kernel event trace - APP_KTRACE in app_config.h */
+#include "static_alloc.h" /* kernel objects - APP_STATIC_ALLOC in app_config.h */
+#include "stack_sizes.h"  /* STACK_WORDS_* - task stack sizes */
+#include "stack_prof.h"   /* stack use reports - APP_STACK_PROFILE in app_config.h */
+#include "ccm_ram.h"      /* heap regions in CCM RAM - APP_CCM_RAM in app_config.h */
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -33,12 +38,18 @@
 /* ---- Settings ---- */
 #define PARKING_SPOTS   3U      /* max semaphore count (try changing to 1 or 5) */
 #define TOTAL_CARS      5U      /* number of car tasks (more than spots = waiting) */
-static char g_acBuf[200];
+#define PRINT_LINE_SIZE 96U     /* longest vPrint() line + terminator */
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
 static SemaphoreHandle_t g_xParkingSem = NULL;
+static SemaphoreHandle_t g_xUartMutex  = NULL;  /* one UART2 writer at a time */
+
+/* Storage of the lot and the cars: static with APP_STATIC_ALLOC, else heap */
+STATIC_SEMAPHORE(parking_lot);
+STATIC_SEMAPHORE(uart_mutex);
+STATIC_TASK_ARRAY(cars, TOTAL_CARS, STACK_WORDS_CARS);
 
 static const char *const g_apcCars[TOTAL_CARS] =
     { "Honda", "Toyota", "BMW", "Tesla", "Suzuki" };
@@ -88,20 +99,59 @@ void vApplicationMallocFailedHook(void) {
 		; /* Hang here — debugger will stop at this line */
 }
 
+/* Idle and timer service task memory (configSUPPORT_STATIC_ALLOCATION).
+ With APP_STATIC_ALLOC the kernel has no heap, so instead of allocating
+ these two tasks at vTaskStartScheduler() it asks for this storage. */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+STATIC_TASK(idle_task, configMINIMAL_STACK_SIZE);
+STATIC_TASK(timer_task, configTIMER_TASK_STACK_DEPTH);
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+		StackType_t **ppxIdleTaskStackBuffer,
+		configSTACK_DEPTH_TYPE *puxIdleTaskStackSize) {
+	*ppxIdleTaskTCBBuffer = STATIC_TASK_TCB(idle_task);
+	*ppxIdleTaskStackBuffer = STATIC_TASK_STACK(idle_task);
+	*puxIdleTaskStackSize = kobj_idle_task_words;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+		StackType_t **ppxTimerTaskStackBuffer,
+		configSTACK_DEPTH_TYPE *puxTimerTaskStackSize) {
+	*ppxTimerTaskTCBBuffer = STATIC_TASK_TCB(timer_task);
+	*ppxTimerTaskStackBuffer = STATIC_TASK_STACK(timer_task);
+	*puxTimerTaskStackSize = kobj_timer_task_words;
+}
+#endif
+
+
 
-static char g_acBuf[200];
 
 
+/* ---- UART2 output ----
+ * The cars, the trace dump and the stack profiler all write here.  The
+ * HAL's busy check and lock on huart2 are not atomic between tasks, so
+ * each write holds the mutex; before the scheduler starts it is free. */
+static void vUartWrite(const char *pcData, uint32_t ulLen)
+{
+    xSemaphoreTake(g_xUartMutex, portMAX_DELAY);
+    HAL_UART_Transmit(&huart2, (const uint8_t *)pcData, (uint16_t)ulLen,
+                      HAL_MAX_DELAY);
+    xSemaphoreGive(g_xUartMutex);
+}
 
-/* ---- Simple print helper ---- */
+/* ---- Simple print helper ----
+ * Every car task prints, so the line is formatted into a buffer on the
+ * calling task's stack (fmt_vsnprintf keeps no state of its own). */
 static void vPrint(const char *fmt, ...)
 {
+    char    acLine[PRINT_LINE_SIZE];   /* own copy per call - no sharing   */
+    int     iLen;
     va_list args;
+
     va_start(args, fmt);
-    vsnprintf(g_acBuf, sizeof(g_acBuf), fmt, args);
+    iLen = fmt_vsnprintf(acLine, sizeof(acLine), fmt, args);
     va_end(args);
-    HAL_UART_Transmit(&huart2, (uint8_t *)g_acBuf,
-                       (uint16_t)strlen(g_acBuf), HAL_MAX_DELAY);
+    vUartWrite(acLine, (uint32_t)iLen);
 }
 
 static void vCarTask(void *pvParam)
@@ -168,15 +218,40 @@ int main(void) {
 	MX_USART2_UART_Init();
 	/* USER CODE BEGIN 2 */
 
-	g_xParkingSem = xSemaphoreCreateCounting(PARKING_SPOTS, PARKING_SPOTS);
+	/* Heap regions before the first create (no-op unless APP_CCM_RAM) */
+	ccm_ram_heap_init();
+
+	/* Before anything is created, so the trace can name it */
+	ktrace_init();
+
+	/* Before the first vPrint: every UART2 writer goes through it */
+	g_xUartMutex = STATIC_SEMAPHORE_CREATE_MUTEX(uart_mutex);
+	configASSERT(g_xUartMutex != NULL);
+	vQueueAddToRegistry(g_xUartMutex, "UartMutex");
+
+	g_xParkingSem = STATIC_SEMAPHORE_CREATE_COUNTING(parking_lot, PARKING_SPOTS,
+	                                                PARKING_SPOTS);
 
 	    if (g_xParkingSem != NULL)
 	    {
+	        /* Name for the debugger's queue view and the kernel trace */
+	        vQueueAddToRegistry(g_xParkingSem, "ParkingLot");
+
 	        vPrint("\r\n=== Parking: %u spots, %u cars ===\r\n\r\n",
 	               PARKING_SPOTS, TOTAL_CARS);
 
 	        for (uint32_t i = 0; i < TOTAL_CARS; i++)
-	            xTaskCreate(vCarTask, g_apcCars[i], 500, (void *)i, 2, NULL);
+	            STATIC_TASK_CREATE_AT(cars, i, vCarTask, g_apcCars[i],
+	                                  (void *)i, 2, NULL);
+
+	        /* Hundreds of extra cars when benchmarking, none otherwise */
+	        car_bench_init();
+
+	        /* Idle priority: dumps the trace while every car sleeps */
+	        ktrace_start(vUartWrite, tskIDLE_PRIORITY);
+
+	        /* Idle priority too: peak stack use of every car, every 10 s */
+	        stack_prof_start(vUartWrite, tskIDLE_PRIORITY);
 
 	        vTaskStartScheduler();
 	    }
@@ -0,0 +1,278 @@
+/**
+ ******************************************************************************
+ * @file           : stack_prof.c
+ * @brief          : Stack profiler: peak stack use per task, reported as
+ *                   text (APP_STACK_PROFILE).
+ *
+ * @description    : The kernel already fills every new stack with a known
+ *                   byte (tskSTACK_FILL_BYTE) and uxTaskGetSystemState()
+ *                   reports how much of it is still untouched, so the
+ *                   profiler only has to look:
+ *
+ *                     static_task_create()          stack_prof_task (low prio)
+ *                       stack_prof_task(name,          every period:
+ *                         object, entry)                 uxTaskGetSystemState
+ *                       -> sp_tasks[] by name            peak = words - free
+ *                                                        one line per task
+ *
+ *                   The table is keyed by task name, so the entry of a task
+ *                   that deleted itself keeps its last peak, and a task
+ *                   created again under the same name adds to it.
+ ******************************************************************************
+ */
+
+#include "stack_prof.h"
+#include "app_config.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if APP_STACK_PROFILE
+
+#include <string.h>
+#include "static_alloc.h"
+
+#define STACK_PROF_VERSION   1U
+#define STACK_PROF_LINE_SIZE 96U   /* "@stk task" + 2 names + 3 numbers      */
+
+#if ( configRECORD_STACK_HIGH_ADDRESS != 1 ) || ( configUSE_TRACE_FACILITY != 1 )
+#error "stack_prof needs configRECORD_STACK_HIGH_ADDRESS and configUSE_TRACE_FACILITY"
+#endif
+
+/* The kernel's defaults (tasks.c, timers.c) when FreeRTOSConfig.h sets none */
+#ifndef configIDLE_TASK_NAME
+#define configIDLE_TASK_NAME            "IDLE"
+#endif
+#ifndef configTIMER_SERVICE_TASK_NAME
+#define configTIMER_SERVICE_TASK_NAME   "Tmr Svc"
+#endif
+
+/* ========================== Private Types ================================ */
+typedef struct {
+    char        name[configMAX_TASK_NAME_LEN];
+    const char *object;            /* STATIC_TASK() name, or "-"            */
+    const char *entry;             /* Entry function, or "-"                */
+    uint32_t    words;             /* Stack size, 0 = never seen running    */
+    uint32_t    peak;              /* Most words ever used                  */
+    uint32_t    alive;             /* In the last snapshot                  */
+} sp_task_t;
+
+/* ========================== Private Data ================================= */
+static sp_task_t          sp_tasks[STACK_PROF_MAX_TASKS];
+static uint32_t           sp_task_count;
+static TaskStatus_t       sp_status[STACK_PROF_MAX_TASKS];
+static stack_prof_send_t  sp_send;
+STATIC_TASK(stack_prof, STACK_PROF_STACK_WORDS);
+
+/* ========================== Table ======================================== */
+
+/**
+ * @brief  The entry for 'name', added if there is none yet.  Caller holds
+ *         the scheduler or a critical section.
+ * @return The entry, or NULL when the table is full.
+ */
+static sp_task_t *sp_find(const char *name)
+{
+    sp_task_t *t;
+
+    for (uint32_t i = 0; i < sp_task_count; i++) {
+        if (strncmp(sp_tasks[i].name, name, configMAX_TASK_NAME_LEN - 1U) == 0) {
+            return &sp_tasks[i];
+        }
+    }
+    if (sp_task_count == STACK_PROF_MAX_TASKS) {
+        return NULL;
+    }
+
+    t = &sp_tasks[sp_task_count++];
+    strncpy(t->name, name, configMAX_TASK_NAME_LEN - 1U);
+    t->name[configMAX_TASK_NAME_LEN - 1U] = '\0';
+
+    /* The two kernel tasks, named like their storage in main.c */
+    if (strcmp(t->name, configIDLE_TASK_NAME) == 0) {
+        t->object = "idle_task";
+        t->entry  = "prvIdleTask";
+    } else if (strcmp(t->name, configTIMER_SERVICE_TASK_NAME) == 0) {
+        t->object = "timer_task";
+        t->entry  = "prvTimerTask";
+    } else {
+        t->object = "-";
+        t->entry  = "-";
+    }
+    return t;
+}
+
+/* ========================== Report ======================================= */
+
+static char *sp_str(char *p, const char *s)
+{
+    while (*s != '\0') {
+        *p++ = *s++;
+    }
+    return p;
+}
+
+static char *sp_dec(char *p, uint32_t value)
+{
+    char     digits[10];
+    uint32_t n = 0;
+
+    do {
+        digits[n++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while (value != 0U);
+    while (n > 0U) {
+        *p++ = digits[--n];
+    }
+    return p;
+}
+
+/**
+ * @brief  Fold one snapshot of all tasks into the table.
+ * @return Tasks in the snapshot, 0 when there were more than the table
+ *         holds.
+ */
+static uint32_t sp_sample(void)
+{
+    UBaseType_t count;
+
+    vTaskSuspendAll();
+    count = uxTaskGetSystemState(sp_status, STACK_PROF_MAX_TASKS, NULL);
+    for (uint32_t i = 0; i < sp_task_count; i++) {
+        sp_tasks[i].alive = 0;
+    }
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t *s = &sp_status[i];
+        sp_task_t          *t = sp_find(s->pcTaskName);
+        uint32_t            words;
+
+        if (t == NULL) {
+            continue;
+        }
+        words = (uint32_t)(s->pxEndOfStack - s->pxStackBase) + 1U;
+        if (words - s->usStackHighWaterMark > t->peak) {
+            t->peak = words - s->usStackHighWaterMark;
+        }
+        t->words = words;
+        t->alive = 1;
+    }
+    (void)xTaskResumeAll();
+    return (uint32_t)count;
+}
+
+static void sp_report(void)
+{
+    char     line[STACK_PROF_LINE_SIZE];
+    char    *p;
+    uint32_t tasks = 0;
+
+    if (sp_sample() == 0U) {
+        p = sp_str(line, "@stk error tasks=");
+        p = sp_dec(p, (uint32_t)uxTaskGetNumberOfTasks());
+        p = sp_str(p, " max=");
+        p = sp_dec(p, STACK_PROF_MAX_TASKS);
+        p = sp_str(p, "\r\n");
+        sp_send(line, (uint32_t)(p - line));
+        return;
+    }
+    for (uint32_t i = 0; i < sp_task_count; i++) {
+        tasks += (sp_tasks[i].words != 0U) ? 1U : 0U;
+    }
+
+    p = sp_str(line, "@stk begin ");
+    p = sp_dec(p, STACK_PROF_VERSION);
+    *p++ = ' ';
+    p = sp_dec(p, (uint32_t)sizeof(StackType_t));
+    *p++ = ' ';
+    p = sp_dec(p, (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS));
+    *p++ = ' ';
+    p = sp_dec(p, tasks);
+    p = sp_str(p, "\r\n");
+    sp_send(line, (uint32_t)(p - line));
+
+    for (uint32_t i = 0; i < sp_task_count; i++) {
+        const sp_task_t *t = &sp_tasks[i];
+
+        if (t->words == 0U) {
+            continue;              /* Registered, not created yet            */
+        }
+        p = sp_str(line, "@stk task ");
+        p = sp_str(p, t->object);
+        *p++ = ' ';
+        p = sp_str(p, t->entry);
+        *p++ = ' ';
+        p = sp_dec(p, t->words);
+        *p++ = ' ';
+        p = sp_dec(p, t->peak);
+        *p++ = ' ';
+        p = sp_dec(p, t->alive);
+        *p++ = ' ';
+        p = sp_str(p, t->name);
+        p = sp_str(p, "\r\n");
+        sp_send(line, (uint32_t)(p - line));
+    }
+
+    p = sp_str(line, "@stk end ");
+    p = sp_dec(p, tasks);
+    p = sp_str(p, "\r\n");
+    sp_send(line, (uint32_t)(p - line));
+}
+
+/* ========================== Task ========================================= */
+
+/**
+ * @brief  Report once per period, for as long as the demo runs.
+ * @param  param  (unused)
+ */
+static void stack_prof_task_fn(void *param)
+{
+    TickType_t wake = xTaskGetTickCount();
+
+    (void)param;
+
+    for (;;) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(STACK_PROF_PERIOD_MS));
+        sp_report();
+    }
+}
+
+/* ========================== Public API =================================== */
+
+void stack_prof_task(const char *name, const char *object, const char *entry)
+{
+    sp_task_t *t;
+
+    taskENTER_CRITICAL();
+    t = sp_find(name);
+    if (t != NULL) {
+        t->object = object;
+        t->entry  = entry;
+    }
+    taskEXIT_CRITICAL();
+}
+
+int32_t stack_prof_start(stack_prof_send_t send, uint32_t priority)
+{
+    sp_send = send;
+
+    return (int32_t)STATIC_TASK_CREATE(stack_prof, stack_prof_task_fn,
+                                       "StackProf", NULL,
+                                       (UBaseType_t)priority, NULL);
+}
+
+#else  /* !APP_STACK_PROFILE */
+
+void stack_prof_task(const char *name, const char *object, const char *entry)
+{
+    (void)name;
+    (void)object;
+    (void)entry;
+}
+
+int32_t stack_prof_start(stack_prof_send_t send, uint32_t priority)
+{
+    (void)send;
+    (void)priority;
+    return (int32_t)pdPASS;
+}
+
+#endif /* APP_STACK_PROFILE */
@@ -0,0 +1,618 @@
+/*
+ * FreeRTOS Kernel V11.1.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/*-----------------------------------------------------------
+* Implementation of functions defined in portable.h for a Linux/POSIX host.
+*
+* Each task runs on its own pthread.  A thread that is not the running task
+* waits on its event; a context switch signals the next thread's event and
+* then waits on its own, so only one task thread executes at a time.  The
+* pthread has its own (host sized) stack: the FreeRTOS stack only carries
+* the thread's control block at its top, which keeps the kernel's stack
+* bookkeeping and overflow checks working.
+*
+* Interrupts are SIGALRM, always delivered to the running task's thread:
+*
+*   tick thread        every tick: ulPendingTicks++, kick the running thread
+*   peripheral models  vPortHostRaiseInterrupt(): pending line bit, kick
+*
+* The signal handler is the one "ISR".  It runs the handlers of the pending
+* lines, then the tick, with the signal masked (the BASEPRI equivalent),
+* and performs a requested context switch last, like PendSV.  Critical
+* sections block the signal for the calling thread; the nesting count is
+* kept across switches by the thread that owns it.
+*----------------------------------------------------------*/
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The signal used for every simulated interrupt. */
+#define portINTERRUPT_SIGNAL    SIGALRM
+
+/* Host stack per task thread.  Generous: printf and friends on the host use
+ * far more stack than their newlib counterparts on the target. */
+#define portTHREAD_STACK_SIZE    ( 256U * 1024U )
+
+/* If the host stalls (suspended process, debugger) the tick catches up at
+ * most this far instead of firing a burst of stale ticks. */
+#define portMAX_TICK_CATCH_UP_NS    ( 100U * 1000000U )
+
+/*-----------------------------------------------------------*/
+
+typedef struct Event
+{
+    pthread_mutex_t xMutex;
+    pthread_cond_t xCond;
+    BaseType_t xSet;
+} Event_t;
+
+typedef struct Thread
+{
+    pthread_t xPthread;
+    TaskFunction_t pxCode;
+    void * pvParams;
+    Event_t xEvent;
+    volatile BaseType_t xDying;
+} Thread_t;
+
+/*-----------------------------------------------------------*/
+
+static sigset_t xInterruptSignals;
+static pthread_t xTickThread;
+static Event_t xSchedulerEndEvent;
+static volatile BaseType_t xSchedulerEnd = pdFALSE;
+
+/* Serialises kicks with thread tear-down, so the tick thread never signals a
+ * pthread that has already been joined. */
+static pthread_mutex_t xKickMutex = PTHREAD_MUTEX_INITIALIZER;
+static Thread_t * volatile pxRunningThread = NULL;
+
+/* Nesting of the running task; each thread keeps its own copy while it is
+ * switched out. */
+static volatile UBaseType_t uxCriticalNesting = 0;
+
+static volatile uint32_t ulPendingLines = 0;
+static volatile uint32_t ulPendingTicks = 0;
+static PortHostIsr_t pxInterruptHandlers[ portHOST_INTERRUPT_LINES ];
+static volatile BaseType_t xInsideInterrupt = pdFALSE;
+static volatile BaseType_t xSwitchRequired = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+static void prvEventInit( Event_t * pxEvent )
+{
+    pthread_mutex_init( &pxEvent->xMutex, NULL );
+    pthread_cond_init( &pxEvent->xCond, NULL );
+    pxEvent->xSet = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventDelete( Event_t * pxEvent )
+{
+    pthread_cond_destroy( &pxEvent->xCond );
+    pthread_mutex_destroy( &pxEvent->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventWait( Event_t * pxEvent )
+{
+    pthread_mutex_lock( &pxEvent->xMutex );
+
+    while( pxEvent->xSet == pdFALSE )
+    {
+        pthread_cond_wait( &pxEvent->xCond, &pxEvent->xMutex );
+    }
+
+    pxEvent->xSet = pdFALSE;
+    pthread_mutex_unlock( &pxEvent->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventSignal( Event_t * pxEvent )
+{
+    pthread_mutex_lock( &pxEvent->xMutex );
+    pxEvent->xSet = pdTRUE;
+    pthread_cond_signal( &pxEvent->xCond );
+    pthread_mutex_unlock( &pxEvent->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static Thread_t * prvGetThreadFromTask( TaskHandle_t xTask )
+{
+    /* pxTopOfStack is the first member of the TCB and points one word
+     * below the thread block (see pxPortInitialiseStack()). */
+    StackType_t * pxTopOfStack = *( StackType_t ** ) xTask;
+
+    return ( Thread_t * ) ( pxTopOfStack + 1 );
+}
+/*-----------------------------------------------------------*/
+
+/* Interrupt the running task thread so its handler services what is
+ * pending.  Called from host threads and from task threads alike. */
+static void prvKickRunningThread( void )
+{
+    pthread_mutex_lock( &xKickMutex );
+
+    if( pxRunningThread != NULL )
+    {
+        pthread_kill( pxRunningThread->xPthread, portINTERRUPT_SIGNAL );
+    }
+
+    pthread_mutex_unlock( &xKickMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMaskInterrupts( void )
+{
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignals, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnmaskInterrupts( void )
+{
+    pthread_sigmask( SIG_UNBLOCK, &xInterruptSignals, NULL );
+
+    /* A kick aimed at this task may have landed on the thread that was
+     * running when it was sent; take it here rather than a tick late. */
+    if( ( ulPendingLines != 0U ) || ( ulPendingTicks != 0U ) )
+    {
+        pthread_kill( pthread_self(), portINTERRUPT_SIGNAL );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/* Hand the CPU from pxFrom to pxTo.  Called with interrupts masked.
+ * Returns once the scheduler has switched back to pxFrom. */
+static void prvSwitchThread( Thread_t * pxTo,
+                             Thread_t * pxFrom )
+{
+    UBaseType_t uxSavedNesting;
+
+    if( pxTo == pxFrom )
+    {
+        return;
+    }
+
+    uxSavedNesting = uxCriticalNesting;
+
+    pthread_mutex_lock( &xKickMutex );
+    pxRunningThread = pxTo;
+    pthread_mutex_unlock( &xKickMutex );
+
+    prvEventSignal( &pxTo->xEvent );
+
+    if( pxFrom->xDying == pdFALSE )
+    {
+        prvEventWait( &pxFrom->xEvent );
+    }
+
+    /* Deleted while switched out (or deleted itself): leave the thread.
+     * vPortCancelThread() joins it. */
+    if( pxFrom->xDying != pdFALSE )
+    {
+        pthread_exit( NULL );
+    }
+
+    uxCriticalNesting = uxSavedNesting;
+}
+/*-----------------------------------------------------------*/
+
+/* Let the kernel pick the next task and switch to its thread. */
+static void prvSwitchContext( void )
+{
+    Thread_t * pxFrom = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+    Thread_t * pxTo;
+
+    vTaskSwitchContext();
+    pxTo = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+    prvSwitchThread( pxTo, pxFrom );
+}
+/*-----------------------------------------------------------*/
+
+static void * prvThreadStart( void * pvParams )
+{
+    Thread_t * pxThread = ( Thread_t * ) pvParams;
+
+    /* Wait to be scheduled for the first time. */
+    prvEventWait( &pxThread->xEvent );
+
+    if( pxThread->xDying != pdFALSE )
+    {
+        return NULL;
+    }
+
+    /* A task starts with interrupts enabled, whatever the thread that
+     * switched to it was doing. */
+    uxCriticalNesting = 0;
+    prvUnmaskInterrupts();
+
+    pxThread->pxCode( pxThread->pvParams );
+
+    /* A task function must not return. */
+    configASSERT( pdFALSE );
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptHandler( int iSignal )
+{
+    int iSavedErrno = errno;
+    uint32_t ulLines;
+    uint32_t ulTicks;
+
+    ( void ) iSignal;
+
+    /* The signal is masked while the handler runs: interrupts are off. */
+    uxCriticalNesting++;
+    xInsideInterrupt = pdTRUE;
+    traceISR_ENTER();
+
+    do
+    {
+        ulLines = __atomic_exchange_n( &ulPendingLines, 0U, __ATOMIC_SEQ_CST );
+
+        while( ulLines != 0U )
+        {
+            UBaseType_t uxLine = ( UBaseType_t ) __builtin_ctz( ulLines );
+
+            ulLines &= ulLines - 1U;
+
+            if( pxInterruptHandlers[ uxLine ] != NULL )
+            {
+                pxInterruptHandlers[ uxLine ]();
+            }
+        }
+
+        ulTicks = __atomic_exchange_n( &ulPendingTicks, 0U, __ATOMIC_SEQ_CST );
+
+        while( ulTicks-- > 0U )
+        {
+            if( xTaskIncrementTick() != pdFALSE )
+            {
+                xSwitchRequired = pdTRUE;
+            }
+        }
+    } while( ulPendingLines != 0U );
+
+    xInsideInterrupt = pdFALSE;
+
+    /* PendSV: switch once every handler has finished. */
+    if( xSwitchRequired != pdFALSE )
+    {
+        traceISR_EXIT_TO_SCHEDULER();
+        xSwitchRequired = pdFALSE;
+        prvSwitchContext();
+    }
+    else
+    {
+        traceISR_EXIT();
+    }
+
+    uxCriticalNesting--;
+    errno = iSavedErrno;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvTickThread( void * pvParams )
+{
+    const long lPeriodNs = 1000000000L / ( long ) configTICK_RATE_HZ;
+    struct timespec xNext;
+    struct timespec xNow;
+
+    ( void ) pvParams;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNext );
+
+    while( xSchedulerEnd == pdFALSE )
+    {
+        xNext.tv_nsec += lPeriodNs;
+
+        if( xNext.tv_nsec >= 1000000000L )
+        {
+            xNext.tv_nsec -= 1000000000L;
+            xNext.tv_sec++;
+        }
+
+        while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xNext, NULL ) == EINTR )
+        {
+        }
+
+        clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+        if( ( ( xNow.tv_sec - xNext.tv_sec ) * 1000000000L + ( xNow.tv_nsec - xNext.tv_nsec ) ) > ( long ) portMAX_TICK_CATCH_UP_NS )
+        {
+            xNext = xNow;
+        }
+
+        __atomic_add_fetch( &ulPendingTicks, 1U, __ATOMIC_SEQ_CST );
+        prvKickRunningThread();
+    }
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    Thread_t * pxThread;
+    pthread_attr_t xAttr;
+    sigset_t xAllSignals;
+    sigset_t xSavedSignals;
+    int iRet;
+
+    /* Thread block at the top of the task's stack, aligned down. */
+    pxThread = ( Thread_t * ) ( ( ( portPOINTER_SIZE_TYPE ) ( pxTopOfStack + 1 ) - sizeof( Thread_t ) ) &
+                                ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) );
+
+    memset( pxThread, 0, sizeof( Thread_t ) );
+    pxThread->pxCode = pxCode;
+    pxThread->pvParams = pvParameters;
+    pxThread->xDying = pdFALSE;
+    prvEventInit( &pxThread->xEvent );
+
+    /* The new thread inherits a fully blocked mask and unblocks the
+     * interrupt signal itself once it is scheduled. */
+    sigfillset( &xAllSignals );
+    pthread_sigmask( SIG_SETMASK, &xAllSignals, &xSavedSignals );
+
+    pthread_attr_init( &xAttr );
+    pthread_attr_setstacksize( &xAttr, portTHREAD_STACK_SIZE );
+    iRet = pthread_create( &pxThread->xPthread, &xAttr, prvThreadStart, pxThread );
+    pthread_attr_destroy( &xAttr );
+
+    pthread_sigmask( SIG_SETMASK, &xSavedSignals, NULL );
+
+    if( iRet != 0 )
+    {
+        fprintf( stderr, "pthread_create: %s\n", strerror( iRet ) );
+        abort();
+    }
+
+    return ( StackType_t * ) pxThread - 1;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+    struct sigaction xAction;
+    sigset_t xAllSignals;
+    Thread_t * pxFirst;
+
+    /* The main thread never runs a task: keep every signal away from it. */
+    sigfillset( &xAllSignals );
+    pthread_sigmask( SIG_BLOCK, &xAllSignals, NULL );
+
+    memset( &xAction, 0, sizeof( xAction ) );
+    xAction.sa_handler = prvInterruptHandler;
+    xAction.sa_flags = SA_RESTART;
+    sigemptyset( &xAction.sa_mask );
+    sigaction( portINTERRUPT_SIGNAL, &xAction, NULL );
+
+    prvEventInit( &xSchedulerEndEvent );
+
+    pxFirst = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+    pthread_mutex_lock( &xKickMutex );
+    pxRunningThread = pxFirst;
+    pthread_mutex_unlock( &xKickMutex );
+
+    pthread_create( &xTickThread, NULL, prvTickThread, NULL );
+    prvEventSignal( &pxFirst->xEvent );
+
+    /* Park here until vPortEndScheduler(). */
+    prvEventWait( &xSchedulerEndEvent );
+
+    pthread_join( xTickThread, NULL );
+    prvEventDelete( &xSchedulerEndEvent );
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+    Thread_t * pxThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+    prvMaskInterrupts();
+
+    pthread_mutex_lock( &xKickMutex );
+    xSchedulerEnd = pdTRUE;
+    pxRunningThread = NULL;
+    pthread_mutex_unlock( &xKickMutex );
+
+    prvEventSignal( &xSchedulerEndEvent );
+
+    /* The calling task never runs again; its thread is not joined. */
+    pxThread->xDying = pdTRUE;
+    pthread_exit( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+    vPortEnterCritical();
+    prvSwitchContext();
+    vPortExitCritical();
+}
+/*-----------------------------------------------------------*/
+
+void vPortYieldFromISR( void )
+{
+    xSwitchRequired = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+    if( uxCriticalNesting == 0U )
+    {
+        prvMaskInterrupts();
+    }
+
+    uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+    configASSERT( uxCriticalNesting != 0U );
+    uxCriticalNesting--;
+
+    if( uxCriticalNesting == 0U )
+    {
+        prvUnmaskInterrupts();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+    prvMaskInterrupts();
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+    prvUnmaskInterrupts();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t xPortSetInterruptMask( void )
+{
+    sigset_t xOld;
+
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignals, &xOld );
+
+    return ( UBaseType_t ) sigismember( &xOld, portINTERRUPT_SIGNAL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( UBaseType_t xMask )
+{
+    if( xMask == 0U )
+    {
+        prvUnmaskInterrupts();
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortIsInsideInterrupt( void )
+{
+    return xInsideInterrupt;
+}
+/*-----------------------------------------------------------*/
+
+void vPortThreadDying( void * pvTaskToDelete,
+                       volatile BaseType_t * pxPendYield )
+{
+    ( void ) pxPendYield;
+
+    /* The task deletes itself: its thread exits on the coming switch. */
+    prvGetThreadFromTask( ( TaskHandle_t ) pvTaskToDelete )->xDying = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortCancelThread( void * pxTaskToDelete )
+{
+    Thread_t * pxThread = prvGetThreadFromTask( ( TaskHandle_t ) pxTaskToDelete );
+    UBaseType_t uxMask;
+
+    /* Interrupts off: a switch while holding xKickMutex would stop the
+     * tick thread. */
+    uxMask = xPortSetInterruptMask();
+    pthread_mutex_lock( &xKickMutex );
+
+    /* A thread switched out waits on its event; wake it to exit. */
+    pxThread->xDying = pdTRUE;
+    prvEventSignal( &pxThread->xEvent );
+    pthread_join( pxThread->xPthread, NULL );
+    prvEventDelete( &pxThread->xEvent );
+
+    pthread_mutex_unlock( &xKickMutex );
+    vPortClearInterruptMask( uxMask );
+}
+/*-----------------------------------------------------------*/
+
+void vPortHostSetInterruptHandler( UBaseType_t uxLine,
+                                   PortHostIsr_t pxHandler )
+{
+    configASSERT( uxLine < portHOST_INTERRUPT_LINES );
+    pxInterruptHandlers[ uxLine ] = pxHandler;
+}
+/*-----------------------------------------------------------*/
+
+void vPortHostRaiseInterrupt( UBaseType_t uxLine )
+{
+    __atomic_or_fetch( &ulPendingLines, 1UL << uxLine, __ATOMIC_SEQ_CST );
+    prvKickRunningThread();
+}
+/*-----------------------------------------------------------*/
+
+void vPortHostIdle( void )
+{
+    sigset_t xOld;
+    sigset_t xWait;
+
+    /* Check and sleep atomically, so an interrupt raised in between is not
+     * slept through. */
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignals, &xOld );
+
+    if( ( ulPendingLines == 0U ) && ( ulPendingTicks == 0U ) )
+    {
+        xWait = xOld;
+        sigdelset( &xWait, portINTERRUPT_SIGNAL );
+        sigsuspend( &xWait );
+    }
+
+    pthread_sigmask( SIG_SETMASK, &xOld, NULL );
+    prvUnmaskInterrupts();
+}
+/*-----------------------------------------------------------*/
+
+/* Build the interrupt signal set before main() runs, so critical sections
+ * used while tasks are being created already mask the right signal. */
+__attribute__( ( constructor ) ) static void prvPortInit( void )
+{
+    sigemptyset( &xInterruptSignals );
+    sigaddset( &xInterruptSignals, portINTERRUPT_SIGNAL );
+}
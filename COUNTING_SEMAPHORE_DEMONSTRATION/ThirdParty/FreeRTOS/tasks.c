@@ -243,6 +243,53 @@
 
 /*-----------------------------------------------------------*/
 
+/* Set configUSE_DELAYED_WHEEL to 1 in FreeRTOSConfig.h to keep tasks that are
+ * blocked with a timeout in a hierarchical timing wheel instead of the two
+ * sorted delayed lists.  Blocking is then O(1) in the number of blocked tasks,
+ * where vListInsert() walks the list to the task's wake time.  The delayed
+ * lists are still created but stay empty. */
+#ifndef configUSE_DELAYED_WHEEL
+    #define configUSE_DELAYED_WHEEL    0
+#endif
+
+#if ( configUSE_DELAYED_WHEEL == 1 )
+
+    #if ( configTICK_TYPE_WIDTH_IN_BITS != TICK_TYPE_WIDTH_32_BITS )
+        #error configUSE_DELAYED_WHEEL requires a 32-bit TickType_t.
+    #endif
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        #error configUSE_DELAYED_WHEEL is only implemented for single core builds.
+    #endif
+
+/* Tickless idle needs the next unblock time, which the wheel does not keep. */
+    #if ( configUSE_TICKLESS_IDLE != 0 )
+        #error configUSE_DELAYED_WHEEL cannot be used with configUSE_TICKLESS_IDLE.
+    #endif
+
+/* Five levels of 64 slots.  Level n holds the tasks due in the current or the
+ * next block of 32^(n+1) ticks, and each of its slots spans 32^n ticks, so no
+ * two wake times of a level share a slot.  While the tick crosses one block of
+ * 32^n ticks, the level n slot of the next block is moved down a level a share
+ * at a time, instead of all at once on the boundary.  Tasks due further ahead
+ * than level 4 reaches wait in a "far" list that is looked through the same
+ * way once per 2^25 ticks.  The wheel is advanced by every tick, so its time
+ * is always xTickCount. */
+    #define taskWHEEL_BITS         ( 5U )
+    #define taskWHEEL_SLOTS        ( 2U << taskWHEEL_BITS )
+    #define taskWHEEL_MASK         ( taskWHEEL_SLOTS - 1U )
+    #define taskWHEEL_LEVELS       ( 5U )
+    #define taskWHEEL_FAR_SHIFT    ( taskWHEEL_BITS * taskWHEEL_LEVELS )
+
+/* Blocks of 2^uxShift ticks from the block holding xNow to the one holding
+ * xTime, across the tick count overflow. */
+    #define taskWHEEL_BLOCKS_AHEAD( xTime, xNow, uxShift ) \
+    ( ( ( ( xTime ) >> ( uxShift ) ) - ( ( xNow ) >> ( uxShift ) ) ) & ( portMAX_DELAY >> ( uxShift ) ) )
+
+#endif /* configUSE_DELAYED_WHEEL */
+
+/*-----------------------------------------------------------*/
+
 /* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
  * count overflows. */
 #define taskSWITCH_DELAYED_LISTS()                                                \
@@ -463,6 +510,14 @@ PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /**< Po
 PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;      /**< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t xPendingReadyList;                         /**< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
+#if ( configUSE_DELAYED_WHEEL == 1 )
+
+    PRIVILEGED_DATA static List_t xDelayedWheel[ taskWHEEL_LEVELS ][ taskWHEEL_SLOTS ]; /**< Delayed tasks, filed by wake time. */
+    PRIVILEGED_DATA static List_t xDelayedWheelFar;                                     /**< Delayed tasks due beyond the last level. */
+    PRIVILEGED_DATA static UBaseType_t uxDelayedWheelFarLeft = ( UBaseType_t ) 0U;      /**< Far tasks still to look at in this 2^25 tick block. */
+
+#endif
+
 #if ( INCLUDE_vTaskDelete == 1 )
 
     PRIVILEGED_DATA static List_t xTasksWaitingTermination; /**< Tasks that have been deleted - but their memory not yet freed. */
@@ -622,6 +677,37 @@ static void prvCheckTasksWaitingTermination( void ) PRIVILEGED_FUNCTION;
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                                             const BaseType_t xCanBlockIndefinitely ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_DELAYED_WHEEL == 1 )
+
+/*
+ * File pxTCB's state list item in the delayed wheel by the wake time held in
+ * its item value.
+ */
+    static void prvDelayedWheelInsert( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+/*
+ * Advance the delayed wheel to xTickCount: move this tick's share of the slots
+ * that come due next down a level and unblock the tasks due now.  Returns
+ * pdTRUE if one of them should preempt the running task.
+ */
+    static BaseType_t prvDelayedWheelTick( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * How many of uxLeft tasks to move this tick so that the last of them moves on
+ * the last tick of the current block of 2^uxShift ticks.
+ */
+    static UBaseType_t prvDelayedWheelShare( UBaseType_t uxLeft,
+                                             UBaseType_t uxShift ) PRIVILEGED_FUNCTION;
+
+/*
+ * pdTRUE if pxList is one of the delayed wheel's lists.
+ */
+    #if ( ( INCLUDE_eTaskGetState == 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_xTaskAbortDelay == 1 ) )
+        static BaseType_t prvIsDelayedWheelList( const List_t * pxList ) PRIVILEGED_FUNCTION;
+    #endif
+
+#endif /* configUSE_DELAYED_WHEEL */
+
 /*
  * Fills an TaskStatus_t structure with information on each task that is
  * referenced from the pxList list (which may be a ready list, a delayed list,
@@ -2527,6 +2613,14 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                 eReturn = eBlocked;
             }
 
+            #if ( configUSE_DELAYED_WHEEL == 1 )
+                else if( prvIsDelayedWheelList( pxStateList ) != pdFALSE )
+                {
+                    /* The task is blocked with a timeout. */
+                    eReturn = eBlocked;
+                }
+            #endif
+
             #if ( INCLUDE_vTaskSuspend == 1 )
                 else if( pxStateList == &xSuspendedTaskList )
                 {
@@ -4296,6 +4390,22 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
                 pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
             }
 
+            #if ( configUSE_DELAYED_WHEEL == 1 )
+            {
+                UBaseType_t uxList;
+
+                for( uxList = 0U; ( pxTCB == NULL ) && ( uxList < ( taskWHEEL_LEVELS * taskWHEEL_SLOTS ) ); uxList++ )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( &( xDelayedWheel[ uxList / taskWHEEL_SLOTS ][ uxList & taskWHEEL_MASK ] ), pcNameToQuery );
+                }
+
+                if( pxTCB == NULL )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( &xDelayedWheelFar, pcNameToQuery );
+                }
+            }
+            #endif
+
             #if ( INCLUDE_vTaskSuspend == 1 )
             {
                 if( pxTCB == NULL )
@@ -4408,6 +4518,19 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
                 uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked ) );
                 uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked ) );
 
+                #if ( configUSE_DELAYED_WHEEL == 1 )
+                {
+                    UBaseType_t uxList;
+
+                    for( uxList = 0U; uxList < ( taskWHEEL_LEVELS * taskWHEEL_SLOTS ); uxList++ )
+                    {
+                        uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xDelayedWheel[ uxList / taskWHEEL_SLOTS ][ uxList & taskWHEEL_MASK ] ), eBlocked ) );
+                    }
+
+                    uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xDelayedWheelFar, eBlocked ) );
+                }
+                #endif /* configUSE_DELAYED_WHEEL */
+
                 #if ( INCLUDE_vTaskDelete == 1 )
                 {
                     /* Fill in an TaskStatus_t structure with information on
@@ -4804,6 +4927,21 @@ BaseType_t xTaskIncrementTick( void )
             }
         }
 
+        /* With the wheel the delayed lists above stay empty, and the wheel
+         * unblocks the tasks due at this tick instead. */
+        #if ( configUSE_DELAYED_WHEEL == 1 )
+        {
+            if( prvDelayedWheelTick() != pdFALSE )
+            {
+                xSwitchRequired = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_DELAYED_WHEEL */
+
         /* Tasks of equal priority to the currently running task will share
          * processing time (time slice) if preemption is on, and the application
          * writer has not explicitly turned time slicing off. */
@@ -6021,6 +6159,20 @@ static void prvInitialiseTaskLists( void )
     vListInitialise( &xDelayedTaskList2 );
     vListInitialise( &xPendingReadyList );
 
+    #if ( configUSE_DELAYED_WHEEL == 1 )
+    {
+        UBaseType_t uxList;
+
+        for( uxList = 0U; uxList < ( taskWHEEL_LEVELS * taskWHEEL_SLOTS ); uxList++ )
+        {
+            vListInitialise( &( xDelayedWheel[ uxList / taskWHEEL_SLOTS ][ uxList & taskWHEEL_MASK ] ) );
+        }
+
+        vListInitialise( &xDelayedWheelFar );
+        uxDelayedWheelFarLeft = ( UBaseType_t ) 0U;
+    }
+    #endif /* configUSE_DELAYED_WHEEL */
+
     #if ( INCLUDE_vTaskDelete == 1 )
     {
         vListInitialise( &xTasksWaitingTermination );
@@ -8417,8 +8569,11 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
 {
     TickType_t xTimeToWake;
     const TickType_t xConstTickCount = xTickCount;
-    List_t * const pxDelayedList = pxDelayedTaskList;
-    List_t * const pxOverflowDelayedList = pxOverflowDelayedTaskList;
+
+    #if ( configUSE_DELAYED_WHEEL == 0 )
+        List_t * const pxDelayedList = pxDelayedTaskList;
+        List_t * const pxOverflowDelayedList = pxOverflowDelayedTaskList;
+    #endif
 
     #if ( INCLUDE_xTaskAbortDelay == 1 )
     {
@@ -8461,6 +8616,13 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
             /* The list item will be inserted in wake time order. */
             listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
+            #if ( configUSE_DELAYED_WHEEL == 1 )
+            {
+                /* The wheel handles a wake time past the overflow itself. */
+                traceMOVED_TASK_TO_DELAYED_LIST();
+                prvDelayedWheelInsert( pxCurrentTCB );
+            }
+            #else /* configUSE_DELAYED_WHEEL */
             if( xTimeToWake < xConstTickCount )
             {
                 /* Wake time has overflowed.  Place this item in the overflow
@@ -8487,6 +8649,7 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                     mtCOVERAGE_TEST_MARKER();
                 }
             }
+            #endif /* configUSE_DELAYED_WHEEL */
         }
     }
     #else /* INCLUDE_vTaskSuspend */
@@ -8499,6 +8662,12 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
         /* The list item will be inserted in wake time order. */
         listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
+        #if ( configUSE_DELAYED_WHEEL == 1 )
+        {
+            traceMOVED_TASK_TO_DELAYED_LIST();
+            prvDelayedWheelInsert( pxCurrentTCB );
+        }
+        #else /* configUSE_DELAYED_WHEEL */
         if( xTimeToWake < xConstTickCount )
         {
             traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
@@ -8523,6 +8692,7 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                 mtCOVERAGE_TEST_MARKER();
             }
         }
+        #endif /* configUSE_DELAYED_WHEEL */
 
         /* Avoid compiler warning when INCLUDE_vTaskSuspend is not 1. */
         ( void ) xCanBlockIndefinitely;
@@ -8531,6 +8701,186 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_DELAYED_WHEEL == 1 )
+
+    static void prvDelayedWheelInsert( TCB_t * pxTCB )
+    {
+        const TickType_t xTimeToWake = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+        const TickType_t xConstTickCount = xTickCount;
+        UBaseType_t uxLevel;
+        UBaseType_t uxSlot;
+
+        /* The lowest level whose window, this block of 32^(n+1) ticks and the
+         * next, holds the wake time.  The slot is picked by the wake time's
+         * own bits, so it is the one that comes due when the task has to move
+         * down a level, or wake.  Block counts wrap with the tick count, so a
+         * wake time more than two level 4 blocks ahead goes to the far list
+         * before it can look like a near one. */
+        uxLevel = taskWHEEL_LEVELS;
+
+        if( ( ( xTimeToWake - xConstTickCount ) >> ( taskWHEEL_FAR_SHIFT + 1U ) ) == ( TickType_t ) 0U )
+        {
+            for( uxLevel = 0U; uxLevel < taskWHEEL_LEVELS; uxLevel++ )
+            {
+                if( taskWHEEL_BLOCKS_AHEAD( xTimeToWake, xConstTickCount, taskWHEEL_BITS * ( uxLevel + 1U ) ) <= ( TickType_t ) 1U )
+                {
+                    break;
+                }
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( uxLevel < taskWHEEL_LEVELS )
+        {
+            uxSlot = ( UBaseType_t ) ( xTimeToWake >> ( taskWHEEL_BITS * uxLevel ) ) & taskWHEEL_MASK;
+            listINSERT_END( &( xDelayedWheel[ uxLevel ][ uxSlot ] ), &( pxTCB->xStateListItem ) );
+        }
+        else
+        {
+            listINSERT_END( &xDelayedWheelFar, &( pxTCB->xStateListItem ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static UBaseType_t prvDelayedWheelShare( UBaseType_t uxLeft,
+                                             UBaseType_t uxShift )
+    {
+        const UBaseType_t uxTicksLeft = ( UBaseType_t ) ( ( ( TickType_t ) 1U << uxShift ) -
+                                                          ( xTickCount & ( ( ( TickType_t ) 1U << uxShift ) - 1U ) ) );
+        UBaseType_t uxShare = uxLeft;
+
+        if( uxLeft > 1U )
+        {
+            uxShare = ( uxLeft + uxTicksLeft - 1U ) / uxTicksLeft;
+        }
+
+        return uxShare;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvDelayedWheelTick( void )
+    {
+        const TickType_t xConstTickCount = xTickCount;
+        BaseType_t xSwitchRequired = pdFALSE;
+        UBaseType_t uxLevel;
+        UBaseType_t uxCount;
+        List_t * pxList;
+        TCB_t * pxTCB;
+
+        /* The far list holds wake times of many blocks, so it is looked
+         * through: every task in it when a 2^25 tick block starts is taken
+         * out once during that block and filed again, in level 4 once it is
+         * due in the next block or back at the far list's end otherwise. */
+        if( ( xConstTickCount & ( ( ( TickType_t ) 1U << taskWHEEL_FAR_SHIFT ) - 1U ) ) == ( TickType_t ) 0U )
+        {
+            uxDelayedWheelFarLeft = listCURRENT_LIST_LENGTH( &xDelayedWheelFar );
+        }
+
+        for( uxCount = prvDelayedWheelShare( uxDelayedWheelFarLeft, taskWHEEL_FAR_SHIFT ); uxCount > 0U; uxCount-- )
+        {
+            /* Tasks leave early when they are deleted or their delay is
+             * aborted. */
+            if( listLIST_IS_EMPTY( &xDelayedWheelFar ) != pdFALSE )
+            {
+                uxDelayedWheelFarLeft = 0U;
+                break;
+            }
+
+            /* MISRA Ref 11.5.3 [Void pointer assignment] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+            /* coverity[misra_c_2012_rule_11_5_violation] */
+            pxTCB = listGET_OWNER_OF_HEAD_ENTRY( &xDelayedWheelFar );
+            listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+            prvDelayedWheelInsert( pxTCB );
+            uxDelayedWheelFarLeft--;
+        }
+
+        /* While the tick crosses a block of level n, the slot of level n for
+         * the next block moves down a share per tick, the last of it on the
+         * block's last tick.  No task of that slot is due before then.  Going
+         * from the top level down lets a task cross several levels in the
+         * last tick of a block, so every slot is empty when it comes due. */
+        for( uxLevel = taskWHEEL_LEVELS - 1U; uxLevel > 0U; uxLevel-- )
+        {
+            pxList = &( xDelayedWheel[ uxLevel ][ ( ( xConstTickCount >> ( taskWHEEL_BITS * uxLevel ) ) + 1U ) & taskWHEEL_MASK ] );
+
+            for( uxCount = prvDelayedWheelShare( listCURRENT_LIST_LENGTH( pxList ), taskWHEEL_BITS * uxLevel ); uxCount > 0U; uxCount-- )
+            {
+                /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxList );
+                listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+                prvDelayedWheelInsert( pxTCB );
+            }
+        }
+
+        /* Unblock every task in level 0's slot for this tick, as the delayed
+         * list loop in xTaskIncrementTick() does. */
+        pxList = &( xDelayedWheel[ 0 ][ xConstTickCount & taskWHEEL_MASK ] );
+
+        while( listLIST_IS_EMPTY( pxList ) == pdFALSE )
+        {
+            /* MISRA Ref 11.5.3 [Void pointer assignment] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+            /* coverity[misra_c_2012_rule_11_5_violation] */
+            pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxList );
+            listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+
+            if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+            {
+                listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            prvAddTaskToReadyList( pxTCB );
+
+            #if ( configUSE_PREEMPTION == 1 )
+            {
+                if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                {
+                    xSwitchRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_PREEMPTION */
+        }
+
+        return xSwitchRequired;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ( INCLUDE_eTaskGetState == 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_xTaskAbortDelay == 1 ) )
+
+    static BaseType_t prvIsDelayedWheelList( const List_t * pxList )
+    {
+        const portPOINTER_SIZE_TYPE uxFirst = ( portPOINTER_SIZE_TYPE ) &( xDelayedWheel[ 0 ][ 0 ] );
+        const portPOINTER_SIZE_TYPE uxList = ( portPOINTER_SIZE_TYPE ) pxList;
+        BaseType_t xReturn = pdFALSE;
+
+        if( ( pxList == &xDelayedWheelFar ) ||
+            ( ( uxList >= uxFirst ) && ( uxList < ( uxFirst + sizeof( xDelayedWheel ) ) ) ) )
+        {
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+
+    #endif /* INCLUDE_eTaskGetState */
+
+#endif /* configUSE_DELAYED_WHEEL */
+/*-----------------------------------------------------------*/
+
 #if ( portUSING_MPU_WRAPPERS == 1 )
 
     xMPU_SETTINGS * xTaskGetMPUSettings( TaskHandle_t xTask )
@@ -0,0 +1,46 @@
+/**
+ ******************************************************************************
+ * @file           : FreeRTOSConfig.h  (host build)
+ * @brief          : Wraps the demo's own ThirdParty/FreeRTOS/FreeRTOSConfig.h
+ *                   for the Posix port.
+ *
+ * @description    : Listed first on the host include path, so FreeRTOS.h
+ *                   lands here; #include_next then pulls in the demo's file,
+ *                   which stays the single source of the kernel settings.
+ *                   Only these things change on the host:
+ *
+ *                     configASSERT       reports file and line and aborts,
+ *                                        instead of spinning with interrupts
+ *                                        off where no debugger will look
+ *                     configUSE_IDLE_HOOK the idle task sleeps until the next
+ *                                        interrupt rather than spinning a
+ *                                        host core at 100 %, unless the demo
+ *                                        already has its own idle hook
+ *                     configTOTAL_HEAP_SIZE HOST_HEAP_SIZE when the Makefile
+ *                                        sets it, for benchmarks that
+ *                                        outgrow the board's heap
+ ******************************************************************************
+ */
+
+#ifndef HOST_FREERTOS_CONFIG_H
+#define HOST_FREERTOS_CONFIG_H
+
+#include_next "FreeRTOSConfig.h"
+
+void host_assert_failed(const char *file, int line);
+
+#undef  configASSERT
+#define configASSERT( x )   if( ( x ) == 0 ) { host_assert_failed( __FILE__, __LINE__ ); }
+
+#if ( configUSE_IDLE_HOOK == 0 )
+    #undef  configUSE_IDLE_HOOK
+    #define configUSE_IDLE_HOOK     1
+    #define HOST_IDLE_HOOK          1  /* Defined in Host/Src/hal_core.c     */
+#endif
+
+#ifdef HOST_HEAP_SIZE
+    #undef  configTOTAL_HEAP_SIZE
+    #define configTOTAL_HEAP_SIZE   ( ( size_t ) HOST_HEAP_SIZE )
+#endif
+
+#endif /* HOST_FREERTOS_CONFIG_H */
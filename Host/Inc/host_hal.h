@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ * @file           : host_hal.h
+ * @brief          : Shared plumbing for the host peripheral models.
+ *
+ * @description    : Each model that interrupts the "CPU" owns one Posix-port
+ *                   interrupt line.  Its host thread updates the model under
+ *                   host_lock() and raises the line; the line's handler then
+ *                   runs on the running task's thread, inside the simulated
+ *                   ISR, and calls the HAL callbacks the demos implement.
+ *
+ *                   host_lock() also masks interrupts for the calling task
+ *                   thread.  HAL calls made from task code take it, so a
+ *                   task is never switched out while it holds the lock -
+ *                   the host version of a register access being atomic.
+ ******************************************************************************
+ */
+
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include "stm32f4xx_hal.h"
+
+/* ========================== Interrupt Lines ========================== */
+#define HOST_IRQ_USART2_RX      0U     /* RXNE / IDLE / DMA HT-TC events     */
+#define HOST_IRQ_USART2_TX      1U     /* Transfer complete                  */
+#define HOST_IRQ_RTC_WKUP       2U     /* Wakeup timer                       */
+#define HOST_IRQ_EXTI0          3U     /* B1 user button (PA0)               */
+#define HOST_IRQ_TIM7           4U     /* TIM7 update (isr_bench)            */
+
+/* ========================== Locking ================================== */
+typedef struct {
+    unsigned long mask;            /* Interrupt mask to restore              */
+} host_lock_t;
+
+void host_lock(host_lock_t *lk);
+void host_unlock(host_lock_t *lk);
+
+/* ========================== Timing =================================== */
+
+/**
+ * @brief  Nanoseconds on CLOCK_MONOTONIC.
+ */
+uint64_t host_now_ns(void);
+
+/**
+ * @brief  Stay busy until an absolute CLOCK_MONOTONIC time, the way a HAL
+ *         polling loop holds the CPU.  Interrupts still run.
+ */
+void     host_busy_until(uint64_t deadline_ns);
+
+/**
+ * @brief  True when the environment variable is set to a non-zero value.
+ */
+int      host_env_flag(const char *name, int fallback);
+
+#endif /* HOST_HAL_H */
@@ -0,0 +1,730 @@
+/**
+ ******************************************************************************
+ * @file           : stm32f4xx_hal.h  (host build)
+ * @brief          : Stand-in for the STM32F4 HAL and CMSIS headers when a
+ *                   demo is built as a Linux executable.
+ *
+ * @description    : Found ahead of Drivers/ on the host include path, so
+ *                   every "main.h" in the tree picks this up unchanged.  It
+ *                   declares only what the demos and their CubeMX files
+ *                   use: the same type, field and constant names as the
+ *                   real HAL, register blocks as plain structs in RAM, and
+ *                   the HAL calls implemented by Host/Src/hal_*.c.
+ *
+ *                   Peripheral models behind the stubs:
+ *                     USART2   pseudo-terminal (hal_uart.c)
+ *                     RTC      calendar driven by the host clock (hal_rtc.c)
+ *                     GPIO     ODR/IDR in RAM; SIGUSR1 presses B1 (PA0)
+ *                     DWT      CYCCNT from CLOCK_MONOTONIC, scaled to
+ *                              SystemCoreClock
+ *                     ITM      reported disabled (no debugger attached)
+ *                     TIM/DMA  registers and handle states only
+ ******************************************************************************
+ */
+
+#ifndef STM32F4XX_HAL_H
+#define STM32F4XX_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ========================== Common =================================== */
+typedef enum {
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum {
+    HAL_UNLOCKED = 0x00U,
+    HAL_LOCKED   = 0x01U
+} HAL_LockTypeDef;
+
+typedef enum { RESET = 0U, SET = !RESET } FlagStatus, ITStatus;
+typedef enum { DISABLE = 0U, ENABLE = !DISABLE } FunctionalState;
+
+#define HAL_MAX_DELAY               0xFFFFFFFFU
+
+#define SET_BIT(REG, BIT)           ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)         ((REG) &= ~(BIT))
+#define READ_BIT(REG, BIT)          ((REG) & (BIT))
+#define WRITE_REG(REG, VAL)         ((REG) = (VAL))
+#define READ_REG(REG)               ((REG))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) \
+    WRITE_REG((REG), (((READ_REG(REG)) & (~(CLEARMASK))) | (SETMASK)))
+
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__)          \
+    do {                                                                      \
+        (__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__);                  \
+        (__DMA_HANDLE__).Parent         = (__HANDLE__);                       \
+    } while (0)
+
+extern uint32_t          SystemCoreClock;
+extern volatile uint32_t uwTick;
+
+/* ========================== Core (CMSIS) ============================= */
+typedef enum {
+    NonMaskableInt_IRQn = -14,
+    MemoryManagement_IRQn = -12,
+    BusFault_IRQn       = -11,
+    UsageFault_IRQn     = -10,
+    SVCall_IRQn         = -5,
+    DebugMonitor_IRQn   = -4,
+    PendSV_IRQn         = -2,
+    SysTick_IRQn        = -1,
+    RTC_WKUP_IRQn       = 3,
+    EXTI0_IRQn          = 6,
+    DMA1_Stream0_IRQn   = 11,
+    DMA1_Stream5_IRQn   = 16,
+    DMA1_Stream6_IRQn   = 17,
+    TIM4_IRQn           = 30,
+    USART2_IRQn         = 38,
+    TIM6_DAC_IRQn       = 54,
+    TIM7_IRQn           = 55
+} IRQn_Type;
+
+#define __NOP()             __asm volatile ("" ::: "memory")
+#define __DMB()             __sync_synchronize()
+#define __DSB()             __sync_synchronize()
+#define __ISB()             __sync_synchronize()
+#define __enable_irq()      ((void)0)
+
+/* Port interrupt lines have no exception number; report thread mode */
+#define __get_IPSR()        (0U)
+
+/* Only Error_Handler() masks everything on these demos: stop there */
+#define __disable_irq()     host_halt(__FILE__, __LINE__)
+
+void host_halt(const char *file, int line) __attribute__((noreturn));
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+
+typedef struct {
+    volatile union {
+        volatile uint8_t  u8;
+        volatile uint16_t u16;
+        volatile uint32_t u32;
+    } PORT[32];
+    volatile uint32_t TER;
+    volatile uint32_t TPR;
+    volatile uint32_t TCR;
+} ITM_Type;
+
+#define ITM_TCR_ITMENA_Msk          (1UL << 0)
+
+extern CoreDebug_Type host_core_debug;
+extern ITM_Type       host_itm;
+DWT_Type             *host_dwt(void);
+
+#define CoreDebug           (&host_core_debug)
+#define ITM                 (&host_itm)
+/* Every access re-reads the host clock into CYCCNT */
+#define DWT                 (host_dwt())
+
+static inline uint32_t ITM_SendChar(uint32_t ch)
+{
+    return ch;                     /* Stimulus port 0 not enabled: dropped   */
+}
+
+/* ========================== RCC / PWR / FLASH ======================== */
+typedef struct {
+    volatile uint32_t CR;
+    volatile uint32_t PLLCFGR;
+    volatile uint32_t CFGR;
+    volatile uint32_t CIR;
+    volatile uint32_t BDCR;
+    volatile uint32_t CSR;
+} RCC_TypeDef;
+
+extern RCC_TypeDef host_rcc;
+#define RCC                 (&host_rcc)
+
+#define RCC_CFGR_PPRE1_Pos          10U
+#define RCC_CFGR_PPRE1              (0x7UL << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE1_DIV1         0x00000000U
+#define RCC_CFGR_PPRE1_DIV2         0x00001000U
+#define RCC_CFGR_PPRE1_DIV4         0x00001400U
+#define RCC_CFGR_PPRE1_DIV8         0x00001800U
+#define RCC_CFGR_PPRE1_DIV16        0x00001C00U
+#define RCC_CFGR_PPRE2_Pos          13U
+#define RCC_CFGR_PPRE2              (0x7UL << RCC_CFGR_PPRE2_Pos)
+
+typedef struct {
+    uint32_t PLLState;
+    uint32_t PLLSource;
+    uint32_t PLLM;
+    uint32_t PLLN;
+    uint32_t PLLP;
+    uint32_t PLLQ;
+} RCC_PLLInitTypeDef;
+
+typedef struct {
+    uint32_t           OscillatorType;
+    uint32_t           HSEState;
+    uint32_t           LSEState;
+    uint32_t           HSIState;
+    uint32_t           HSICalibrationValue;
+    uint32_t           LSIState;
+    RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct {
+    uint32_t ClockType;
+    uint32_t SYSCLKSource;
+    uint32_t AHBCLKDivider;
+    uint32_t APB1CLKDivider;
+    uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+typedef struct {
+    uint32_t PeriphClockSelection;
+    uint32_t RTCClockSelection;
+} RCC_PeriphCLKInitTypeDef;
+
+#define RCC_OSCILLATORTYPE_HSE      0x00000001U
+#define RCC_OSCILLATORTYPE_HSI      0x00000002U
+#define RCC_OSCILLATORTYPE_LSE      0x00000004U
+#define RCC_OSCILLATORTYPE_LSI      0x00000008U
+#define RCC_HSE_ON                  0x00010000U
+#define RCC_HSI_ON                  0x00000001U
+#define RCC_LSI_ON                  0x00000001U
+#define RCC_HSICALIBRATION_DEFAULT  0x10U
+#define RCC_PLL_ON                  0x00000002U
+#define RCC_PLLSOURCE_HSI           0x00000000U
+#define RCC_PLLSOURCE_HSE           0x00400000U
+#define RCC_PLLP_DIV2               0x00000002U
+#define RCC_PLLP_DIV4               0x00000004U
+#define RCC_CLOCKTYPE_SYSCLK        0x00000001U
+#define RCC_CLOCKTYPE_HCLK          0x00000002U
+#define RCC_CLOCKTYPE_PCLK1         0x00000004U
+#define RCC_CLOCKTYPE_PCLK2         0x00000008U
+#define RCC_SYSCLKSOURCE_PLLCLK     0x00000002U
+#define RCC_SYSCLK_DIV1             0x00000000U
+#define RCC_HCLK_DIV1               RCC_CFGR_PPRE1_DIV1
+#define RCC_HCLK_DIV2               RCC_CFGR_PPRE1_DIV2
+#define RCC_HCLK_DIV4               RCC_CFGR_PPRE1_DIV4
+#define RCC_HCLK_DIV8               RCC_CFGR_PPRE1_DIV8
+#define RCC_HCLK_DIV16              RCC_CFGR_PPRE1_DIV16
+#define RCC_PERIPHCLK_RTC           0x00000002U
+#define RCC_RTCCLKSOURCE_LSI        0x00000200U
+#define RCC_RTCCLKSOURCE_LSE        0x00000100U
+
+#define FLASH_LATENCY_5             0x00000005U
+#define PWR_REGULATOR_VOLTAGE_SCALE1 0x0000C000U
+
+/* Clock gates and regulator scaling have nothing to model */
+#define __HAL_PWR_VOLTAGESCALING_CONFIG(x)  ((void)(x))
+#define __HAL_RCC_PWR_CLK_ENABLE()          ((void)0)
+#define __HAL_RCC_SYSCFG_CLK_ENABLE()       ((void)0)
+#define __HAL_RCC_GPIOA_CLK_ENABLE()        ((void)0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()        ((void)0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE()        ((void)0)
+#define __HAL_RCC_GPIOD_CLK_ENABLE()        ((void)0)
+#define __HAL_RCC_GPIOE_CLK_ENABLE()        ((void)0)
+#define __HAL_RCC_GPIOH_CLK_ENABLE()        ((void)0)
+#define __HAL_RCC_DMA1_CLK_ENABLE()         ((void)0)
+#define __HAL_RCC_DMA2_CLK_ENABLE()         ((void)0)
+#define __HAL_RCC_USART2_CLK_ENABLE()       ((void)0)
+#define __HAL_RCC_USART2_CLK_DISABLE()      ((void)0)
+#define __HAL_RCC_TIM4_CLK_ENABLE()         ((void)0)
+#define __HAL_RCC_TIM4_CLK_DISABLE()        ((void)0)
+#define __HAL_RCC_TIM6_CLK_ENABLE()         ((void)0)
+#define __HAL_RCC_TIM7_CLK_ENABLE()         ((void)0)
+#define __HAL_RCC_TIM7_CLK_DISABLE()        ((void)0)
+#define __HAL_RCC_RTC_ENABLE()              ((void)0)
+#define __HAL_RCC_RTC_DISABLE()             ((void)0)
+
+/* ========================== GPIO ===================================== */
+typedef struct {
+    volatile uint32_t MODER;
+    volatile uint32_t OTYPER;
+    volatile uint32_t OSPEEDR;
+    volatile uint32_t PUPDR;
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+    volatile uint32_t LCKR;
+    volatile uint32_t AFR[2];
+} GPIO_TypeDef;
+
+typedef struct {
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+extern GPIO_TypeDef host_gpio[8];
+#define GPIOA               (&host_gpio[0])
+#define GPIOB               (&host_gpio[1])
+#define GPIOC               (&host_gpio[2])
+#define GPIOD               (&host_gpio[3])
+#define GPIOE               (&host_gpio[4])
+#define GPIOH               (&host_gpio[7])
+
+#define GPIO_PIN_0                  ((uint16_t)0x0001)
+#define GPIO_PIN_1                  ((uint16_t)0x0002)
+#define GPIO_PIN_2                  ((uint16_t)0x0004)
+#define GPIO_PIN_3                  ((uint16_t)0x0008)
+#define GPIO_PIN_4                  ((uint16_t)0x0010)
+#define GPIO_PIN_5                  ((uint16_t)0x0020)
+#define GPIO_PIN_6                  ((uint16_t)0x0040)
+#define GPIO_PIN_7                  ((uint16_t)0x0080)
+#define GPIO_PIN_8                  ((uint16_t)0x0100)
+#define GPIO_PIN_9                  ((uint16_t)0x0200)
+#define GPIO_PIN_10                 ((uint16_t)0x0400)
+#define GPIO_PIN_11                 ((uint16_t)0x0800)
+#define GPIO_PIN_12                 ((uint16_t)0x1000)
+#define GPIO_PIN_13                 ((uint16_t)0x2000)
+#define GPIO_PIN_14                 ((uint16_t)0x4000)
+#define GPIO_PIN_15                 ((uint16_t)0x8000)
+#define GPIO_PIN_All                ((uint16_t)0xFFFF)
+
+#define GPIO_MODE_INPUT             0x00000000U
+#define GPIO_MODE_OUTPUT_PP         0x00000001U
+#define GPIO_MODE_OUTPUT_OD         0x00000011U
+#define GPIO_MODE_AF_PP             0x00000002U
+#define GPIO_MODE_AF_OD             0x00000012U
+#define GPIO_MODE_ANALOG            0x00000003U
+#define GPIO_MODE_IT_RISING         0x10110000U
+#define GPIO_MODE_IT_FALLING        0x10210000U
+#define GPIO_MODE_EVT_RISING        0x10120000U
+#define GPIO_NOPULL                 0x00000000U
+#define GPIO_PULLUP                 0x00000001U
+#define GPIO_PULLDOWN               0x00000002U
+#define GPIO_SPEED_FREQ_LOW         0x00000000U
+#define GPIO_SPEED_FREQ_MEDIUM      0x00000001U
+#define GPIO_SPEED_FREQ_HIGH        0x00000002U
+#define GPIO_SPEED_FREQ_VERY_HIGH   0x00000003U
+#define GPIO_AF2_TIM4               ((uint8_t)0x02)
+#define GPIO_AF4_I2C1               ((uint8_t)0x04)
+#define GPIO_AF5_SPI1               ((uint8_t)0x05)
+#define GPIO_AF5_SPI2               ((uint8_t)0x05)
+#define GPIO_AF6_SPI3               ((uint8_t)0x06)
+#define GPIO_AF7_USART2             ((uint8_t)0x07)
+#define GPIO_AF10_OTG_FS            ((uint8_t)0x0A)
+
+void          HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void          HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void          HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+                                GPIO_PinState PinState);
+void          HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void          HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin);
+void          HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+/* ========================== DMA ====================================== */
+typedef struct {
+    volatile uint32_t CR;
+    volatile uint32_t NDTR;
+    volatile uint32_t PAR;
+    volatile uint32_t M0AR;
+    volatile uint32_t M1AR;
+    volatile uint32_t FCR;
+} DMA_Stream_TypeDef;
+
+typedef struct {
+    uint32_t Channel;
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+    uint32_t FIFOMode;
+    uint32_t FIFOThreshold;
+    uint32_t MemBurst;
+    uint32_t PeriphBurst;
+} DMA_InitTypeDef;
+
+typedef enum {
+    HAL_DMA_STATE_RESET   = 0x00U,
+    HAL_DMA_STATE_READY   = 0x01U,
+    HAL_DMA_STATE_BUSY    = 0x02U,
+    HAL_DMA_STATE_TIMEOUT = 0x03U,
+    HAL_DMA_STATE_ERROR   = 0x04U,
+    HAL_DMA_STATE_ABORT   = 0x05U
+} HAL_DMA_StateTypeDef;
+
+typedef struct __DMA_HandleTypeDef {
+    DMA_Stream_TypeDef            *Instance;
+    DMA_InitTypeDef                Init;
+    HAL_LockTypeDef                Lock;
+    volatile HAL_DMA_StateTypeDef  State;
+    void                          *Parent;
+    volatile uint32_t              ErrorCode;
+} DMA_HandleTypeDef;
+
+extern DMA_Stream_TypeDef host_dma1_stream[8];
+extern DMA_Stream_TypeDef host_dma2_stream[8];
+#define DMA1_Stream0        (&host_dma1_stream[0])
+#define DMA1_Stream5        (&host_dma1_stream[5])
+#define DMA1_Stream6        (&host_dma1_stream[6])
+#define DMA2_Stream0        (&host_dma2_stream[0])
+
+#define DMA_CHANNEL_0               0x00000000U
+#define DMA_CHANNEL_2               0x04000000U
+#define DMA_CHANNEL_4               0x08000000U
+#define DMA_PERIPH_TO_MEMORY        0x00000000U
+#define DMA_MEMORY_TO_PERIPH        0x00000040U
+#define DMA_MEMORY_TO_MEMORY        0x00000080U
+#define DMA_PINC_DISABLE            0x00000000U
+#define DMA_PINC_ENABLE             0x00000200U
+#define DMA_MINC_ENABLE             0x00000400U
+#define DMA_PDATAALIGN_BYTE         0x00000000U
+#define DMA_PDATAALIGN_HALFWORD     0x00000800U
+#define DMA_PDATAALIGN_WORD         0x00001000U
+#define DMA_MDATAALIGN_BYTE         0x00000000U
+#define DMA_MDATAALIGN_HALFWORD     0x00002000U
+#define DMA_MDATAALIGN_WORD         0x00004000U
+#define DMA_NORMAL                  0x00000000U
+#define DMA_CIRCULAR                0x00000100U
+#define DMA_PRIORITY_LOW            0x00000000U
+#define DMA_PRIORITY_HIGH           0x00020000U
+#define DMA_PRIORITY_VERY_HIGH      0x00030000U
+#define DMA_FIFOMODE_DISABLE        0x00000000U
+#define DMA_FIFOMODE_ENABLE         0x00000004U
+#define DMA_FIFO_THRESHOLD_FULL     0x00000003U
+#define DMA_MBURST_INC4             0x00800000U
+#define DMA_PBURST_INC4             0x00200000U
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress,
+                                uint32_t DstAddress, uint32_t DataLength);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+
+/* ========================== UART ===================================== */
+typedef struct {
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+    volatile uint32_t BRR;
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t CR3;
+    volatile uint32_t GTPR;
+} USART_TypeDef;
+
+typedef struct {
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef enum {
+    HAL_UART_STATE_RESET      = 0x00U,
+    HAL_UART_STATE_READY      = 0x20U,
+    HAL_UART_STATE_BUSY       = 0x24U,
+    HAL_UART_STATE_BUSY_TX    = 0x21U,
+    HAL_UART_STATE_BUSY_RX    = 0x22U,
+    HAL_UART_STATE_BUSY_TX_RX = 0x23U,
+    HAL_UART_STATE_TIMEOUT    = 0xA0U,
+    HAL_UART_STATE_ERROR      = 0xE0U
+} HAL_UART_StateTypeDef;
+
+typedef struct __UART_HandleTypeDef {
+    USART_TypeDef                  *Instance;
+    UART_InitTypeDef                Init;
+    const uint8_t                  *pTxBuffPtr;
+    uint16_t                        TxXferSize;
+    volatile uint16_t               TxXferCount;
+    uint8_t                        *pRxBuffPtr;
+    uint16_t                        RxXferSize;
+    volatile uint16_t               RxXferCount;
+    volatile uint32_t               ReceptionType;
+    DMA_HandleTypeDef              *hdmatx;
+    DMA_HandleTypeDef              *hdmarx;
+    HAL_LockTypeDef                 Lock;
+    volatile HAL_UART_StateTypeDef  gState;
+    volatile HAL_UART_StateTypeDef  RxState;
+    volatile uint32_t               ErrorCode;
+} UART_HandleTypeDef;
+
+extern USART_TypeDef host_usart2;
+#define USART2              (&host_usart2)
+
+#define UART_WORDLENGTH_8B          0x00000000U
+#define UART_STOPBITS_1             0x00000000U
+#define UART_PARITY_NONE            0x00000000U
+#define UART_MODE_TX_RX             0x0000000CU
+#define UART_HWCONTROL_NONE         0x00000000U
+#define UART_OVERSAMPLING_16        0x00000000U
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart,
+                                    const uint8_t *pData, uint16_t Size,
+                                    uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart,
+                                        const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart,
+                                      uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart,
+                                               uint8_t *pData, uint16_t Size);
+void HAL_UART_MspInit(UART_HandleTypeDef *huart);
+void HAL_UART_MspDeInit(UART_HandleTypeDef *huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+
+/* ========================== TIM ====================================== */
+typedef struct {
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t SMCR;
+    volatile uint32_t DIER;
+    volatile uint32_t SR;
+    volatile uint32_t EGR;
+    volatile uint32_t CCMR1;
+    volatile uint32_t CCMR2;
+    volatile uint32_t CCER;
+    volatile uint32_t CNT;
+    volatile uint32_t PSC;
+    volatile uint32_t ARR;
+    volatile uint32_t RCR;
+    volatile uint32_t CCR1;
+    volatile uint32_t CCR2;
+    volatile uint32_t CCR3;
+    volatile uint32_t CCR4;
+    volatile uint32_t BDTR;
+    volatile uint32_t DCR;
+    volatile uint32_t DMAR;
+    volatile uint32_t OR;
+} TIM_TypeDef;
+
+typedef struct {
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t RepetitionCounter;
+    uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+    uint32_t OCMode;
+    uint32_t Pulse;
+    uint32_t OCPolarity;
+    uint32_t OCNPolarity;
+    uint32_t OCFastMode;
+    uint32_t OCIdleState;
+    uint32_t OCNIdleState;
+} TIM_OC_InitTypeDef;
+
+typedef struct {
+    TIM_TypeDef          *Instance;
+    TIM_Base_InitTypeDef  Init;
+    uint32_t              Channel;
+    DMA_HandleTypeDef    *hdma[7];
+    HAL_LockTypeDef       Lock;
+    volatile uint32_t     State;
+} TIM_HandleTypeDef;
+
+extern TIM_TypeDef host_tim4;
+extern TIM_TypeDef host_tim6;
+extern TIM_TypeDef host_tim7;
+#define TIM4                (&host_tim4)
+#define TIM6                (&host_tim6)
+#define TIM7                (&host_tim7)
+
+#define TIM_CR1_CEN                 (1UL << 0)
+#define TIM_CR2_CCDS                (1UL << 3)
+#define TIM_DIER_UIE                (1UL << 0)
+#define TIM_DIER_CC1DE              (1UL << 9)
+#define TIM_SR_UIF                  (1UL << 0)
+#define TIM_EGR_UG                  (1UL << 0)
+#define TIM_COUNTERMODE_UP          0x00000000U
+#define TIM_CLOCKDIVISION_DIV1      0x00000000U
+#define TIM_AUTORELOAD_PRELOAD_DISABLE 0x00000000U
+#define TIM_AUTORELOAD_PRELOAD_ENABLE 0x00000080U
+#define TIM_OCMODE_PWM1             0x00000060U
+#define TIM_OCPOLARITY_HIGH         0x00000000U
+#define TIM_OCFAST_DISABLE          0x00000000U
+#define TIM_CHANNEL_1               0x00000000U
+#define TIM_CHANNEL_2               0x00000004U
+#define TIM_CHANNEL_3               0x00000008U
+#define TIM_CHANNEL_4               0x0000000CU
+#define TIM_DMA_ID_CC1              ((uint16_t)0x0001)
+#define TIM_DMA_CC1                 TIM_DIER_CC1DE
+#define TIM_DMABASE_PSC             0x0000000AU
+#define TIM_DMABURSTLENGTH_7TRANSFERS 0x00000600U
+
+#define __HAL_TIM_ENABLE(h)         ((h)->Instance->CR1 |= TIM_CR1_CEN)
+#define __HAL_TIM_DISABLE(h)        ((h)->Instance->CR1 &= ~TIM_CR1_CEN)
+#define __HAL_TIM_ENABLE_DMA(h, d)  ((h)->Instance->DIER |= (d))
+#define __HAL_TIM_DISABLE_DMA(h, d) ((h)->Instance->DIER &= ~(d))
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim,
+                                            const TIM_OC_InitTypeDef *sConfig,
+                                            uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim);
+void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim);
+void HAL_TIM_PWM_MspDeInit(TIM_HandleTypeDef *htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+
+/* ========================== RTC ====================================== */
+typedef struct {
+    volatile uint32_t TR;
+    volatile uint32_t DR;
+    volatile uint32_t CR;
+    volatile uint32_t ISR;
+    volatile uint32_t PRER;
+    volatile uint32_t WUTR;
+    volatile uint32_t CALIBR;
+    volatile uint32_t ALRMAR;
+    volatile uint32_t ALRMBR;
+    volatile uint32_t WPR;
+    volatile uint32_t SSR;
+} RTC_TypeDef;
+
+typedef struct {
+    uint32_t HourFormat;
+    uint32_t AsynchPrediv;
+    uint32_t SynchPrediv;
+    uint32_t OutPut;
+    uint32_t OutPutPolarity;
+    uint32_t OutPutType;
+} RTC_InitTypeDef;
+
+typedef struct {
+    uint8_t  Hours;
+    uint8_t  Minutes;
+    uint8_t  Seconds;
+    uint8_t  TimeFormat;
+    uint32_t SubSeconds;
+    uint32_t SecondFraction;
+    uint32_t DayLightSaving;
+    uint32_t StoreOperation;
+} RTC_TimeTypeDef;
+
+typedef struct {
+    uint8_t WeekDay;
+    uint8_t Month;
+    uint8_t Date;
+    uint8_t Year;
+} RTC_DateTypeDef;
+
+typedef struct {
+    RTC_TypeDef      *Instance;
+    RTC_InitTypeDef   Init;
+    HAL_LockTypeDef   Lock;
+    volatile uint32_t State;
+} RTC_HandleTypeDef;
+
+extern RTC_TypeDef host_rtc;
+#define RTC                 (&host_rtc)
+
+#define RTC_HOURFORMAT_24           0x00000000U
+#define RTC_HOURFORMAT_12           0x00000040U
+#define RTC_HOURFORMAT12_AM         ((uint8_t)0x00)
+#define RTC_HOURFORMAT12_PM         ((uint8_t)0x01)
+#define RTC_FORMAT_BIN              0x00000000U
+#define RTC_FORMAT_BCD              0x00000001U
+#define RTC_OUTPUT_DISABLE          0x00000000U
+#define RTC_OUTPUT_POLARITY_HIGH    0x00000000U
+#define RTC_OUTPUT_TYPE_OPENDRAIN   0x00000000U
+#define RTC_DAYLIGHTSAVING_NONE     0x00000000U
+#define RTC_STOREOPERATION_RESET    0x00000000U
+#define RTC_WAKEUPCLOCK_CK_SPRE_16BITS 0x00000004U
+
+#define RTC_TR_SU_Pos   0U
+#define RTC_TR_SU_Msk   (0xFUL << RTC_TR_SU_Pos)
+#define RTC_TR_ST_Pos   4U
+#define RTC_TR_ST_Msk   (0x7UL << RTC_TR_ST_Pos)
+#define RTC_TR_MNU_Pos  8U
+#define RTC_TR_MNU_Msk  (0xFUL << RTC_TR_MNU_Pos)
+#define RTC_TR_MNT_Pos  12U
+#define RTC_TR_MNT_Msk  (0x7UL << RTC_TR_MNT_Pos)
+#define RTC_TR_HU_Pos   16U
+#define RTC_TR_HU_Msk   (0xFUL << RTC_TR_HU_Pos)
+#define RTC_TR_HT_Pos   20U
+#define RTC_TR_HT_Msk   (0x3UL << RTC_TR_HT_Pos)
+#define RTC_TR_PM_Pos   22U
+#define RTC_TR_PM_Msk   (0x1UL << RTC_TR_PM_Pos)
+#define RTC_DR_DU_Pos   0U
+#define RTC_DR_DU_Msk   (0xFUL << RTC_DR_DU_Pos)
+#define RTC_DR_DT_Pos   4U
+#define RTC_DR_DT_Msk   (0x3UL << RTC_DR_DT_Pos)
+#define RTC_DR_MU_Pos   8U
+#define RTC_DR_MU_Msk   (0xFUL << RTC_DR_MU_Pos)
+#define RTC_DR_MT_Pos   12U
+#define RTC_DR_MT_Msk   (0x1UL << RTC_DR_MT_Pos)
+#define RTC_DR_WDU_Pos  13U
+#define RTC_DR_WDU_Msk  (0x7UL << RTC_DR_WDU_Pos)
+#define RTC_DR_YU_Pos   16U
+#define RTC_DR_YU_Msk   (0xFUL << RTC_DR_YU_Pos)
+#define RTC_DR_YT_Pos   20U
+#define RTC_DR_YT_Msk   (0xFUL << RTC_DR_YT_Pos)
+#define RTC_CR_BYPSHAD  (1UL << 5)
+
+#define __HAL_RTC_WRITEPROTECTION_DISABLE(h)                                  \
+    do { (h)->Instance->WPR = 0xCAU; (h)->Instance->WPR = 0x53U; } while (0)
+#define __HAL_RTC_WRITEPROTECTION_ENABLE(h)                                   \
+    do { (h)->Instance->WPR = 0xFFU; } while (0)
+
+HAL_StatusTypeDef HAL_RTC_Init(RTC_HandleTypeDef *hrtc);
+HAL_StatusTypeDef HAL_RTC_SetTime(RTC_HandleTypeDef *hrtc,
+                                  RTC_TimeTypeDef *sTime, uint32_t Format);
+HAL_StatusTypeDef HAL_RTC_GetTime(RTC_HandleTypeDef *hrtc,
+                                  RTC_TimeTypeDef *sTime, uint32_t Format);
+HAL_StatusTypeDef HAL_RTC_SetDate(RTC_HandleTypeDef *hrtc,
+                                  RTC_DateTypeDef *sDate, uint32_t Format);
+HAL_StatusTypeDef HAL_RTC_GetDate(RTC_HandleTypeDef *hrtc,
+                                  RTC_DateTypeDef *sDate, uint32_t Format);
+HAL_StatusTypeDef HAL_RTCEx_SetWakeUpTimer_IT(RTC_HandleTypeDef *hrtc,
+                                              uint32_t WakeUpCounter,
+                                              uint32_t WakeUpClock);
+void HAL_RTC_MspInit(RTC_HandleTypeDef *hrtc);
+void HAL_RTC_MspDeInit(RTC_HandleTypeDef *hrtc);
+void HAL_RTCEx_WakeUpTimerEventCallback(RTC_HandleTypeDef *hrtc);
+
+/* ========================== HAL Core ================================= */
+HAL_StatusTypeDef HAL_Init(void);
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority);
+void              HAL_MspInit(void);
+void              HAL_IncTick(void);
+uint32_t          HAL_GetTick(void);
+void              HAL_Delay(uint32_t Delay);
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct,
+                                      uint32_t FLatency);
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit);
+uint32_t          HAL_RCC_GetHCLKFreq(void);
+uint32_t          HAL_RCC_GetPCLK1Freq(void);
+uint32_t          HAL_RCC_GetPCLK2Freq(void);
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority,
+                          uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+#endif /* STM32F4XX_HAL_H */
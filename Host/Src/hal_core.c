@@ -0,0 +1,577 @@
+/**
+ ******************************************************************************
+ * @file           : hal_core.c  (host build)
+ * @brief          : HAL core, RCC, NVIC, GPIO, DMA and TIM stubs, and the
+ *                   CMSIS debug blocks (DWT, ITM), for the Linux build.
+ *
+ * @description    : Register blocks are plain structs, so code that pokes
+ *                   registers directly (TIM4->CCR1, GPIOD->BSRR) compiles
+ *                   and runs; only what a demo can observe is modelled:
+ *
+ *                     SystemCoreClock   follows SystemClock_Config()
+ *                     RCC->CFGR         APB prescalers from ClockConfig
+ *                     GPIO              ODR/IDR via the HAL calls; set
+ *                                       HOST_TRACE_GPIO=1 to log port D
+ *                     B1 (PA0)          kill -USR1 <pid> presses it: EXTI0
+ *                     DWT->CYCCNT       host monotonic clock in CPU cycles
+ *                     ITM               TCR = 0, as with no debugger
+ *                     TIM7              update interrupts at the PSC / ARR
+ *                                       rate while CEN and UIE are set
+ *                     DMA / TIM         handle states only, no transfers
+ ******************************************************************************
+ */
+
+#include "host_hal.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* ========================== Register Blocks ============================= */
+uint32_t           SystemCoreClock = 16000000U;   /* HSI until clock setup  */
+volatile uint32_t  uwTick;
+
+RCC_TypeDef        host_rcc;
+GPIO_TypeDef       host_gpio[8];
+DMA_Stream_TypeDef host_dma1_stream[8];
+DMA_Stream_TypeDef host_dma2_stream[8];
+TIM_TypeDef        host_tim4;
+TIM_TypeDef        host_tim6;
+TIM_TypeDef        host_tim7;
+CoreDebug_Type     host_core_debug;
+ITM_Type           host_itm;
+
+/* ========================== Private Data =============================== */
+#define HOST_HSI_HZ         16000000U
+
+static pthread_mutex_t host_mutex = PTHREAD_MUTEX_INITIALIZER;
+static DWT_Type        host_dwt_regs;
+static uint64_t        host_start_ns;
+static uint32_t        host_pll_hz = HOST_HSI_HZ;
+static int             host_trace_gpio;
+
+/* ========================== Host Helpers =============================== */
+
+void host_lock(host_lock_t *lk)
+{
+    lk->mask = xPortSetInterruptMask();
+    pthread_mutex_lock(&host_mutex);
+}
+
+void host_unlock(host_lock_t *lk)
+{
+    pthread_mutex_unlock(&host_mutex);
+    vPortClearInterruptMask(lk->mask);
+}
+
+uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void host_busy_until(uint64_t deadline_ns)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = (time_t)(deadline_ns / 1000000000ULL);
+    ts.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+
+    /* Sleeping stands in for spinning: an interrupt (EINTR) may switch
+     * tasks, and the rest of the wait resumes when this one runs again */
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+int host_env_flag(const char *name, int fallback)
+{
+    const char *value = getenv(name);
+
+    if (value == NULL || value[0] == '\0') {
+        return fallback;
+    }
+    return atoi(value) != 0;
+}
+
+void host_halt(const char *file, int line)
+{
+    fflush(stdout);
+    fprintf(stderr, "[host] Error_Handler() at %s:%d\n", file, line);
+    abort();
+}
+
+void host_assert_failed(const char *file, int line)
+{
+    fflush(stdout);
+    fprintf(stderr, "[host] configASSERT failed at %s:%d\n", file, line);
+    abort();
+}
+
+#if HOST_IDLE_HOOK
+void vApplicationIdleHook(void)
+{
+    vPortHostIdle();
+}
+#endif
+
+/* ========================== DWT ======================================== */
+
+DWT_Type *host_dwt(void)
+{
+    if ((host_dwt_regs.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0U) {
+        uint64_t ns = host_now_ns() - host_start_ns;
+
+        /* Cycles of a core running at SystemCoreClock, so cycle figures
+         * read like the target's (wraps like CYCCNT) */
+        host_dwt_regs.CYCCNT =
+            (uint32_t)(ns * (SystemCoreClock / 1000000U) / 1000U);
+    }
+    return &host_dwt_regs;
+}
+
+/* ========================== B1 Button (EXTI0) ========================== */
+
+/* The TASK demo's EXTI0_IRQHandler (stm32f4xx_it.c, not built here) calls
+ * this before the HAL handler; the other demos declare it but never define
+ * it, so the weak reference stays NULL for them */
+extern void button_interrupt_handler(void) __attribute__((weak));
+
+static void host_exti0_isr(void)
+{
+    if (button_interrupt_handler != NULL) {
+        button_interrupt_handler();
+    }
+    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_0);
+}
+
+/**
+ * @brief  SIGUSR1 presses B1: PA0 reads high for 50 ms and EXTI0 fires.
+ */
+static void *host_button_thread(void *arg)
+{
+    sigset_t set;
+    int      sig;
+
+    (void)arg;
+    sigemptyset(&set);
+    sigaddset(&set, SIGUSR1);
+
+    for (;;) {
+        host_lock_t lk;
+
+        if (sigwait(&set, &sig) != 0) {
+            continue;
+        }
+
+        host_lock(&lk);
+        GPIOA->IDR |= GPIO_PIN_0;
+        host_unlock(&lk);
+        vPortHostRaiseInterrupt(HOST_IRQ_EXTI0);
+
+        usleep(50000);
+
+        host_lock(&lk);
+        GPIOA->IDR &= ~(uint32_t)GPIO_PIN_0;
+        host_unlock(&lk);
+    }
+    return NULL;
+}
+
+/* ========================== HAL Core =================================== */
+
+__attribute__((weak)) void HAL_MspInit(void)
+{
+}
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+    pthread_t thread;
+    sigset_t  set;
+
+    host_start_ns   = host_now_ns();
+    host_trace_gpio = host_env_flag("HOST_TRACE_GPIO", 0);
+
+    /* Demo output goes out a line at a time, as on a terminal */
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    /* Only the button thread takes SIGUSR1; every thread started from here
+     * on inherits the block */
+    sigemptyset(&set);
+    sigaddset(&set, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+    vPortHostSetInterruptHandler(HOST_IRQ_EXTI0, host_exti0_isr);
+    pthread_create(&thread, NULL, host_button_thread, NULL);
+    pthread_detach(thread);
+
+    fprintf(stderr, "[host] pid %d (kill -USR1 %d presses B1)\n",
+            (int)getpid(), (int)getpid());
+
+    HAL_MspInit();
+    return HAL_InitTick(15U);
+}
+
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+    (void)TickPriority;
+    return HAL_OK;
+}
+
+void HAL_IncTick(void)
+{
+    uwTick++;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)((host_now_ns() - host_start_ns) / 1000000ULL);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    host_busy_until(host_now_ns() + (uint64_t)Delay * 1000000ULL);
+}
+
+/* ========================== RCC ======================================== */
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct)
+{
+    const RCC_PLLInitTypeDef *pll = &RCC_OscInitStruct->PLL;
+
+    if (pll->PLLState == RCC_PLL_ON && pll->PLLM != 0U && pll->PLLP != 0U) {
+        host_pll_hz = HOST_HSI_HZ / pll->PLLM * pll->PLLN / pll->PLLP;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct,
+                                      uint32_t FLatency)
+{
+    (void)FLatency;
+
+    if (RCC_ClkInitStruct->SYSCLKSource == RCC_SYSCLKSOURCE_PLLCLK) {
+        SystemCoreClock = host_pll_hz;
+    }
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2,
+               RCC_ClkInitStruct->APB1CLKDivider |
+               (RCC_ClkInitStruct->APB2CLKDivider << 3));
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit)
+{
+    (void)PeriphClkInit;
+    return HAL_OK;
+}
+
+/**
+ * @brief  APB divider from a PPREx field: 0xx = 1, 100 = 2 ... 111 = 16.
+ */
+static uint32_t host_apb_div(uint32_t ppre)
+{
+    return (ppre < 4U) ? 1U : (1U << (ppre - 3U));
+}
+
+uint32_t HAL_RCC_GetHCLKFreq(void)
+{
+    return SystemCoreClock;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return SystemCoreClock /
+           host_apb_div((RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos);
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void)
+{
+    return SystemCoreClock /
+           host_apb_div((RCC->CFGR & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos);
+}
+
+/* ========================== NVIC ======================================= */
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority,
+                          uint32_t SubPriority)
+{
+    (void)IRQn;
+    (void)PreemptPriority;
+    (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+/* ========================== GPIO ======================================= */
+
+/**
+ * @brief  Log output changes on port D (the four LEDs) when tracing.
+ */
+static void gpio_trace(GPIO_TypeDef *port, uint32_t before)
+{
+    uint32_t changed = (before ^ port->ODR) & 0xF000U;
+
+    if (!host_trace_gpio || port != GPIOD || changed == 0U) {
+        return;
+    }
+    for (uint32_t pin = 12; pin < 16; pin++) {
+        if ((changed & (1UL << pin)) != 0U) {
+            fprintf(stderr, "[gpio] PD%lu=%lu\n", (unsigned long)pin,
+                    (unsigned long)((port->ODR >> pin) & 1U));
+        }
+    }
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    (void)GPIOx;
+    (void)GPIO_Init;
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
+{
+    (void)GPIOx;
+    (void)GPIO_Pin;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return ((GPIOx->IDR & GPIO_Pin) != 0U) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+                       GPIO_PinState PinState)
+{
+    host_lock_t lk;
+    uint32_t    before;
+
+    host_lock(&lk);
+    before = GPIOx->ODR;
+    if (PinState != GPIO_PIN_RESET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+    gpio_trace(GPIOx, before);
+    host_unlock(&lk);
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    host_lock_t lk;
+    uint32_t    before;
+
+    host_lock(&lk);
+    before      = GPIOx->ODR;
+    GPIOx->ODR ^= GPIO_Pin;
+    gpio_trace(GPIOx, before);
+    host_unlock(&lk);
+}
+
+__attribute__((weak)) void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    (void)GPIO_Pin;
+}
+
+void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin)
+{
+    HAL_GPIO_EXTI_Callback(GPIO_Pin);
+}
+
+/* ========================== DMA ======================================== */
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma)
+{
+    hdma->State = HAL_DMA_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress,
+                                uint32_t DstAddress, uint32_t DataLength)
+{
+    (void)SrcAddress;
+    (void)DstAddress;
+
+    if (hdma->State != HAL_DMA_STATE_READY) {
+        return HAL_BUSY;
+    }
+    hdma->Instance->NDTR = DataLength;
+    hdma->State          = HAL_DMA_STATE_BUSY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+/* ========================== TIM ======================================== */
+
+/* The UART demo's TIM7_IRQHandler (stm32f4xx_it.c, not built here) is this
+ * one call; the other demos never start TIM7 */
+extern void isr_bench_timer_irq(void) __attribute__((weak));
+
+static void host_tim7_isr(void)
+{
+    if (isr_bench_timer_irq != NULL) {
+        isr_bench_timer_irq();
+    } else {
+        TIM7->SR &= ~TIM_SR_UIF;
+    }
+}
+
+/**
+ * @brief  Update period of an APB1 timer: the timer clock is PCLK1, doubled
+ *         when the APB1 prescaler divides, as on the target.
+ */
+static uint64_t host_tim_period_ns(const TIM_TypeDef *tim)
+{
+    uint64_t tim_hz = HAL_RCC_GetPCLK1Freq();
+
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        tim_hz *= 2U;
+    }
+    return ((uint64_t)tim->PSC + 1U) * ((uint64_t)tim->ARR + 1U) *
+           1000000000ULL / tim_hz;
+}
+
+/**
+ * @brief  TIM7 update events: UIF set and the line raised once per period
+ *         while the counter and its update interrupt are enabled.
+ */
+static void *host_tim7_thread(void *arg)
+{
+    uint64_t next = host_now_ns();
+
+    (void)arg;
+
+    for (;;) {
+        host_lock_t lk;
+        uint64_t    period;
+        int         fire;
+
+        host_lock(&lk);
+        fire   = (TIM7->CR1 & TIM_CR1_CEN) != 0U &&
+                 (TIM7->DIER & TIM_DIER_UIE) != 0U;
+        period = host_tim_period_ns(TIM7);
+        host_unlock(&lk);
+
+        if (!fire) {
+            usleep(1000);
+            next = host_now_ns();
+            continue;
+        }
+
+        /* A late wakeup starts a new period rather than firing a burst */
+        next += period;
+        if (next < host_now_ns()) {
+            next = host_now_ns();
+        }
+        host_busy_until(next);
+
+        host_lock(&lk);
+        fire = (TIM7->CR1 & TIM_CR1_CEN) != 0U &&
+               (TIM7->DIER & TIM_DIER_UIE) != 0U;
+        if (fire) {
+            TIM7->SR |= TIM_SR_UIF;
+        }
+        host_unlock(&lk);
+
+        if (fire) {
+            vPortHostRaiseInterrupt(HOST_IRQ_TIM7);
+        }
+    }
+    return NULL;
+}
+
+__attribute__((weak)) void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+__attribute__((weak)) void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->PSC = htim->Init.Prescaler;
+    htim->Instance->ARR = htim->Init.Period;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+    static int tim7_running;
+
+    if (htim->Instance == TIM7 && !tim7_running) {
+        pthread_t thread;
+
+        tim7_running = 1;
+        vPortHostSetInterruptHandler(HOST_IRQ_TIM7, host_tim7_isr);
+        pthread_create(&thread, NULL, host_tim7_thread, NULL);
+        pthread_detach(thread);
+    }
+    htim->Instance->DIER |= TIM_DIER_UIE;
+    htim->Instance->CR1  |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->DIER &= ~TIM_DIER_UIE;
+    htim->Instance->CR1  &= ~TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim)
+{
+    HAL_TIM_PWM_MspInit(htim);     /* Links the CC1 DMA handle (msp.c)      */
+    return HAL_TIM_Base_Init(htim);
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim,
+                                            const TIM_OC_InitTypeDef *sConfig,
+                                            uint32_t Channel)
+{
+    volatile uint32_t *ccr = &htim->Instance->CCR1 + (Channel >> 2);
+
+    *ccr = sConfig->Pulse;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    htim->Instance->CCER |= 1UL << Channel;
+    htim->Instance->CR1  |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
+{
+    HAL_TIM_PeriodElapsedCallback(htim);
+}
@@ -0,0 +1,343 @@
+/**
+ ******************************************************************************
+ * @file           : hal_rtc.c  (host build)
+ * @brief          : RTC calendar and wakeup timer, ticking with the host
+ *                   clock.
+ *
+ * @description    : HAL_RTC_Init() starts the calendar at the host's local
+ *                   time (the board starts at 00:00:00 on 1 Jan 2000; a
+ *                   demo that sets the clock overrides either).  A host
+ *                   thread advances it on every real second, rewrites TR
+ *                   and DR in BCD exactly as the hardware lays them out, and
+ *                   raises the wakeup interrupt when the wakeup timer is
+ *                   armed on ck_spre.
+ *
+ *                   The calendar is kept in 24-hour form; HourFormat 12
+ *                   converts at the HAL boundary and sets the PM bit in TR.
+ ******************************************************************************
+ */
+
+#include "host_hal.h"
+
+#include <pthread.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+
+RTC_TypeDef host_rtc;
+
+/* ========================== Private Data =============================== */
+static RTC_HandleTypeDef *rtc;
+static struct {
+    uint8_t hours;                 /* 0..23                                  */
+    uint8_t minutes;
+    uint8_t seconds;
+    uint8_t weekday;               /* 1 = Monday .. 7 = Sunday               */
+    uint8_t date;                  /* 1..31                                  */
+    uint8_t month;                 /* 1..12                                  */
+    uint8_t year;                  /* 0..99 (2000..2099)                     */
+} cal;
+static volatile uint32_t wakeup_period;    /* Seconds, 0 = disarmed         */
+static uint32_t          wakeup_count;
+
+/* ========================== Private Helpers ============================ */
+
+static uint8_t to_bcd(uint8_t v)
+{
+    return (uint8_t)(((v / 10U) << 4) | (v % 10U));
+}
+
+static uint8_t from_bcd(uint8_t v)
+{
+    return (uint8_t)((v >> 4) * 10U + (v & 0x0FU));
+}
+
+static int is_12h(void)
+{
+    return rtc != NULL && rtc->Init.HourFormat == RTC_HOURFORMAT_12;
+}
+
+/**
+ * @brief  Rewrite TR and DR from the calendar.  Caller holds host_lock.
+ */
+static void regs_update(void)
+{
+    uint8_t  hours = cal.hours;
+    uint32_t pm    = 0;
+
+    if (is_12h()) {
+        pm    = (hours >= 12U);
+        hours = (uint8_t)(hours % 12U);
+        if (hours == 0U) {
+            hours = 12U;
+        }
+    }
+
+    RTC->TR = ((uint32_t)to_bcd(hours) << RTC_TR_HU_Pos)
+            | ((uint32_t)to_bcd(cal.minutes) << RTC_TR_MNU_Pos)
+            | ((uint32_t)to_bcd(cal.seconds) << RTC_TR_SU_Pos)
+            | (pm << RTC_TR_PM_Pos);
+    RTC->DR = ((uint32_t)to_bcd(cal.year) << RTC_DR_YU_Pos)
+            | ((uint32_t)cal.weekday << RTC_DR_WDU_Pos)
+            | ((uint32_t)to_bcd(cal.month) << RTC_DR_MU_Pos)
+            | ((uint32_t)to_bcd(cal.date) << RTC_DR_DU_Pos);
+}
+
+static uint8_t days_in_month(void)
+{
+    static const uint8_t days[12] = { 31, 28, 31, 30, 31, 30,
+                                      31, 31, 30, 31, 30, 31 };
+
+    if (cal.month == 2U && (cal.year % 4U) == 0U) {
+        return 29;                 /* Every 4th year: 2000..2099 only        */
+    }
+    return days[(cal.month - 1U) % 12U];
+}
+
+/**
+ * @brief  One calendar second, with every carry the hardware does.
+ */
+static void cal_tick(void)
+{
+    if (++cal.seconds < 60U) {
+        return;
+    }
+    cal.seconds = 0;
+    if (++cal.minutes < 60U) {
+        return;
+    }
+    cal.minutes = 0;
+    if (++cal.hours < 24U) {
+        return;
+    }
+    cal.hours   = 0;
+    cal.weekday = (uint8_t)(cal.weekday % 7U + 1U);
+    if (++cal.date <= days_in_month()) {
+        return;
+    }
+    cal.date = 1;
+    if (++cal.month <= 12U) {
+        return;
+    }
+    cal.month = 1;
+    cal.year  = (uint8_t)((cal.year + 1U) % 100U);
+}
+
+static void rtc_wkup_isr(void)
+{
+    HAL_RTCEx_WakeUpTimerEventCallback(rtc);
+}
+
+/**
+ * @brief  ck_spre: one calendar second per host second.
+ */
+static void *rtc_thread(void *arg)
+{
+    uint64_t next = host_now_ns();
+
+    (void)arg;
+
+    for (;;) {
+        host_lock_t lk;
+        int         wake = 0;
+
+        next += 1000000000ULL;
+        host_busy_until(next);
+
+        host_lock(&lk);
+        cal_tick();
+        regs_update();
+        if (wakeup_period != 0U && ++wakeup_count >= wakeup_period) {
+            wakeup_count = 0;
+            wake         = 1;
+        }
+        host_unlock(&lk);
+
+        if (wake) {
+            vPortHostRaiseInterrupt(HOST_IRQ_RTC_WKUP);
+        }
+    }
+    return NULL;
+}
+
+/* ========================== HAL API ==================================== */
+
+__attribute__((weak)) void HAL_RTC_MspInit(RTC_HandleTypeDef *hrtc)
+{
+    (void)hrtc;
+}
+
+__attribute__((weak)) void HAL_RTCEx_WakeUpTimerEventCallback(RTC_HandleTypeDef *hrtc)
+{
+    (void)hrtc;
+}
+
+HAL_StatusTypeDef HAL_RTC_Init(RTC_HandleTypeDef *hrtc)
+{
+    pthread_t   thread;
+    host_lock_t lk;
+    time_t      now = time(NULL);
+    struct tm   tm;
+
+    if (hrtc->Instance != RTC || rtc != NULL) {
+        return HAL_ERROR;
+    }
+
+    HAL_RTC_MspInit(hrtc);
+
+    localtime_r(&now, &tm);
+
+    host_lock(&lk);
+    rtc         = hrtc;
+    cal.hours   = (uint8_t)tm.tm_hour;
+    cal.minutes = (uint8_t)tm.tm_min;
+    cal.seconds = (uint8_t)tm.tm_sec;
+    cal.weekday = (uint8_t)(tm.tm_wday == 0 ? 7 : tm.tm_wday);
+    cal.date    = (uint8_t)tm.tm_mday;
+    cal.month   = (uint8_t)(tm.tm_mon + 1);
+    cal.year    = (uint8_t)(tm.tm_year % 100);
+    RTC->PRER   = (hrtc->Init.AsynchPrediv << 16) | hrtc->Init.SynchPrediv;
+    regs_update();
+    host_unlock(&lk);
+
+    vPortHostSetInterruptHandler(HOST_IRQ_RTC_WKUP, rtc_wkup_isr);
+    pthread_create(&thread, NULL, rtc_thread, NULL);
+    pthread_detach(thread);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_SetTime(RTC_HandleTypeDef *hrtc,
+                                  RTC_TimeTypeDef *sTime, uint32_t Format)
+{
+    host_lock_t lk;
+    uint8_t     hours   = sTime->Hours;
+    uint8_t     minutes = sTime->Minutes;
+    uint8_t     seconds = sTime->Seconds;
+
+    (void)hrtc;
+
+    if (Format == RTC_FORMAT_BCD) {
+        hours   = from_bcd(hours);
+        minutes = from_bcd(minutes);
+        seconds = from_bcd(seconds);
+    }
+    if (is_12h()) {
+        hours = (uint8_t)(hours % 12U);
+        if (sTime->TimeFormat == RTC_HOURFORMAT12_PM) {
+            hours = (uint8_t)(hours + 12U);
+        }
+    }
+    if (hours > 23U || minutes > 59U || seconds > 59U) {
+        return HAL_ERROR;
+    }
+
+    host_lock(&lk);
+    cal.hours    = hours;
+    cal.minutes  = minutes;
+    cal.seconds  = seconds;
+    wakeup_count = 0;              /* Prescalers restart on a calendar write */
+    regs_update();
+    host_unlock(&lk);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_GetTime(RTC_HandleTypeDef *hrtc,
+                                  RTC_TimeTypeDef *sTime, uint32_t Format)
+{
+    host_lock_t lk;
+    uint32_t    tr;
+
+    (void)hrtc;
+
+    host_lock(&lk);
+    tr = RTC->TR;
+    host_unlock(&lk);
+
+    sTime->Hours      = (uint8_t)((tr & (RTC_TR_HT_Msk | RTC_TR_HU_Msk)) >> RTC_TR_HU_Pos);
+    sTime->Minutes    = (uint8_t)((tr & (RTC_TR_MNT_Msk | RTC_TR_MNU_Msk)) >> RTC_TR_MNU_Pos);
+    sTime->Seconds    = (uint8_t)((tr & (RTC_TR_ST_Msk | RTC_TR_SU_Msk)) >> RTC_TR_SU_Pos);
+    sTime->TimeFormat = (uint8_t)((tr & RTC_TR_PM_Msk) >> RTC_TR_PM_Pos);
+    sTime->SubSeconds = 0;
+
+    if (Format == RTC_FORMAT_BIN) {
+        sTime->Hours   = from_bcd(sTime->Hours);
+        sTime->Minutes = from_bcd(sTime->Minutes);
+        sTime->Seconds = from_bcd(sTime->Seconds);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_SetDate(RTC_HandleTypeDef *hrtc,
+                                  RTC_DateTypeDef *sDate, uint32_t Format)
+{
+    host_lock_t lk;
+    uint8_t     date  = sDate->Date;
+    uint8_t     month = sDate->Month;
+    uint8_t     year  = sDate->Year;
+
+    (void)hrtc;
+
+    if (Format == RTC_FORMAT_BCD) {
+        date  = from_bcd(date);
+        month = from_bcd(month);
+        year  = from_bcd(year);
+    }
+    if (date < 1U || date > 31U || month < 1U || month > 12U || year > 99U ||
+        sDate->WeekDay < 1U || sDate->WeekDay > 7U) {
+        return HAL_ERROR;
+    }
+
+    host_lock(&lk);
+    cal.date    = date;
+    cal.month   = month;
+    cal.year    = year;
+    cal.weekday = sDate->WeekDay;
+    regs_update();
+    host_unlock(&lk);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTC_GetDate(RTC_HandleTypeDef *hrtc,
+                                  RTC_DateTypeDef *sDate, uint32_t Format)
+{
+    host_lock_t lk;
+    uint32_t    dr;
+
+    (void)hrtc;
+
+    host_lock(&lk);
+    dr = RTC->DR;
+    host_unlock(&lk);
+
+    sDate->Year    = (uint8_t)((dr & (RTC_DR_YT_Msk | RTC_DR_YU_Msk)) >> RTC_DR_YU_Pos);
+    sDate->Month   = (uint8_t)((dr & (RTC_DR_MT_Msk | RTC_DR_MU_Msk)) >> RTC_DR_MU_Pos);
+    sDate->Date    = (uint8_t)((dr & (RTC_DR_DT_Msk | RTC_DR_DU_Msk)) >> RTC_DR_DU_Pos);
+    sDate->WeekDay = (uint8_t)((dr & RTC_DR_WDU_Msk) >> RTC_DR_WDU_Pos);
+
+    if (Format == RTC_FORMAT_BIN) {
+        sDate->Year  = from_bcd(sDate->Year);
+        sDate->Month = from_bcd(sDate->Month);
+        sDate->Date  = from_bcd(sDate->Date);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RTCEx_SetWakeUpTimer_IT(RTC_HandleTypeDef *hrtc,
+                                              uint32_t WakeUpCounter,
+                                              uint32_t WakeUpClock)
+{
+    host_lock_t lk;
+
+    /* Only ck_spre (1 Hz) is modelled; RTCCLK/n wakeups would need a
+     * sub-second calendar */
+    if (hrtc != rtc || WakeUpClock != RTC_WAKEUPCLOCK_CK_SPRE_16BITS) {
+        return HAL_ERROR;
+    }
+
+    host_lock(&lk);
+    RTC->WUTR     = WakeUpCounter;
+    wakeup_count  = 0;
+    wakeup_period = WakeUpCounter + 1U;
+    host_unlock(&lk);
+    return HAL_OK;
+}
@@ -0,0 +1,428 @@
+/**
+ ******************************************************************************
+ * @file           : hal_uart.c  (host build)
+ * @brief          : USART2 on a pseudo-terminal.
+ *
+ * @description    : HAL_UART_Init() opens a pty and prints the slave path;
+ *                   connect any terminal to it (screen, picocom, minicom):
+ *
+ *                     [host] USART2 on /dev/pts/7
+ *                     $ picocom -b 115200 /dev/pts/7
+ *
+ *                   Set HOST_UART_LINK=/tmp/ttyDEMO to also get a stable
+ *                   symlink to the slave.
+ *
+ *                   The line runs at huart->Init.BaudRate: each byte costs
+ *                   ten bit times, spent busy in HAL_UART_Transmit() and in
+ *                   the background for DMA transfers, so output pacing and
+ *                   task timing match the board.  HOST_UART_PACE=0 sends at
+ *                   host speed instead.  Like a real UART with nothing
+ *                   attached, bytes nobody reads are lost, never blocking.
+ *
+ *                   Reception, one reader thread raising the RX line:
+ *                     HAL_UART_Receive_IT         byte by byte, RxCplt when
+ *                                                 the count is reached
+ *                     HAL_UARTEx_ReceiveToIdle_DMA  circular buffer, RxEvent
+ *                                                 at the end of every burst
+ *                                                 (IDLE) and of the buffer
+ ******************************************************************************
+ */
+
+#define _GNU_SOURCE
+#include "host_hal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+
+USART_TypeDef host_usart2;
+
+/* ========================== Private Types ============================== */
+typedef enum {
+    RX_IDLE = 0,                   /* Nothing armed: bytes are overruns      */
+    RX_IT,                         /* HAL_UART_Receive_IT                    */
+    RX_TO_IDLE_DMA                 /* HAL_UARTEx_ReceiveToIdle_DMA, circular */
+} rx_mode_t;
+
+/* ========================== Private Data =============================== */
+static UART_HandleTypeDef *uart;   /* The one modelled handle (USART2)       */
+static int                 pty_master = -1;
+static int                 pty_slave  = -1;
+static int                 uart_pace;
+
+static pthread_cond_t      rx_armed = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t     rx_mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile rx_mode_t  rx_mode;
+static volatile uint16_t   rx_pos;         /* DMA write index               */
+static volatile uint16_t   rx_event_pos;   /* Size argument for RxEvent     */
+static volatile int        rx_cplt;        /* Receive_IT count reached      */
+
+static pthread_cond_t      tx_cond  = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t     tx_mutex = PTHREAD_MUTEX_INITIALIZER;
+static const uint8_t      *tx_data;        /* Pending DMA transfer          */
+static uint16_t            tx_len;
+
+/* ========================== Line Model ================================= */
+
+/**
+ * @brief  Nanoseconds the line needs for len bytes (8N1: 10 bits each).
+ */
+static uint64_t line_ns(uint32_t len)
+{
+    if (!uart_pace || uart->Init.BaudRate == 0U) {
+        return 0;
+    }
+    return (uint64_t)len * 10ULL * 1000000000ULL / uart->Init.BaudRate;
+}
+
+/**
+ * @brief  Put bytes on the wire.  A full pty buffer means nobody is
+ *         reading: the rest is dropped, as a UART would.
+ */
+static void line_write(const uint8_t *data, uint32_t len)
+{
+    while (len > 0U) {
+        ssize_t n = write(pty_master, data, len);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;                /* EAGAIN / EIO: nobody listening         */
+        }
+        data += n;
+        len  -= (uint32_t)n;
+    }
+}
+
+/* ========================== Interrupts ================================= */
+
+static void uart_rx_isr(void)
+{
+    host_lock_t lk;
+    rx_mode_t   mode;
+    uint16_t    pos;
+    int         cplt;
+
+    host_lock(&lk);
+    mode    = rx_mode;
+    pos     = rx_event_pos;
+    cplt    = rx_cplt;
+    rx_cplt = 0;
+    if (cplt) {
+        rx_mode       = RX_IDLE;
+        uart->RxState = HAL_UART_STATE_READY;
+    }
+    host_unlock(&lk);
+
+    if (mode == RX_TO_IDLE_DMA) {
+        HAL_UARTEx_RxEventCallback(uart, pos);
+    } else if (cplt) {
+        HAL_UART_RxCpltCallback(uart);
+    }
+}
+
+static void uart_tx_isr(void)
+{
+    uart->gState = HAL_UART_STATE_READY;
+    HAL_UART_TxCpltCallback(uart);
+}
+
+/* ========================== Host Threads =============================== */
+
+/**
+ * @brief  Deliver received bytes to whatever reception is armed.
+ */
+static void rx_deliver(const uint8_t *data, ssize_t len)
+{
+    for (ssize_t i = 0; i < len; i++) {
+        host_lock_t lk;
+        int         raise = 0;
+
+        /* Receive_IT: wait (briefly) for the callback to re-arm */
+        pthread_mutex_lock(&rx_mutex);
+        if (rx_mode == RX_IDLE) {
+            struct timespec ts;
+
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += 20000000L;
+            if (ts.tv_nsec >= 1000000000L) {
+                ts.tv_nsec -= 1000000000L;
+                ts.tv_sec++;
+            }
+            while (rx_mode == RX_IDLE &&
+                   pthread_cond_timedwait(&rx_armed, &rx_mutex, &ts) == 0) {
+            }
+        }
+        pthread_mutex_unlock(&rx_mutex);
+
+        host_lock(&lk);
+        if (rx_mode == RX_IT) {
+            uart->pRxBuffPtr[uart->RxXferSize - uart->RxXferCount] = data[i];
+            if (--uart->RxXferCount == 0U) {
+                rx_cplt = 1;
+                raise   = 1;
+            }
+        } else if (rx_mode == RX_TO_IDLE_DMA) {
+            uart->pRxBuffPtr[rx_pos++] = data[i];
+            if (rx_pos == uart->RxXferSize) {
+                /* Transfer complete: Size is the whole buffer, DMA wraps */
+                rx_event_pos = rx_pos;
+                rx_pos       = 0;
+                raise        = 1;
+            } else if (i == len - 1) {
+                rx_event_pos = rx_pos;   /* IDLE after the burst            */
+                raise        = 1;
+            }
+        }
+        /* else: overrun, byte lost */
+        host_unlock(&lk);
+
+        if (raise) {
+            vPortHostRaiseInterrupt(HOST_IRQ_USART2_RX);
+        }
+    }
+}
+
+static void *uart_rx_thread(void *arg)
+{
+    struct pollfd pfd = { .fd = pty_master, .events = POLLIN };
+    uint8_t       buf[64];
+
+    (void)arg;
+
+    for (;;) {
+        ssize_t n;
+
+        if (poll(&pfd, 1, -1) <= 0) {
+            continue;
+        }
+        n = read(pty_master, buf, sizeof(buf));
+        if (n <= 0) {
+            usleep(10000);
+            continue;
+        }
+
+        /* Let the bytes arrive no faster than the line could carry them */
+        host_busy_until(host_now_ns() + line_ns((uint32_t)n));
+        rx_deliver(buf, n);
+    }
+    return NULL;
+}
+
+static void *uart_tx_thread(void *arg)
+{
+    (void)arg;
+
+    for (;;) {
+        const uint8_t *data;
+        uint16_t       len;
+        uint64_t       deadline;
+
+        pthread_mutex_lock(&tx_mutex);
+        while (tx_data == NULL) {
+            pthread_cond_wait(&tx_cond, &tx_mutex);
+        }
+        data = tx_data;
+        len  = tx_len;
+        pthread_mutex_unlock(&tx_mutex);
+
+        deadline = host_now_ns() + line_ns(len);
+        line_write(data, len);
+        host_busy_until(deadline);
+
+        pthread_mutex_lock(&tx_mutex);
+        tx_data = NULL;
+        pthread_mutex_unlock(&tx_mutex);
+
+        vPortHostRaiseInterrupt(HOST_IRQ_USART2_TX);
+    }
+    return NULL;
+}
+
+/* ========================== Setup ====================================== */
+
+static void uart_open_pty(void)
+{
+    struct termios tio;
+    const char    *name;
+    const char    *link;
+
+    pty_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty_master < 0 || grantpt(pty_master) != 0 ||
+        unlockpt(pty_master) != 0 || (name = ptsname(pty_master)) == NULL) {
+        perror("[host] pty");
+        exit(1);
+    }
+
+    /* Hold the slave open, raw: no echo of our own output back into RX,
+     * no line editing, and no EIO while no terminal is attached */
+    pty_slave = open(name, O_RDWR | O_NOCTTY);
+    if (pty_slave >= 0 && tcgetattr(pty_slave, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(pty_slave, TCSANOW, &tio);
+    }
+    fcntl(pty_master, F_SETFL, fcntl(pty_master, F_GETFL) | O_NONBLOCK);
+
+    fprintf(stderr, "[host] USART2 on %s\n", name);
+
+    link = getenv("HOST_UART_LINK");
+    if (link != NULL && link[0] != '\0') {
+        unlink(link);
+        if (symlink(name, link) == 0) {
+            fprintf(stderr, "[host] USART2 linked at %s\n", link);
+        }
+    }
+}
+
+/* ========================== HAL API ==================================== */
+
+__attribute__((weak)) void HAL_UART_MspInit(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart,
+                                                      uint16_t Size)
+{
+    (void)huart;
+    (void)Size;
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+    pthread_t thread;
+
+    if (huart->Instance != USART2 || uart != NULL) {
+        return HAL_ERROR;
+    }
+
+    HAL_UART_MspInit(huart);       /* Links the DMA handles (msp.c)          */
+
+    uart         = huart;
+    uart_pace    = host_env_flag("HOST_UART_PACE", 1);
+    huart->gState  = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+
+    uart_open_pty();
+
+    vPortHostSetInterruptHandler(HOST_IRQ_USART2_RX, uart_rx_isr);
+    vPortHostSetInterruptHandler(HOST_IRQ_USART2_TX, uart_tx_isr);
+    pthread_create(&thread, NULL, uart_rx_thread, NULL);
+    pthread_detach(thread);
+    pthread_create(&thread, NULL, uart_tx_thread, NULL);
+    pthread_detach(thread);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart,
+                                    const uint8_t *pData, uint16_t Size,
+                                    uint32_t Timeout)
+{
+    uint64_t deadline;
+
+    (void)Timeout;
+
+    if (huart != uart || pData == NULL || Size == 0U) {
+        return HAL_ERROR;
+    }
+
+    /* Polling transmit: the caller holds the CPU for the whole frame */
+    deadline = host_now_ns() + line_ns(Size);
+    line_write(pData, Size);
+    host_busy_until(deadline);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart,
+                                        const uint8_t *pData, uint16_t Size)
+{
+    host_lock_t lk;
+
+    if (huart != uart || pData == NULL || Size == 0U) {
+        return HAL_ERROR;
+    }
+
+    host_lock(&lk);
+    if (huart->gState != HAL_UART_STATE_READY) {
+        host_unlock(&lk);
+        return HAL_BUSY;
+    }
+    huart->gState      = HAL_UART_STATE_BUSY_TX;
+    huart->pTxBuffPtr  = pData;
+    huart->TxXferSize  = Size;
+
+    pthread_mutex_lock(&tx_mutex);
+    tx_data = pData;
+    tx_len  = Size;
+    pthread_cond_signal(&tx_cond);
+    pthread_mutex_unlock(&tx_mutex);
+    host_unlock(&lk);
+    return HAL_OK;
+}
+
+/**
+ * @brief  Arm a reception and wake a reader waiting for one.
+ */
+static HAL_StatusTypeDef rx_arm(UART_HandleTypeDef *huart, uint8_t *pData,
+                                uint16_t Size, rx_mode_t mode)
+{
+    host_lock_t lk;
+
+    if (huart != uart || pData == NULL || Size == 0U) {
+        return HAL_ERROR;
+    }
+
+    host_lock(&lk);
+    if (huart->RxState != HAL_UART_STATE_READY) {
+        host_unlock(&lk);
+        return HAL_BUSY;
+    }
+    huart->RxState     = HAL_UART_STATE_BUSY_RX;
+    huart->pRxBuffPtr  = pData;
+    huart->RxXferSize  = Size;
+    huart->RxXferCount = Size;
+    rx_pos             = 0;
+
+    pthread_mutex_lock(&rx_mutex);
+    rx_mode = mode;
+    pthread_cond_signal(&rx_armed);
+    pthread_mutex_unlock(&rx_mutex);
+    host_unlock(&lk);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart,
+                                      uint8_t *pData, uint16_t Size)
+{
+    return rx_arm(huart, pData, Size, RX_IT);
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart,
+                                               uint8_t *pData, uint16_t Size)
+{
+    return rx_arm(huart, pData, Size, RX_TO_IDLE_DMA);
+}
@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ * @file           : host_libc.c  (host build)
+ * @brief          : glibc calls that take internal locks, made safe to call
+ *                   from preemptible task threads.
+ *
+ * @description    : A task preempted inside rand() or printf() keeps the
+ *                   glibc lock it holds while switched out.  The next task
+ *                   to call the same function then waits in the kernel on a
+ *                   lock only the suspended task can release, and if that
+ *                   task has a lower priority it never runs again.
+ *
+ *                   The Makefile links with -Wl,--wrap=<fn> for each
+ *                   function below, so the demo's calls land here and run
+ *                   with interrupts masked, the way newlib's reentrancy
+ *                   hooks would serialise them on the target.
+ ******************************************************************************
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+
+int  __real_rand(void);
+void __real_srand(unsigned int seed);
+int  __real_vprintf(const char *fmt, va_list ap);
+int  __real_puts(const char *s);
+int  __real_putchar(int c);
+
+int __wrap_rand(void)
+{
+    UBaseType_t mask = xPortSetInterruptMask();
+    int         value = __real_rand();
+
+    vPortClearInterruptMask(mask);
+    return value;
+}
+
+void __wrap_srand(unsigned int seed)
+{
+    UBaseType_t mask = xPortSetInterruptMask();
+
+    __real_srand(seed);
+    vPortClearInterruptMask(mask);
+}
+
+int __wrap_vprintf(const char *fmt, va_list ap)
+{
+    UBaseType_t mask = xPortSetInterruptMask();
+    int         n    = __real_vprintf(fmt, ap);
+
+    vPortClearInterruptMask(mask);
+    return n;
+}
+
+int __wrap_printf(const char *fmt, ...)
+{
+    va_list ap;
+    int     n;
+
+    va_start(ap, fmt);
+    n = __wrap_vprintf(fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+/* GCC turns printf("text\n") into puts() and printf("\n") into putchar() */
+int __wrap_puts(const char *s)
+{
+    UBaseType_t mask = xPortSetInterruptMask();
+    int         n    = __real_puts(s);
+
+    vPortClearInterruptMask(mask);
+    return n;
+}
+
+int __wrap_putchar(int c)
+{
+    UBaseType_t mask = xPortSetInterruptMask();
+    int         n    = __real_putchar(c);
+
+    vPortClearInterruptMask(mask);
+    return n;
+}
@@ -0,0 +1,393 @@
+#!/usr/bin/env python3
+"""
+ktrace_export.py - turn a ktrace dump into a Chrome / Perfetto timeline.
+
+The firmware's ktrace recorder (Core/Inc/ktrace.h in the binary, counting and
+mutex demos) dumps its RAM ring as text lines starting with "@kt":
+
+    @kt begin <version> <cpu_hz> <tick_hz> <events> <lost>
+    @kt task <id> <priority> <name>
+    @kt obj <id> <queue type> <name or ->
+    @kt ev <event word><timestamp> ...     16 hex digits per event
+    @kt end <events> <sum of all words>
+
+Every other line is skipped, so the input can be a raw capture of the demo's
+console.  The output is Chrome trace event JSON, which ui.perfetto.dev and
+chrome://tracing both open:
+
+    one track per task     Running, Ready (woken, waiting for the CPU),
+                           Preempted and Blocked slices; queue and semaphore
+                           operations as instant events
+    "Interrupts" track     interrupt entry to exit (empty ticks are dropped
+                           on the target)
+    counters               items in each queue / semaphore count / mutex free
+
+A summary of CPU share, wake-up latency and blocking time per task is printed
+on stderr.
+
+Usage:
+    stty -F /dev/ttyACM0 115200 raw -echo
+    ./Tools/ktrace_export.py /dev/ttyACM0 -o parking.json    # waits for @kt end
+
+    make counting_trace && HOST_UART_LINK=/tmp/usart2 ./build/counting_trace/counting_trace &
+    ./Tools/ktrace_export.py /tmp/usart2 -o parking.json      # host build
+
+    ./Tools/ktrace_export.py capture.txt -o trace.json        # saved console
+
+Standard library only.
+"""
+
+import argparse
+import json
+import sys
+
+KTRACE_VERSION = 1
+
+EV_SWITCH_IN = 0x01
+EV_SWITCH_OUT = 0x02
+EV_READY = 0x03
+EV_DELAY = 0x04
+EV_DELAY_UNTIL = 0x05
+EV_TASK_DELETE = 0x06
+EV_PRIO_INHERIT = 0x07
+EV_PRIO_DISINHERIT = 0x08
+EV_SEND = 0x10
+EV_SEND_FAILED = 0x11
+EV_SEND_FROM_ISR = 0x12
+EV_RECEIVE = 0x13
+EV_RECEIVE_FAILED = 0x14
+EV_RECEIVE_FROM_ISR = 0x15
+EV_BLOCK_SEND = 0x16
+EV_BLOCK_RECEIVE = 0x17
+EV_ISR_ENTER = 0x20
+EV_ISR_EXIT = 0x21
+EV_TIMER_COMMAND = 0x30
+
+# ucQueueType: (kind, verb for a send, verb for a receive, counter argument)
+QUEUE_TYPES = {
+    0: ("queue", "send", "receive", "items"),
+    1: ("mutex", "give", "take", "free"),
+    2: ("counting semaphore", "give", "take", "count"),
+    3: ("binary semaphore", "give", "take", "count"),
+    4: ("recursive mutex", "give", "take", "free"),
+}
+
+TIMER_COMMANDS = {
+    -2: "pend callback from ISR", -1: "pend callback", 0: "start",
+    1: "start", 2: "reset", 3: "stop", 4: "change period", 5: "delete",
+    6: "start from ISR", 7: "reset from ISR", 8: "stop from ISR",
+    9: "change period from ISR",
+}
+
+EXCEPTIONS = {0: "ISR", 11: "SVCall", 14: "PendSV", 15: "SysTick"}
+
+PID = 1
+ISR_TID = 0
+UNKNOWN_TID = 999               # Task or object id 0: the table was full
+
+
+class Dump:
+    """The @kt lines of one dump, parsed."""
+
+    def __init__(self):
+        self.cpu_hz = 0
+        self.tick_hz = 0
+        self.count = 0
+        self.lost = 0
+        self.tasks = {}         # id -> (name, priority)
+        self.objects = {}       # id -> (name, type)
+        self.events = []        # (code, arg, cycle counter)
+        self.checksum_ok = None
+
+    @classmethod
+    def read(cls, stream):
+        dump = None
+        words_sum = 0
+        for raw in stream:
+            line = raw.decode("ascii", errors="replace")
+            at = line.find("@kt ")
+            if at < 0:
+                continue
+            fields = line[at + 4:].strip().split(" ", 3)
+            kind = fields[0]
+            if kind == "begin":
+                dump = cls()
+                words_sum = 0
+                version, dump.cpu_hz, dump.tick_hz, dump.count, dump.lost = \
+                    (int(f) for f in line[at + 4:].split()[1:6])
+                if version != KTRACE_VERSION:
+                    raise ValueError(f"dump version {version}, expected {KTRACE_VERSION}")
+            elif dump is None:
+                continue        # The tail of an earlier, partial dump
+            elif kind == "task":
+                dump.tasks[int(fields[1])] = (fields[3] if len(fields) > 3 else "?",
+                                              int(fields[2]))
+            elif kind == "obj":
+                name = fields[3] if len(fields) > 3 else "-"
+                dump.objects[int(fields[1])] = (name, int(fields[2]))
+            elif kind == "ev":
+                for token in line[at + 7:].split():
+                    word, stamp = int(token[:8], 16), int(token[8:16], 16)
+                    dump.events.append((word >> 24, word & 0xFFFFFF, stamp))
+                    words_sum += word + stamp
+            elif kind == "end":
+                dump.checksum_ok = (words_sum & 0xFFFFFFFF) == int(fields[2], 16)
+                return dump
+        if dump is None:
+            raise ValueError("no '@kt begin' line in the input")
+        return dump     # Cut short: checksum_ok stays None
+
+
+class Timeline:
+    """Replays the events into Chrome trace events and per-task statistics."""
+
+    def __init__(self, dump):
+        self.dump = dump
+        self.out = []
+        self.running = None             # Task id on the CPU
+        self.since = {}                 # Task id -> (state, start us, label)
+        self.reason = {}                # Task id -> why it is about to block
+        self.isr_stack = []
+        self.counter_seen = set()
+        self.stats = {}
+        self.isr_times = []
+
+    # ---------------------------------------------------------------- helpers
+    @staticmethod
+    def tid(task):
+        return task if task != 0 else UNKNOWN_TID
+
+    def stat(self, task):
+        if task not in self.stats:
+            self.stats[task] = {"runs": 0, "run_us": 0.0, "wakes": [],
+                                "blocked_us": 0.0, "blocked_max": 0.0,
+                                "preempted": 0}
+        return self.stats[task]
+
+    def obj(self, obj_id):
+        name, qtype = self.dump.objects.get(obj_id, ("-", 0))
+        if name == "-":
+            name = f"queue #{obj_id}"
+        return name, QUEUE_TYPES.get(qtype, QUEUE_TYPES[0])
+
+    def slice(self, tid, name, start, end, cname=None, args=None):
+        ev = {"ph": "X", "pid": PID, "tid": tid, "name": name,
+              "ts": start, "dur": max(end - start, 0.0)}
+        if cname:
+            ev["cname"] = cname
+        if args:
+            ev["args"] = args
+        self.out.append(ev)
+
+    def instant(self, tid, name, ts, args=None):
+        ev = {"ph": "i", "s": "t", "pid": PID, "tid": tid, "name": name, "ts": ts}
+        if args:
+            ev["args"] = args
+        self.out.append(ev)
+
+    def counter(self, name, key, value, ts):
+        self.out.append({"ph": "C", "pid": PID, "name": name, "ts": ts,
+                         "args": {key: value}})
+
+    def close(self, task, now):
+        """End the task's current slice; returns (state, start) or None."""
+        state = self.since.pop(task, None)
+        if state is None:
+            return None
+        kind, start, label = state
+        st = self.stat(task)
+        tid = self.tid(task)
+        if kind == "running":
+            self.slice(tid, "Running", start, now, "thread_state_running")
+            st["run_us"] += now - start
+        elif kind == "ready":
+            self.slice(tid, "Ready", start, now, "thread_state_runnable",
+                       {"latency_us": round(now - start, 3)})
+        elif kind == "preempted":
+            self.slice(tid, "Preempted", start, now, "thread_state_runnable")
+        elif kind == "blocked":
+            self.slice(tid, label, start, now, "thread_state_sleeping")
+            st["blocked_us"] += now - start
+            st["blocked_max"] = max(st["blocked_max"], now - start)
+        return kind, start
+
+    # ----------------------------------------------------------------- replay
+    def run(self):
+        d = self.dump
+        us_per_cycle = 1e6 / d.cpu_hz
+        cycles = 0
+        last = d.events[0][2] if d.events else 0
+
+        for code, arg, stamp in d.events:
+            cycles += (stamp - last) & 0xFFFFFFFF   # CYCCNT wraps every 25 s
+            last = stamp
+            self.event(code, arg, cycles * us_per_cycle)
+
+        end = cycles * us_per_cycle
+        for task in list(self.since):
+            self.close(task, end)
+        for name, start in self.isr_stack:
+            self.slice(ISR_TID, name, start, end, "thread_state_running")
+        self.metadata()
+        return end
+
+    def event(self, code, arg, now):
+        if code == EV_SWITCH_IN:
+            state = self.close(arg, now)
+            if state and state[0] == "ready":
+                self.stat(arg)["wakes"].append(now - state[1])
+            self.stat(arg)["runs"] += 1
+            self.since[arg] = ("running", now, None)
+            self.running = arg
+            self.reason.pop(arg, None)
+
+        elif code == EV_SWITCH_OUT:
+            self.close(arg, now)
+            label = self.reason.pop(arg, None)
+            if label is not None:
+                self.since[arg] = ("blocked", now, label)
+            else:
+                self.since[arg] = ("preempted", now, None)
+                self.stat(arg)["preempted"] += 1
+            self.running = None
+
+        elif code == EV_READY:
+            state = self.since.get(arg)
+            if arg != self.running and (state is None or state[0] == "blocked"):
+                self.close(arg, now)
+                self.since[arg] = ("ready", now, None)
+
+        elif code == EV_DELAY and self.running is not None:
+            self.reason[self.running] = f"Delay {arg} ticks"
+        elif code == EV_DELAY_UNTIL and self.running is not None:
+            self.reason[self.running] = f"Sleep until tick {arg}"
+        elif code == EV_TASK_DELETE:
+            self.close(arg, now)
+            self.instant(self.tid(arg), "Deleted", now)
+
+        elif code in (EV_PRIO_INHERIT, EV_PRIO_DISINHERIT):
+            task, prio = arg >> 8, arg & 0xFF
+            what = "inherits" if code == EV_PRIO_INHERIT else "returns to"
+            self.instant(self.tid(task), f"Priority {what} {prio}", now)
+
+        elif EV_SEND <= code <= EV_BLOCK_RECEIVE:
+            self.queue_event(code, arg >> 16, arg & 0xFFFF, now)
+
+        elif code == EV_ISR_ENTER:
+            self.isr_stack.append((EXCEPTIONS.get(arg, f"IRQ {arg - 16}"), now))
+        elif code == EV_ISR_EXIT:
+            if self.isr_stack:
+                name, start = self.isr_stack.pop()
+                self.slice(ISR_TID, name, start, now, "thread_state_running",
+                           {"switch": bool(arg)})
+                self.isr_times.append(now - start)
+
+        elif code == EV_TIMER_COMMAND:
+            cmd = arg >> 8
+            cmd = cmd - 0x10000 if cmd & 0x8000 else cmd
+            name = TIMER_COMMANDS.get(cmd, f"command {cmd}")
+            tid = self.tid(self.running) if self.running is not None else ISR_TID
+            self.instant(tid, f"Timer {name}", now, {"queued": bool(arg & 0xFF)})
+
+    def queue_event(self, code, obj_id, before, now):
+        name, (kind, send, receive, key) = self.obj(obj_id)
+        in_isr = code in (EV_SEND_FROM_ISR, EV_RECEIVE_FROM_ISR) or self.isr_stack
+        tid = ISR_TID if in_isr or self.running is None else self.tid(self.running)
+
+        if code in (EV_BLOCK_SEND, EV_BLOCK_RECEIVE):
+            verb = send if code == EV_BLOCK_SEND else receive
+            if self.running is not None:
+                self.reason[self.running] = f"Blocked: {verb} {name}"
+            return
+
+        after = before
+        if code in (EV_SEND, EV_SEND_FROM_ISR):
+            verb, after = send, before + 1
+        elif code in (EV_RECEIVE, EV_RECEIVE_FROM_ISR):
+            verb, after = receive, before - 1
+        elif code == EV_SEND_FAILED:
+            verb = send + " failed"
+        else:
+            verb = receive + " failed"
+
+        self.instant(tid, f"{verb} {name}", now, {kind: name, key: after})
+        if obj_id not in self.counter_seen:
+            self.counter_seen.add(obj_id)
+            self.counter(name, key, before, 0.0)
+        self.counter(name, key, after, now)
+
+    def metadata(self):
+        meta = [({"name": "process_name", "tid": 0},
+                 {"name": f"FreeRTOS @ {self.dump.cpu_hz / 1e6:g} MHz"}),
+                ({"name": "thread_name", "tid": ISR_TID}, {"name": "Interrupts"}),
+                ({"name": "thread_sort_index", "tid": ISR_TID}, {"sort_index": -1})]
+        for task, (name, prio) in self.dump.tasks.items():
+            meta.append(({"name": "thread_name", "tid": task},
+                         {"name": f"{name} (prio {prio})"}))
+            meta.append(({"name": "thread_sort_index", "tid": task},
+                         {"sort_index": 100 - prio}))
+        meta.append(({"name": "thread_name", "tid": UNKNOWN_TID},
+                     {"name": "unnamed tasks"}))
+        for head, args in meta:
+            self.out.append(dict(head, ph="M", pid=PID, args=args))
+
+    # ------------------------------------------------------------------ stats
+    def summary(self, span, out):
+        out.write(f"# ktrace: {len(self.dump.events)} events over {span / 1000:.1f} ms"
+                  f" at {self.dump.cpu_hz / 1e6:g} MHz")
+        if self.dump.lost:
+            out.write(f", {self.dump.lost} older events overwritten")
+        out.write("\n")
+        out.write(f"# {'task':<16} {'prio':>4} {'runs':>6} {'cpu%':>6} "
+                  f"{'wake_avg_us':>11} {'wake_max_us':>11} {'preempted':>9} "
+                  f"{'blocked_ms':>10} {'block_max_ms':>12}\n")
+        rows = sorted(self.dump.tasks.items(), key=lambda kv: -kv[1][1])
+        for task, (name, prio) in rows:
+            st = self.stat(task)
+            wakes = st["wakes"]
+            avg = sum(wakes) / len(wakes) if wakes else 0.0
+            cpu = 100.0 * st["run_us"] / span if span else 0.0
+            out.write(f"  {name:<16} {prio:>4} {st['runs']:>6} {cpu:>6.2f} "
+                      f"{avg:>11.1f} {max(wakes, default=0.0):>11.1f} "
+                      f"{st['preempted']:>9} {st['blocked_us'] / 1000:>10.1f} "
+                      f"{st['blocked_max'] / 1000:>12.1f}\n")
+        if self.isr_times:
+            out.write(f"# interrupts recorded: {len(self.isr_times)}, "
+                      f"avg {sum(self.isr_times) / len(self.isr_times):.2f} us, "
+                      f"max {max(self.isr_times):.2f} us\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Convert a ktrace dump to Chrome trace JSON.")
+    ap.add_argument("input", help="serial device, capture file, or - for stdin")
+    ap.add_argument("-o", "--output", default="ktrace.json",
+                    help="JSON file to write (default ktrace.json)")
+    ap.add_argument("--cpu-hz", type=float,
+                    help="override the core clock from the dump header")
+    opts = ap.parse_args()
+
+    stream = sys.stdin.buffer if opts.input == "-" else open(opts.input, "rb")
+    try:
+        dump = Dump.read(stream)
+    except KeyboardInterrupt:
+        sys.exit("interrupted before '@kt end'")
+    if opts.cpu_hz:
+        dump.cpu_hz = opts.cpu_hz
+    if dump.checksum_ok is None:
+        sys.stderr.write("warning: no '@kt end' line, the dump is incomplete\n")
+    elif not dump.checksum_ok or len(dump.events) != dump.count:
+        sys.stderr.write(f"warning: {len(dump.events)} of {dump.count} events read, "
+                         f"checksum {'ok' if dump.checksum_ok else 'mismatch'}\n")
+
+    timeline = Timeline(dump)
+    span = timeline.run()
+    with open(opts.output, "w") as f:
+        json.dump({"traceEvents": timeline.out, "displayTimeUnit": "ns",
+                   "otherData": {"tick_hz": dump.tick_hz, "cpu_hz": dump.cpu_hz,
+                                 "lost_events": dump.lost}}, f)
+    timeline.summary(span, sys.stderr)
+    sys.stderr.write(f"# wrote {opts.output}: open it in https://ui.perfetto.dev\n")
+
+
+if __name__ == "__main__":
+    main()
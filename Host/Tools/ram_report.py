@@ -0,0 +1,260 @@
+#!/usr/bin/env python3
+"""
+ram_report.py - RAM per kernel object and per variable from a GNU ld map file.
+
+The demos declare their tasks, queues, semaphores, timers and stream buffers
+with Core/Inc/static_alloc.h, which names the storage kobj_<object>_<part>:
+
+    kobj_print_task_stack   kobj_print_task_tcb          task
+    kobj_queue_print_storage kobj_queue_print_queue      queue
+    kobj_msg_pool_sem                                    semaphore / mutex
+    kobj_timer_rtc_report_timer                          timer
+    kobj_uart_rx_stream_storage kobj_uart_rx_stream_stream  stream buffer
+
+With APP_STATIC_ALLOC = 1 that storage is all the RAM the kernel objects
+use, and the map file says where each part went and how big it is.  This
+script adds the parts up per object, lists the largest other variables
+(the FreeRTOS heap, ucHeap, among them in a heap build) and compares the
+total with the _Ram_Budget the linker script asserts on.  With
+APP_CCM_RAM = 1 task stacks and TCBs go to .ccmbss in CCM RAM (ccm_ram.h):
+the region column says where each object went, and only main RAM counts
+against the budget.
+
+It needs one input section per variable, which -fdata-sections gives (on by
+default in STM32CubeIDE projects, and in Host/Makefile).
+
+Usage:
+    ./Tools/ram_report.py ../MUTEX_Demonstration/Debug/MUTEX_Demonstration.map
+    make uart_static && ./Tools/ram_report.py build/uart_static/uart_static.map
+    ./Tools/ram_report.py firmware.map --budget 24576      # exit 1 if over
+
+Standard library only.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Storage suffixes from static_alloc.h: (object kind, buffer or control part)
+KOBJ_PARTS = {
+    "stack": ("task", "buffer"),
+    "tcb": ("task", "control"),
+    "storage": (None, "buffer"),        # queue or stream buffer, see below
+    "queue": ("queue", "control"),
+    "sem": ("semaphore", "control"),
+    "timer": ("timer", "control"),
+    "stream": ("stream buffer", "control"),
+}
+
+KOBJ_RE = re.compile(r"^kobj_(\w+)_(" + "|".join(KOBJ_PARTS) + r")$")
+
+# Output section header: ".bss   0x20000078   0xcc70 [load address ...]"
+OUT_RE = re.compile(r"^(\.\S+|\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+OUT_NAME_RE = re.compile(r"^(\.\S+)\s*$")
+# Input section: " .bss.name   0x20000094   0x48 ./Core/Src/main.o"
+IN_RE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(.*))?$")
+IN_NAME_RE = re.compile(r"^ (\S+)\s*$")
+IN_CONT_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(.*))?$")
+REGION_RE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+BUDGET_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+(?:PROVIDE \()?_Ram_Budget\s*=")
+
+# GCC prefixes a data section name with these, per variable
+DATA_PREFIXES = (".bss.", ".data.rel.local.", ".data.rel.ro.local.",
+                 ".data.rel.ro.", ".data.rel.", ".data.", ".sbss.", ".sdata.",
+                 ".ccmram.", ".ccmbss.")
+
+
+def is_ram_section(name):
+    return (name.startswith(".data") or name.startswith(".bss")
+            or name.startswith(".ccm") or name == "._user_heap_stack")
+
+
+class MapFile:
+    """The parts of a GNU ld map file this report needs."""
+
+    def __init__(self):
+        self.regions = {}           # name -> (origin, length)
+        self.sections = []          # (name, address, size) of RAM output sections
+        self.variables = []         # (name, input section, address, size, file)
+        self.budget = None
+
+    @classmethod
+    def read(cls, stream):
+        m = cls()
+        lines = stream.read().splitlines()
+        i = 0
+        in_regions = False
+        in_map = False
+        current = None              # RAM output section being walked
+
+        while i < len(lines):
+            line = lines[i]
+            i += 1
+
+            if line.startswith("Memory Configuration"):
+                in_regions = True
+                continue
+            if line.startswith("Linker script and memory map"):
+                in_regions = False
+                in_map = True
+                continue
+            if in_regions:
+                r = REGION_RE.match(line)
+                if r and r.group(1) not in ("Name", "*default*"):
+                    m.regions[r.group(1)] = (int(r.group(2), 16), int(r.group(3), 16))
+                continue
+            if not in_map:
+                continue
+
+            b = BUDGET_RE.match(line)
+            if b:
+                m.budget = int(b.group(1), 16)
+                continue
+
+            # Output section: name alone at column 0 has its numbers next line
+            if line and not line[0].isspace():
+                o = OUT_RE.match(line)
+                n = OUT_NAME_RE.match(line) if not o else None
+                if n and i < len(lines):
+                    c = IN_CONT_RE.match(lines[i])
+                    if c:
+                        o = OUT_RE.match(n.group(1) + " " + lines[i].strip())
+                        i += 1
+                current = None
+                if o and is_ram_section(o.group(1)):
+                    current = o.group(1)
+                    m.sections.append((current, int(o.group(2), 16), int(o.group(3), 16)))
+                continue
+
+            if current is None:
+                continue
+
+            # Input section: name and numbers on one line, or on two
+            s = IN_RE.match(line)
+            if not s:
+                n = IN_NAME_RE.match(line)
+                if n and i < len(lines):
+                    c = IN_CONT_RE.match(lines[i])
+                    if c:
+                        s = IN_RE.match(line.rstrip() + " " + lines[i].strip())
+                        i += 1
+            if not s:
+                continue
+            sect, addr, size, obj = s.group(1), int(s.group(2), 16), int(s.group(3), 16), s.group(4) or ""
+            if sect.startswith("*") or size == 0:
+                continue
+            m.variables.append((variable_name(sect), sect, addr, size, object_name(obj)))
+        return m
+
+    def region_of(self, addr, section=""):
+        """Memory region at 'addr'; by section name when the map has none
+        (a host build)."""
+        for name, (origin, length) in self.regions.items():
+            if origin <= addr < origin + length:
+                return name
+        return "CCMRAM" if section.startswith(".ccm") else "RAM"
+
+
+def variable_name(section):
+    """.bss.kobj_x_stack -> kobj_x_stack; .bss.buf.0 (function static) -> buf"""
+    for p in DATA_PREFIXES:
+        if section.startswith(p):
+            name = section[len(p):]
+            return re.sub(r"\.\d+$", "", name)
+    return section              # whole .bss / .data of a file, COMMON
+
+
+def object_name(path):
+    """Archive member or object file name without its directory."""
+    path = path.strip()
+    a = re.search(r"\(([^)]+)\)$", path)
+    if a:
+        return a.group(1)
+    return os.path.basename(path.replace("\\", "/"))
+
+
+def kernel_objects(variables, region_of):
+    """Group kobj_* storage by object: name -> [kind, buffer, control, regions]
+
+    An active object (AO_STORAGE in ao.h) is a queue and a task under one
+    name, reported as kind "queue+task".
+    """
+    objs = {}
+    rest = []
+    for name, sect, addr, size, obj in variables:
+        k = KOBJ_RE.match(name)
+        if not k:
+            rest.append((name, sect, addr, size, obj))
+            continue
+        kind, part = KOBJ_PARTS[k.group(2)]
+        o = objs.setdefault(k.group(1), [set(), 0, 0, set()])
+        if kind is not None:
+            o[0].add(kind)
+        o[1 if part == "buffer" else 2] += size
+        o[3].add(region_of(addr, sect))
+    for o in objs.values():
+        o[0] = "+".join(sorted(o[0])) or "queue"
+        o[3] = "+".join(sorted(o[3]))
+    return objs, rest
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Report RAM per kernel object from a GNU ld map file.")
+    ap.add_argument("map", help="linker map file (-Wl,-Map=...)")
+    ap.add_argument("--top", type=int, default=10, help="other variables to list (default 10)")
+    ap.add_argument("--budget", type=lambda v: int(v, 0),
+                    help="RAM budget in bytes (default: _Ram_Budget from the map)")
+    args = ap.parse_args()
+
+    with open(args.map, encoding="utf-8", errors="replace") as f:
+        m = MapFile.read(f)
+
+    objs, rest = kernel_objects(m.variables, m.region_of)
+    out = sys.stdout
+
+    out.write("# ram_report %s\n" % args.map)
+
+    out.write("# kernel objects (static_alloc.h)\n")
+    out.write("%-24s %-14s %8s %8s %8s  %s\n"
+              % ("object", "kind", "buffer", "control", "total", "region"))
+    kobj_total = 0
+    for name, (kind, buf, ctl, where) in sorted(objs.items(), key=lambda kv: -(kv[1][1] + kv[1][2])):
+        out.write("%-24s %-14s %8d %8d %8d  %s\n" % (name, kind, buf, ctl, buf + ctl, where))
+        kobj_total += buf + ctl
+    if not objs:
+        out.write("(none: a heap build, or the map has no per-variable sections)\n")
+    out.write("%-24s %-14s %8s %8s %8d\n" % ("total", "", "", "", kobj_total))
+
+    out.write("# largest other variables\n")
+    out.write("%-24s %-24s %8s  %s\n" % ("variable", "file", "bytes", "region"))
+    for name, sect, addr, size, obj in sorted(rest, key=lambda v: -v[3])[:args.top]:
+        out.write("%-24s %-24s %8d  %s\n" % (name[:24], obj[:24], size, m.region_of(addr, sect)))
+
+    out.write("# sections\n")
+    used = {}
+    for name, addr, size in m.sections:
+        region = m.region_of(addr, name)
+        used[region] = used.get(region, 0) + size
+        out.write("%-24s %-24s %8d\n" % (name, region, size))
+
+    budget = args.budget if args.budget is not None else m.budget
+    ram = used.get("RAM", 0)
+    over = False
+    out.write("# total\n")
+    for region, size in sorted(used.items()):
+        line = "%-24s %-24s %8d" % (region, "used", size)
+        if region == "RAM" and budget:
+            line += "  of budget %d (%d %%)" % (budget, 100 * size // budget)
+            over = size > budget
+        elif region in m.regions:
+            line += "  of %d" % m.regions[region][1]
+        out.write(line + "\n")
+    if over:
+        out.write("RAM budget exceeded by %d bytes\n" % (ram - budget))
+    out.write("# end\n")
+    return 1 if over else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,309 @@
+#!/usr/bin/env python3
+"""
+stack_size.py - recommend a stack size per task and write Core/Inc/stack_sizes.h.
+
+Two measurements go in:
+
+  1. A stack profile.  With APP_STACK_PROFILE = 1 (app_config.h) the firmware
+     prints the peak stack use of every task every 10 s (stack_prof.c):
+
+         @stk begin <version> <word bytes> <uptime ms> <tasks>
+         @stk task <object> <entry> <words> <peak> <alive> <name>
+         @stk end <tasks>
+
+     The peak is what the workload actually reached, interrupts included,
+     but only on the paths it happened to take.
+
+  2. The compiler's call graph.  Built with -fcallgraph-info=su, GCC writes a
+     .ci file next to every object, with the frame size of each function and
+     the calls it makes.  The deepest path from a task's entry function,
+     plus the context a switch or an interrupt pushes (--frame-words), bounds
+     the stack on every path - unless the path has indirect calls,
+     recursion, alloca, or library functions compiled without the flag.
+     Those make the bound a lower bound, and are listed.
+
+The recommendation is the larger of the two, plus --margin percent, rounded
+up to --round words and no less than --min-words.  With --header the tool
+rewrites the value and comment of every "#define STACK_WORDS_<OBJECT>" line
+in stack_sizes.h (the object is the STATIC_TASK() name, upper case) and
+leaves the rest of the file alone.  Objects missing from the profile keep
+their value.
+
+Usage:
+    stty -F /dev/ttyACM0 115200 raw -echo
+    ./Tools/stack_size.py /dev/ttyACM0 \\
+        --ci ../UART_RTC_Handling-Processing_Using_Queues-Timers/Debug \\
+        --header ../UART_RTC_Handling-Processing_Using_Queues-Timers/Core/Inc/stack_sizes.h
+
+    make uart_stack && HOST_UART_LINK=/tmp/usart2 ./build/uart_stack/uart_stack &
+    ./Tools/stack_size.py /tmp/usart2 --ci build/uart_stack/obj     # host build
+
+    ./Tools/stack_size.py capture.txt --ci Debug      # the last report in a log
+
+A device or pipe is read up to the first complete report; a file is read to
+the end and its last report is used.  Standard library only.
+"""
+
+import argparse
+import math
+import os
+import re
+import stat
+import sys
+
+STACK_PROF_VERSION = 1
+
+# Cortex-M4F: the exception frame with the FPU context (26 words) plus what
+# the port's PendSV handler saves below it (r4-r11, lr, s16-s31: 25 words)
+FRAME_WORDS = 51
+
+NODE_RE = re.compile(r'^node: \{ title: "([^"]*)" label: "([^"]*)"')
+EDGE_RE = re.compile(r'^edge: \{ sourcename: "([^"]*)" targetname: "([^"]*)"')
+SIZE_RE = re.compile(r"(\d+) bytes \(([a-z,]+)\)")
+DEFINE_RE = re.compile(r"^(#define\s+STACK_WORDS_(\w+)\s+)(\d+)U?(\s*)(/\*.*\*/)?\s*$")
+
+INDIRECT = "__indirect_call"
+
+
+class Profile:
+    """One @stk report: object -> [words, peak, tasks, names]."""
+
+    def __init__(self, word_bytes, uptime_ms):
+        self.word_bytes = word_bytes
+        self.uptime_ms = uptime_ms
+        self.objects = {}
+        self.entries = {}           # object -> entry function
+
+    def add(self, obj, entry, words, peak, name):
+        o = self.objects.setdefault(obj, [words, 0, 0, []])
+        o[0] = max(o[0], words)
+        o[1] = max(o[1], peak)
+        o[2] += 1
+        o[3].append(name)
+        self.entries[obj] = entry
+
+    @classmethod
+    def read(cls, stream, to_end):
+        last = None
+        report = None
+        for raw in stream:
+            line = raw.decode("ascii", errors="replace")
+            at = line.find("@stk ")
+            if at < 0:
+                continue
+            fields = line[at + 5:].strip().split(" ", 6)
+            kind = fields[0]
+            if kind == "begin":
+                version, word_bytes, uptime = (int(f) for f in fields[1:4])
+                if version != STACK_PROF_VERSION:
+                    raise ValueError(f"report version {version}, expected {STACK_PROF_VERSION}")
+                report = cls(word_bytes, uptime)
+            elif kind == "error":
+                raise ValueError("firmware: " + line[at:].strip()
+                                 + " (raise STACK_PROF_MAX_TASKS in stack_prof.h)")
+            elif report is None:
+                continue            # The tail of an earlier, partial report
+            elif kind == "task" and len(fields) >= 6:
+                obj, entry, words, peak = fields[1], fields[2], int(fields[3]), int(fields[4])
+                name = fields[6] if len(fields) > 6 else "?"
+                if obj == "-":
+                    obj = "(" + name + ")"
+                report.add(obj, entry, words, peak, name)
+            elif kind == "end":
+                last, report = report, None
+                if not to_end:
+                    break
+        if last is None:
+            raise ValueError("no complete '@stk begin' ... '@stk end' report in the input")
+        return last
+
+
+class CallGraph:
+    """Frame sizes and calls from GCC -fcallgraph-info=su .ci files."""
+
+    def __init__(self):
+        self.frames = {}            # title -> (bytes, qualifier)
+        self.calls = {}             # title -> set of titles
+        self.by_name = {}           # bare name -> titles with a frame size
+        self.memo = {}
+
+    def load(self, path):
+        with open(path, encoding="utf-8", errors="replace") as f:
+            for line in f:
+                n = NODE_RE.match(line)
+                if n:
+                    s = SIZE_RE.search(n.group(2).replace("\\n", "\n"))
+                    if s:
+                        title = n.group(1)
+                        self.frames[title] = (int(s.group(1)), s.group(2))
+                        self.by_name.setdefault(title.rsplit(":", 1)[-1], set()).add(title)
+                    continue
+                e = EDGE_RE.match(line)
+                if e:
+                    self.calls.setdefault(e.group(1), set()).add(e.group(2))
+
+    def resolve(self, name):
+        """A call target or entry name -> title with a frame size, or None."""
+        if name in self.frames:
+            return name
+        titles = self.by_name.get(name.rsplit(":", 1)[-1], ())
+        return next(iter(titles)) if len(titles) == 1 else None
+
+    def depth(self, name, visiting=None):
+        """(bytes on the deepest path from 'name', reasons it may be more)"""
+        if name == INDIRECT:
+            return 0, {"indirect calls"}
+        title = self.resolve(name)
+        if title is None:
+            return 0, {"no call graph: " + name.rsplit(":", 1)[-1]}
+        if title in self.memo:
+            return self.memo[title]
+        visiting = visiting or set()
+        visiting.add(title)
+
+        size, qualifier = self.frames[title]
+        reasons = set()
+        if qualifier == "dynamic":
+            reasons.add("alloca / VLA in " + title.rsplit(":", 1)[-1])
+        deepest = 0
+        for callee in self.calls.get(title, ()):
+            target = self.resolve(callee) or callee
+            if target in visiting:
+                reasons.add("recursion in " + title.rsplit(":", 1)[-1])
+                continue
+            d, r = self.depth(callee, visiting)
+            deepest = max(deepest, d)
+            reasons |= r
+
+        visiting.discard(title)
+        self.memo[title] = (size + deepest, reasons)
+        return self.memo[title]
+
+
+def find_ci(dirs):
+    for d in dirs:
+        for root, _, files in os.walk(d):
+            for f in files:
+                if f.endswith(".ci"):
+                    yield os.path.join(root, f)
+
+
+def round_up(value, step):
+    return int(math.ceil(value / step) * step)
+
+
+def rewrite_header(path, recommended):
+    """Replace the STACK_WORDS_* values that have a recommendation."""
+    with open(path, encoding="utf-8") as f:
+        lines = f.read().splitlines(keepends=True)
+    changed = 0
+    seen = set()
+    for i, line in enumerate(lines):
+        d = DEFINE_RE.match(line.rstrip("\n"))
+        if not d or d.group(2) not in recommended:
+            continue
+        seen.add(d.group(2))
+        words, comment = recommended[d.group(2)]
+        value = f"{words}U"
+        pad = max(1, len(d.group(3)) + 1 + len(d.group(4)) - len(value))
+        lines[i] = f"{d.group(1)}{value}{' ' * pad}/* {comment} */\n"
+        changed += int(int(d.group(3)) != words)
+    with open(path, "w", encoding="utf-8") as f:
+        f.writelines(lines)
+    return changed, seen
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Recommend task stack sizes from a stack profile "
+                                             "and the compiler's call graph.")
+    ap.add_argument("input", help="serial device, capture file, or - for stdin")
+    ap.add_argument("--ci", action="append", default=[], metavar="DIR",
+                    help="directory with -fcallgraph-info=su .ci files (repeatable)")
+    ap.add_argument("--header", help="stack_sizes.h to rewrite")
+    ap.add_argument("--margin", type=int, default=25, help="percent added on top (default 25)")
+    ap.add_argument("--frame-words", type=int, default=FRAME_WORDS,
+                    help=f"context pushed on a task stack, added to the call graph depth "
+                         f"(default {FRAME_WORDS}, Cortex-M4F)")
+    ap.add_argument("--min-words", type=int, default=64, help="smallest size written (default 64)")
+    ap.add_argument("--round", type=int, default=8, help="round up to this many words (default 8)")
+    opts = ap.parse_args()
+
+    if opts.input == "-":
+        stream, to_end = sys.stdin.buffer, False
+    else:
+        stream = open(opts.input, "rb")
+        to_end = stat.S_ISREG(os.fstat(stream.fileno()).st_mode)
+    try:
+        profile = Profile.read(stream, to_end)
+    except KeyboardInterrupt:
+        sys.exit("interrupted before '@stk end'")
+    except ValueError as e:
+        sys.exit(str(e))
+
+    graph = CallGraph()
+    ci_files = list(find_ci(opts.ci))
+    for path in ci_files:
+        graph.load(path)
+    if opts.ci and not ci_files:
+        sys.stderr.write("warning: no .ci files found; build with -fcallgraph-info=su\n")
+
+    out = sys.stdout
+    wb = profile.word_bytes
+    out.write(f"# stack_size {opts.input} uptime_ms={profile.uptime_ms} word_bytes={wb} "
+              f"ci_files={len(ci_files)} margin={opts.margin}% frame_words={opts.frame_words}\n")
+    out.write("%-14s %-20s %3s %6s %6s %7s %9s  %s\n"
+              % ("# object", "entry", "n", "words", "peak", "static", "recommend", "name"))
+
+    recommended = {}
+    notes = {}
+    sizes = {}                  # OBJECT -> bytes freed by the recommendation
+    for obj, (words, peak, count, names) in sorted(profile.objects.items()):
+        entry = profile.entries[obj]
+        static = None
+        reasons = set()
+        if ci_files and entry != "-":
+            depth, reasons = graph.depth(entry)
+            static = int(math.ceil(depth / wb)) + opts.frame_words
+        need = max(peak, static or 0)
+        rec = max(opts.min_words, round_up(need * (100 + opts.margin) / 100, opts.round))
+
+        static_txt = "-" if static is None else ("%d%s" % (static, "+" if reasons else ""))
+        out.write("%-14s %-20s %3d %6d %6d %7s %9d  %s\n"
+                  % (obj, entry, count, words, peak, static_txt, rec, ",".join(names)))
+        if reasons:
+            notes[obj] = reasons
+
+        if not obj.startswith("("):
+            comment = f"peak {peak}"
+            if static is not None:
+                comment += f", call graph {'>=' if reasons else ''}{static}"
+            recommended[obj.upper()] = (rec, comment)
+            sizes[obj.upper()] = (words - rec) * count * wb
+
+    if notes:
+        out.write("# static is a lower bound (+) for:\n")
+        for obj, reasons in sorted(notes.items()):
+            missing = sorted(r.split(": ", 1)[1] for r in reasons if r.startswith("no call graph"))
+            shown = sorted(r for r in reasons if not r.startswith("no call graph"))
+            if missing:
+                more = ", ..." if len(missing) > 4 else ""
+                shown.append(f"{len(missing)} functions without a call graph "
+                             f"({', '.join(missing[:4])}{more})")
+            out.write(f"#   {obj}: {'; '.join(shown)}\n")
+
+    seen = set(recommended)
+    if opts.header:
+        changed, seen = rewrite_header(opts.header, recommended)
+        missing = sorted(set(recommended) - seen)
+        out.write(f"# {opts.header}: {changed} of {len(seen)} values changed\n")
+        if missing:
+            out.write("# not in the header: " + " ".join("STACK_WORDS_" + m for m in missing) + "\n")
+
+    saved = sum(sizes[o] for o in seen)
+    out.write(f"# recommended sizes free {saved} bytes of stack\n" if saved >= 0 else
+              f"# recommended sizes need {-saved} more bytes of stack\n")
+    out.write("# end\n")
+
+
+if __name__ == "__main__":
+    main()
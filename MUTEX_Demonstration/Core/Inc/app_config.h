@@ -0,0 +1,89 @@
+/**
+ ******************************************************************************
+ * @file           : app_config.h
+ * @brief          : Application feature switches for the mutex demo.
+ *
+ * @description    : Kernel options and trace modes are selected here with a
+ *                   0/1 switch.  FreeRTOSConfig.h includes this file so that
+ *                   kernel settings can follow the switches.
+ ******************************************************************************
+ */
+
+#ifndef APP_CONFIG_H
+#define APP_CONFIG_H
+
+/* ============================================================
+ *  KERNEL OBJECT ALLOCATION
+ * ============================================================ */
+
+/* 1 = Static profile: both tasks, the UART mutex and the ktrace task (plus
+     the idle and timer tasks) get their memory from variables declared
+     with static_alloc.h, and the kernel is built without a heap
+     (configSUPPORT_DYNAMIC_ALLOCATION 0); Host/Tools/ram_report.py lists
+     the RAM per object from the map file
+ 0 = Objects are taken from the configTOTAL_HEAP_SIZE heap at creation */
+#ifndef APP_STATIC_ALLOC
+#define APP_STATIC_ALLOC                0
+#endif
+
+/* ============================================================
+ *  STACK PROFILE
+ * ============================================================ */
+
+/* 1 = A task at idle priority prints the peak stack use of every task as
+     "@stk" lines on USART2 every 10 s (stack_prof.c), taking the UART
+     mutex like the demo tasks; feed the last report and the compiler's
+     call graph to Host/Tools/stack_size.py to rewrite
+     Core/Inc/stack_sizes.h.  Turns on configRECORD_STACK_HIGH_ADDRESS
+ 0 = Stack sizes stay as stack_sizes.h has them, with no profiler */
+#ifndef APP_STACK_PROFILE
+#define APP_STACK_PROFILE               0
+#endif
+
+/* ============================================================
+ *  CCM RAM
+ * ============================================================ */
+
+/* 1 = Task stacks and TCBs go to the 64 KB core-coupled RAM, which only
+     the CPU can reach (ccm_ram.h): with the heap, heap_5.c spreads it over
+     APP_CCM_HEAP_SIZE bytes of CCM plus main SRAM and fills CCM first;
+     with APP_STATIC_ALLOC the STATIC_TASK() storage is placed there
+ 0 = Everything in main SRAM */
+#ifndef APP_CCM_RAM
+#define APP_CCM_RAM                     0
+#endif
+
+/* Bytes of the heap (configTOTAL_HEAP_SIZE) placed in CCM RAM when
+   APP_CCM_RAM = 1; the rest stays in main SRAM.  At most 64 KB, and less
+   than the whole heap */
+#ifndef APP_CCM_HEAP_SIZE
+#define APP_CCM_HEAP_SIZE               (32 * 1024)
+#endif
+
+/* ============================================================
+ *  KERNEL EVENT TRACE
+ * ============================================================ */
+
+/* 1 = Record context switches, queue and semaphore traffic, interrupts and
+ timer commands in a RAM ring (ktrace.c) and dump it as text; turn the dump
+ into a timeline with Host/Tools/ktrace_export.py.  8 KiB of RAM and a few
+ dozen cycles per kernel event.  Host/Makefile's mutex_trace target sets it
+ 0 = The kernel trace hooks stay empty */
+#ifndef APP_KTRACE
+#define APP_KTRACE                      0
+#endif
+
+/* 1 = Dump over SWO (ITM port 0)
+ 0 = Dump over USART2, between the demo's own lines */
+#ifndef APP_KTRACE_SWO
+#define APP_KTRACE_SWO                  0
+#endif
+
+/* 1 = Stop recording when the ring is full: the trace covers start-up
+ 0 = Flight recorder: keep overwriting the oldest events until
+     ktrace_trigger() is called */
+#ifndef APP_KTRACE_SNAPSHOT
+#define APP_KTRACE_SNAPSHOT             1
+#endif
+
+#endif /* APP_CONFIG_H */
@@ -0,0 +1,62 @@
+/**
+ ******************************************************************************
+ * @file           : ccm_ram.h
+ * @brief          : Kernel heap and task stacks in the 64 KB core-coupled
+ *                   memory (CCM RAM) of the STM32F407 (APP_CCM_RAM).
+ *
+ * @description    : CCM RAM (0x1000_0000) is wired to the Cortex-M4 D-bus
+ *                   only.  The DMA controllers cannot reach it, so the CPU
+ *                   never waits there behind a DMA transfer to main SRAM,
+ *                   and a DMA stream pointed at it fails with a transfer
+ *                   error.  Stacks and TCBs are touched by the CPU alone and
+ *                   belong there; DMA buffers stay in main SRAM.
+ *
+ *                   With APP_CCM_RAM = 1 (app_config.h):
+ *
+ *                     heap build    heap_5.c replaces heap_4.c, and
+ *                                   ccm_ram_heap_init() gives it two
+ *                                   regions: APP_CCM_HEAP_SIZE bytes of CCM
+ *                                   and the rest of configTOTAL_HEAP_SIZE in
+ *                                   main SRAM.  First fit from the lowest
+ *                                   address fills CCM first.
+ *                     static build  STATIC_TASK() stacks and TCBs
+ *                                   (static_alloc.h) are CCM_TASK_BSS.
+ *
+ *                   CCM variables go to the linker's .ccmbss section, which
+ *                   the startup code does not clear: put there only storage
+ *                   that is written before it is read, as the kernel does
+ *                   with a stack and a TCB.
+ ******************************************************************************
+ */
+
+#ifndef CCM_RAM_H
+#define CCM_RAM_H
+
+#include "app_config.h"
+
+/* ========================== Memory Map =================================== */
+#define CCM_RAM_BASE        0x10000000UL
+#define CCM_RAM_SIZE        0x00010000UL   /* 64 KB, CPU (D-bus) only        */
+
+/* ========================== Placement ==================================== */
+
+/* A variable in CCM RAM, whatever APP_CCM_RAM says; never zeroed */
+#define CCM_BSS(var)        __attribute__((section(".ccmbss." #var)))
+
+/* Task stack or TCB: in CCM RAM with APP_CCM_RAM = 1, in .bss otherwise */
+#if APP_CCM_RAM
+#define CCM_TASK_BSS(var)   CCM_BSS(var)
+#else
+#define CCM_TASK_BSS(var)
+#endif
+
+/* ========================== Public API =================================== */
+
+/**
+ * @brief  Hand the heap regions to heap_5.c.  Call once, before the first
+ *         kernel object is created.  Does nothing unless APP_CCM_RAM = 1 in
+ *         a heap build.
+ */
+void ccm_ram_heap_init(void);
+
+#endif /* CCM_RAM_H */
@@ -0,0 +1,83 @@
+/**
+ ******************************************************************************
+ * @file           : ktrace.h
+ * @brief          : Kernel event tracer.  The FreeRTOS trace hooks
+ *                   (ktrace_freertos.h) store timestamped events in a RAM
+ *                   ring.  A low-priority task dumps the ring as text over
+ *                   UART or SWO, and Host/Tools/ktrace_export.py turns the
+ *                   dump into a Chrome trace for ui.perfetto.dev.
+ *
+ * @description    : Enabled by APP_KTRACE in app_config.h.  What is recorded:
+ *                   context switches, tasks made ready, delays, queue /
+ *                   semaphore / mutex sends and receives (with the count
+ *                   before each one), blocking, priority inheritance,
+ *                   interrupt entry and exit, and timer commands.
+ *
+ *                   With APP_KTRACE_SNAPSHOT = 1 recording starts in
+ *                   ktrace_init() and stops when the ring is full, so a
+ *                   dump covers the first KTRACE_RING_EVENTS events after
+ *                   start-up.  With 0 the ring keeps overwriting its
+ *                   oldest events until ktrace_trigger() is called, so a
+ *                   dump covers the events leading up to the trigger.
+ *
+ *                   Dump, one line each, hex event words:
+ *
+ *                     @kt begin <version> <cpu_hz> <tick_hz> <events> <lost>
+ *                     @kt task <id> <priority> <name>
+ *                     @kt obj <id> <queue type> <name or ->
+ *                     @kt ev <event word><timestamp> ...  (up to 8 per line)
+ *                     @kt end <events> <sum of all words, hex>
+ *
+ *                   The converter skips every line that has no "@kt", so
+ *                   the dump can share the console with the demo's own
+ *                   text.
+ ******************************************************************************
+ */
+
+#ifndef KTRACE_H
+#define KTRACE_H
+
+#include "main.h"
+#include <stdint.h>
+
+/* ========================== Configuration ================================ */
+#define KTRACE_RING_EVENTS      1024U  /* 8 KiB of RAM, power of two         */
+#define KTRACE_MAX_TASKS        16U    /* Named tasks; later ones get id 0   */
+#define KTRACE_MAX_OBJECTS      16U    /* Queues, semaphores and mutexes     */
+#define KTRACE_NAME_LEN         16U    /* Including the terminator           */
+#define KTRACE_POLL_MS          100U   /* Dump task checks this often        */
+#define KTRACE_STACK_WORDS      256U   /* Dump task: one formatted line      */
+
+/* ========================== Public API =================================== */
+
+/**
+ * @brief  Writes one dump line.  Called from the dump task only; may block,
+ *         and has to keep the line whole against the demo's other UART
+ *         writers.
+ */
+typedef void (*ktrace_send_t)(const char *line, uint32_t len);
+
+/**
+ * @brief  Start the DWT cycle counter and start recording.  Call before the
+ *         tasks and queues of interest are created, so that the dump can
+ *         name them.
+ */
+void ktrace_init(void);
+
+/**
+ * @brief  Create the task that dumps the ring once recording has stopped.
+ * @param  send      Line output when APP_KTRACE_SWO is 0: the demo's
+ *                   console.  Unused with SWO.
+ * @param  priority  Dump task priority; keep it at or below the lowest
+ *                   application task.
+ * @return pdPASS, or the xTaskCreate() error.
+ */
+int32_t ktrace_start(ktrace_send_t send, uint32_t priority);
+
+/**
+ * @brief  Stop recording now and have the dump task send the ring.
+ *         Task or ISR context.  Later calls do nothing.
+ */
+void ktrace_trigger(void);
+
+#endif /* KTRACE_H */
@@ -0,0 +1,26 @@
+/**
+ ******************************************************************************
+ * @file           : stack_sizes.h
+ * @brief          : Stack size of every task, in stack words.
+ *
+ * @description    : Host/Tools/stack_size.py rewrites the values below from
+ *                   a stack profile (APP_STACK_PROFILE in app_config.h) and
+ *                   the compiler's call graph (-fcallgraph-info=su), and
+ *                   leaves the rest of this file alone.  The comment after
+ *                   each value says where it came from; "estimate" is a
+ *                   hand-picked size that has not been profiled.
+ *
+ *                   FreeRTOSConfig.h takes the idle and timer service task
+ *                   stacks from here too.
+ ******************************************************************************
+ */
+
+#ifndef STACK_SIZES_H
+#define STACK_SIZES_H
+
+#define STACK_WORDS_TASK1               500U    /* estimate */
+#define STACK_WORDS_TASK2               500U    /* estimate */
+#define STACK_WORDS_IDLE_TASK           128U    /* estimate */
+#define STACK_WORDS_TIMER_TASK          256U    /* estimate */
+
+#endif /* STACK_SIZES_H */
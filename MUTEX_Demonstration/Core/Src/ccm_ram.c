@@ -0,0 +1,63 @@
+/**
+ ******************************************************************************
+ * @file           : ccm_ram.c
+ * @brief          : The two heap_5 regions of an APP_CCM_RAM heap build.
+ *
+ * @description    : configTOTAL_HEAP_SIZE stays the size of the whole heap;
+ *                   APP_CCM_HEAP_SIZE bytes of it are taken from CCM RAM and
+ *                   the rest from main SRAM:
+ *
+ *                     0x1000_0000  ccm_heap   APP_CCM_HEAP_SIZE     region 0
+ *                     0x2000_xxxx  sram_heap  total - CCM part      region 1
+ *
+ *                   heap_5 allocates first fit from the lowest address, so
+ *                   the task stacks and TCBs created at start-up land in
+ *                   CCM until it is full, and only later (or larger) blocks
+ *                   spill into main SRAM.
+ ******************************************************************************
+ */
+
+#include "ccm_ram.h"
+#include "FreeRTOS.h"
+
+#if ( configUSE_HEAP_5 == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+#include <stdint.h>
+
+_Static_assert(APP_CCM_HEAP_SIZE <= CCM_RAM_SIZE,
+               "APP_CCM_HEAP_SIZE is larger than CCM RAM");
+_Static_assert(APP_CCM_HEAP_SIZE < configTOTAL_HEAP_SIZE,
+               "configTOTAL_HEAP_SIZE must leave a main SRAM part");
+
+/* ========================== Private Data ================================= */
+static uint8_t ccm_heap[APP_CCM_HEAP_SIZE]
+    CCM_BSS(ccm_heap) __attribute__((aligned(8)));
+static uint8_t sram_heap[configTOTAL_HEAP_SIZE - APP_CCM_HEAP_SIZE]
+    __attribute__((aligned(8)));
+
+/* ========================== Public API =================================== */
+
+void ccm_ram_heap_init(void)
+{
+    HeapRegion_t regions[3] = {
+        { ccm_heap,  sizeof(ccm_heap)  },
+        { sram_heap, sizeof(sram_heap) },
+        { NULL,      0                 }
+    };
+
+    /* heap_5 wants the regions in address order.  On the board CCM is
+     * always below main SRAM; a host build puts the sections anywhere. */
+    if ((uintptr_t)sram_heap < (uintptr_t)ccm_heap) {
+        regions[0] = regions[1];
+        regions[1] = (HeapRegion_t){ ccm_heap, sizeof(ccm_heap) };
+    }
+    vPortDefineHeapRegions(regions);
+}
+
+#else  /* heap_4 / heap_tlsf, or no heap */
+
+void ccm_ram_heap_init(void)
+{
+}
+
+#endif /* configUSE_HEAP_5 */
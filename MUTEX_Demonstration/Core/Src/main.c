@@ -23,9 +23,7 @@
 /* USER CODE END Header */
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
-#include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 #include <stdarg.h>
 
 /* Private includes ----------------------------------------------------------*/
@@ -34,6 +32,12 @@
 #include "task.h"
 #include "semphr.h"
 #include "queue.h"
+#include "fmt_lite.h"    /* fmt_vsnprintf - small reentrant printf subset */
+#include "ktrace.h"      /* kernel event trace - APP_KTRACE in app_config.h */
+#include "static_alloc.h" /* kernel objects - APP_STATIC_ALLOC in app_config.h */
+#include "stack_sizes.h"  /* STACK_WORDS_* - task stack sizes */
+#include "stack_prof.h"   /* stack use reports - APP_STACK_PROFILE in app_config.h */
+#include "ccm_ram.h"      /* heap regions in CCM RAM - APP_CCM_RAM in app_config.h */
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -43,6 +47,7 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define PRINT_LINE_SIZE 96U     /* longest vPrint() line + terminator */
 
 
 /* USER CODE END PD */
@@ -90,6 +95,30 @@ void vApplicationMallocFailedHook(void) {
 		; /* Hang here — debugger will stop at this line */
 }
 
+/* Idle and timer service task memory (configSUPPORT_STATIC_ALLOCATION).
+ With APP_STATIC_ALLOC the kernel has no heap, so instead of allocating
+ these two tasks at vTaskStartScheduler() it asks for this storage. */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+STATIC_TASK(idle_task, configMINIMAL_STACK_SIZE);
+STATIC_TASK(timer_task, configTIMER_TASK_STACK_DEPTH);
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+		StackType_t **ppxIdleTaskStackBuffer,
+		configSTACK_DEPTH_TYPE *puxIdleTaskStackSize) {
+	*ppxIdleTaskTCBBuffer = STATIC_TASK_TCB(idle_task);
+	*ppxIdleTaskStackBuffer = STATIC_TASK_STACK(idle_task);
+	*puxIdleTaskStackSize = kobj_idle_task_words;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+		StackType_t **ppxTimerTaskStackBuffer,
+		configSTACK_DEPTH_TYPE *puxTimerTaskStackSize) {
+	*ppxTimerTaskTCBBuffer = STATIC_TASK_TCB(timer_task);
+	*ppxTimerTaskStackBuffer = STATIC_TASK_STACK(timer_task);
+	*puxTimerTaskStackSize = kobj_timer_task_words;
+}
+#endif
+
 
 
 
@@ -99,7 +128,6 @@ void vApplicationMallocFailedHook(void) {
  *  Uncomment    = clean output   (mutex protection)
  * =================================================================== */
 #define USE_MUTEX
-static char g_acBuf[200];
 
 /*
  * MUTEX (Mutual Exclusion):
@@ -122,19 +150,45 @@ static char g_acBuf[200];
  */
 static SemaphoreHandle_t g_xMutex = NULL;
 
+/* Storage of the mutex and both tasks: static with APP_STATIC_ALLOC, else heap */
+STATIC_SEMAPHORE(uart_mutex);
+STATIC_TASK(task1, STACK_WORDS_TASK1);
+STATIC_TASK(task2, STACK_WORDS_TASK2);
+
 /* The strings each task will try to print */
 static const char *pcTask1String = "Task1 ::::: Hello from low-priority task, this is a task1's string to show the problem\r\n";
 static const char *pcTask2String = "Task2 ----- Hello from high-priority task, this string can interrupt Task1 anytime if USE_MUTEX not defined\r\n";
 
-/* ----  print helper ---- */
+/* ----  print helper (fmt_vsnprintf into a stack buffer - reentrant) ---- */
 static void vPrint(const char *fmt, ...)
 {
+    char    acLine[PRINT_LINE_SIZE];   /* own copy per call - no sharing   */
+    int     iLen;
     va_list args;
+
     va_start(args, fmt);
-    vsnprintf(g_acBuf, sizeof(g_acBuf), fmt, args);
+    iLen = fmt_vsnprintf(acLine, sizeof(acLine), fmt, args);
     va_end(args);
-    HAL_UART_Transmit(&huart2, (uint8_t *)g_acBuf,
-                       (uint16_t)strlen(g_acBuf), HAL_MAX_DELAY);
+    HAL_UART_Transmit(&huart2, (uint8_t *)acLine, (uint16_t)iLen, HAL_MAX_DELAY);
+}
+
+/* ----  report output: one stack profile or trace dump line, under the
+ *        mutex like the task strings so it never lands in the middle of
+ *        one.  Without USE_MUTEX a task may have the UART right now (the
+ *        HAL then reports busy); the line waits instead of being lost ---- */
+static void vReportSend(const char *pcLine, uint32_t ulLen)
+{
+#ifdef USE_MUTEX
+    xSemaphoreTake(g_xMutex, portMAX_DELAY);
+#endif
+    while (HAL_UART_Transmit(&huart2, (uint8_t *)pcLine, (uint16_t)ulLen,
+                             HAL_MAX_DELAY) == HAL_BUSY)
+    {
+        vTaskDelay(1);
+    }
+#ifdef USE_MUTEX
+    xSemaphoreGive(g_xMutex);
+#endif
 }
 
 /* =========================================================================
@@ -257,16 +311,29 @@ int main(void) {
 	MX_GPIO_Init();
 	MX_USART2_UART_Init();
 	/* USER CODE BEGIN 2 */
+    /* Heap regions before the first create (no-op unless APP_CCM_RAM) */
+    ccm_ram_heap_init();
+
+    /* Before anything is created, so the trace can name it */
+    ktrace_init();
+
 #ifdef USE_MUTEX
     vPrint("\r\n=== Mutex ENABLED - output should be CLEAN ===\r\n\r\n");
-    g_xMutex = xSemaphoreCreateMutex();
+    g_xMutex = STATIC_SEMAPHORE_CREATE_MUTEX(uart_mutex);
+    vQueueAddToRegistry(g_xMutex, "UartMutex");
 #else
     vPrint("\r\n=== Mutex DISABLED - output will be GARBLED ===\r\n\r\n");
 #endif
 
     /* Task1 = low priority, Task2 = high priority */
-    xTaskCreate(vTask1, "Task1-Low",  500, NULL, 1, NULL);
-    xTaskCreate(vTask2, "Task2-High", 500, NULL, 2, NULL);
+    STATIC_TASK_CREATE(task1, vTask1, "Task1-Low",  NULL, 1, NULL);
+    STATIC_TASK_CREATE(task2, vTask2, "Task2-High", NULL, 2, NULL);
+
+    /* Idle priority: dumps the trace while both tasks sleep */
+    ktrace_start(vReportSend, tskIDLE_PRIORITY);
+
+    /* Idle priority too: peak stack use of both tasks, every 10 s */
+    stack_prof_start(vReportSend, tskIDLE_PRIORITY);
 
     vTaskStartScheduler();
 		/* USER CODE END 2 */
@@ -0,0 +1,62 @@
+/**
+ ******************************************************************************
+ * @file           : app_config.h
+ * @brief          : Application feature switches for the four-LED task demo.
+ *
+ * @description    : Kernel options are selected here with a 0/1 switch.
+ *                   FreeRTOSConfig.h includes this file so that kernel
+ *                   settings can follow the switches.
+ ******************************************************************************
+ */
+
+#ifndef APP_CONFIG_H
+#define APP_CONFIG_H
+
+/* ============================================================
+ *  KERNEL OBJECT ALLOCATION
+ * ============================================================ */
+
+/* 1 = Static profile: the four LED tasks, the idle task and the timer task
+     get their stacks and TCBs from variables declared with static_alloc.h,
+     and the kernel is built without a heap (configSUPPORT_DYNAMIC_ALLOCATION
+     0); Host/Tools/ram_report.py lists the RAM per task from the map file
+ 0 = Tasks are taken from the configTOTAL_HEAP_SIZE heap at creation */
+#ifndef APP_STATIC_ALLOC
+#define APP_STATIC_ALLOC                0
+#endif
+
+/* ============================================================
+ *  STACK PROFILE
+ * ============================================================ */
+
+/* 1 = A task at idle priority prints the peak stack use of every task as
+     "@stk" lines over SWO (ITM port 0) every 10 s (stack_prof.c); press
+     the button through the deletion chain, then feed the last report and
+     the compiler's call graph to Host/Tools/stack_size.py to rewrite
+     Core/Inc/stack_sizes.h.  Turns on configRECORD_STACK_HIGH_ADDRESS
+ 0 = Stack sizes stay as stack_sizes.h has them, with no profiler */
+#ifndef APP_STACK_PROFILE
+#define APP_STACK_PROFILE               0
+#endif
+
+/* ============================================================
+ *  CCM RAM
+ * ============================================================ */
+
+/* 1 = Task stacks and TCBs go to the 64 KB core-coupled RAM, which only
+     the CPU can reach (ccm_ram.h): with the heap, heap_5.c spreads it over
+     APP_CCM_HEAP_SIZE bytes of CCM plus main SRAM and fills CCM first;
+     with APP_STATIC_ALLOC the STATIC_TASK() storage is placed there
+ 0 = Everything in main SRAM */
+#ifndef APP_CCM_RAM
+#define APP_CCM_RAM                     0
+#endif
+
+/* Bytes of the heap (configTOTAL_HEAP_SIZE) placed in CCM RAM when
+   APP_CCM_RAM = 1; the rest stays in main SRAM.  At most 64 KB, and less
+   than the whole heap */
+#ifndef APP_CCM_HEAP_SIZE
+#define APP_CCM_HEAP_SIZE               (32 * 1024)
+#endif
+
+#endif /* APP_CONFIG_H */
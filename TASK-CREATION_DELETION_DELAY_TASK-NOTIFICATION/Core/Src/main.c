@@ -26,6 +26,10 @@
 /* USER CODE BEGIN Includes */
 #include "FreeRTOS.h"
 #include "task.h"
+#include "static_alloc.h" /* kernel objects - APP_STATIC_ALLOC in app_config.h */
+#include "stack_sizes.h"  /* STACK_WORDS_* - task stack sizes */
+#include "stack_prof.h"   /* stack use reports - APP_STACK_PROFILE in app_config.h */
+#include "ccm_ram.h"      /* heap regions in CCM RAM - APP_CCM_RAM in app_config.h */
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -41,6 +45,7 @@ static void task2_GREEN_LED(void *parameters);
 static void task3_BLUE_LED(void *parameters);
 static void task4_ORANGE_LED(void *parameters);
 void button_interrupt_handler(void);
+static void stack_prof_send(const char *line, uint32_t len);
 
 /* Task handles — needed to send notifications and manage deletion */
 TaskHandle_t task1_RED_LED_handle;
@@ -48,6 +53,12 @@ TaskHandle_t task2_GREEN_LED_handle;
 TaskHandle_t task3_BLUE_LED_handle;
 TaskHandle_t task4_ORANGE_LED_handle;
 
+/* Stack + TCB of each task: static with APP_STATIC_ALLOC, else heap */
+STATIC_TASK(task1, STACK_WORDS_TASK1);
+STATIC_TASK(task2, STACK_WORDS_TASK2);
+STATIC_TASK(task3, STACK_WORDS_TASK3);
+STATIC_TASK(task4, STACK_WORDS_TASK4);
+
 /*
  * Points to the task that should be deleted on the next button press.
  * Marked volatile because it is shared between task context (critical section)
@@ -100,6 +111,30 @@ void vApplicationMallocFailedHook(void) {
 		; /* Hang here — debugger will stop at this line */
 }
 
+/* Idle and timer service task memory (configSUPPORT_STATIC_ALLOCATION).
+ With APP_STATIC_ALLOC the kernel has no heap, so instead of allocating
+ these two tasks at vTaskStartScheduler() it asks for this storage. */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+STATIC_TASK(idle_task, configMINIMAL_STACK_SIZE);
+STATIC_TASK(timer_task, configTIMER_TASK_STACK_DEPTH);
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+		StackType_t **ppxIdleTaskStackBuffer,
+		configSTACK_DEPTH_TYPE *puxIdleTaskStackSize) {
+	*ppxIdleTaskTCBBuffer = STATIC_TASK_TCB(idle_task);
+	*ppxIdleTaskStackBuffer = STATIC_TASK_STACK(idle_task);
+	*puxIdleTaskStackSize = kobj_idle_task_words;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+		StackType_t **ppxTimerTaskStackBuffer,
+		configSTACK_DEPTH_TYPE *puxTimerTaskStackSize) {
+	*ppxTimerTaskTCBBuffer = STATIC_TASK_TCB(timer_task);
+	*ppxTimerTaskStackBuffer = STATIC_TASK_STACK(timer_task);
+	*puxTimerTaskStackSize = kobj_timer_task_words;
+}
+#endif
+
 /* ---------------------------------------------------------------------------
  * RED LED (PD14) — Toggles every 1 s.
  *
@@ -208,6 +243,20 @@ static void task4_ORANGE_LED(void *parameters)
 	}
 }
 
+/* ---------------------------------------------------------------------------
+ * Stack profile output — one report line (stack_prof.c) over SWO.
+ *
+ * The board has no console, so the lines go to ITM port 0; capture them
+ * with the debugger's SWV console into a file for Host/Tools/stack_size.py.
+ * ---------------------------------------------------------------------------*/
+static void stack_prof_send(const char *line, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; i++)
+	{
+		(void)ITM_SendChar((uint32_t)(uint8_t)line[i]);
+	}
+}
+
 /* ---------------------------------------------------------------------------
  * Button ISR handler — called from HAL_GPIO_EXTI_Callback() on PA0 press.
  *
@@ -274,32 +323,39 @@ int main(void) {
 	MX_GPIO_Init();
 	/* USER CODE BEGIN 2 */
 
+	/* Heap regions before the first create (no-op unless APP_CCM_RAM) */
+	ccm_ram_heap_init();
+
 	/*
 	 * Create four tasks — all at priority 2 (equal = round-robin scheduling).
-	 *  xTaskCreate(function,   name,    stack,   parameter,  priority,  handle);
-	 ↑          ↑        ↑           ↑           ↑         ↑
-	 what to    debug    how much    data to    who runs   task ID
-	 run       name      RAM        pass in     first    (optional)  */
+	 *  STATIC_TASK_CREATE(storage, function, name, parameter, priority, handle);
+	 ↑          ↑         ↑       ↑           ↑         ↑
+	 STATIC_TASK  what to   debug   data to    who runs   task ID
+	 (stack size) run       name    pass in     first    (optional)  */
 
-	status = xTaskCreate(task1_RED_LED, "TASK-1", 200, NULL, 2,
+	status = STATIC_TASK_CREATE(task1, task1_RED_LED, "TASK-1", NULL, 2,
 			&task1_RED_LED_handle);
 	configASSERT(status = pdPASS);
 
-	status = xTaskCreate(task2_GREEN_LED, "TASK-2", 200, NULL, 2,
+	status = STATIC_TASK_CREATE(task2, task2_GREEN_LED, "TASK-2", NULL, 2,
 			&task2_GREEN_LED_handle);
 	configASSERT(status = pdPASS);
 
 	/* Green is the first target in the deletion chain */
 	task_to_delete_handle = task2_GREEN_LED_handle;
 
-	status = xTaskCreate(task3_BLUE_LED, "TASK-3", 200, NULL, 2,
+	status = STATIC_TASK_CREATE(task3, task3_BLUE_LED, "TASK-3", NULL, 2,
 			&task3_BLUE_LED_handle);
 	configASSERT(status = pdPASS);
 
-	status = xTaskCreate(task4_ORANGE_LED, "TASK-4", 200, NULL, 2,
+	status = STATIC_TASK_CREATE(task4, task4_ORANGE_LED, "TASK-4", NULL, 2,
 			&task4_ORANGE_LED_handle);
 	configASSERT(status = pdPASS);
 
+	/* Idle priority: reports peak stack use while every LED task sleeps */
+	status = stack_prof_start(stack_prof_send, tskIDLE_PRIORITY);
+	configASSERT(status == pdPASS);
+
 	//start the freeRTOS scheduler
 	vTaskStartScheduler();
 
@@ -26,6 +26,11 @@
 extern uint32_t SystemCoreClock;
 #endif
 
+/* Application feature switches (APP_*) that some settings below follow */
+#include "app_config.h"
+/* Stack size of every task in words (Host/Tools/stack_size.py writes it) */
+#include "stack_sizes.h"
+
 /* ============================================================
  *  SECTION 1 — SCHEDULER
  * ============================================================ */
@@ -56,10 +61,18 @@ extern uint32_t SystemCoreClock;
  *  SECTION 3 — TASK PRIORITIES
  * ============================================================ */
 
-/* Total number of priority levels available — gives you levels 0, 1, 2, 3, 4
- Level 0 is reserved for the FreeRTOS Idle task, your tasks use levels 1 to 4
- Do not set this larger than needed — each extra level wastes a small amount of RAM */
-#define configMAX_PRIORITIES                    ( 5 )
+/* Total number of priority levels available — gives you levels 0 to 31
+ Level 0 is reserved for the FreeRTOS Idle task, your tasks use levels 1 to 31
+ Each level costs one 20-byte ready list (640 bytes for 32); with the optimised
+ selection below, picking the next task costs the same at any level count */
+#define configMAX_PRIORITIES                    ( 32 )
+
+/* 1 = The port keeps one "ready" bit per priority and finds the highest set bit
+     with a single CLZ instruction (Cortex-M4; __builtin_clz on the host port),
+     so a context switch costs the same for 2 or 32 priorities in use
+ 0 = Generic C: scan the ready lists down one priority at a time
+ The port's portmacro.h rejects 1 with more than 32 priorities at compile time */
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
 
 /* ============================================================
  *  SECTION 4 — MEMORY (STACK AND HEAP)
@@ -67,14 +80,33 @@ extern uint32_t SystemCoreClock;
 
 /* Minimum stack size for any task, measured in WORDS not bytes
  On STM32 (32-bit CPU): 1 word = 4 bytes, so 128 words = 512 bytes
- This is the bare minimum — give your own tasks 256 or 512 words each */
-#define configMINIMAL_STACK_SIZE                ( ( unsigned short ) 128 )
+ This is also the idle task's stack — give your own tasks 256 or 512 words each
+ Set by STACK_WORDS_IDLE_TASK in stack_sizes.h */
+#define configMINIMAL_STACK_SIZE                ( ( unsigned short ) STACK_WORDS_IDLE_TASK )
 
 /* Total RAM pool given to FreeRTOS for tasks, queues, semaphores and timers
  STM32F4 has 192 KB RAM total — starting with 50 KB for FreeRTOS is safe
  If you get a malloc failed error or crash at startup → increase this number */
 #define configTOTAL_HEAP_SIZE                   ( ( size_t ) ( 50 * 1024 ) )
 
+/* How the heap above is laid out
+ 0 = One array in main SRAM (heap_4 or heap_tlsf)
+ 1 = heap_5: APP_CCM_HEAP_SIZE bytes of it in the 64 KB CCM RAM, the rest
+     in main SRAM, first fit from the CCM end so task stacks and TCBs go
+     there first.  CCM is CPU only: nothing from pvPortMalloc() may be
+     given to DMA.  Set by APP_CCM_RAM in app_config.h */
+#define configUSE_HEAP_5                        APP_CCM_RAM
+
+/* Where the kernel objects' memory comes from
+ Static = xTaskCreateStatic() and friends with storage the application
+          declares (static_alloc.h), plus the idle and timer task memory
+          callbacks in main.c
+ Dynamic = pvPortMalloc() from the heap above
+ APP_STATIC_ALLOC = 1 builds static only: no heap is linked and
+ configTOTAL_HEAP_SIZE is unused.  Set by APP_STATIC_ALLOC in app_config.h */
+#define configSUPPORT_STATIC_ALLOCATION         APP_STATIC_ALLOC
+#define configSUPPORT_DYNAMIC_ALLOCATION        ( !APP_STATIC_ALLOC )
+
 /* ============================================================
  *  SECTION 5 — TASK SETTINGS
  * ============================================================ */
@@ -126,9 +158,10 @@ extern uint32_t SystemCoreClock;
 #define configTIMER_QUEUE_LENGTH                10
 
 /* Stack size in WORDS for the timer service task
- MINIMAL_STACK_SIZE x 2 = 256 words = 1024 bytes, enough for simple callbacks
- Increase this if your timer callbacks use sprintf, floating point, or call many functions */
-#define configTIMER_TASK_STACK_DEPTH            ( configMINIMAL_STACK_SIZE * 2 )
+ 256 words = 1024 bytes to start with, enough for simple callbacks
+ Increase this if your timer callbacks use sprintf, floating point, or call many functions
+ Set by STACK_WORDS_TIMER_TASK in stack_sizes.h */
+#define configTIMER_TASK_STACK_DEPTH            STACK_WORDS_TIMER_TASK
 
 /* Enable the trace facility so debugger tools can inspect task states and timing
  Required by FreeRTOS+Trace and Segger SystemView — almost no runtime overhead
@@ -154,6 +187,11 @@ extern uint32_t SystemCoreClock;
  You must write this function — keep at 2 during all development and testing */
 #define configCHECK_FOR_STACK_OVERFLOW          2
 
+/* 1 = Keep the top address of each stack in its TCB, so that
+ uxTaskGetSystemState() reports stack sizes to the stack profiler (stack_prof.c)
+ Set by APP_STACK_PROFILE in app_config.h */
+#define configRECORD_STACK_HIGH_ADDRESS         APP_STACK_PROFILE
+
 /* ============================================================
  *  SECTION 8 — HOOKS YOU DO NOT NEED YET — LEAVE ALL OFF
  * ============================================================ */
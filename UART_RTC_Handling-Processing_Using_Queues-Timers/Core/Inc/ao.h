@@ -0,0 +1,159 @@
+/**
+ ******************************************************************************
+ * @file           : ao.h
+ * @brief          : Minimal active-object framework (event queue + HSM).
+ *
+ * @description    : An active object owns one task, one FreeRTOS queue of
+ *                   events and a hierarchical state machine.  The task takes
+ *                   one event at a time and runs it to completion through
+ *                   the current state and, if unhandled, its ancestors.
+ *                   Nothing else touches the state machine, so handlers need
+ *                   no locking and never block waiting on another task.
+ *
+ *                   A state is a handler plus a parent pointer.  Handlers
+ *                   return AO_HANDLED, AO_UNHANDLED (ask the parent) or
+ *                   AO_TRAN(me, target).  On a transition the framework
+ *                   sends AO_SIG_EXIT up to the least common ancestor and
+ *                   AO_SIG_ENTRY down to the target.  Targets must be leaf
+ *                   states; a transition to the current state exits and
+ *                   re-enters it.
+ ******************************************************************************
+ */
+
+#ifndef AO_H
+#define AO_H
+
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "static_alloc.h"
+
+/* ========================== Signals ====================================== */
+#define AO_SIG_ENTRY        1U     /* State entered (framework generated)    */
+#define AO_SIG_EXIT         2U     /* State left (framework generated)       */
+#define AO_SIG_USER         8U     /* First application signal               */
+
+/* Deepest state nesting supported by a transition (root = depth 1) */
+#define AO_MAX_DEPTH        6U
+
+/**
+ * @brief  Event, copied by value into the active object's queue.
+ *         Small payloads travel inline so posting never allocates.
+ */
+typedef struct {
+    uint16_t sig;                  /* AO_SIG_* or application signal         */
+    uint16_t len;                  /* Payload length (may exceed data[])     */
+    uint8_t  data[APP_AO_EVENT_DATA]; /* Inline payload                      */
+} ao_event_t;
+
+typedef struct ao       ao_t;
+typedef struct ao_state ao_state_t;
+
+/**
+ * @brief  Result of a state handler.
+ */
+typedef enum {
+    AO_HANDLED = 0,                /* Event consumed                         */
+    AO_UNHANDLED,                  /* Pass the event to the parent state     */
+    AO_TRANSITION,                 /* Consumed; go to me->target             */
+} ao_result_t;
+
+/**
+ * @brief  State handler.
+ * @param  me    Active object being dispatched.
+ * @param  self  The state whose handler this is (for shared handlers).
+ * @param  e     Event to process.
+ */
+typedef ao_result_t (*ao_handler_t)(ao_t *me, const ao_state_t *self,
+                                    const ao_event_t *e);
+
+/**
+ * @brief  One state of a hierarchical state machine.  Usually the first
+ *         member of a larger const struct carrying per-state data.
+ */
+struct ao_state {
+    const ao_state_t *parent;      /* Enclosing state, NULL for the root     */
+    ao_handler_t      handler;
+};
+
+/**
+ * @brief  Active object instance.
+ */
+struct ao {
+    QueueHandle_t     queue;       /* Incoming events                        */
+    TaskHandle_t      task;        /* Task running the event loop            */
+    const ao_state_t *state;       /* Current leaf state                     */
+    const ao_state_t *target;      /* Set by AO_TRAN()                       */
+    const ao_state_t *initial;     /* Leaf entered when the task starts      */
+};
+
+/**
+ * @brief  Memory for an active object's event queue and task.  Pass
+ *         AO_MEM(name) for storage declared with AO_STORAGE(name, ...);
+ *         the pointers are NULL (heap) unless APP_STATIC_ALLOC is 1.
+ */
+typedef struct {
+    UBaseType_t            queue_len;   /* Event queue depth                 */
+    configSTACK_DEPTH_TYPE stack_words; /* Task stack in words               */
+    uint8_t               *queue_buf;   /* queue_len events                  */
+    StaticQueue_t         *queue;       /* Queue structure                   */
+    StackType_t           *stack;       /* stack_words words                 */
+    StaticTask_t          *tcb;         /* Task control block                */
+    const char            *object;      /* AO_STORAGE() name (stack_prof.c)  */
+} ao_mem_t;
+
+/* File-scope event queue and task storage of active object 'name' */
+#define AO_STORAGE(name, queue_len, stack_words)                              \
+    STATIC_QUEUE(name, queue_len, sizeof(ao_event_t));                        \
+    STATIC_TASK(name, stack_words)
+
+/* const ao_mem_t * describing AO_STORAGE(name), for ao_start() */
+#define AO_MEM(name)                                                          \
+    (&(const ao_mem_t){ kobj_##name##_length, kobj_##name##_words,            \
+                        STATIC_QUEUE_STORAGE(name), STATIC_QUEUE_STRUCT(name),\
+                        STATIC_TASK_STACK(name), STATIC_TASK_TCB(name),   \
+                        #name })
+
+/* Request a transition from inside a handler: return AO_TRAN(me, &s) */
+#define AO_TRAN(me, tgt)    ((me)->target = (tgt), AO_TRANSITION)
+
+/**
+ * @brief  Create the event queue and task.  The initial state is entered
+ *         (ENTRY actions run) from the new task once the scheduler starts.
+ * @param  me          Instance to start.
+ * @param  name        Task name.
+ * @param  initial     Leaf state to enter first.
+ * @param  mem         Queue depth, stack size and storage (AO_MEM()).
+ * @param  priority    Task priority.
+ */
+void       ao_start(ao_t *me, const char *name, const ao_state_t *initial,
+                    const ao_mem_t *mem, UBaseType_t priority);
+
+/**
+ * @brief  Post an event (task context).
+ * @param  me    Target active object.
+ * @param  e     Event to copy into the queue.
+ * @param  wait  Ticks to wait for queue space (0 from the object itself).
+ * @return pdTRUE if queued.
+ */
+BaseType_t ao_post(ao_t *me, const ao_event_t *e, TickType_t wait);
+
+/**
+ * @brief  Post an event (ISR context).
+ * @param  me     Target active object.
+ * @param  e      Event to copy into the queue.
+ * @param  woken  Accumulates the "higher priority task woken" flag.
+ * @return pdTRUE if queued.
+ */
+BaseType_t ao_post_from_isr(ao_t *me, const ao_event_t *e, BaseType_t *woken);
+
+/**
+ * @brief  Run one event to completion through the state hierarchy.
+ *         Called by the active object's own task only.
+ * @param  me  Active object.
+ * @param  e   Event to dispatch.
+ */
+void       ao_dispatch(ao_t *me, const ao_event_t *e);
+
+#endif /* AO_H */
@@ -0,0 +1,70 @@
+/**
+ ******************************************************************************
+ * @file           : app_bench.h
+ * @brief          : On-target benchmark hooks and the reporting task.
+ *
+ * @description    : Each benchmark is enabled by an APP_BENCH_* switch in
+ *                   app_config.h.  Instrumented code feeds raw DWT cycle
+ *                   counts in through the record functions below; a
+ *                   low-priority task prints one line per period on the
+ *                   ITM console (printf -> SWO).
+ ******************************************************************************
+ */
+
+#ifndef APP_BENCH_H
+#define APP_BENCH_H
+
+#include "main.h"
+
+/**
+ * @brief  Start the DWT counter and create the benchmark report task.
+ *         Does nothing when no APP_BENCH_* switch is enabled.
+ */
+void app_bench_init(void);
+
+/**
+ * @brief  Record one USART2 / RX-DMA interrupt (ISR context).
+ * @param  cycles  DWT cycles spent in the IRQ handler.
+ */
+void app_bench_uart_rx_isr(uint32_t cycles);
+
+/**
+ * @brief  Record bytes delivered to menu_ao by the RX path (ISR context).
+ * @param  bytes    Bytes accepted.
+ * @param  dropped  Bytes lost because the receive FIFO was full.
+ */
+void app_bench_uart_rx_bytes(uint32_t bytes, uint32_t dropped);
+
+/**
+ * @brief  Record one string handed to the UART by print_task (task context).
+ * @param  bytes   String length.
+ * @param  cycles  DWT cycles print_task spent in the transmit call.
+ */
+void app_bench_uart_tx_task(uint32_t bytes, uint32_t cycles);
+
+/**
+ * @brief  Record one transmit-side interrupt (ISR context).
+ * @param  cycles  DWT cycles spent in the TX DMA IRQ / completion callback.
+ */
+void app_bench_uart_tx_isr(uint32_t cycles);
+
+/**
+ * @brief  Record one dispatched command line (task context).
+ * @param  lookup_cycles  DWT cycles spent in cmd_lookup().
+ * @param  total_cycles   DWT cycles for lookup and handler.
+ */
+void app_bench_cmd_dispatch(uint32_t lookup_cycles, uint32_t total_cycles);
+
+/**
+ * @brief  Count one command line handled by menu_ao (task context).
+ *         Context switches are counted by traceTASK_SWITCHED_IN.
+ */
+void app_bench_ao_command(void);
+
+/**
+ * @brief  Record one run of the RTC report timer callback (timer task).
+ * @param  cycles  DWT cycles spent in the callback.
+ */
+void app_bench_rtc_report(uint32_t cycles);
+
+#endif /* APP_BENCH_H */
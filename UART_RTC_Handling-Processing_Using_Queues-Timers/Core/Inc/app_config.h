@@ -0,0 +1,372 @@
+/**
+ ******************************************************************************
+ * @file           : app_config.h
+ * @brief          : Application feature switches for the UART/RTC menu app.
+ *
+ * @description    : Every optional subsystem and benchmark mode is selected
+ *                   here with a 0/1 switch, so the rest of the code only
+ *                   ever tests these macros.  Included through main.h.
+ ******************************************************************************
+ */
+
+#ifndef APP_CONFIG_H
+#define APP_CONFIG_H
+
+/* ============================================================
+ *  UART LINK
+ * ============================================================ */
+
+/* USART2 baud rate.  The DMA receive path keeps up well above 115200;
+ the legacy per-byte interrupt path starts dropping bytes under load */
+#define APP_UART_BAUDRATE               115200U
+
+/* 1 = Receive via circular DMA + IDLE-line event into a stream buffer
+ 0 = Legacy path: one HAL_UART_Receive_IT interrupt per byte into
+     queue_uart_rx (kept so the two can be benchmarked side by side) */
+#define APP_UART_RX_DMA                 1
+
+/* Size in bytes of the circular DMA receive buffer.  The HAL raises an
+ event at half-transfer, transfer-complete and IDLE, so each half must
+ cover the worst-case ISR latency at the chosen baud rate */
+#define APP_UART_RX_DMA_BUF_SIZE        128U
+
+/* Size in bytes of the stream buffer between the RX ISR and menu_ao */
+#define APP_UART_RX_STREAM_SIZE         256U
+
+/* 1 = Transmit via a ring buffer drained by DMA1 Stream6 in contiguous
+     chunks; print_task only copies bytes and sleeps when the ring is full
+ 0 = Legacy path: blocking HAL_UART_Transmit spinning on TXE per byte */
+#define APP_UART_TX_DMA                 1
+
+/* Size in bytes of the transmit ring (power of two, <= 65535).  Large
+ enough to queue a whole menu banner without the producer blocking */
+#define APP_UART_TX_RING_SIZE           1024U
+
+/* ============================================================
+ *  LED EFFECTS
+ * ============================================================ */
+
+/* 1 = TIM4 PWM on PD12-PD15, effects played from a frame table by
+ circular DMA (breathing and chase included), no CPU while playing
+ 0 = Software sequencer: one FreeRTOS timer steps through on/off
+     scripts, one GPIOD->BSRR store per step (no fading) */
+#define APP_LED_PWM                     1
+
+/* Frame table size of the PWM engine (14 bytes per frame).  A fade
+ takes one frame per APP_LED_PWM_STEP_MS, a hold one per ~200 ms */
+#define APP_LED_PWM_FRAMES              256U
+
+/* Length of one fade step in milliseconds.  Also the PWM period while
+ fading, so keep it at or below 10 ms (100 Hz) to avoid flicker */
+#define APP_LED_PWM_STEP_MS             5U
+
+/* ============================================================
+ *  RTC
+ * ============================================================ */
+
+/* 1 = The RTC wakeup interrupt refreshes a decoded time/date snapshot
+     once per second; reports read it lock-free and format it with
+     fixed-width integer code (no HAL call, no printf/snprintf)
+ 0 = Legacy path: HAL_RTC_GetTime/GetDate + printf/snprintf per report */
+#define APP_RTC_CACHE                   1
+
+/* ============================================================
+ *  TRACE OUTPUT (ITM/SWO)
+ * ============================================================ */
+
+/* 1 = ITM text (RTC report, printf) is copied into one FIFO per stimulus
+     port and sent by a low-priority drain task; writers never wait on
+     the SWO link and drop (counted) when a FIFO is full
+ 0 = Legacy path: every character spins on the stimulus port, inside
+     the timer service task for the RTC report */
+#define APP_ITM_LOG                     1
+
+/* Size in bytes of each port's FIFO (power of two).  Holds a few seconds
+ of RTC report lines plus a burst of benchmark output */
+#define APP_ITM_LOG_FIFO_SIZE           512U
+
+/* ============================================================
+ *  COMMAND DISPATCH
+ * ============================================================ */
+
+/* 0 = Look commands up through the compile-time perfect hash
+ 1 = Linear strcmp scan of the command table -- the cost of the old
+     if/strcmp chains, kept only as a benchmark reference */
+#define APP_CMD_LOOKUP_LINEAR           0
+
+/* ============================================================
+ *  PRINT MESSAGE POOL
+ * ============================================================ */
+
+/* Number of fixed-size message blocks behind queue_print.  Must cover the
+ queue depth plus whatever producers hold while formatting */
+#define APP_MSG_POOL_BLOCKS             16U
+
+/* Inline payload of one block in bytes.  Constant strings are wrapped
+ without copying, so only formatted messages are limited by this */
+#define APP_MSG_POOL_BLOCK_SIZE         64U
+
+/* ============================================================
+ *  MENU ACTIVE OBJECT
+ * ============================================================ */
+
+/* Inline payload of one menu_ao event in bytes.  Command lines travel in
+ it by value, so it must hold the longest command plus its terminator */
+#define APP_AO_EVENT_DATA               12U
+
+/* ============================================================
+ *  SOFTWARE TIMERS
+ * ============================================================ */
+
+/* 1 = Timer service keeps active timers in a hierarchical timing wheel
+     (configUSE_TIMER_WHEEL): start / stop / expire cost does not grow
+     with the number of running timers
+ 0 = Stock sorted timer list; the better choice for a handful of timers */
+#ifndef APP_TIMER_WHEEL
+#define APP_TIMER_WHEEL                 0
+#endif
+
+/* ============================================================
+ *  KERNEL OBJECT ALLOCATION
+ * ============================================================ */
+
+/* 1 = Static profile: every task stack, TCB, queue, semaphore, timer and
+     stream buffer is a variable declared with static_alloc.h, the kernel
+     is built without a heap (configSUPPORT_DYNAMIC_ALLOCATION 0) and all
+     of its RAM is placed and checked at link time; Host/Tools/
+     ram_report.py lists it per object from the map file.  The kernel,
+     timer, ISR and heap benchmarks create objects at run time and refuse
+     to build
+ 0 = Objects are taken from the configTOTAL_HEAP_SIZE heap at creation */
+#ifndef APP_STATIC_ALLOC
+#define APP_STATIC_ALLOC                0
+#endif
+
+/* ============================================================
+ *  STACK PROFILE
+ * ============================================================ */
+
+/* 1 = A task at idle priority prints the peak stack use of every task as
+     "@stk" lines on the UART console every 10 s (stack_prof.c); exercise
+     the menu, then feed the last report and the compiler's call graph to
+     Host/Tools/stack_size.py to rewrite Core/Inc/stack_sizes.h.  Turns on
+     configRECORD_STACK_HIGH_ADDRESS
+ 0 = Stack sizes stay as stack_sizes.h has them, with no profiler */
+#ifndef APP_STACK_PROFILE
+#define APP_STACK_PROFILE               0
+#endif
+
+/* ============================================================
+ *  KERNEL HEAP
+ * ============================================================ */
+
+/* 1 = Two-level segregated fit allocator (heap_tlsf.c): pvPortMalloc and
+     vPortFree take the same time whatever the free list looks like
+ 0 = heap_4.c: first fit over an address-ordered free list, slower as
+     the heap fragments but ~400 bytes smaller */
+#ifndef APP_HEAP_TLSF
+#define APP_HEAP_TLSF                   0
+#endif
+
+/* ============================================================
+ *  CCM RAM
+ * ============================================================ */
+
+/* 1 = Task stacks and TCBs go to the 64 KB core-coupled RAM, which only
+     the CPU can reach, so they no longer share the bus matrix with the
+     UART and LED DMA streams (ccm_ram.h): with the heap, heap_5.c spreads
+     it over APP_CCM_HEAP_SIZE bytes of CCM plus main SRAM and fills CCM
+     first; with APP_STATIC_ALLOC the STATIC_TASK() storage is placed
+     there.  Never hand a pvPortMalloc() block to DMA in this mode.  Not
+     with APP_HEAP_TLSF
+ 0 = Everything in main SRAM */
+#ifndef APP_CCM_RAM
+#define APP_CCM_RAM                     0
+#endif
+
+/* Bytes of the heap (configTOTAL_HEAP_SIZE) placed in CCM RAM when
+   APP_CCM_RAM = 1; the rest stays in main SRAM.  At most 64 KB, and less
+   than the whole heap */
+#ifndef APP_CCM_HEAP_SIZE
+#define APP_CCM_HEAP_SIZE               (32 * 1024)
+#endif
+
+/* ============================================================
+ *  QUEUES
+ * ============================================================ */
+
+/* 1 = queue_uart_rx (1-byte chars) and queue_print (msg_t pointers) copy
+     items with a fixed-size copy the compiler makes one load and store
+     (configUSE_QUEUE_FAST_COPY, xQueueEnableFastCopy) instead of calling
+     memcpy() with the item size
+ 0 = Stock kernel: every queue copies with memcpy() */
+#ifndef APP_QUEUE_FAST_COPY
+#define APP_QUEUE_FAST_COPY             1
+#endif
+
+/* 1 = xQueueSendMultiple / xQueueReceiveMultiple (configUSE_QUEUE_BATCH):
+     the legacy RX path drains queue_uart_rx in one call per read instead
+     of one xQueueReceive per byte
+ 0 = Stock kernel, one item per call */
+#ifndef APP_QUEUE_BATCH
+#define APP_QUEUE_BATCH                 1
+#endif
+
+/* ============================================================
+ *  CPU STATISTICS (TASK MONITOR)
+ * ============================================================ */
+
+/* 1 = configGENERATE_RUN_TIME_STATS on, with the DWT cycle counter as
+     the run-time clock; per-task and per-ISR CPU %, stack high-water
+     mark, state and priority on the main menu's Task Monitor page
+ 0 = No run-time clock read on each context switch; the page only says
+     it is disabled */
+#ifndef APP_CPU_STATS
+#define APP_CPU_STATS                   1
+#endif
+
+/* Sampling period in milliseconds: the "now" column of the page */
+#define APP_CPU_STATS_PERIOD_MS         1000U
+
+/* Periods in the sliding "avg" window.  Costs one sample of roughly
+ 16 bytes per task slot each */
+#define APP_CPU_STATS_WINDOW            10U
+
+/* Task slots per sample.  With more tasks alive the sample keeps no task
+ rows (the kernel benchmark's filler tasks can exceed it briefly) */
+#define APP_CPU_STATS_MAX_TASKS         16U
+
+/* ============================================================
+ *  BENCHMARK MODES (DWT cycle counter, results printed on ITM)
+ * ============================================================ */
+
+/* 1 = Measure RX ISR cycles, ISR count, throughput and dropped bytes
+ for whichever receive path APP_UART_RX_DMA selects */
+#define APP_BENCH_UART_RX               0
+
+/* 1 = Measure CPU cycles per transmitted byte: time print_task spends
+ handing each string to the UART, plus TX DMA / completion interrupts */
+#define APP_BENCH_UART_TX               0
+
+/* 1 = Measure command dispatch: cycles for the table lookup alone and
+ for lookup + handler, per command line */
+#define APP_BENCH_CMD_DISPATCH          0
+
+/* 1 = Report message-pool occupancy: blocks in use, peak, failed allocs */
+#define APP_BENCH_MSG_POOL              0
+
+/* 1 = Report what the single menu task costs: context switches per
+ command line (traceTASK_SWITCHED_IN), task count and free heap */
+#define APP_BENCH_AO                    0
+
+/* 1 = Format the demos' console lines with fmt_snprintf and with newlib
+ snprintf back to back and report cycles per line for each */
+#define APP_BENCH_FMT                   0
+
+/* 1 = Measure the RTC report timer callback (cycles, worst case) and
+ report each ITM port's sent / dropped bytes and FIFO peak */
+#define APP_BENCH_ITM                   0
+
+/* 1 = Run the kernel microbenchmark suite (kernel_bench.c) once after the
+ scheduler starts and print its cycle table on the console; the menu app
+ runs normally afterwards.  Host/Makefile's kbench target sets it (and
+ APP_BENCH_KERNEL_EXIT) from the command line */
+#ifndef APP_BENCH_KERNEL
+#define APP_BENCH_KERNEL                0
+#endif
+
+/* Samples per kernel benchmark case (4 bytes of RAM each) */
+#define APP_BENCH_KERNEL_SAMPLES        256U
+
+/* 1 = exit() once the kernel table is printed.  For the host build, where
+ it ends the process; on the board exit() only halts */
+#ifndef APP_BENCH_KERNEL_EXIT
+#define APP_BENCH_KERNEL_EXIT           0
+#endif
+
+/* 1 = Run the timer scaling benchmark (timer_bench.c) once after the
+ scheduler starts: start / stop / expire cycles with 10 up to
+ APP_BENCH_TIMERS_MAX software timers running.  Host/Makefile's tbench
+ and tbench_wheel targets set it from the command line */
+#ifndef APP_BENCH_TIMERS
+#define APP_BENCH_TIMERS                0
+#endif
+
+/* Most timers in the largest row.  Each costs ~50 bytes of heap, so the
+ board stops at 500; the host runs the full 10,000 */
+#ifndef APP_BENCH_TIMERS_MAX
+#define APP_BENCH_TIMERS_MAX            500U
+#endif
+
+/* 1 = exit() once the timer table is printed (host build) */
+#ifndef APP_BENCH_TIMERS_EXIT
+#define APP_BENCH_TIMERS_EXIT           0
+#endif
+
+/* 1 = Run the interrupt-to-task latency benchmark (isr_bench.c) once after
+ the scheduler starts: TIM7 interrupts wake a task by notification,
+ semaphore, queue, stream buffer, event group and pended function call.
+ Host/Makefile's ibench target sets it from the command line */
+#ifndef APP_BENCH_ISR
+#define APP_BENCH_ISR                   0
+#endif
+
+/* Wakeups measured per mechanism (4 bytes of RAM each) */
+#ifndef APP_BENCH_ISR_SAMPLES
+#define APP_BENCH_ISR_SAMPLES           1000U
+#endif
+
+/* 1 = exit() once the latency table is printed (host build) */
+#ifndef APP_BENCH_ISR_EXIT
+#define APP_BENCH_ISR_EXIT              0
+#endif
+
+/* 1 = Run the heap benchmark (heap_bench.c) once after the scheduler
+ starts: pvPortMalloc / vPortFree latency and fragmentation while task,
+ queue and timer allocations come and go, for whichever allocator
+ APP_HEAP_TLSF selects.  Host/Makefile's hbench and hbench_tlsf targets
+ set it from the command line */
+#ifndef APP_BENCH_HEAP
+#define APP_BENCH_HEAP                  0
+#endif
+
+/* Calls measured per operation (8 bytes of RAM each: malloc + free) */
+#ifndef APP_BENCH_HEAP_SAMPLES
+#define APP_BENCH_HEAP_SAMPLES          1000U
+#endif
+
+/* 1 = exit() once the heap table is printed (host build) */
+#ifndef APP_BENCH_HEAP_EXIT
+#define APP_BENCH_HEAP_EXIT             0
+#endif
+
+/* 1 = Run the CCM RAM benchmark (ccm_bench.c) once after the scheduler
+ starts: a word copy and a task switch ping-pong with their buffers,
+ stacks and TCBs in main SRAM and then in CCM RAM, idle, with the UART TX
+ DMA busy and with a DMA2 memory-to-memory copy hammering main SRAM.
+ Needs APP_STATIC_ALLOC = 1 to place the ping-pong tasks; Host/Makefile's
+ ccmbench target sets both from the command line */
+#ifndef APP_BENCH_CCM
+#define APP_BENCH_CCM                   0
+#endif
+
+/* Samples per row (4 bytes of RAM each) */
+#ifndef APP_BENCH_CCM_SAMPLES
+#define APP_BENCH_CCM_SAMPLES           500U
+#endif
+
+/* 1 = exit() once the CCM table is printed (host build) */
+#ifndef APP_BENCH_CCM_EXIT
+#define APP_BENCH_CCM_EXIT              0
+#endif
+
+/* Reporting period of the benchmark task in milliseconds */
+#define APP_BENCH_PERIOD_MS             1000U
+
+/* Derived: 1 when any benchmark above is enabled (creates bench_task) */
+#define APP_BENCH_ANY                   ( APP_BENCH_UART_RX || APP_BENCH_UART_TX || \
+                                          APP_BENCH_MSG_POOL || APP_BENCH_CMD_DISPATCH || \
+                                          APP_BENCH_AO || APP_BENCH_FMT || \
+                                          APP_BENCH_ITM )
+
+#endif /* APP_CONFIG_H */
@@ -0,0 +1,25 @@
+/**
+ ******************************************************************************
+ * @file           : ccm_bench.h
+ * @brief          : CCM RAM benchmark: the same CPU work on main SRAM and on
+ *                   CCM RAM, with and without DMA traffic on the bus matrix.
+ *
+ * @description    : Enabled by APP_BENCH_CCM in app_config.h.  Shows what
+ *                   APP_CCM_RAM buys: the rows for main SRAM slow down while
+ *                   a DMA stream uses it, the rows for CCM RAM do not.
+ ******************************************************************************
+ */
+
+#ifndef CCM_BENCH_H
+#define CCM_BENCH_H
+
+#include "main.h"
+
+/**
+ * @brief  Start the DWT counter, set up the DMA2 load and create the
+ *         benchmark task.  Call once, before the scheduler starts.  Does
+ *         nothing when APP_BENCH_CCM is 0.
+ */
+void ccm_bench_init(void);
+
+#endif /* CCM_BENCH_H */
@@ -0,0 +1,138 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_dispatch.h
+ * @brief          : Declarative command table with a compile-time perfect hash.
+ *
+ * @description    : A command table is an X-macro list of rows
+ *
+ *                       X(state, token, handler, next_state)
+ *
+ *                   token is a parenthesised list of up to four characters,
+ *                   e.g. ('n','o','n','e') or ('1'), or CMD_ANY to accept any
+ *                   input in that state (data entry).  CMD_TABLE_DEFINE()
+ *                   expands the list three times:
+ *
+ *                     1. a row list, in source order (linear lookup, docs)
+ *                     2. a slot array indexed by CMD_SLOT(key) -- the hash
+ *                     3. a never-called switch with one case per slot, so
+ *                        two rows hashing to the same slot are a
+ *                        "duplicate case value" compile error
+ *
+ *                   (3) proves the hash is perfect for the table as written.
+ *                   If a new row collides, pick another odd CMD_HASH_MULT.
+ *
+ *                   Lookup is one multiply, one shift and one compare, plus
+ *                   a second probe for the CMD_ANY row of the state, no
+ *                   matter how many commands the table holds.
+ ******************************************************************************
+ */
+
+#ifndef CMD_DISPATCH_H
+#define CMD_DISPATCH_H
+
+#include "main.h"
+
+/* ========================== Hash Parameters ============================== */
+#define CMD_HASH_BITS       6U                     /* 64 slots               */
+#define CMD_HASH_SLOTS      (1U << CMD_HASH_BITS)
+#define CMD_HASH_MULT       0x9755D4C1U            /* Odd multiplier         */
+#define CMD_TOKEN_MAX       4U                     /* 7-bit chars per token  */
+#define CMD_STATES_MAX      15U                    /* States 0..14 (CMD_KEY) */
+
+/* Token that matches any input in its state (tried after an exact miss) */
+#define CMD_ANY             (0)
+
+/* ========================== Key Construction ============================= */
+
+/* Pack up to four 7-bit characters into 28 bits, zero padded */
+#define CMD_PACK(...)                   CMD_PACK4_(__VA_ARGS__, 0, 0, 0, 0)
+#define CMD_PACK4_(a, b, c, d, ...)     (((uint32_t)(a) << 21) | \
+                                         ((uint32_t)(b) << 14) | \
+                                         ((uint32_t)(c) <<  7) | \
+                                          (uint32_t)(d))
+
+/* Token characters as a null-terminated string (for the linear lookup) */
+#define CMD_STR(...)                    ((const char[]){ __VA_ARGS__, 0 })
+
+/* Key = (state + 1) in the top nibble | packed token.  Never 0, so an
+   all-zero slot is always empty.  The nibble holds 1..15, so state must be
+   below CMD_STATES_MAX: a 16th state would wrap to 0 and collide */
+#define CMD_KEY(state, token)           ((((uint32_t)(state) + 1U) << 28) | \
+                                         CMD_PACK token)
+
+/* Multiplicative hash: top CMD_HASH_BITS bits of key * CMD_HASH_MULT */
+#define CMD_SLOT(key)                   ((uint32_t)((uint32_t)(key) * \
+                                         CMD_HASH_MULT) >> (32U - CMD_HASH_BITS))
+
+/* ========================== Table Types ================================== */
+
+/**
+ * @brief  Command handler.  Runs before the transition to next_state.
+ * @param  text  Command line (null-terminated).
+ * @param  len   Characters in the line (may exceed the payload buffer).
+ */
+typedef void (*cmd_handler_t)(const uint8_t *text, uint32_t len);
+
+/**
+ * @brief  One row of a command table.
+ */
+typedef struct {
+    uint32_t       key;            /* CMD_KEY(state, token); 0 = empty slot  */
+    const char    *token;          /* Token text, "" for CMD_ANY             */
+    cmd_handler_t  handler;        /* Action, or NULL for a pure transition  */
+    uint8_t        state;          /* State the row applies in               */
+    uint8_t        next;           /* State after the handler returns        */
+} cmd_entry_t;
+
+/**
+ * @brief  A command table as built by CMD_TABLE_DEFINE().
+ */
+typedef struct {
+    const cmd_entry_t *slots;      /* CMD_HASH_SLOTS entries, hash-indexed   */
+    const cmd_entry_t *rows;       /* Rows in source order                   */
+    uint32_t           row_count;
+} cmd_table_t;
+
+/* ========================== Table Generators ============================= */
+#define CMD_X_ROW(state, token, handler, next) \
+    { CMD_KEY(state, token), CMD_STR token, handler, state, next },
+
+#define CMD_X_SLOT(state, token, handler, next) \
+    [CMD_SLOT(CMD_KEY(state, token))] = CMD_X_ROW(state, token, handler, next)
+
+#define CMD_X_CASE(state, token, handler, next) \
+    case CMD_SLOT(CMD_KEY(state, token)):
+
+/**
+ * @brief  Define `name` (a cmd_table_t) from the X-macro list TABLE.
+ *         Fails to compile if two rows share a hash slot.
+ */
+#define CMD_TABLE_DEFINE(name, TABLE)                                         \
+    static const cmd_entry_t name##_rows[] = { TABLE(CMD_X_ROW) };            \
+    static const cmd_entry_t name##_slots[CMD_HASH_SLOTS] = {                 \
+        TABLE(CMD_X_SLOT)                                                     \
+    };                                                                        \
+    static inline void name##_collision_check(void)                           \
+    {                                                                         \
+        switch (0U) { TABLE(CMD_X_CASE) default: break; }                     \
+    }                                                                         \
+    static const cmd_table_t name = {                                         \
+        name##_slots, name##_rows,                                            \
+        sizeof(name##_rows) / sizeof(name##_rows[0])                          \
+    }
+
+/**
+ * @brief  Find the row for a command line in the given state.
+ *         Exact token first, then the state's CMD_ANY row.
+ *         APP_CMD_LOOKUP_LINEAR = 1 swaps in a strcmp scan of the rows
+ *         instead (benchmark reference).
+ * @param  table  Table from CMD_TABLE_DEFINE().
+ * @param  state  Current state.
+ * @param  text   Command line (null-terminated).
+ * @param  len    Characters in the line.
+ * @return Matching row, or NULL if the command is not valid in this state.
+ */
+const cmd_entry_t *cmd_lookup(const cmd_table_t *table, uint8_t state,
+                              const uint8_t *text, uint32_t len);
+
+#endif /* CMD_DISPATCH_H */
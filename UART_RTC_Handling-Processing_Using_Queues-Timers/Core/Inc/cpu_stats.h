@@ -0,0 +1,88 @@
+/**
+ ******************************************************************************
+ * @file           : cpu_stats.h
+ * @brief          : Per-task and per-ISR CPU accounting behind the menu's
+ *                   "Task Monitor" (top) page.
+ *
+ * @description    : Enabled by APP_CPU_STATS in app_config.h, which also
+ *                   turns on configGENERATE_RUN_TIME_STATS.  The kernel's
+ *                   run-time clock is the DWT cycle counter, widened to 64
+ *                   bits here so per-task totals never wrap.
+ *
+ *                   A software timer samples uxTaskGetSystemState() and the
+ *                   ISR cycle totals every APP_CPU_STATS_PERIOD_MS into a
+ *                   ring, so the page can show CPU % over the last period
+ *                   and over a window of APP_CPU_STATS_WINDOW periods that
+ *                   slides forward with every sample.
+ ******************************************************************************
+ */
+
+#ifndef CPU_STATS_H
+#define CPU_STATS_H
+
+#include "main.h"
+#include <stddef.h>
+
+/**
+ * @brief  Interrupt handlers with their own row on the page.  Each one
+ *         reports its cycles from stm32f4xx_it.c.
+ */
+typedef enum {
+    CPU_ISR_USART2 = 0,            /* USART2 (IDLE line / legacy RX)         */
+    CPU_ISR_DMA_RX,                /* DMA1 Stream5: USART2_RX                */
+    CPU_ISR_DMA_TX,                /* DMA1 Stream6: USART2_TX                */
+    CPU_ISR_RTC_WKUP,              /* RTC wakeup (1 Hz snapshot)             */
+    CPU_ISR_COUNT                  /* Number of accounted handlers           */
+} cpu_isr_t;
+
+/**
+ * @brief  Longest line handed to a cpu_stats_out_t, including "\r\n".
+ */
+#define CPU_STATS_LINE_MAX      64U
+
+/**
+ * @brief  Receives one formatted line of the page (not null-terminated).
+ */
+typedef void (*cpu_stats_out_t)(const char *text, size_t len);
+
+/**
+ * @brief  Create and start the sampling timer.
+ *         Call once, before the scheduler starts.  Does nothing when
+ *         APP_CPU_STATS is 0.
+ */
+void     cpu_stats_init(void);
+
+/**
+ * @brief  Start the DWT counter as the run-time clock.
+ *         portCONFIGURE_TIMER_FOR_RUN_TIME_STATS (FreeRTOSConfig.h); the
+ *         kernel calls it from vTaskStartScheduler().
+ */
+void     cpu_stats_clock_start(void);
+
+/**
+ * @brief  CPU cycles since cpu_stats_clock_start(), 64 bits wide.
+ *         portGET_RUN_TIME_COUNTER_VALUE (FreeRTOSConfig.h).  Safe from tasks
+ *         and ISRs; must run at least once per CYCCNT wrap (~25 s), which
+ *         the sampling timer guarantees.
+ * @return Cycle count.
+ */
+uint64_t cpu_stats_clock(void);
+
+/**
+ * @brief  Charge one interrupt to its row (ISR context).
+ *         Handlers of one row must not nest, which holds while they all
+ *         share one NVIC priority.
+ * @param  isr     Handler being accounted.
+ * @param  cycles  DWT cycles spent in the handler.
+ */
+void     cpu_stats_isr(cpu_isr_t isr, uint32_t cycles);
+
+/**
+ * @brief  Format the Task Monitor page, one line per call of out.
+ *         Task context only.  Prints a one-line note when APP_CPU_STATS
+ *         is 0.
+ * @param  out  Line sink, e.g. a queue_print producer.
+ */
+void     cpu_stats_print(cpu_stats_out_t out);
+
+#endif /* CPU_STATS_H */
@@ -0,0 +1,47 @@
+/**
+ ******************************************************************************
+ * @file           : dwt_cycles.h
+ * @brief          : Cycle-accurate timing helpers built on the Cortex-M4
+ *                   DWT cycle counter (CYCCNT, 168 counts per microsecond).
+ *
+ * @note           : CYCCNT is a free-running 32-bit counter; differences
+ *                   are correct across one wrap (~25 s at 168 MHz).
+ ******************************************************************************
+ */
+
+#ifndef DWT_CYCLES_H
+#define DWT_CYCLES_H
+
+#include "main.h"
+
+/**
+ * @brief  Enable the trace block and start the DWT cycle counter.
+ *         Safe to call more than once.
+ */
+static inline void dwt_cycles_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;   /* Enable DWT/ITM      */
+    DWT->CYCCNT       = 0;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;       /* Start counting      */
+}
+
+/**
+ * @brief  Read the current cycle count.
+ * @return Free-running CPU cycle counter value.
+ */
+static inline uint32_t dwt_cycles_now(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief  Cycles elapsed since a previous dwt_cycles_now() sample.
+ * @param  start  Earlier sample.
+ * @return Elapsed cycles (wrap-safe).
+ */
+static inline uint32_t dwt_cycles_since(uint32_t start)
+{
+    return DWT->CYCCNT - start;
+}
+
+#endif /* DWT_CYCLES_H */
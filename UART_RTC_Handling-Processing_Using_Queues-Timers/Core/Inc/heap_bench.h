@@ -0,0 +1,27 @@
+/**
+ ******************************************************************************
+ * @file           : heap_bench.h
+ * @brief          : Kernel heap benchmark: pvPortMalloc / vPortFree latency
+ *                   and fragmentation under the allocation pattern of tasks,
+ *                   queues and timers being created and deleted.
+ *
+ * @description    : Enabled by APP_BENCH_HEAP in app_config.h.  Run it once
+ *                   with APP_HEAP_TLSF = 0 (heap_4) and once with 1
+ *                   (heap_tlsf) and compare the two tables; the pattern is
+ *                   the same pseudo-random sequence both times.
+ ******************************************************************************
+ */
+
+#ifndef HEAP_BENCH_H
+#define HEAP_BENCH_H
+
+#include "main.h"
+
+/**
+ * @brief  Start the DWT counter and create the benchmark task.
+ *         Call once, before the scheduler starts.  Does nothing when
+ *         APP_BENCH_HEAP is 0.
+ */
+void heap_bench_init(void);
+
+#endif /* HEAP_BENCH_H */
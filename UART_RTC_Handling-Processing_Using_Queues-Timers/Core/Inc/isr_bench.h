@@ -0,0 +1,33 @@
+/**
+ ******************************************************************************
+ * @file           : isr_bench.h
+ * @brief          : Interrupt-to-task latency benchmark: how long after a
+ *                   timer ISR starts the task it signals is running, for
+ *                   each way an ISR can hand work to a task.
+ *
+ * @description    : Enabled by APP_BENCH_ISR in app_config.h.  TIM7 is the
+ *                   interrupt source (TIM6 is the HAL timebase, TIM4 drives
+ *                   the LEDs).  Prints min / avg / p99 / max per mechanism
+ *                   and a histogram of each on the console, in the same
+ *                   format as kernel_bench.
+ ******************************************************************************
+ */
+
+#ifndef ISR_BENCH_H
+#define ISR_BENCH_H
+
+#include "main.h"
+
+/**
+ * @brief  Start the DWT counter and create the benchmark task.
+ *         Call once, before the scheduler starts.  Does nothing when
+ *         APP_BENCH_ISR is 0.
+ */
+void isr_bench_init(void);
+
+/**
+ * @brief  TIM7 update interrupt body; TIM7_IRQHandler calls only this.
+ */
+void isr_bench_timer_irq(void);
+
+#endif /* ISR_BENCH_H */
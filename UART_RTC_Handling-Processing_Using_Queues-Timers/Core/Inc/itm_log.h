@@ -0,0 +1,73 @@
+/**
+ ******************************************************************************
+ * @file           : itm_log.h
+ * @brief          : Non-blocking ITM/SWO output: one software FIFO per
+ *                   stimulus port, emptied by a low-priority drain task.
+ *
+ * @description    : Writing to an ITM stimulus port spins until the port's
+ *                   one-entry hardware FIFO is free, and with a slow SWO
+ *                   link that can take as long as the debugger wants.
+ *                   itm_log_write() only copies into RAM and returns, so it
+ *                   is safe from the timer service task, from ISRs and
+ *                   from any other task that must not stall.
+ *
+ *                   Each subsystem has its own stimulus port, so a viewer
+ *                   can filter or split them (SWV ITM Data Console: one tab
+ *                   per enabled port).  A message either fits in its port's
+ *                   FIFO whole or is dropped whole and counted; lines are
+ *                   never cut.
+ *
+ *                   When the debugger has not enabled a port (or ITM at
+ *                   all), writes to it are discarded at no cost.
+ ******************************************************************************
+ */
+
+#ifndef ITM_LOG_H
+#define ITM_LOG_H
+
+#include "main.h"
+
+/**
+ * @brief  Stimulus port per subsystem.
+ */
+typedef enum {
+    ITM_LOG_PORT_CONSOLE = 0,      /* printf (benchmark lines, misc)         */
+    ITM_LOG_PORT_RTC     = 1,      /* Live RTC report                        */
+    ITM_LOG_PORT_COUNT
+} itm_log_port_t;
+
+/**
+ * @brief  Per-port counters, lifetime since itm_log_init().
+ */
+typedef struct {
+    uint32_t sent;                 /* Bytes written to the stimulus port     */
+    uint32_t dropped;              /* Bytes refused, FIFO full               */
+    uint32_t dropped_msgs;         /* Messages refused, FIFO full            */
+    uint32_t peak;                 /* Highest FIFO fill level in bytes       */
+} itm_log_stats_t;
+
+/**
+ * @brief  Create the drain task.  Call once, before the scheduler starts.
+ *         Writes made earlier are kept and sent once it runs.
+ */
+void     itm_log_init(void);
+
+/**
+ * @brief  Queue bytes for one stimulus port.  Never blocks.
+ *         Task or ISR context (priority at or below the syscall ceiling).
+ * @param  port  Subsystem port.
+ * @param  data  Bytes to send.
+ * @param  len   Number of bytes.
+ * @return len if queued (or discarded because the port is not enabled),
+ *         0 if dropped because the FIFO is full.
+ */
+uint32_t itm_log_write(itm_log_port_t port, const void *data, uint32_t len);
+
+/**
+ * @brief  Snapshot one port's counters.
+ * @param  port  Subsystem port.
+ * @param  out   Destination for the counters.
+ */
+void     itm_log_get_stats(itm_log_port_t port, itm_log_stats_t *out);
+
+#endif /* ITM_LOG_H */
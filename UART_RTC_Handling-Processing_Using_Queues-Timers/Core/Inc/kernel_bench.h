@@ -0,0 +1,36 @@
+/**
+ ******************************************************************************
+ * @file           : kernel_bench.h
+ * @brief          : FreeRTOS kernel microbenchmarks, measured with the DWT
+ *                   cycle counter under this project's FreeRTOSConfig.h.
+ *
+ * @description    : Enabled by APP_BENCH_KERNEL in app_config.h.  One
+ *                   high-priority task runs every case once, right after
+ *                   the scheduler starts, and prints a fixed-format table
+ *                   on the console (printf: ITM port 0 on the board, stdout
+ *                   on the host port).  Save the table before and after a
+ *                   FreeRTOSConfig.h change and diff the two files.
+ ******************************************************************************
+ */
+
+#ifndef KERNEL_BENCH_H
+#define KERNEL_BENCH_H
+
+#include "main.h"
+
+/**
+ * @brief  Start the DWT counter and create the benchmark task.
+ *         Call once, before the scheduler starts.  Does nothing when
+ *         APP_BENCH_KERNEL is 0.
+ */
+void kernel_bench_init(void);
+
+/**
+ * @brief  vTaskSwitchContext timing hooks, called from traceTASK_SWITCHED_OUT
+ *         and traceTASK_SWITCHED_IN (FreeRTOSConfig.h) inside the kernel's
+ *         switch path.  Only defined when APP_BENCH_KERNEL is 1.
+ */
+void kernel_bench_switch_out(void);
+void kernel_bench_switch_in(void);
+
+#endif /* KERNEL_BENCH_H */
@@ -0,0 +1,63 @@
+/**
+ ******************************************************************************
+ * @file           : led_pwm.h
+ * @brief          : TIM4 PWM LED effects engine fed by DMA (PD12-PD15).
+ *
+ * @description    : PD12-PD15 are TIM4 channels 1-4 (AF2).  An effect is a
+ *                   short script of keyframes -- four brightness levels and
+ *                   a duration, either held or faded into.  led_pwm_play()
+ *                   expands the script once into a table of timer frames;
+ *                   circular DMA then writes one frame per PWM period into
+ *                   PSC, ARR and CCR1-4 through the TIM4 DMA burst register.
+ *
+ *                   Once an effect is playing it costs no CPU at all: no
+ *                   interrupt, no task and no timer-daemon wakeup.
+ ******************************************************************************
+ */
+
+#ifndef LED_PWM_H
+#define LED_PWM_H
+
+#include "main.h"
+
+/* ========================== Limits ======================================= */
+#define LED_PWM_CHANNELS    4U     /* TIM4 CH1-CH4 = PD12-PD15               */
+#define LED_PWM_LEVEL_MAX   255U   /* Full brightness                        */
+
+/**
+ * @brief  One keyframe of an effect script.
+ *
+ *         fade = 0: jump to level[] and hold it for ms.
+ *         fade = 1: ramp from the previous keyframe's level[] to this one
+ *                   over ms.  The first keyframe fades from the last, so a
+ *                   looping script ramps smoothly across the wrap.
+ */
+typedef struct {
+    uint8_t  level[LED_PWM_CHANNELS]; /* 0..255, perceptual (gamma applied) */
+    uint16_t ms;                   /* Hold or fade time in milliseconds      */
+    uint8_t  fade;                 /* 0 = hold, 1 = fade into level[]        */
+} led_pwm_key_t;
+
+/**
+ * @brief  Start PWM on all four channels with the LEDs off.
+ *         Call once after MX_TIM4_Init().
+ * @param  htim  TIM4 handle, linked to its CC1 DMA stream.
+ */
+void     led_pwm_init(TIM_HandleTypeDef *htim);
+
+/**
+ * @brief  Replace the running effect with a looping keyframe script.
+ *         The script is expanded into frames here; playback needs no CPU.
+ * @param  keys   Keyframes, played in order and repeated forever.
+ * @param  count  Number of keyframes.
+ * @return Frames used, or 0 if the script does not fit in
+ *         APP_LED_PWM_FRAMES (the LEDs are switched off).
+ */
+uint32_t led_pwm_play(const led_pwm_key_t *keys, uint32_t count);
+
+/**
+ * @brief  Stop the running effect and switch all four LEDs off.
+ */
+void     led_pwm_stop(void);
+
+#endif /* LED_PWM_H */
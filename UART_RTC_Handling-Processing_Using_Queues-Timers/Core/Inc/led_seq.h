@@ -0,0 +1,69 @@
+/**
+ ******************************************************************************
+ * @file           : led_seq.h
+ * @brief          : Software LED pattern sequencer on one FreeRTOS timer
+ *                   (PD12-PD15 as GPIO outputs, APP_LED_PWM = 0).
+ *
+ * @description    : An effect is a script of steps, each an on/off pattern
+ *                   for the four LEDs and how long to show it.  One one-shot
+ *                   software timer walks the script: its callback applies
+ *                   the next step with a single GPIOD->BSRR store and re-arms
+ *                   itself with that step's duration.  Scripts may be any
+ *                   length and every step may have its own duration.
+ *
+ *                   Starting, switching or stopping an effect sends exactly
+ *                   one command to the timer daemon.
+ ******************************************************************************
+ */
+
+#ifndef LED_SEQ_H
+#define LED_SEQ_H
+
+#include "main.h"
+
+/* ========================== Pin Map ====================================== */
+#define LED_SEQ_PIN_SHIFT   12U    /* Pattern bit 0 = PD12 ... bit 3 = PD15  */
+#define LED_SEQ_PIN_MASK    0x0FU
+
+/**
+ * @brief  BSRR word that drives all four LEDs to a 4-bit pattern at once:
+ *         set bits for the LEDs that are on, reset bits for the rest.
+ *         Bit 0 -> PD12, Bit 1 -> PD13, Bit 2 -> PD14, Bit 3 -> PD15.
+ */
+#define LED_SEQ_BSRR(pattern)                                                 \
+    ( ((uint32_t)((pattern) & LED_SEQ_PIN_MASK) << LED_SEQ_PIN_SHIFT) |       \
+      ((uint32_t)(~(pattern) & LED_SEQ_PIN_MASK) << (LED_SEQ_PIN_SHIFT + 16U)) )
+
+/**
+ * @brief  One step of a script.  Build with LED_SEQ_STEP() so the BSRR
+ *         word is computed at compile time.
+ */
+typedef struct {
+    uint32_t bsrr;                 /* Written to GPIOD->BSRR as is           */
+    uint16_t ms;                   /* Time the step is shown, milliseconds   */
+} led_seq_step_t;
+
+#define LED_SEQ_STEP(pattern, ms)   { LED_SEQ_BSRR(pattern), (ms) }
+
+/**
+ * @brief  Create the sequencer timer and switch all four LEDs off.
+ *         Call once, before the scheduler starts.
+ */
+void     led_seq_init(void);
+
+/**
+ * @brief  Replace the running effect with a looping script.  The first
+ *         step is shown immediately.
+ * @param  steps  Steps, played in order and repeated forever.  Must stay
+ *                valid while playing (normally a const table).
+ * @param  count  Number of steps.
+ * @return count, or 0 if the script is empty (the LEDs are switched off).
+ */
+uint32_t led_seq_play(const led_seq_step_t *steps, uint32_t count);
+
+/**
+ * @brief  Stop the running effect and switch all four LEDs off.
+ */
+void     led_seq_stop(void);
+
+#endif /* LED_SEQ_H */
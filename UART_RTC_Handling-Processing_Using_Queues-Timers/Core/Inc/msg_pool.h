@@ -0,0 +1,99 @@
+/**
+ ******************************************************************************
+ * @file           : msg_pool.h
+ * @brief          : Fixed-block, reference-counted message pool.
+ *
+ * @description    : queue_print carries msg_t handles instead of raw string
+ *                   pointers.  A producer either allocates a block and
+ *                   formats into it, or wraps a constant string (no copy).
+ *                   Whoever holds the last reference releases the block;
+ *                   print_task does so once the text is handed to the UART.
+ *
+ *                   Allocation and release are O(1) (free-list pop / push)
+ *                   and have task and ISR variants.
+ ******************************************************************************
+ */
+
+#ifndef MSG_POOL_H
+#define MSG_POOL_H
+
+#include "main.h"
+#include "FreeRTOS.h"
+
+/**
+ * @brief  One message block.  Read text/len; write data/len when the block
+ *         came from msg_alloc().
+ */
+typedef struct msg_block msg_t;
+struct msg_block {
+    msg_t           *next;         /* Free-list link (pool internal)         */
+    const char      *text;         /* Bytes to send: data[] or a constant    */
+    uint16_t         len;          /* Number of valid bytes at text          */
+    volatile uint8_t refs;         /* Holders; block is free again at 0      */
+    char             data[APP_MSG_POOL_BLOCK_SIZE]; /* Inline payload        */
+};
+
+/**
+ * @brief  Pool occupancy counters.
+ */
+typedef struct {
+    uint32_t blocks;               /* Total blocks in the pool               */
+    uint32_t in_use;               /* Blocks currently allocated             */
+    uint32_t peak;                 /* Highest in_use since msg_pool_init     */
+    uint32_t fails;                /* Allocations that found no free block   */
+} msg_pool_stats_t;
+
+/**
+ * @brief  Thread the free list and create the free-block semaphore.
+ *         Call once, before the scheduler starts.
+ */
+void   msg_pool_init(void);
+
+/**
+ * @brief  Take a block for formatting (task context).
+ *         refs = 1, text = data, len = 0.
+ * @param  wait  Ticks to block while the pool is empty.
+ * @return Block, or NULL on timeout.
+ */
+msg_t *msg_alloc(TickType_t wait);
+
+/**
+ * @brief  Take a block without blocking (ISR context).
+ * @return Block, or NULL if the pool is empty.
+ */
+msg_t *msg_alloc_from_isr(void);
+
+/**
+ * @brief  Take a block that points at a string with static lifetime.
+ *         The text is not copied, so any length is allowed.
+ * @param  text  Null-terminated constant string.
+ * @param  wait  Ticks to block while the pool is empty.
+ * @return Block, or NULL on timeout.
+ */
+msg_t *msg_wrap_const(const char *text, TickType_t wait);
+
+/**
+ * @brief  Add a reference before passing the same block to another consumer.
+ * @param  msg  Block already held by the caller.
+ */
+void   msg_ref(msg_t *msg);
+
+/**
+ * @brief  Drop one reference (task context); frees the block at zero.
+ * @param  msg  Block held by the caller.
+ */
+void   msg_release(msg_t *msg);
+
+/**
+ * @brief  Drop one reference (ISR context); frees the block at zero.
+ * @param  msg  Block held by the caller.
+ */
+void   msg_release_from_isr(msg_t *msg);
+
+/**
+ * @brief  Snapshot the occupancy counters.
+ * @param  out  Destination for the counters.
+ */
+void   msg_pool_get_stats(msg_pool_stats_t *out);
+
+#endif /* MSG_POOL_H */
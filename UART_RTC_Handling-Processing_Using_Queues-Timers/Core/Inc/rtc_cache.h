@@ -0,0 +1,85 @@
+/**
+ ******************************************************************************
+ * @file           : rtc_cache.h
+ * @brief          : Cached RTC time/date, refreshed once per second by the
+ *                   RTC wakeup interrupt, plus fixed-width formatters.
+ *
+ * @description    : The wakeup timer runs from ck_spre (the calendar's own
+ *                   1 Hz clock) and interrupts right after each second
+ *                   tick.  The ISR reads TR/DR directly, decodes the BCD
+ *                   once and publishes an 8-byte snapshot under a sequence
+ *                   counter.
+ *
+ *                   Readers copy the snapshot without locking: they retry
+ *                   only if a refresh overlapped the copy.  Neither reading
+ *                   nor formatting calls the HAL or newlib.
+ ******************************************************************************
+ */
+
+#ifndef RTC_CACHE_H
+#define RTC_CACHE_H
+
+#include "main.h"
+
+/**
+ * @brief  One decoded calendar snapshot (binary, not BCD).
+ */
+typedef struct {
+    uint8_t hours;                 /* 1-12                                   */
+    uint8_t minutes;               /* 0-59                                   */
+    uint8_t seconds;               /* 0-59                                   */
+    uint8_t pm;                    /* 0 = AM, 1 = PM                         */
+    uint8_t day;                   /* Day of month, 1-31                     */
+    uint8_t month;                 /* 1-12                                   */
+    uint8_t weekday;               /* 1-7 as written by the menu             */
+    uint8_t year;                  /* 0-99, i.e. 2000-2099                   */
+} rtc_cache_t;
+
+/* Characters written by the formatters (no terminator) */
+#define RTC_FMT_TIME_LEN    13U    /* "HH:MM:SS [AM]"                        */
+#define RTC_FMT_DATE_LEN    10U    /* "MM-DD-YYYY"                           */
+
+/**
+ * @brief  Switch the RTC to direct counter reads, start the 1 Hz wakeup
+ *         interrupt and take the first snapshot.
+ *         Call once after MX_RTC_Init(), before the scheduler starts.
+ * @param  hrtc  RTC handle.
+ */
+void     rtc_cache_init(RTC_HandleTypeDef *hrtc);
+
+/**
+ * @brief  Take a new snapshot now.  Call after writing the time or date so
+ *         readers do not see the old value until the next second.
+ *         Task context.
+ */
+void     rtc_cache_refresh(void);
+
+/**
+ * @brief  Take a new snapshot from the wakeup interrupt.
+ *         Call from HAL_RTCEx_WakeUpTimerEventCallback (ISR context).
+ */
+void     rtc_cache_wakeup_isr(void);
+
+/**
+ * @brief  Copy the latest snapshot.  Lock-free; any context.
+ * @param  out  Destination.
+ */
+void     rtc_cache_read(rtc_cache_t *out);
+
+/**
+ * @brief  Format the time as "HH:MM:SS [AM]" (RTC_FMT_TIME_LEN chars).
+ * @param  dst  Destination, at least RTC_FMT_TIME_LEN bytes; not terminated.
+ * @param  t    Snapshot.
+ * @return Characters written.
+ */
+uint32_t rtc_fmt_time(char *dst, const rtc_cache_t *t);
+
+/**
+ * @brief  Format the date as "MM-DD-YYYY" (RTC_FMT_DATE_LEN chars).
+ * @param  dst  Destination, at least RTC_FMT_DATE_LEN bytes; not terminated.
+ * @param  t    Snapshot.
+ * @return Characters written.
+ */
+uint32_t rtc_fmt_date(char *dst, const rtc_cache_t *t);
+
+#endif /* RTC_CACHE_H */
@@ -0,0 +1,27 @@
+/**
+ ******************************************************************************
+ * @file           : timer_bench.h
+ * @brief          : Software timer scaling benchmark: start, stop and expire
+ *                   cost with 10 up to APP_BENCH_TIMERS_MAX timers running.
+ *
+ * @description    : Enabled by APP_BENCH_TIMERS in app_config.h.  Prints one
+ *                   row per timer count on the console, in the same format
+ *                   as kernel_bench.  Run it once with APP_TIMER_WHEEL = 0
+ *                   and once with 1 and diff the two tables to compare the
+ *                   sorted-list and timing-wheel timer services.
+ ******************************************************************************
+ */
+
+#ifndef TIMER_BENCH_H
+#define TIMER_BENCH_H
+
+#include "main.h"
+
+/**
+ * @brief  Start the DWT counter and create the benchmark task.
+ *         Call once, before the scheduler starts.  Does nothing when
+ *         APP_BENCH_TIMERS is 0.
+ */
+void timer_bench_init(void);
+
+#endif /* TIMER_BENCH_H */
@@ -0,0 +1,123 @@
+/**
+ ******************************************************************************
+ * @file           : uart_dma.h
+ * @brief          : DMA-driven USART2 receive and transmit paths.
+ *
+ * @description    : RX: USART2_RX runs on DMA1 Stream5 in circular mode.  The
+ *                   HAL reports half-transfer, transfer-complete and IDLE-line
+ *                   events; each event copies the newly arrived span of the
+ *                   DMA ring into a FreeRTOS stream buffer in one call, so the
+ *                   CPU takes one interrupt per burst instead of per byte.
+ *
+ *                   TX: producers copy bytes into a transmit ring; DMA1
+ *                   Stream6 drains it in contiguous chunks and the completion
+ *                   interrupt chains the next chunk.  A producer only sleeps
+ *                   (on a task notification) while the ring is full.
+ ******************************************************************************
+ */
+
+#ifndef UART_DMA_H
+#define UART_DMA_H
+
+#include "main.h"
+#include "FreeRTOS.h"
+
+/**
+ * @brief  Receive-side counters (monotonic since uart_dma_rx_init).
+ */
+typedef struct {
+    uint32_t events;               /* RX events handled (HT / TC / IDLE)     */
+    uint32_t bytes;                /* Bytes copied into the stream buffer    */
+    uint32_t dropped;              /* Bytes lost because the stream was full */
+    uint32_t restarts;             /* DMA re-arms after a UART error         */
+} uart_dma_rx_stats_t;
+
+/**
+ * @brief  Transmit-side counters (monotonic since uart_dma_tx_init).
+ */
+typedef struct {
+    uint32_t bytes;                /* Bytes handed to the DMA and completed  */
+    uint32_t chunks;               /* DMA transfers started                  */
+    uint32_t start_fails;          /* Starts the HAL refused (retried)       */
+    uint32_t waits;                /* Producer sleeps on a full ring         */
+    uint32_t peak;                 /* Highest ring fill level seen (bytes)   */
+} uart_dma_tx_stats_t;
+
+/* Task-notification slot used to wake a producer waiting for ring space.
+ Slot 0 stays free for the application (see FreeRTOSConfig.h) */
+#define UART_DMA_TX_NOTIFY_INDEX   1
+
+/**
+ * @brief  Create the RX stream buffer and start circular DMA reception.
+ *         Call once, before the scheduler starts.
+ * @param  huart  UART handle already linked to its RX DMA stream.
+ */
+void   uart_dma_rx_init(UART_HandleTypeDef *huart);
+
+/**
+ * @brief  Re-arm reception if the HAL aborted it (blocking error such as
+ *         overrun).  Call from HAL_UART_ErrorCallback; does nothing while
+ *         the DMA is still running.
+ */
+void   uart_dma_rx_restart(void);
+
+/**
+ * @brief  Read whatever bytes are available, blocking until at least one.
+ * @param  dst    Destination buffer.
+ * @param  max    Capacity of dst in bytes.
+ * @param  wait   Ticks to block while the stream is empty.
+ * @return Number of bytes copied (0 on timeout).
+ */
+size_t uart_dma_rx_read(uint8_t *dst, size_t max, TickType_t wait);
+
+/**
+ * @brief  ISR hook -- forward HAL_UARTEx_RxEventCallback here.
+ * @param  huart  UART handle that raised the event.
+ * @param  pos    Current write position of the DMA inside the ring.
+ */
+void   uart_dma_rx_event_isr(UART_HandleTypeDef *huart, uint16_t pos);
+
+/**
+ * @brief  Snapshot the receive counters.
+ * @param  out  Destination for the counters.
+ */
+void   uart_dma_rx_get_stats(uart_dma_rx_stats_t *out);
+
+/**
+ * @brief  Create the producer mutex and bind the transmit ring to a UART.
+ *         Call once, before the scheduler starts.
+ * @param  huart  UART handle already linked to its TX DMA stream.
+ */
+void   uart_dma_tx_init(UART_HandleTypeDef *huart);
+
+/**
+ * @brief  Queue bytes for transmission (task context, thread-safe).
+ *         Returns as soon as the bytes are in the ring; sleeps only while
+ *         the ring is full.
+ * @param  data   Bytes to send.
+ * @param  len    Number of bytes.
+ * @param  wait   Ticks to wait in total for the producer lock and space.
+ * @return Number of bytes queued (less than len only on timeout).
+ */
+size_t uart_dma_tx_write(const void *data, size_t len, TickType_t wait);
+
+/**
+ * @brief  ISR hook -- forward HAL_UART_TxCpltCallback here.
+ * @param  huart  UART handle whose DMA transfer finished.
+ */
+void   uart_dma_tx_complete_isr(UART_HandleTypeDef *huart);
+
+/**
+ * @brief  Restart the transmit chain if a DMA error stopped it, or if a
+ *         start was refused while bytes wait in the ring.
+ *         Call from HAL_UART_ErrorCallback.
+ */
+void   uart_dma_tx_recover(void);
+
+/**
+ * @brief  Snapshot the transmit counters.
+ * @param  out  Destination for the counters.
+ */
+void   uart_dma_tx_get_stats(uart_dma_tx_stats_t *out);
+
+#endif /* UART_DMA_H */
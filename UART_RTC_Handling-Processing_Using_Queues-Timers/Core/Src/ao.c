@@ -0,0 +1,144 @@
+/**
+ ******************************************************************************
+ * @file           : ao.c
+ * @brief          : Minimal active-object framework (event queue + HSM).
+ *
+ * @description    : Event loop:
+ *
+ *                     ISR / task --ao_post--> queue --> ao_task --> ao_dispatch
+ *                                                               |
+ *                                  leaf handler -> parent -> ... -> root
+ *
+ *                   Transition from S to T:
+ *
+ *                     1. LCA = deepest state enclosing both S and T
+ *                        (T's parent when S == T, so S is re-entered)
+ *                     2. EXIT  S, S.parent, ... up to (not incl.) LCA
+ *                     3. ENTRY from below LCA down to T
+ *
+ *                   ENTRY/EXIT handlers must return AO_HANDLED; they may
+ *                   post events but not request transitions.
+ ******************************************************************************
+ */
+
+#include "ao.h"
+#include "app_config.h"
+
+/* ========================== Private Data ================================= */
+static const ao_event_t AO_EVT_ENTRY = { AO_SIG_ENTRY, 0, { 0 } };
+static const ao_event_t AO_EVT_EXIT  = { AO_SIG_EXIT,  0, { 0 } };
+
+/* ========================== Private Helpers ============================== */
+
+/**
+ * @brief  Deepest state that encloses both a and b (NULL = above the root).
+ */
+static const ao_state_t *ao_lca(const ao_state_t *a, const ao_state_t *b)
+{
+    for (const ao_state_t *s = a; s != NULL; s = s->parent) {
+        for (const ao_state_t *t = b; t != NULL; t = t->parent) {
+            if (s == t) {
+                return s;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief  Leave the current state and enter target, running EXIT / ENTRY
+ *         actions along the way.  me->state may be NULL (initial entry).
+ */
+static void ao_transition(ao_t *me, const ao_state_t *target)
+{
+    const ao_state_t *path[AO_MAX_DEPTH];
+    const ao_state_t *lca;
+    uint32_t          depth = 0;
+
+    lca = (target == me->state) ? target->parent
+                                : ao_lca(me->state, target);
+
+    /* Exit from the current leaf up to the common ancestor */
+    for (const ao_state_t *s = me->state; s != lca; s = s->parent) {
+        (void)s->handler(me, s, &AO_EVT_EXIT);
+    }
+
+    /* Record target .. LCA (exclusive), then enter outermost first */
+    for (const ao_state_t *s = target; s != lca; s = s->parent) {
+        configASSERT(depth < AO_MAX_DEPTH);
+        path[depth++] = s;
+    }
+    me->state = target;
+    while (depth > 0U) {
+        const ao_state_t *s = path[--depth];
+        (void)s->handler(me, s, &AO_EVT_ENTRY);
+    }
+}
+
+/**
+ * @brief  Active-object task: enter the initial state, then run every
+ *         event to completion, one at a time.
+ * @param  param  The ao_t instance.
+ */
+static void ao_task(void *param)
+{
+    ao_t      *me = param;
+    ao_event_t e;
+
+    ao_transition(me, me->initial);
+
+    for (;;) {
+        xQueueReceive(me->queue, &e, portMAX_DELAY);
+        ao_dispatch(me, &e);
+    }
+}
+
+/* ========================== Public API =================================== */
+
+void ao_start(ao_t *me, const char *name, const ao_state_t *initial,
+              const ao_mem_t *mem, UBaseType_t priority)
+{
+    BaseType_t status;
+
+    me->state   = NULL;
+    me->target  = NULL;
+    me->initial = initial;
+
+    me->queue = static_queue_create(mem->queue_len, sizeof(ao_event_t),
+                                    mem->queue_buf, mem->queue);
+    configASSERT(me->queue != NULL);
+
+    status = static_task_create(ao_task, name, mem->stack_words, me, priority,
+                                &me->task, mem->stack, mem->tcb,
+                                mem->object, "ao_task");
+    configASSERT(status == pdPASS);
+}
+
+BaseType_t ao_post(ao_t *me, const ao_event_t *e, TickType_t wait)
+{
+    return xQueueSend(me->queue, e, wait);
+}
+
+BaseType_t ao_post_from_isr(ao_t *me, const ao_event_t *e, BaseType_t *woken)
+{
+    return xQueueSendFromISR(me->queue, e, woken);
+}
+
+void ao_dispatch(ao_t *me, const ao_event_t *e)
+{
+    const ao_state_t *s = me->state;
+    ao_result_t       r = AO_UNHANDLED;
+
+    /* Offer the event to the leaf first, then to each enclosing state */
+    while (s != NULL) {
+        r = s->handler(me, s, e);
+        if (r != AO_UNHANDLED) {
+            break;
+        }
+        s = s->parent;
+    }
+
+    if (r == AO_TRANSITION) {
+        ao_transition(me, me->target);
+    }
+}
@@ -0,0 +1,500 @@
+/**
+ ******************************************************************************
+ * @file           : app_bench.c
+ * @brief          : On-target benchmark counters and ITM report task.
+ *
+ * @description    : Counters are written from ISR context and read-and-reset
+ *                   by bench_task inside a critical section, so one report
+ *                   line always describes one complete window.
+ *
+ *                   Line formats:
+ *                     APP_BENCH_UART_RX:
+ *                       [rx dma] isr=<n> bytes=<n> cyc/isr=<n> cyc/B=<n> ...
+ *                     APP_BENCH_UART_TX:
+ *                       [tx dma] bytes=<n> task cyc/B=<n> isr cyc/B=<n> ...
+ *                     APP_BENCH_CMD_DISPATCH:
+ *                       [cmd hash] n=<n> lookup avg=<n> max=<n> total avg=<n> ...
+ *                     APP_BENCH_MSG_POOL:
+ *                       [pool] blocks=<n> in_use=<n> peak=<n> fails=<n>
+ *                     APP_BENCH_AO:
+ *                       [ao] cmds=<n> switches=<n> sw/cmd=<n> tasks=<n> ...
+ *                     APP_BENCH_FMT:
+ *                       [fmt] lite avg=<n> min=<n> newlib avg=<n> min=<n>
+ *                     APP_BENCH_ITM:
+ *                       [itm] cb n=<n> avg=<n> max=<n> p0 sent=<n> drop=<n> ...
+ ******************************************************************************
+ */
+
+#include "app_bench.h"
+#include "app_config.h"
+#include "dwt_cycles.h"
+#include "msg_pool.h"
+#include "fmt_lite.h"
+#include "itm_log.h"
+
+#include <stdio.h>                 /* printf -> ITM (syscalls.c)             */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "static_alloc.h"
+#include "stack_sizes.h"
+
+#if APP_BENCH_UART_RX
+
+/* ========================== RX Counters ================================== */
+typedef struct {
+    uint32_t isr_count;            /* IRQ handler invocations this window    */
+    uint32_t isr_cycles;           /* Total cycles inside those handlers     */
+    uint32_t isr_max;              /* Worst single IRQ in this window        */
+    uint32_t bytes;                /* Bytes handed to menu_ao                */
+    uint32_t dropped;              /* Bytes lost to a full FIFO              */
+} bench_uart_rx_t;
+
+static volatile bench_uart_rx_t bench_rx;
+
+void app_bench_uart_rx_isr(uint32_t cycles)
+{
+    bench_rx.isr_count++;
+    bench_rx.isr_cycles += cycles;
+    if (cycles > bench_rx.isr_max) {
+        bench_rx.isr_max = cycles;
+    }
+}
+
+void app_bench_uart_rx_bytes(uint32_t bytes, uint32_t dropped)
+{
+    bench_rx.bytes   += bytes;
+    bench_rx.dropped += dropped;
+}
+
+/**
+ * @brief  Print and clear one window of RX counters.
+ * @param  window_ms  Length of the window that just ended.
+ */
+static void bench_report_uart_rx(uint32_t window_ms)
+{
+    bench_uart_rx_t snap;
+
+    /* USART2 / DMA IRQs run at priority 6, below the syscall ceiling */
+    taskENTER_CRITICAL();
+    snap = bench_rx;
+    bench_rx.isr_count  = 0;
+    bench_rx.isr_cycles = 0;
+    bench_rx.isr_max    = 0;
+    bench_rx.bytes      = 0;
+    bench_rx.dropped    = 0;
+    taskEXIT_CRITICAL();
+
+    printf("[rx %s] isr=%lu bytes=%lu cyc/isr=%lu cyc/B=%lu max=%lu "
+           "B/s=%lu drop=%lu\n",
+           APP_UART_RX_DMA ? "dma" : "it",
+           snap.isr_count, snap.bytes,
+           snap.isr_count ? snap.isr_cycles / snap.isr_count : 0UL,
+           snap.bytes     ? snap.isr_cycles / snap.bytes     : 0UL,
+           snap.isr_max,
+           (snap.bytes * 1000UL) / window_ms,
+           snap.dropped);
+}
+
+#else  /* !APP_BENCH_UART_RX */
+
+void app_bench_uart_rx_isr(uint32_t cycles)                 { (void)cycles; }
+void app_bench_uart_rx_bytes(uint32_t bytes, uint32_t dropped)
+{
+    (void)bytes;
+    (void)dropped;
+}
+
+#endif /* APP_BENCH_UART_RX */
+
+#if APP_BENCH_UART_TX
+
+/* ========================== TX Counters ================================== */
+typedef struct {
+    uint32_t bytes;                /* Bytes handed over by print_task        */
+    uint32_t task_cycles;          /* Cycles print_task spent transmitting   */
+    uint32_t isr_count;            /* TX DMA / completion interrupts         */
+    uint32_t isr_cycles;           /* Cycles inside those interrupts         */
+} bench_uart_tx_t;
+
+static volatile bench_uart_tx_t bench_tx;
+
+void app_bench_uart_tx_task(uint32_t bytes, uint32_t cycles)
+{
+    taskENTER_CRITICAL();
+    bench_tx.bytes       += bytes;
+    bench_tx.task_cycles += cycles;
+    taskEXIT_CRITICAL();
+}
+
+void app_bench_uart_tx_isr(uint32_t cycles)
+{
+    bench_tx.isr_count++;
+    bench_tx.isr_cycles += cycles;
+}
+
+/**
+ * @brief  Print and clear one window of TX counters.  Task and ISR cost
+ *         are reported separately; their sum is the CPU cost per byte.
+ * @param  window_ms  Length of the window that just ended.
+ */
+static void bench_report_uart_tx(uint32_t window_ms)
+{
+    bench_uart_tx_t snap;
+
+    taskENTER_CRITICAL();
+    snap = bench_tx;
+    bench_tx.bytes       = 0;
+    bench_tx.task_cycles = 0;
+    bench_tx.isr_count   = 0;
+    bench_tx.isr_cycles  = 0;
+    taskEXIT_CRITICAL();
+
+    printf("[tx %s] bytes=%lu task cyc/B=%lu isr=%lu isr cyc/B=%lu "
+           "B/s=%lu\n",
+           APP_UART_TX_DMA ? "dma" : "poll",
+           snap.bytes,
+           snap.bytes ? snap.task_cycles / snap.bytes : 0UL,
+           snap.isr_count,
+           snap.bytes ? snap.isr_cycles / snap.bytes : 0UL,
+           (snap.bytes * 1000UL) / window_ms);
+}
+
+#else  /* !APP_BENCH_UART_TX */
+
+void app_bench_uart_tx_task(uint32_t bytes, uint32_t cycles)
+{
+    (void)bytes;
+    (void)cycles;
+}
+
+void app_bench_uart_tx_isr(uint32_t cycles)                 { (void)cycles; }
+
+#endif /* APP_BENCH_UART_TX */
+
+#if APP_BENCH_CMD_DISPATCH
+
+/* ========================== Dispatch Counters ============================ */
+typedef struct {
+    uint32_t count;                /* Command lines dispatched               */
+    uint32_t lookup_cycles;        /* Total cycles in cmd_lookup()           */
+    uint32_t lookup_max;           /* Worst single lookup                    */
+    uint32_t total_cycles;         /* Total cycles lookup + handler          */
+    uint32_t total_max;            /* Worst single dispatch                  */
+} bench_cmd_t;
+
+static bench_cmd_t bench_cmd;
+
+void app_bench_cmd_dispatch(uint32_t lookup_cycles, uint32_t total_cycles)
+{
+    taskENTER_CRITICAL();
+    bench_cmd.count++;
+    bench_cmd.lookup_cycles += lookup_cycles;
+    bench_cmd.total_cycles  += total_cycles;
+    if (lookup_cycles > bench_cmd.lookup_max) {
+        bench_cmd.lookup_max = lookup_cycles;
+    }
+    if (total_cycles > bench_cmd.total_max) {
+        bench_cmd.total_max = total_cycles;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief  Print and clear one window of dispatch counters.  Silent when
+ *         no command arrived, so typed input is easy to spot.
+ */
+static void bench_report_cmd_dispatch(void)
+{
+    bench_cmd_t snap;
+
+    taskENTER_CRITICAL();
+    snap = bench_cmd;
+    bench_cmd.count         = 0;
+    bench_cmd.lookup_cycles = 0;
+    bench_cmd.lookup_max    = 0;
+    bench_cmd.total_cycles  = 0;
+    bench_cmd.total_max     = 0;
+    taskEXIT_CRITICAL();
+
+    if (snap.count == 0U) {
+        return;
+    }
+
+    printf("[cmd %s] n=%lu lookup avg=%lu max=%lu total avg=%lu max=%lu\n",
+           APP_CMD_LOOKUP_LINEAR ? "linear" : "hash",
+           snap.count,
+           snap.lookup_cycles / snap.count, snap.lookup_max,
+           snap.total_cycles  / snap.count, snap.total_max);
+}
+
+#else  /* !APP_BENCH_CMD_DISPATCH */
+
+void app_bench_cmd_dispatch(uint32_t lookup_cycles, uint32_t total_cycles)
+{
+    (void)lookup_cycles;
+    (void)total_cycles;
+}
+
+#endif /* APP_BENCH_CMD_DISPATCH */
+
+#if APP_BENCH_MSG_POOL
+
+/**
+ * @brief  Print the message-pool occupancy.  The pool keeps its own
+ *         counters, so nothing is reset here; peak and fails are lifetime.
+ */
+static void bench_report_msg_pool(void)
+{
+    msg_pool_stats_t snap;
+
+    msg_pool_get_stats(&snap);
+
+    printf("[pool] blocks=%lu in_use=%lu peak=%lu fails=%lu\n",
+           snap.blocks, snap.in_use, snap.peak, snap.fails);
+}
+
+#endif /* APP_BENCH_MSG_POOL */
+
+#if APP_BENCH_AO
+
+/* ========================== Active Object Counters ======================= */
+volatile uint32_t app_bench_switches;       /* traceTASK_SWITCHED_IN        */
+static volatile uint32_t bench_ao_cmds;     /* Lines handled by menu_ao     */
+
+void app_bench_ao_command(void)
+{
+    bench_ao_cmds++;               /* menu_ao is the only writer             */
+}
+
+/**
+ * @brief  Print and clear one window of active-object counters.  The
+ *         switch count includes bench_task's own wake-up (two switches per
+ *         period) and every switch to idle, so read sw/cmd on a window in
+ *         which a burst of commands was typed.
+ */
+static void bench_report_ao(void)
+{
+    uint32_t cmds;
+    uint32_t switches;
+
+    taskENTER_CRITICAL();
+    cmds               = bench_ao_cmds;
+    switches           = app_bench_switches;
+    bench_ao_cmds      = 0;
+    app_bench_switches = 0;
+    taskEXIT_CRITICAL();
+
+#if APP_STATIC_ALLOC
+    /* No kernel heap to report: every object was placed by the linker */
+    printf("[ao] cmds=%lu switches=%lu sw/cmd=%lu tasks=%lu heap=none\n",
+           cmds, switches,
+           cmds ? switches / cmds : 0UL,
+           (uint32_t)uxTaskGetNumberOfTasks());
+#else
+    printf("[ao] cmds=%lu switches=%lu sw/cmd=%lu tasks=%lu heap_free=%lu "
+           "min_ever=%lu\n",
+           cmds, switches,
+           cmds ? switches / cmds : 0UL,
+           (uint32_t)uxTaskGetNumberOfTasks(),
+           (uint32_t)xPortGetFreeHeapSize(),
+           (uint32_t)xPortGetMinimumEverFreeHeapSize());
+#endif
+}
+
+#else  /* !APP_BENCH_AO */
+
+void app_bench_ao_command(void)
+{
+}
+
+#endif /* APP_BENCH_AO */
+
+#if APP_BENCH_FMT
+
+/* ========================== Formatter Comparison ========================= */
+#define BENCH_FMT_RUNS      16U    /* Passes over the line set per report    */
+
+typedef int (*bench_fmt_fn_t)(char *dst, size_t size, const char *fmt, ...);
+
+/**
+ * @brief  Format one copy of each demo's typical console line.
+ *         The set covers every conversion the console helpers use.
+ */
+static void bench_fmt_lines(bench_fmt_fn_t fn, char *buf, size_t size)
+{
+    (void)fn(buf, size, "[MASTER] Order #%u  ->  Distribute %u x %s\r\n",
+             42U, 7U, "Sticky Note");
+    (void)fn(buf, size, "  [SLAVE] Handing out %s %u of %u ...\r\n",
+             "Notebook", 3U, 15U);
+    (void)fn(buf, size, "[%s] PARKED! (free: %u/%u)\r\n", "Car-3", 1U, 3U);
+    (void)fn(buf, size, "%02d:%02d:%02d [%s]\t%02d-%02d-%04d\n",
+             9, 5, 7, "PM", 2, 23, 2026);
+    (void)fn(buf, size, "fault at 0x%x (%d)\r\n", 0x2001FFF0U, -12);
+}
+
+#define BENCH_FMT_LINES     5U     /* Calls made by bench_fmt_lines()        */
+
+/**
+ * @brief  Time one formatter over BENCH_FMT_RUNS passes.
+ * @param  fn       Formatter under test.
+ * @param  min_out  Cheapest single pass (least disturbed by interrupts).
+ * @return Total cycles.
+ */
+static uint32_t bench_fmt_time(bench_fmt_fn_t fn, uint32_t *min_out)
+{
+    char     buf[96];
+    uint32_t total = 0;
+    uint32_t best  = UINT32_MAX;
+
+    for (uint32_t run = 0; run < BENCH_FMT_RUNS; run++) {
+        uint32_t start  = dwt_cycles_now();
+        uint32_t cycles;
+
+        bench_fmt_lines(fn, buf, sizeof(buf));
+        cycles = dwt_cycles_since(start);
+        total += cycles;
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    *min_out = best;
+    return total;
+}
+
+/**
+ * @brief  Print cycles per formatted line for fmt_lite and for newlib.
+ */
+static void bench_report_fmt(void)
+{
+    const uint32_t calls = BENCH_FMT_RUNS * BENCH_FMT_LINES;
+    uint32_t       lite_min;
+    uint32_t       newlib_min;
+    uint32_t       lite   = bench_fmt_time(fmt_snprintf, &lite_min);
+    uint32_t       newlib = bench_fmt_time(snprintf, &newlib_min);
+
+    printf("[fmt] lite avg=%lu min=%lu newlib avg=%lu min=%lu cyc/line\n",
+           lite / calls, lite_min / BENCH_FMT_LINES,
+           newlib / calls, newlib_min / BENCH_FMT_LINES);
+}
+
+#endif /* APP_BENCH_FMT */
+
+#if APP_BENCH_ITM
+
+/* ========================== ITM Output Counters ========================== */
+typedef struct {
+    uint32_t count;                /* Callback runs this window              */
+    uint32_t cycles;               /* Total cycles in those runs             */
+    uint32_t max;                  /* Worst single run in this window        */
+} bench_rtc_report_t;
+
+static volatile bench_rtc_report_t bench_rtc;
+
+void app_bench_rtc_report(uint32_t cycles)
+{
+    bench_rtc.count++;
+    bench_rtc.cycles += cycles;
+    if (cycles > bench_rtc.max) {
+        bench_rtc.max = cycles;
+    }
+}
+
+/**
+ * @brief  Print and clear one window of callback timing, then each port's
+ *         lifetime counters.  With APP_ITM_LOG = 0 the callback spins on
+ *         the stimulus port, so max shows how long the SWO link held the
+ *         timer task.
+ */
+static void bench_report_itm(void)
+{
+    bench_rtc_report_t snap;
+
+    taskENTER_CRITICAL();
+    snap = bench_rtc;
+    bench_rtc.count  = 0;
+    bench_rtc.cycles = 0;
+    bench_rtc.max    = 0;
+    taskEXIT_CRITICAL();
+
+    printf("[itm] cb n=%lu avg=%lu max=%lu",
+           snap.count, snap.count ? snap.cycles / snap.count : 0UL, snap.max);
+#if APP_ITM_LOG
+    for (uint32_t port = 0; port < ITM_LOG_PORT_COUNT; port++) {
+        itm_log_stats_t stats;
+
+        itm_log_get_stats((itm_log_port_t)port, &stats);
+        printf(" p%lu sent=%lu drop=%lu/%lu peak=%lu", port, stats.sent,
+               stats.dropped, stats.dropped_msgs, stats.peak);
+    }
+#endif
+    printf("\n");
+}
+
+#else  /* !APP_BENCH_ITM */
+
+void app_bench_rtc_report(uint32_t cycles)
+{
+    (void)cycles;
+}
+
+#endif /* APP_BENCH_ITM */
+
+#if APP_BENCH_ANY
+
+STATIC_TASK(bench_task, STACK_WORDS_BENCH_TASK); /* Report task stack + TCB */
+
+/**
+ * @brief  Benchmark report task -- wakes once per period and prints every
+ *         enabled benchmark's counters to the ITM console.
+ * @param  param  (unused)
+ */
+static void task_bench(void *param)
+{
+    (void)param;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    for (;;) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(APP_BENCH_PERIOD_MS));
+#if APP_BENCH_UART_RX
+        bench_report_uart_rx(APP_BENCH_PERIOD_MS);
+#endif
+#if APP_BENCH_UART_TX
+        bench_report_uart_tx(APP_BENCH_PERIOD_MS);
+#endif
+#if APP_BENCH_CMD_DISPATCH
+        bench_report_cmd_dispatch();
+#endif
+#if APP_BENCH_MSG_POOL
+        bench_report_msg_pool();
+#endif
+#if APP_BENCH_AO
+        bench_report_ao();
+#endif
+#if APP_BENCH_FMT
+        bench_report_fmt();
+#endif
+#if APP_BENCH_ITM
+        bench_report_itm();
+#endif
+    }
+}
+
+void app_bench_init(void)
+{
+    BaseType_t status;
+
+    dwt_cycles_init();
+
+    /* Lowest application priority so reporting never perturbs the DUT */
+    status = STATIC_TASK_CREATE(bench_task, task_bench, "bench_task", NULL, 1,
+                                NULL);
+    configASSERT(status == pdPASS);
+}
+
+#else
+
+void app_bench_init(void)
+{
+}
+
+#endif /* APP_BENCH_ANY */
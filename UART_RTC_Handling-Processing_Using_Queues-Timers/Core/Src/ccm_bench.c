@@ -0,0 +1,376 @@
+/**
+ ******************************************************************************
+ * @file           : ccm_bench.c
+ * @brief          : CPU work on main SRAM vs CCM RAM under DMA traffic
+ *                   (APP_BENCH_CCM).
+ *
+ * @description    : Two workloads, each run once with its memory in main
+ *                   SRAM and once in CCM RAM:
+ *
+ *                     copy    CB_COPY_WORDS words from one half of a buffer
+ *                             to the other, one load and one store each
+ *                     switch  CB_ROUND_TRIPS task notification round trips
+ *                             between cb_ping and cb_pong, whose stacks and
+ *                             TCBs are in the memory under test: two
+ *                             context switches each, all of them stacking
+ *                             and unstacking registers there
+ *
+ *                   under three loads:
+ *
+ *                     none    nothing else on the bus matrix
+ *                     uart    the UART TX ring full, DMA1 Stream6 draining
+ *                             it to USART2 (the demo's own console path)
+ *                     m2m     DMA2 Stream0 copying CB_M2M_WORDS words of
+ *                             main SRAM onto themselves, restarted for
+ *                             every sample: the worst a DMA can do
+ *
+ *                   Once every row has APP_BENCH_CCM_SAMPLES, it prints:
+ *
+ *                     # ccm_bench V11.1.0 cpu_hz=... n=... overhead=...
+ *                     # load   work     memory      min      avg      p99      max
+ *                     none     copy     sram         ..       ..       ..       ..
+ *                     none     copy     ccm          ..       ..       ..       ..
+ *                     ...
+ *                     # m2m_short=0
+ *                     # end
+ *
+ *                   Values are CPU cycles per sample minus the cost of
+ *                   reading the counter.  m2m_short counts samples that
+ *                   outlasted their DMA transfer; with 0 the m2m rows ran
+ *                   under load from start to end.
+ *
+ *                   The DMA and the CPU only meet at a bus matrix slave
+ *                   both use.  CCM RAM is not one for any DMA, so the CCM
+ *                   rows should read the same under every load.  A UART at
+ *                   115200 baud moves a byte every ~14,600 CPU cycles: its
+ *                   row is the real application and will barely move; the
+ *                   m2m row shows what a busy stream (SPI, ADC, SDIO, a
+ *                   display) costs the tasks left in main SRAM.  On the
+ *                   host there is no bus matrix, and the rows only compare
+ *                   code paths.
+ ******************************************************************************
+ */
+
+#include "ccm_bench.h"
+#include "app_config.h"
+
+#if APP_BENCH_CCM
+
+#include "dwt_cycles.h"
+#include "bench_stats.h"
+
+#include <stdio.h>                 /* printf -> ITM / host stdout            */
+#include <stdlib.h>                /* exit (APP_BENCH_CCM_EXIT)              */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "static_alloc.h"
+#include "ccm_ram.h"
+#include "uart_dma.h"
+
+#if !APP_STATIC_ALLOC
+#error "ccm_bench places its task stacks and TCBs: build it with APP_STATIC_ALLOC = 1"
+#endif
+
+/* ========================== Private Defines ============================== */
+#define CB_PRIO_BENCH       ( configMAX_PRIORITIES - 3U )
+#define CB_PRIO_PING        ( configMAX_PRIORITIES - 3U )
+#define CB_PRIO_PONG        ( configMAX_PRIORITIES - 2U )  /* Under timers  */
+#define CB_STACK_WORDS      256U   /* cbench_task: printf + sort             */
+#define CB_PING_WORDS       128U   /* cb_ping / cb_pong: a notify loop       */
+
+#define CB_COPY_WORDS       256U   /* copy: 1 KB per sample                  */
+#define CB_ROUND_TRIPS      8U     /* switch: 16 context switches per sample */
+#define CB_M2M_WORDS        2048U  /* m2m: 8 KB per transfer, > one sample   */
+
+/* Pause between printed rows, so the ITM FIFO drains */
+#define CB_ROW_GAP_MS       20U
+
+/* ========================== Private Types ================================ */
+typedef enum {
+    CB_LOAD_NONE = 0,
+    CB_LOAD_UART,
+    CB_LOAD_M2M,
+    CB_LOADS
+} cb_load_t;
+
+typedef struct {
+    const char   *name;
+    uint32_t     *buf;                       /* 2 * CB_COPY_WORDS           */
+    StackType_t (*stack)[CB_PING_WORDS];     /* cb_ping, cb_pong            */
+    StaticTask_t *tcb;
+} cb_mem_t;
+
+/* ========================== Private Data ================================= */
+static uint32_t          cb_sram_buf[2U * CB_COPY_WORDS];
+static StackType_t       cb_sram_stack[2][CB_PING_WORDS];
+static StaticTask_t      cb_sram_tcb[2];
+
+static uint32_t          cb_ccm_buf[2U * CB_COPY_WORDS] CCM_BSS(cb_ccm_buf);
+static StackType_t       cb_ccm_stack[2][CB_PING_WORDS] CCM_BSS(cb_ccm_stack);
+static StaticTask_t      cb_ccm_tcb[2] CCM_BSS(cb_ccm_tcb);
+
+static const cb_mem_t    cb_mems[] = {
+    { "sram", cb_sram_buf, cb_sram_stack, cb_sram_tcb },
+    { "ccm",  cb_ccm_buf,  cb_ccm_stack,  cb_ccm_tcb  },
+};
+
+static const char *const cb_load_names[CB_LOADS] = { "none", "uart", "m2m" };
+
+static uint32_t          cb_m2m_buf[CB_M2M_WORDS];
+static DMA_HandleTypeDef cb_dma;
+
+static uint32_t          cb_samples[APP_BENCH_CCM_SAMPLES];
+static uint32_t          cb_overhead;      /* bench_calibrate(), header line */
+static bench_stats_t     cb_stats;         /* Summary of the row printed     */
+static uint32_t          cb_m2m_short;     /* Samples past the DMA transfer  */
+static cb_load_t         cb_load;          /* Load of the row being run      */
+
+static TaskHandle_t      cb_bench_handle;
+static TaskHandle_t      cb_ping_handle;
+static TaskHandle_t      cb_pong_handle;
+
+STATIC_TASK(cbench_task, CB_STACK_WORDS);
+
+/* ========================== Load ========================================= */
+
+/**
+ * @brief  DMA2 Stream0, memory to memory, word bursts: as much main SRAM
+ *         traffic as one stream makes.
+ */
+static void cb_dma_init(void)
+{
+    HAL_StatusTypeDef status;
+
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    cb_dma.Instance                 = DMA2_Stream0;
+    cb_dma.Init.Channel             = DMA_CHANNEL_0;
+    cb_dma.Init.Direction           = DMA_MEMORY_TO_MEMORY;
+    cb_dma.Init.PeriphInc           = DMA_PINC_ENABLE;
+    cb_dma.Init.MemInc              = DMA_MINC_ENABLE;
+    cb_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    cb_dma.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    cb_dma.Init.Mode                = DMA_NORMAL;
+    cb_dma.Init.Priority            = DMA_PRIORITY_VERY_HIGH;
+    cb_dma.Init.FIFOMode            = DMA_FIFOMODE_ENABLE;  /* M2M needs it  */
+    cb_dma.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
+    cb_dma.Init.MemBurst            = DMA_MBURST_INC4;
+    cb_dma.Init.PeriphBurst         = DMA_PBURST_INC4;
+    status = HAL_DMA_Init(&cb_dma);
+    configASSERT(status == HAL_OK);
+}
+
+/**
+ * @brief  Fill the UART TX ring, so DMA1 Stream6 stays busy for the ~90 ms
+ *         the ring takes to drain at 115200 baud: longer than a row.
+ */
+static void cb_uart_fill(void)
+{
+#if APP_UART_TX_DMA
+    static const char line[] = "ccm_bench uart load ......................"
+                               "......................\r\n";
+    size_t            queued = 0;
+
+    while (queued < APP_UART_TX_RING_SIZE &&
+           uart_dma_tx_write(line, sizeof(line) - 1U, 0) == sizeof(line) - 1U) {
+        queued += sizeof(line) - 1U;
+    }
+#endif
+}
+
+/* Around each sample, outside the timed part */
+static void cb_load_begin(void)
+{
+    if (cb_load == CB_LOAD_M2M) {
+        (void)HAL_DMA_Start(&cb_dma, (uint32_t)cb_m2m_buf, (uint32_t)cb_m2m_buf,
+                            CB_M2M_WORDS);
+    }
+}
+
+static void cb_load_end(void)
+{
+    if (cb_load == CB_LOAD_M2M) {
+        if (cb_dma.Instance->NDTR == 0U) {
+            cb_m2m_short++;        /* Finished before the sample did          */
+        }
+        (void)HAL_DMA_Abort(&cb_dma);
+    }
+}
+
+/* ========================== Measurement ================================== */
+
+/**
+ * @brief  copy: one sample per pass over the buffer.  volatile keeps every
+ *         word a separate load and store.
+ */
+static void cb_run_copy(const cb_mem_t *mem)
+{
+    volatile uint32_t *src = mem->buf;
+    volatile uint32_t *dst = mem->buf + CB_COPY_WORDS;
+
+    for (uint32_t i = 0; i < 2U * CB_COPY_WORDS; i++) {
+        mem->buf[i] = i;           /* CCM is not cleared at reset            */
+    }
+    for (uint32_t s = 0; s < APP_BENCH_CCM_SAMPLES; s++) {
+        uint32_t start;
+
+        cb_load_begin();
+        start = dwt_cycles_now();
+        for (uint32_t i = 0; i < CB_COPY_WORDS; i++) {
+            dst[i] = src[i];
+        }
+        cb_samples[s] = bench_net(dwt_cycles_since(start));
+        cb_load_end();
+    }
+}
+
+/**
+ * @brief  Answers every notification from cb_ping.  Higher priority, so
+ *         each give in cb_ping switches here and each take here switches
+ *         back.
+ */
+static void cb_pong(void *param)
+{
+    (void)param;
+
+    for (;;) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        xTaskNotifyGive(cb_ping_handle);
+    }
+}
+
+/**
+ * @brief  Times CB_ROUND_TRIPS round trips per sample, then wakes the
+ *         bench task and deletes itself.
+ */
+static void cb_ping(void *param)
+{
+    (void)param;
+
+    for (uint32_t s = 0; s < APP_BENCH_CCM_SAMPLES; s++) {
+        uint32_t start;
+
+        cb_load_begin();
+        start = dwt_cycles_now();
+        for (uint32_t r = 0; r < CB_ROUND_TRIPS; r++) {
+            xTaskNotifyGive(cb_pong_handle);
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        cb_samples[s] = bench_net(dwt_cycles_since(start));
+        cb_load_end();
+    }
+    xTaskNotifyGive(cb_bench_handle);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief  switch: both tasks on the stacks and TCBs of 'mem'.
+ */
+static void cb_run_switch(const cb_mem_t *mem)
+{
+    cb_pong_handle = xTaskCreateStatic(cb_pong, "cb_pong", CB_PING_WORDS, NULL,
+                                       CB_PRIO_PONG, mem->stack[1], &mem->tcb[1]);
+    cb_ping_handle = xTaskCreateStatic(cb_ping, "cb_ping", CB_PING_WORDS, NULL,
+                                       CB_PRIO_PING, mem->stack[0], &mem->tcb[0]);
+    configASSERT(cb_pong_handle != NULL && cb_ping_handle != NULL);
+
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    vTaskDelete(cb_pong_handle);
+
+    /* Let the idle task finish the deletions before the storage is reused */
+    vTaskDelay(pdMS_TO_TICKS(CB_ROW_GAP_MS));
+}
+
+/* ========================== Report ======================================= */
+
+static void cb_print_header(void)
+{
+    printf("# ccm_bench %s cpu_hz=%lu n=%lu overhead=%lu copy_words=%lu "
+           "round_trips=%lu m2m_words=%lu\n",
+           tskKERNEL_VERSION_NUMBER,
+           (unsigned long)SystemCoreClock,
+           (unsigned long)APP_BENCH_CCM_SAMPLES,
+           (unsigned long)cb_overhead,
+           (unsigned long)CB_COPY_WORDS,
+           (unsigned long)CB_ROUND_TRIPS,
+           (unsigned long)CB_M2M_WORDS);
+    printf("# %-6s %-8s %-6s %8s %8s %8s %8s\n",
+           "load", "work", "memory", "min", "avg", "p99", "max");
+}
+
+static void cb_print_row(const char *work, const cb_mem_t *mem)
+{
+    bench_summarise(&cb_stats, cb_samples, APP_BENCH_CCM_SAMPLES);
+    printf("%-8s %-8s %-6s %8lu %8lu %8lu %8lu\n",
+           cb_load_names[cb_load], work, mem->name,
+           (unsigned long)cb_stats.min, (unsigned long)cb_stats.avg,
+           (unsigned long)cb_stats.p99, (unsigned long)cb_stats.max);
+}
+
+/* ========================== Task ========================================= */
+
+/**
+ * @brief  Run every load / workload / memory row, print the table, then
+ *         exit (host build, APP_BENCH_CCM_EXIT) or delete itself.
+ * @param  param  (unused)
+ */
+static void cbench_task(void *param)
+{
+    (void)param;
+
+    /* Let the start-up work of the other tasks finish first */
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    cb_overhead = bench_calibrate();
+    cb_print_header();
+
+    for (cb_load = CB_LOAD_NONE; cb_load < CB_LOADS; cb_load++) {
+        if (cb_load == CB_LOAD_UART && !APP_UART_TX_DMA) {
+            continue;              /* Console is polled: no DMA to measure   */
+        }
+        for (uint32_t m = 0; m < sizeof(cb_mems) / sizeof(cb_mems[0]); m++) {
+            if (cb_load == CB_LOAD_UART) {
+                cb_uart_fill();
+            }
+            cb_run_copy(&cb_mems[m]);
+            cb_print_row("copy", &cb_mems[m]);
+
+            if (cb_load == CB_LOAD_UART) {
+                cb_uart_fill();
+            }
+            cb_run_switch(&cb_mems[m]);
+            cb_print_row("switch", &cb_mems[m]);
+            vTaskDelay(pdMS_TO_TICKS(CB_ROW_GAP_MS));
+        }
+    }
+    printf("# m2m_short=%lu\n", (unsigned long)cb_m2m_short);
+    printf("# end\n");
+
+#if APP_BENCH_CCM_EXIT
+    exit(0);
+#endif
+
+    vTaskDelete(NULL);
+}
+
+/* ========================== Public API =================================== */
+
+void ccm_bench_init(void)
+{
+    BaseType_t status;
+
+    dwt_cycles_init();
+    cb_dma_init();
+
+    status = STATIC_TASK_CREATE(cbench_task, cbench_task, "cbench_task", NULL,
+                                CB_PRIO_BENCH, &cb_bench_handle);
+    configASSERT(status == pdPASS);
+}
+
+#else  /* !APP_BENCH_CCM */
+
+void ccm_bench_init(void)
+{
+}
+
+#endif /* APP_BENCH_CCM */
@@ -0,0 +1,87 @@
+/**
+ ******************************************************************************
+ * @file           : cmd_dispatch.c
+ * @brief          : Command table lookup (perfect hash or linear reference).
+ *
+ * @description    : The hash lookup packs the typed line into the same key
+ *                   the table macros computed at compile time and probes
+ *                   one slot.  A line that cannot be a token (too long, or
+ *                   a non-ASCII byte) skips straight to the CMD_ANY probe.
+ *
+ *                   The linear lookup compares the line against every row
+ *                   with strcmp, like the if/strcmp chains the table
+ *                   replaced; it exists only so APP_BENCH_CMD_DISPATCH can
+ *                   report both costs on the same build.
+ ******************************************************************************
+ */
+
+#include "cmd_dispatch.h"
+#include "app_config.h"
+
+#include <string.h>                /* strcmp                                 */
+
+#if APP_CMD_LOOKUP_LINEAR
+
+const cmd_entry_t *cmd_lookup(const cmd_table_t *table, uint8_t state,
+                              const uint8_t *text, uint32_t len)
+{
+    const cmd_entry_t *any = NULL;
+
+    (void)len;
+
+    for (uint32_t i = 0; i < table->row_count; i++) {
+        const cmd_entry_t *row = &table->rows[i];
+
+        if (row->state != state) {
+            continue;
+        }
+        if (row->token[0] == '\0') {
+            any = row;             /* Remember the wildcard, keep scanning   */
+        } else if (strcmp((const char *)text, row->token) == 0) {
+            return row;
+        }
+    }
+    return any;
+}
+
+#else  /* !APP_CMD_LOOKUP_LINEAR */
+
+/**
+ * @brief  Probe the slot a key hashes to.
+ * @return Row if the slot holds exactly this key, else NULL.
+ */
+static const cmd_entry_t *cmd_probe(const cmd_table_t *table, uint32_t key)
+{
+    const cmd_entry_t *row = &table->slots[CMD_SLOT(key)];
+
+    return (row->key == key) ? row : NULL;
+}
+
+const cmd_entry_t *cmd_lookup(const cmd_table_t *table, uint8_t state,
+                              const uint8_t *text, uint32_t len)
+{
+    const cmd_entry_t *row = NULL;
+
+    if (len <= CMD_TOKEN_MAX) {
+        uint32_t packed = 0;
+        uint8_t  high   = 0;       /* OR of all chars: bit 7 = non-ASCII     */
+
+        for (uint32_t i = 0; i < CMD_TOKEN_MAX; i++) {
+            uint8_t c = (i < len) ? text[i] : 0U;
+
+            high  |= c;
+            packed = (packed << 7) | (c & 0x7FU);
+        }
+
+        if ((high & 0x80U) == 0U) {
+            row = cmd_probe(table, CMD_KEY(state, (0)) | packed);
+        }
+    }
+
+    if (row == NULL) {
+        row = cmd_probe(table, CMD_KEY(state, CMD_ANY));
+    }
+    return row;
+}
+
+#endif /* APP_CMD_LOOKUP_LINEAR */
@@ -0,0 +1,434 @@
+/**
+ ******************************************************************************
+ * @file           : cpu_stats.c
+ * @brief          : Per-task and per-ISR CPU accounting behind the menu's
+ *                   "Task Monitor" (top) page.
+ *
+ * @description    : Data flow:
+ *
+ *                   vTaskSwitchContext --> cpu_stats_clock() --> each TCB's
+ *                                          run-time counter (kernel)
+ *                   IRQ handlers ------> cpu_stats_isr() --> cycle totals
+ *                                                               |
+ *                   cpu_stats timer (1 / period): uxTaskGetSystemState()
+ *                   and the ISR totals --> ring of WINDOW + 1 samples
+ *                                                               |
+ *                   menu_ao: cpu_stats_print() diffs the newest sample
+ *                   against the one before it and the oldest one
+ *
+ *                   Every counter is cumulative, so a window is just the
+ *                   difference of two samples and no sample is ever reset.
+ *                   Tasks are matched between samples by xTaskNumber,
+ *                   which the kernel never reuses.
+ *
+ *                   The run-time clock counts wall time between switches,
+ *                   so an interrupt's cycles also land in the task it
+ *                   interrupted; the ISR rows show that share separately.
+ ******************************************************************************
+ */
+
+#include "cpu_stats.h"
+#include "app_config.h"
+#include "fmt_lite.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if APP_CPU_STATS
+
+#include <string.h>                /* strncpy                                */
+#include "timers.h"
+#include "dwt_cycles.h"
+#include "static_alloc.h"
+
+/* Samples in the ring: the window needs one more than it has periods */
+#define CPU_RING_SIZE       (APP_CPU_STATS_WINDOW + 1U)
+
+/* Permille value printed as "-": task not present at the window start */
+#define CPU_PCT_NONE        0xFFFFFFFFUL
+
+#if APP_CPU_STATS_WINDOW < 2U
+#error "APP_CPU_STATS_WINDOW must be at least 2 periods"
+#endif
+
+/* ========================== Private Types ================================ */
+typedef struct {
+    UBaseType_t number;            /* TaskStatus_t.xTaskNumber               */
+    uint64_t    run;               /* Run-time counter at the sample         */
+} cpu_task_sample_t;
+
+typedef struct {
+    uint64_t          clock;       /* Run-time clock at the sample           */
+    uint64_t          isr_cycles[CPU_ISR_COUNT];   /* Cumulative             */
+    uint32_t          isr_count[CPU_ISR_COUNT];    /* Cumulative, wraps      */
+    UBaseType_t       tasks;       /* Valid task[] entries (0 = overflow)    */
+    cpu_task_sample_t task[APP_CPU_STATS_MAX_TASKS];
+} cpu_sample_t;
+
+/* One line of the task table, computed with the scheduler suspended */
+typedef struct {
+    char        name[configMAX_TASK_NAME_LEN];
+    char        state;             /* X R B S D, as in vTaskList()           */
+    UBaseType_t prio;              /* Current (possibly inherited) priority  */
+    uint32_t    stack;             /* High-water mark: words never used      */
+    uint32_t    pct_now;           /* Permille over the last period          */
+    uint32_t    pct_avg;           /* Permille over the whole window         */
+} cpu_task_row_t;
+
+typedef struct {
+    uint32_t    count;             /* Interrupts in the last period          */
+    uint32_t    pct_now;
+    uint32_t    pct_avg;
+} cpu_isr_row_t;
+
+/* ========================== Private Data ================================= */
+
+/* 64-bit run-time clock: CYCCNT plus a software high word */
+static uint32_t          cpu_clock_last;
+static uint64_t          cpu_clock_high;
+
+/* Written by the handlers of one row only (same NVIC priority, no nesting) */
+static volatile uint32_t cpu_isr_cycles[CPU_ISR_COUNT];
+static volatile uint32_t cpu_isr_count[CPU_ISR_COUNT];
+
+/* Sampler state (timer service task) */
+static uint32_t          cpu_isr_seen[CPU_ISR_COUNT];  /* Cycles last sample */
+static uint64_t          cpu_isr_total[CPU_ISR_COUNT];
+static cpu_sample_t      cpu_ring[CPU_RING_SIZE];
+static uint32_t          cpu_head;                     /* Next slot written  */
+static uint32_t          cpu_fill;                     /* Valid samples      */
+
+/* Shared by the sampler and cpu_stats_print(); the latter holds the
+ * scheduler suspended while it uses them, so the two never overlap */
+static TaskStatus_t      cpu_status[APP_CPU_STATS_MAX_TASKS];
+static cpu_task_row_t    cpu_rows[APP_CPU_STATS_MAX_TASKS];
+static cpu_isr_row_t     cpu_isr_rows[CPU_ISR_COUNT];
+STATIC_TIMER(cpu_stats);                               /* Sampling timer     */
+
+static const char *const CPU_ISR_NAMES[CPU_ISR_COUNT] = {
+    [CPU_ISR_USART2]   = "usart2",
+    [CPU_ISR_DMA_RX]   = "dma1_s5 rx",
+    [CPU_ISR_DMA_TX]   = "dma1_s6 tx",
+    [CPU_ISR_RTC_WKUP] = "rtc_wkup",
+};
+
+/* ========================== Run-Time Clock =============================== */
+
+void cpu_stats_clock_start(void)
+{
+    dwt_cycles_init();
+    cpu_clock_last = 0;
+    cpu_clock_high = 0;
+}
+
+uint64_t cpu_stats_clock(void)
+{
+    /* Called from the switch path, the sampler and task code alike */
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t    now  = dwt_cycles_now();
+    uint64_t    clock;
+
+    if (now < cpu_clock_last) {
+        cpu_clock_high += (uint64_t)1U << 32;
+    }
+    cpu_clock_last = now;
+    clock = cpu_clock_high | now;
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+    return clock;
+}
+
+void cpu_stats_isr(cpu_isr_t isr, uint32_t cycles)
+{
+    cpu_isr_cycles[isr] += cycles;
+    cpu_isr_count[isr]++;
+}
+
+/* ========================== Sampling ===================================== */
+
+/**
+ * @brief  Timer callback: append one sample to the ring.
+ *         Also keeps cpu_stats_clock() running at least once per CYCCNT
+ *         wrap when nothing else switches tasks.
+ */
+static void cpu_stats_sample(TimerHandle_t timer)
+{
+    cpu_sample_t               *s = &cpu_ring[cpu_head];
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    UBaseType_t                 n;
+
+    (void)timer;
+
+    n = uxTaskGetSystemState(cpu_status, APP_CPU_STATS_MAX_TASKS, &total);
+    if (n == 0U) {
+        total = cpu_stats_clock(); /* More tasks than slots: no task rows    */
+    }
+
+    s->clock = total;
+    s->tasks = n;
+    for (UBaseType_t i = 0; i < n; i++) {
+        s->task[i].number = cpu_status[i].xTaskNumber;
+        s->task[i].run    = cpu_status[i].ulRunTimeCounter;
+    }
+
+    for (uint32_t i = 0; i < CPU_ISR_COUNT; i++) {
+        uint32_t cycles = cpu_isr_cycles[i];
+
+        cpu_isr_total[i] += cycles - cpu_isr_seen[i];  /* Wrap-safe delta   */
+        cpu_isr_seen[i]   = cycles;
+        s->isr_cycles[i]  = cpu_isr_total[i];
+        s->isr_count[i]   = cpu_isr_count[i];
+    }
+
+    cpu_head = (cpu_head + 1U) % CPU_RING_SIZE;
+    if (cpu_fill < CPU_RING_SIZE) {
+        cpu_fill++;
+    }
+}
+
+/**
+ * @brief  Sample taken a number of periods before the newest one.
+ * @param  back  0 = newest; must be below cpu_fill.
+ */
+static const cpu_sample_t *cpu_sample_back(uint32_t back)
+{
+    return &cpu_ring[(cpu_head + CPU_RING_SIZE - 1U - back) % CPU_RING_SIZE];
+}
+
+/**
+ * @brief  Find a task's run-time counter in a sample.
+ * @return Entry, or NULL if the task did not exist then.
+ */
+static const cpu_task_sample_t *cpu_sample_find(const cpu_sample_t *s,
+                                                UBaseType_t number)
+{
+    for (UBaseType_t i = 0; i < s->tasks; i++) {
+        if (s->task[i].number == number) {
+            return &s->task[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief  part / whole in permille, clamped to 1000.
+ */
+static uint32_t cpu_permille(uint64_t part, uint64_t whole)
+{
+    uint64_t permille;
+
+    if (whole == 0U) {
+        return 0;
+    }
+    permille = part * 1000U / whole;
+    return (permille > 1000U) ? 1000U : (uint32_t)permille;
+}
+
+/**
+ * @brief  A task's share between two samples.
+ * @return Permille, or CPU_PCT_NONE if it is missing from either sample.
+ */
+static uint32_t cpu_task_pct(UBaseType_t number,
+                             const cpu_sample_t *from, const cpu_sample_t *to)
+{
+    const cpu_task_sample_t *a = cpu_sample_find(from, number);
+    const cpu_task_sample_t *b = cpu_sample_find(to, number);
+
+    if (a == NULL || b == NULL) {
+        return CPU_PCT_NONE;
+    }
+    return cpu_permille(b->run - a->run, to->clock - from->clock);
+}
+
+/* ========================== Task Monitor Page ============================ */
+
+static char cpu_state_char(eTaskState state)
+{
+    switch (state) {
+    case eRunning:   return 'X';
+    case eReady:     return 'R';
+    case eBlocked:   return 'B';
+    case eSuspended: return 'S';
+    case eDeleted:   return 'D';
+    default:         return '?';
+    }
+}
+
+/**
+ * @brief  Fill cpu_rows / cpu_isr_rows.  Runs with the scheduler
+ *         suspended, so the sampler cannot move the ring underneath.
+ * @param  periods  Out: periods covered by the long window.
+ * @return Task rows, or 0 if there is no window yet or too many tasks.
+ */
+static UBaseType_t cpu_collect(uint32_t *periods)
+{
+    const cpu_sample_t *now;
+    const cpu_sample_t *prev;
+    const cpu_sample_t *first;
+    UBaseType_t         n;
+
+    *periods = 0;
+    if (cpu_fill < 2U) {
+        return 0;
+    }
+    *periods = cpu_fill - 1U;
+    now   = cpu_sample_back(0);
+    prev  = cpu_sample_back(1);
+    first = cpu_sample_back(*periods);
+
+    /* Live name, state, priority and stack; CPU from the samples */
+    n = uxTaskGetSystemState(cpu_status, APP_CPU_STATS_MAX_TASKS, NULL);
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t *ts  = &cpu_status[i];
+        cpu_task_row_t     *row = &cpu_rows[i];
+
+        strncpy(row->name, ts->pcTaskName, sizeof(row->name) - 1U);
+        row->name[sizeof(row->name) - 1U] = '\0';
+        row->state   = cpu_state_char(ts->eCurrentState);
+        row->prio    = ts->uxCurrentPriority;
+        row->stack   = (uint32_t)ts->usStackHighWaterMark;
+        row->pct_now = cpu_task_pct(ts->xTaskNumber, prev, now);
+        row->pct_avg = cpu_task_pct(ts->xTaskNumber, first, now);
+    }
+
+    for (uint32_t i = 0; i < CPU_ISR_COUNT; i++) {
+        cpu_isr_rows[i].count   = now->isr_count[i] - prev->isr_count[i];
+        cpu_isr_rows[i].pct_now = cpu_permille(now->isr_cycles[i] - prev->isr_cycles[i],
+                                               now->clock - prev->clock);
+        cpu_isr_rows[i].pct_avg = cpu_permille(now->isr_cycles[i] - first->isr_cycles[i],
+                                               now->clock - first->clock);
+    }
+
+    return n;
+}
+
+/**
+ * @brief  Busiest first (last period), missing values last.
+ *         Insertion sort: a dozen rows at most.
+ */
+static void cpu_sort_rows(UBaseType_t n)
+{
+    for (UBaseType_t i = 1; i < n; i++) {
+        cpu_task_row_t key = cpu_rows[i];
+        uint32_t       k   = (key.pct_now == CPU_PCT_NONE) ? 0U : key.pct_now + 1U;
+        UBaseType_t    j   = i;
+
+        while (j > 0U) {
+            uint32_t p = cpu_rows[j - 1U].pct_now;
+
+            if (((p == CPU_PCT_NONE) ? 0U : p + 1U) >= k) {
+                break;
+            }
+            cpu_rows[j] = cpu_rows[j - 1U];
+            j--;
+        }
+        cpu_rows[j] = key;
+    }
+}
+
+/**
+ * @brief  Permille as a 5-character percentage: "100.0", "  2.5", "    -".
+ */
+static void cpu_fmt_pct(char out[6], uint32_t permille)
+{
+    if (permille == CPU_PCT_NONE) {
+        (void)fmt_snprintf(out, 6, "%5s", "-");
+    } else {
+        (void)fmt_snprintf(out, 6, "%3u.%u",
+                           (unsigned)(permille / 10U),
+                           (unsigned)(permille % 10U));
+    }
+}
+
+void cpu_stats_print(cpu_stats_out_t out)
+{
+    char        line[CPU_STATS_LINE_MAX];
+    char        now_pct[6];
+    char        avg_pct[6];
+    uint32_t    periods;
+    uint32_t    window_s;
+    UBaseType_t n;
+
+    vTaskSuspendAll();
+    n = cpu_collect(&periods);
+    (void)xTaskResumeAll();
+
+    if (periods == 0U) {
+        out(line, (size_t)fmt_snprintf(line, sizeof(line),
+            "\r\n  [!] CPU stats: first window not complete yet.\r\n"));
+        return;
+    }
+    if (n == 0U) {
+        out(line, (size_t)fmt_snprintf(line, sizeof(line),
+            "\r\n  [!] CPU stats: more than %u tasks.\r\n",
+            (unsigned)APP_CPU_STATS_MAX_TASKS));
+        return;
+    }
+
+    cpu_sort_rows(n);
+    window_s = periods * APP_CPU_STATS_PERIOD_MS / 1000U;
+
+    out(line, (size_t)fmt_snprintf(line, sizeof(line),
+        "\r\n  TASK MONITOR  (CPU %% over %u ms / %u s)\r\n",
+        (unsigned)APP_CPU_STATS_PERIOD_MS, (unsigned)window_s));
+    out(line, (size_t)fmt_snprintf(line, sizeof(line),
+        "  %-16s st pri   now   avg  stack\r\n", "task"));
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        cpu_fmt_pct(now_pct, cpu_rows[i].pct_now);
+        cpu_fmt_pct(avg_pct, cpu_rows[i].pct_avg);
+        out(line, (size_t)fmt_snprintf(line, sizeof(line),
+            "  %-16s %c  %2u %s %s %6u\r\n",
+            cpu_rows[i].name, cpu_rows[i].state,
+            (unsigned)cpu_rows[i].prio, now_pct, avg_pct,
+            (unsigned)cpu_rows[i].stack));
+    }
+
+    out(line, (size_t)fmt_snprintf(line, sizeof(line),
+        "  %-16s  irqs   now   avg\r\n", "isr"));
+    for (uint32_t i = 0; i < CPU_ISR_COUNT; i++) {
+        cpu_fmt_pct(now_pct, cpu_isr_rows[i].pct_now);
+        cpu_fmt_pct(avg_pct, cpu_isr_rows[i].pct_avg);
+        out(line, (size_t)fmt_snprintf(line, sizeof(line),
+            "  %-16s %5u %s %s\r\n",
+            CPU_ISR_NAMES[i], (unsigned)cpu_isr_rows[i].count,
+            now_pct, avg_pct));
+    }
+
+    out(line, (size_t)fmt_snprintf(line, sizeof(line),
+        "  st: X run R ready B blocked S suspended\r\n"));
+    out(line, (size_t)fmt_snprintf(line, sizeof(line),
+        "  stack: words never used; task %% includes its ISRs\r\n"));
+}
+
+void cpu_stats_init(void)
+{
+    TimerHandle_t timer;
+    BaseType_t    status;
+
+    timer = STATIC_TIMER_CREATE(cpu_stats, "cpu_stats",
+                                pdMS_TO_TICKS(APP_CPU_STATS_PERIOD_MS),
+                                pdTRUE, NULL, cpu_stats_sample);
+    configASSERT(timer != NULL);
+
+    /* Queued now, processed once the timer service task starts */
+    status = xTimerStart(timer, 0);
+    configASSERT(status == pdPASS);
+}
+
+#else
+
+void cpu_stats_init(void)
+{
+}
+
+void cpu_stats_print(cpu_stats_out_t out)
+{
+    static const char MSG_CPU_STATS_OFF[] =
+        "\r\n  [!] Task monitor needs APP_CPU_STATS = 1.\r\n";
+
+    out(MSG_CPU_STATS_OFF, sizeof(MSG_CPU_STATS_OFF) - 1U);
+}
+
+#endif /* APP_CPU_STATS */
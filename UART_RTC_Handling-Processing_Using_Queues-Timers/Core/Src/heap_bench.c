@@ -0,0 +1,375 @@
+/**
+ ******************************************************************************
+ * @file           : heap_bench.c
+ * @brief          : Kernel heap latency and fragmentation (APP_BENCH_HEAP).
+ *
+ * @description    : hbench_task churns HB_SLOTS object slots: each step
+ *                   picks a slot at random and either frees what it holds
+ *                   or fills it with a new task, queue or timer.  It makes
+ *                   the heap calls those objects make, with their sizes:
+ *
+ *                     object  allocations (in order)          freed
+ *                     task    stack (128..511 words), TCB     stack, TCB
+ *                     queue   Queue_t + 1..16 items of 1..32 B  one block
+ *                     timer   Timer_t                         one block
+ *
+ *                   Calling pvPortMalloc / vPortFree directly keeps the
+ *                   samples to the allocator alone: xTaskCreate would add
+ *                   the stack fill, xTimerCreate a trip through the timer
+ *                   queue.  Each call is one sample.  Once both have
+ *                   APP_BENCH_HEAP_SAMPLES, it prints:
+ *
+ *                     # heap_bench V11.1.0 cpu_hz=... heap=heap_4 ...
+ *                     # op                 min      avg      p99      max
+ *                     malloc                ..       ..       ..       ..
+ *                     free                  ..       ..       ..       ..
+ *                     #
+ *                     # step      live      free   largest   blocks  frag%
+ *                     #  ...
+ *                     #
+ *                     # malloc (calls per cycle range)
+ *                     #       64-127      |#########                 120
+ *                     ...
+ *                     # end
+ *
+ *                   Values are CPU cycles minus the cost of reading the
+ *                   counter.  The fragmentation rows are taken at four
+ *                   points of the run from vPortGetHeapStats():
+ *                   frag% = 100 - 100 * largest free block / free bytes,
+ *                   so 0 means all free memory is one block.
+ *
+ *                   The churn holds at most half of the heap that was free
+ *                   when it started (budget); a creation that would go
+ *                   over it is skipped and counted instead.  That leaves
+ *                   the application room and keeps every allocation
+ *                   successful, since the malloc-failed hook halts.
+ *
+ *                   The pattern is a fixed pseudo-random sequence, the
+ *                   same for every heap, so two runs differ only in the
+ *                   allocator.  The rest of the application keeps its
+ *                   objects on the same heap throughout.
+ ******************************************************************************
+ */
+
+#include "heap_bench.h"
+#include "app_config.h"
+
+#if APP_BENCH_HEAP
+
+#include "dwt_cycles.h"
+#include "bench_stats.h"
+
+#include <stdio.h>                 /* printf -> ITM / host stdout            */
+#include <stdlib.h>                /* exit (APP_BENCH_HEAP_EXIT)             */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if APP_STATIC_ALLOC
+#error "heap_bench times pvPortMalloc: build it with APP_STATIC_ALLOC = 0"
+#endif
+
+/* ========================== Private Defines ============================== */
+#define HB_PRIO_BENCH       ( configMAX_PRIORITIES - 2U )
+#define HB_STACK_WORDS      256U   /* hbench_task: printf + sort             */
+
+#define HB_SLOTS            24U    /* Objects alive at most, half on average */
+#define HB_CHECKPOINTS      4U     /* Fragmentation rows                     */
+#define HB_SEED             0x2545F491UL
+
+/* Bound on steps, in case the budget turns most creations away */
+#define HB_MAX_STEPS        ( 8U * APP_BENCH_HEAP_SAMPLES )
+
+/* Pause between printed rows, so the ITM FIFO drains */
+#define HB_ROW_GAP_MS       20U
+
+/* ========================== Private Types ================================ */
+typedef enum {
+    HB_EMPTY = 0,
+    HB_TASK,
+    HB_QUEUE,
+    HB_TIMER
+} hb_kind_t;
+
+typedef struct {
+    hb_kind_t kind;
+    void     *block[2];            /* Task: stack, TCB; others: block[0]     */
+    size_t    bytes;               /* Requested, both blocks                 */
+} hb_slot_t;
+
+typedef struct {
+    uint32_t step;
+    uint32_t live;                 /* Occupied slots                         */
+    size_t   free_bytes;
+    size_t   largest;
+    size_t   blocks;
+} hb_frag_t;
+
+/* ========================== Private Data ================================= */
+static uint32_t          hb_malloc_samples[APP_BENCH_HEAP_SAMPLES];
+static uint32_t          hb_free_samples[APP_BENCH_HEAP_SAMPLES];
+static uint32_t          hb_malloc_count;
+static uint32_t          hb_free_count;
+static uint32_t          hb_skipped;       /* Creations over the budget      */
+static size_t            hb_budget;        /* Bytes the churn may hold       */
+static size_t            hb_live_bytes;
+static uint32_t          hb_overhead;      /* bench_calibrate(), header line */
+static uint32_t          hb_rand_state = HB_SEED;
+
+static hb_slot_t         hb_slots[HB_SLOTS];
+static hb_frag_t         hb_frag[HB_CHECKPOINTS];
+static uint32_t          hb_frag_count;
+static bench_stats_t     hb_malloc_stats;
+static bench_stats_t     hb_free_stats;
+
+/* ========================== Measurement ================================== */
+
+/**
+ * @brief  32-bit LCG: the same sequence on every run and heap.
+ */
+static uint32_t hb_rand(void)
+{
+    hb_rand_state = hb_rand_state * 1664525UL + 1013904223UL;
+    return hb_rand_state >> 8;
+}
+
+/**
+ * @brief  One timed pvPortMalloc.  The budget keeps it from failing (the
+ *         malloc-failed hook halts), so the result is not checked.
+ */
+static void *hb_malloc(size_t size)
+{
+    uint32_t start = dwt_cycles_now();
+    void    *p = pvPortMalloc(size);
+    uint32_t cycles = dwt_cycles_since(start);
+
+    if (hb_malloc_count < APP_BENCH_HEAP_SAMPLES) {
+        hb_malloc_samples[hb_malloc_count++] = bench_net(cycles);
+    }
+    return p;
+}
+
+static void hb_free(void *p)
+{
+    uint32_t start = dwt_cycles_now();
+    uint32_t cycles;
+
+    vPortFree(p);
+    cycles = dwt_cycles_since(start);
+    if (hb_free_count < APP_BENCH_HEAP_SAMPLES) {
+        hb_free_samples[hb_free_count++] = bench_net(cycles);
+    }
+}
+
+/**
+ * @brief  Fill an empty slot with a random object, unless that would take
+ *         the churn's memory over hb_budget.
+ */
+static void hb_create(hb_slot_t *s)
+{
+    uint32_t  r = hb_rand();
+    hb_kind_t kind;
+    size_t    size[2] = { 0U, 0U };
+
+    switch (r % 3U) {
+    case 0:
+        kind    = HB_TASK;
+        size[0] = (128U + (r >> 2) % 384U) * sizeof(StackType_t);
+        size[1] = sizeof(StaticTask_t);
+        break;
+    case 1:
+        kind    = HB_QUEUE;
+        size[0] = sizeof(StaticQueue_t) +
+                  (1U + (r >> 2) % 16U) * (1U + (r >> 6) % 32U);
+        break;
+    default:
+        kind    = HB_TIMER;
+        size[0] = sizeof(StaticTimer_t);
+        break;
+    }
+
+    if (hb_live_bytes + size[0] + size[1] > hb_budget) {
+        hb_skipped++;
+        return;
+    }
+
+    s->kind     = kind;
+    s->bytes    = size[0] + size[1];
+    s->block[0] = hb_malloc(size[0]);
+    s->block[1] = (kind == HB_TASK) ? hb_malloc(size[1]) : NULL;
+    hb_live_bytes += s->bytes;
+}
+
+static void hb_delete(hb_slot_t *s)
+{
+    hb_free(s->block[0]);
+    if (s->kind == HB_TASK) {
+        hb_free(s->block[1]);
+    }
+    hb_live_bytes -= s->bytes;
+    s->kind = HB_EMPTY;
+}
+
+static void hb_checkpoint(uint32_t step)
+{
+    HeapStats_t stats;
+    hb_frag_t  *f = &hb_frag[hb_frag_count++];
+
+    vPortGetHeapStats(&stats);
+    f->step       = step;
+    f->live       = 0U;
+    f->free_bytes = stats.xAvailableHeapSpaceInBytes;
+    f->largest    = stats.xSizeOfLargestFreeBlockInBytes;
+    f->blocks     = stats.xNumberOfFreeBlocks;
+    for (uint32_t i = 0; i < HB_SLOTS; i++) {
+        if (hb_slots[i].kind != HB_EMPTY) {
+            f->live++;
+        }
+    }
+}
+
+/**
+ * @brief  Churn until both sample sets are full, taking the
+ *         fragmentation checkpoints along the way, then empty every slot.
+ */
+static void hb_run(void)
+{
+    uint32_t step = 0U;
+
+    /* Half of what is free leaves the application room, and keeps
+     * fragmentation from ever failing an allocation */
+    hb_budget = xPortGetFreeHeapSize() / 2U;
+
+    while ((hb_malloc_count < APP_BENCH_HEAP_SAMPLES ||
+            hb_free_count < APP_BENCH_HEAP_SAMPLES) && step < HB_MAX_STEPS) {
+        hb_slot_t *s = &hb_slots[hb_rand() % HB_SLOTS];
+
+        if (s->kind == HB_EMPTY) {
+            hb_create(s);
+        } else {
+            hb_delete(s);
+        }
+        step++;
+
+        if (hb_frag_count < HB_CHECKPOINTS &&
+            hb_malloc_count >= (hb_frag_count + 1U) * APP_BENCH_HEAP_SAMPLES /
+                               HB_CHECKPOINTS) {
+            hb_checkpoint(step);
+        }
+    }
+
+    /* Leave the heap as the application had it */
+    for (uint32_t i = 0; i < HB_SLOTS; i++) {
+        if (hb_slots[i].kind != HB_EMPTY) {
+            vPortFree(hb_slots[i].block[0]);
+            if (hb_slots[i].kind == HB_TASK) {
+                vPortFree(hb_slots[i].block[1]);
+            }
+            hb_slots[i].kind = HB_EMPTY;
+        }
+    }
+}
+
+/* ========================== Report ======================================= */
+
+static void hb_print_header(void)
+{
+    printf("# heap_bench %s cpu_hz=%lu heap=%s heap_bytes=%lu slots=%lu "
+           "n=%lu overhead=%lu\n",
+           tskKERNEL_VERSION_NUMBER,
+           (unsigned long)SystemCoreClock,
+           (configUSE_HEAP_TLSF == 1) ? "heap_tlsf" :
+           (configUSE_HEAP_5 == 1)    ? "heap_5" : "heap_4",
+           (unsigned long)configTOTAL_HEAP_SIZE,
+           (unsigned long)HB_SLOTS,
+           (unsigned long)APP_BENCH_HEAP_SAMPLES,
+           (unsigned long)hb_overhead);
+    printf("# %-16s %8s %8s %8s %8s\n", "op", "min", "avg", "p99", "max");
+}
+
+static void hb_print_row(const char *name, const bench_stats_t *r)
+{
+    if (r->count == 0U) {
+        printf("%-18s %8s %8s %8s %8s\n", name, "-", "-", "-", "-");
+        return;
+    }
+    printf("%-18s %8lu %8lu %8lu %8lu\n", name,
+           (unsigned long)r->min, (unsigned long)r->avg,
+           (unsigned long)r->p99, (unsigned long)r->max);
+}
+
+static void hb_print_frag(void)
+{
+    printf("#\n# %8s %6s %9s %9s %8s %6s\n",
+           "step", "live", "free", "largest", "blocks", "frag%");
+    for (uint32_t i = 0; i < hb_frag_count; i++) {
+        const hb_frag_t *f = &hb_frag[i];
+        uint32_t frag = (f->free_bytes == 0U) ? 0U :
+                        (uint32_t)(100U - (uint64_t)f->largest * 100U /
+                                          f->free_bytes);
+
+        printf("# %8lu %6lu %9lu %9lu %8lu %6lu\n",
+               (unsigned long)f->step, (unsigned long)f->live,
+               (unsigned long)f->free_bytes, (unsigned long)f->largest,
+               (unsigned long)f->blocks, (unsigned long)frag);
+    }
+    printf("# budget=%lu skipped=%lu\n", (unsigned long)hb_budget,
+           (unsigned long)hb_skipped);
+}
+
+/* ========================== Task ========================================= */
+
+/**
+ * @brief  Run the churn, print the table, fragmentation rows and charts,
+ *         then exit (host build, APP_BENCH_HEAP_EXIT) or delete itself.
+ * @param  param  (unused)
+ */
+static void hbench_task(void *param)
+{
+    (void)param;
+
+    /* Let the start-up work of the other tasks finish first */
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    hb_overhead = bench_calibrate();
+    hb_run();
+    bench_summarise(&hb_malloc_stats, hb_malloc_samples, hb_malloc_count);
+    bench_summarise(&hb_free_stats, hb_free_samples, hb_free_count);
+
+    hb_print_header();
+    hb_print_row("malloc", &hb_malloc_stats);
+    hb_print_row("free", &hb_free_stats);
+    vTaskDelay(pdMS_TO_TICKS(HB_ROW_GAP_MS));
+    hb_print_frag();
+    vTaskDelay(pdMS_TO_TICKS(HB_ROW_GAP_MS));
+    bench_print_chart("malloc", "calls", &hb_malloc_stats);
+    vTaskDelay(pdMS_TO_TICKS(HB_ROW_GAP_MS));
+    bench_print_chart("free", "calls", &hb_free_stats);
+    printf("# end\n");
+
+#if APP_BENCH_HEAP_EXIT
+    exit(0);
+#endif
+
+    vTaskDelete(NULL);
+}
+
+/* ========================== Public API =================================== */
+
+void heap_bench_init(void)
+{
+    BaseType_t status;
+
+    dwt_cycles_init();
+
+    status = xTaskCreate(hbench_task, "hbench_task", HB_STACK_WORDS,
+                         NULL, HB_PRIO_BENCH, NULL);
+    configASSERT(status == pdPASS);
+}
+
+#else  /* !APP_BENCH_HEAP */
+
+void heap_bench_init(void)
+{
+}
+
+#endif /* APP_BENCH_HEAP */
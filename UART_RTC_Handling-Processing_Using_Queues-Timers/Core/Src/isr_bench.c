@@ -0,0 +1,488 @@
+/**
+ ******************************************************************************
+ * @file           : isr_bench.c
+ * @brief          : Interrupt-to-task latency benchmark (APP_BENCH_ISR).
+ *
+ * @description    : TIM7 interrupts every IB_PERIOD_US.  The ISR reads the
+ *                   cycle counter first thing, then signals a waiting task
+ *                   the way the case under test does; the task reads the
+ *                   counter again as soon as it runs:
+ *
+ *                     case           ISR                         task side
+ *                     notify         vTaskNotifyGiveFromISR      ulTaskNotifyTake
+ *                     semaphore      xSemaphoreGiveFromISR       xSemaphoreTake
+ *                     queue          xQueueSendFromISR           xQueueReceive
+ *                     stream_buffer  xStreamBufferSendFromISR    xStreamBufferReceive
+ *                     event_group    xEventGroupSetBitsFromISR   xEventGroupWaitBits
+ *                     pend_call      xTimerPendFunctionCallFromISR (runs in the
+ *                                    timer service task)
+ *
+ *                   The queue, stream buffer and pended call carry the ISR's
+ *                   timestamp as their payload.  xEventGroupSetBitsFromISR
+ *                   is itself a pended call: the timer service task sets
+ *                   the bits, then the waiter runs, so event_group costs
+ *                   pend_call plus a second switch.
+ *
+ *                   After APP_BENCH_ISR_SAMPLES wakeups per case, ibench_task
+ *                   prints:
+ *
+ *                     # isr_bench V11.1.0 cpu_hz=... tick_hz=... irq=TIM7 ...
+ *                     # case               min      avg      p99      max  skipped
+ *                     notify                ..       ..       ..       ..       ..
+ *                     ...
+ *                     #
+ *                     # notify (wakeups per cycle range)
+ *                     #      64-127      |#########                      120
+ *                     ...
+ *                     # end
+ *
+ *                   Values are CPU cycles from ISR entry to the woken code
+ *                   running, minus the cost of reading the counter: the
+ *                   rest of the ISR, its exit and the switch.  The stacking
+ *                   before the ISR's first instruction is not included.
+ *                   skipped counts interrupts that found the previous
+ *                   wakeup still on its way (or a full queue) and
+ *                   signalled nothing.
+ *
+ *                   Priorities: TIM7 at configLIBRARY_MAX_SYSCALL_INTERRUPT_
+ *                   PRIORITY, above the demo's own interrupts, so only
+ *                   kernel critical sections delay its entry.  The waiter
+ *                   runs at configMAX_PRIORITIES - 2, just below the timer
+ *                   service task, so every other task waits its turn.  The
+ *                   period is not a multiple of the tick, so interrupts
+ *                   land at every phase of it.
+ ******************************************************************************
+ */
+
+#include "isr_bench.h"
+#include "app_config.h"
+
+#if APP_BENCH_ISR
+
+#include "dwt_cycles.h"
+#include "bench_stats.h"
+
+#include <stdio.h>                 /* printf -> ITM / host stdout            */
+#include <stdlib.h>                /* exit (APP_BENCH_ISR_EXIT)              */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "stream_buffer.h"
+#include "event_groups.h"
+#include "timers.h"
+
+#if APP_STATIC_ALLOC
+#error "isr_bench creates its waiter tasks at run time: build it with APP_STATIC_ALLOC = 0"
+#endif
+
+/* ========================== Private Defines ============================== */
+#define IB_PRIO_WAITER      ( configMAX_PRIORITIES - 2U )
+#define IB_PRIO_BENCH       ( configMAX_PRIORITIES - 3U )
+
+#define IB_STACK_WORDS      256U   /* ibench_task: printf + sort             */
+#define IB_WAITER_WORDS     128U   /* Woken task of each case                */
+
+#define IB_PERIOD_US        997U   /* TIM7 period; prime, so not tick-locked */
+#define IB_EVENT_BIT        0x01U
+
+/* Every case should finish in SAMPLES periods; allow for skipped ones */
+#define IB_CASE_TIMEOUT_MS  ( 4U * APP_BENCH_ISR_SAMPLES * IB_PERIOD_US / 1000U + 1000U )
+
+/* ibench_task outranks itm_drain, so after each row it sleeps long
+ * enough for the drain task to empty the console FIFO */
+#define IB_ROW_GAP_MS       20U
+
+#if ( INCLUDE_xTimerPendFunctionCall != 1 )
+#error "isr_bench needs INCLUDE_xTimerPendFunctionCall = 1"
+#endif
+
+/* ========================== Private Types ================================ */
+typedef struct {
+    const char    *name;                        /* Row label, no spaces     */
+    BaseType_t   (*signal)(uint32_t stamp, BaseType_t *woken);    /* ISR    */
+    TaskFunction_t waiter;                      /* NULL: timer service task */
+} ib_case_t;
+
+typedef struct {
+    bench_stats_t stats;           /* count: all samples, unless timed out   */
+    uint32_t      skipped;
+} ib_result_t;
+
+/* ========================== Private Data ================================= */
+static uint32_t                   ib_samples[APP_BENCH_ISR_SAMPLES];
+static volatile uint32_t          ib_count;      /* Samples this case        */
+static volatile uint32_t          ib_stamp;      /* CYCCNT at ISR entry      */
+static volatile uint32_t          ib_pending;    /* A wakeup is on its way   */
+static volatile uint32_t          ib_skipped;
+static const ib_case_t * volatile ib_active;     /* NULL: ISR signals nothing */
+static uint32_t                   ib_overhead;   /* bench_calibrate(), header */
+static TaskHandle_t               ib_self;
+static TaskHandle_t               ib_waiter;
+
+static TIM_HandleTypeDef          ib_tim;
+static SemaphoreHandle_t          ib_sem;
+static QueueHandle_t              ib_queue;
+static StreamBufferHandle_t       ib_stream;
+static EventGroupHandle_t         ib_events;
+
+/* ========================== Sampling ===================================== */
+
+/**
+ * @brief  Store the latency of one wakeup, less the counter-read overhead,
+ *         and let the ISR signal again.  Task context.
+ * @param  stamp  CYCCNT the ISR read on entry.
+ */
+static void ib_record(uint32_t stamp)
+{
+    uint32_t cycles = dwt_cycles_since(stamp);
+
+    if (ib_count < APP_BENCH_ISR_SAMPLES) {
+        ib_samples[ib_count++] = bench_net(cycles);
+        if (ib_count == APP_BENCH_ISR_SAMPLES) {
+            (void)xTaskNotifyGive(ib_self);
+        }
+    }
+    ib_pending = 0U;
+}
+
+/* ========================== Cases ======================================== */
+
+static BaseType_t ib_signal_notify(uint32_t stamp, BaseType_t *woken)
+{
+    (void)stamp;
+    vTaskNotifyGiveFromISR(ib_waiter, woken);
+    return pdPASS;
+}
+
+static void ib_wait_notify(void *param)
+{
+    (void)param;
+
+    for (;;) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        ib_record(ib_stamp);
+    }
+}
+
+static BaseType_t ib_signal_semaphore(uint32_t stamp, BaseType_t *woken)
+{
+    (void)stamp;
+    return xSemaphoreGiveFromISR(ib_sem, woken);
+}
+
+static void ib_wait_semaphore(void *param)
+{
+    (void)param;
+
+    for (;;) {
+        if (xSemaphoreTake(ib_sem, portMAX_DELAY) == pdPASS) {
+            ib_record(ib_stamp);
+        }
+    }
+}
+
+static BaseType_t ib_signal_queue(uint32_t stamp, BaseType_t *woken)
+{
+    return xQueueSendFromISR(ib_queue, &stamp, woken);
+}
+
+static void ib_wait_queue(void *param)
+{
+    uint32_t stamp;
+
+    (void)param;
+
+    for (;;) {
+        if (xQueueReceive(ib_queue, &stamp, portMAX_DELAY) == pdPASS) {
+            ib_record(stamp);
+        }
+    }
+}
+
+static BaseType_t ib_signal_stream(uint32_t stamp, BaseType_t *woken)
+{
+    size_t sent = xStreamBufferSendFromISR(ib_stream, &stamp, sizeof(stamp),
+                                           woken);
+
+    return (sent == sizeof(stamp)) ? pdPASS : pdFAIL;
+}
+
+static void ib_wait_stream(void *param)
+{
+    uint32_t stamp;
+
+    (void)param;
+
+    for (;;) {
+        if (xStreamBufferReceive(ib_stream, &stamp, sizeof(stamp),
+                                 portMAX_DELAY) == sizeof(stamp)) {
+            ib_record(stamp);
+        }
+    }
+}
+
+static BaseType_t ib_signal_events(uint32_t stamp, BaseType_t *woken)
+{
+    (void)stamp;
+    return xEventGroupSetBitsFromISR(ib_events, IB_EVENT_BIT, woken);
+}
+
+static void ib_wait_events(void *param)
+{
+    (void)param;
+
+    for (;;) {
+        EventBits_t bits = xEventGroupWaitBits(ib_events, IB_EVENT_BIT, pdTRUE,
+                                               pdFALSE, portMAX_DELAY);
+
+        if ((bits & IB_EVENT_BIT) != 0U) {
+            ib_record(ib_stamp);
+        }
+    }
+}
+
+/**
+ * @brief  The pended function: runs in the timer service task.
+ */
+static void ib_pended(void *param, uint32_t stamp)
+{
+    (void)param;
+    ib_record(stamp);
+}
+
+static BaseType_t ib_signal_pend(uint32_t stamp, BaseType_t *woken)
+{
+    return xTimerPendFunctionCallFromISR(ib_pended, NULL, stamp, woken);
+}
+
+static const ib_case_t ib_cases[] = {
+    { "notify",        ib_signal_notify,    ib_wait_notify    },
+    { "semaphore",     ib_signal_semaphore, ib_wait_semaphore },
+    { "queue",         ib_signal_queue,     ib_wait_queue     },
+    { "stream_buffer", ib_signal_stream,    ib_wait_stream    },
+    { "event_group",   ib_signal_events,    ib_wait_events    },
+    { "pend_call",     ib_signal_pend,      NULL              },
+};
+
+#define IB_NCASES   ( sizeof(ib_cases) / sizeof(ib_cases[0]) )
+
+static ib_result_t ib_results[IB_NCASES];
+
+/* ========================== Interrupt ==================================== */
+
+void isr_bench_timer_irq(void)
+{
+    uint32_t         now    = dwt_cycles_now();
+    const ib_case_t *active = ib_active;
+    BaseType_t       woken  = pdFALSE;
+
+    TIM7->SR = ~(uint32_t)TIM_SR_UIF;  /* rc_w0: clears only the update flag */
+
+    if (active == NULL) {
+        return;
+    }
+    if (ib_pending != 0U) {
+        ib_skipped++;
+        return;
+    }
+
+    ib_stamp   = now;
+    ib_pending = 1U;
+    if (active->signal(now, &woken) != pdPASS) {
+        ib_pending = 0U;
+        ib_skipped++;
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief  TIM7 at 1 MHz, update every IB_PERIOD_US, interrupt enabled.
+ */
+static void ib_timer_start(void)
+{
+    uint32_t tim_hz = HAL_RCC_GetPCLK1Freq();
+
+    /* APB1 timers run at twice PCLK1 whenever APB1 is divided */
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        tim_hz *= 2U;
+    }
+
+    __HAL_RCC_TIM7_CLK_ENABLE();
+
+    ib_tim.Instance               = TIM7;
+    ib_tim.Init.Prescaler         = tim_hz / 1000000U - 1U;
+    ib_tim.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    ib_tim.Init.Period            = IB_PERIOD_US - 1U;
+    ib_tim.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&ib_tim) != HAL_OK) {
+        Error_Handler();
+    }
+
+    HAL_NVIC_SetPriority(TIM7_IRQn,
+                         configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(TIM7_IRQn);
+
+    if (HAL_TIM_Base_Start_IT(&ib_tim) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+static void ib_timer_stop(void)
+{
+    (void)HAL_TIM_Base_Stop_IT(&ib_tim);
+    HAL_NVIC_DisableIRQ(TIM7_IRQn);
+    __HAL_RCC_TIM7_CLK_DISABLE();
+}
+
+/* ========================== Measurement ================================== */
+
+/**
+ * @brief  Let the timer drive one case until it has every sample or
+ *         IB_CASE_TIMEOUT_MS passes.
+ */
+static void ib_run_case(const ib_case_t *c)
+{
+    ib_waiter  = NULL;
+    ib_count   = 0U;
+    ib_skipped = 0U;
+    ib_pending = 0U;
+
+    /* The waiter outranks this task: it is blocked before the ISR starts
+     * signalling it */
+    if (c->waiter != NULL) {
+        BaseType_t status = xTaskCreate(c->waiter, "ib_waiter",
+                                        IB_WAITER_WORDS, NULL,
+                                        IB_PRIO_WAITER, &ib_waiter);
+        configASSERT(status == pdPASS);
+    }
+
+    ib_active = c;
+    (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IB_CASE_TIMEOUT_MS));
+    ib_active = NULL;
+
+    /* A wakeup signalled just before may still be on its way */
+    vTaskDelay(pdMS_TO_TICKS(2));
+    if (ib_waiter != NULL) {
+        vTaskDelete(ib_waiter);
+    }
+}
+
+/* ========================== Report ======================================= */
+
+/**
+ * @brief  Summarise the samples of the case just run.
+ */
+static void ib_summarise(ib_result_t *r)
+{
+    bench_summarise(&r->stats, ib_samples, ib_count);
+    r->skipped = ib_skipped;
+}
+
+static void ib_print_header(void)
+{
+    printf("# isr_bench %s cpu_hz=%lu tick_hz=%lu irq=TIM7 period_us=%lu "
+           "n=%lu overhead=%lu\n",
+           tskKERNEL_VERSION_NUMBER,
+           (unsigned long)SystemCoreClock,
+           (unsigned long)configTICK_RATE_HZ,
+           (unsigned long)IB_PERIOD_US,
+           (unsigned long)APP_BENCH_ISR_SAMPLES,
+           (unsigned long)ib_overhead);
+    printf("# %-16s %8s %8s %8s %8s %8s\n",
+           "case", "min", "avg", "p99", "max", "skipped");
+}
+
+static void ib_print_row(const char *name, const ib_result_t *r)
+{
+    const bench_stats_t *s = &r->stats;
+
+    if (s->count == 0U) {
+        printf("%-18s %8s %8s %8s %8s %8lu\n", name, "-", "-", "-", "-",
+               (unsigned long)r->skipped);
+        return;
+    }
+    printf("%-18s %8lu %8lu %8lu %8lu %8lu\n", name,
+           (unsigned long)s->min, (unsigned long)s->avg,
+           (unsigned long)s->p99, (unsigned long)s->max,
+           (unsigned long)r->skipped);
+    if (s->count < APP_BENCH_ISR_SAMPLES) {
+        printf("# %s: timed out after %lu samples\n", name,
+               (unsigned long)s->count);
+    }
+}
+
+/* ========================== Task ========================================= */
+
+/**
+ * @brief  Run every case with TIM7 firing, print the table and charts,
+ *         then exit (host build, APP_BENCH_ISR_EXIT) or delete itself.
+ * @param  param  (unused)
+ */
+static void ibench_task(void *param)
+{
+    (void)param;
+
+    ib_self   = xTaskGetCurrentTaskHandle();
+    ib_sem    = xSemaphoreCreateBinary();
+    ib_queue  = xQueueCreate(1, sizeof(uint32_t));
+    ib_stream = xStreamBufferCreate(2U * sizeof(uint32_t), sizeof(uint32_t));
+    ib_events = xEventGroupCreate();
+    configASSERT(ib_sem != NULL && ib_queue != NULL &&
+                 ib_stream != NULL && ib_events != NULL);
+
+    /* Let the start-up work of the other tasks finish first */
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    ib_overhead = bench_calibrate();
+    ib_timer_start();
+
+    /* Measure everything first: printing would land inside the samples */
+    for (uint32_t i = 0; i < IB_NCASES; i++) {
+        ib_run_case(&ib_cases[i]);
+        ib_summarise(&ib_results[i]);
+    }
+    ib_timer_stop();
+
+    ib_print_header();
+    for (uint32_t i = 0; i < IB_NCASES; i++) {
+        ib_print_row(ib_cases[i].name, &ib_results[i]);
+        vTaskDelay(pdMS_TO_TICKS(IB_ROW_GAP_MS));
+    }
+    for (uint32_t i = 0; i < IB_NCASES; i++) {
+        bench_print_chart(ib_cases[i].name, "wakeups", &ib_results[i].stats);
+        vTaskDelay(pdMS_TO_TICKS(IB_ROW_GAP_MS));
+    }
+    printf("# end\n");
+
+#if APP_BENCH_ISR_EXIT
+    exit(0);
+#endif
+
+    vSemaphoreDelete(ib_sem);
+    vQueueDelete(ib_queue);
+    vStreamBufferDelete(ib_stream);
+    vEventGroupDelete(ib_events);
+    vTaskDelete(NULL);
+}
+
+/* ========================== Public API =================================== */
+
+void isr_bench_init(void)
+{
+    BaseType_t status;
+
+    dwt_cycles_init();
+
+    status = xTaskCreate(ibench_task, "ibench_task", IB_STACK_WORDS,
+                         NULL, IB_PRIO_BENCH, NULL);
+    configASSERT(status == pdPASS);
+}
+
+#else  /* !APP_BENCH_ISR */
+
+void isr_bench_init(void)
+{
+}
+
+#endif /* APP_BENCH_ISR */
@@ -0,0 +1,245 @@
+/**
+ ******************************************************************************
+ * @file           : itm_log.c
+ * @brief          : Non-blocking ITM/SWO output: one software FIFO per
+ *                   stimulus port, emptied by a low-priority drain task.
+ *
+ * @description    : Data flow:
+ *
+ *                   rtc_report (timer cb) --copy--> fifo[RTC]     --+
+ *                   printf (_write)       --copy--> fifo[CONSOLE] --+
+ *                                                                   v
+ *                                 itm_task: ITM->PORT[n] while the port is
+ *                                 ready, 32 bits per write where it can
+ *
+ *                   head / tail are free-running byte counters; (head -
+ *                   tail) is the fill level.  Writers reserve and copy
+ *                   under BASEPRI, so a message lands whole or not at all.
+ *                   The drain task is the only writer of tail.
+ *
+ *                   The drain task sleeps on its notification while every
+ *                   FIFO is empty; a write that makes a FIFO non-empty
+ *                   wakes it.  When a stimulus port stays busy (SWO
+ *                   slower than the producers) it backs off one tick
+ *                   instead of spinning, so even at the lowest priority it
+ *                   leaves the CPU to idle.
+ ******************************************************************************
+ */
+
+#include "itm_log.h"
+#include "app_config.h"
+
+#include <string.h>                /* memcpy                                 */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "static_alloc.h"
+#include "stack_sizes.h"
+
+#if APP_ITM_LOG
+
+#define ITM_LOG_FIFO_MASK   (APP_ITM_LOG_FIFO_SIZE - 1U)
+
+#if (APP_ITM_LOG_FIFO_SIZE & ITM_LOG_FIFO_MASK) != 0U
+#error "APP_ITM_LOG_FIFO_SIZE must be a power of two"
+#endif
+
+/* ========================== Private Types ================================ */
+typedef struct {
+    uint8_t                  buf[APP_ITM_LOG_FIFO_SIZE];
+    volatile uint32_t        head;             /* Writers, under BASEPRI     */
+    volatile uint32_t        tail;             /* itm_task only              */
+    itm_log_stats_t          stats;
+} itm_fifo_t;
+
+/* ========================== Private Data ================================= */
+static itm_fifo_t    itm_fifo[ITM_LOG_PORT_COUNT];
+static TaskHandle_t  itm_task_handle;
+STATIC_TASK(itm_task, STACK_WORDS_ITM_TASK);
+
+/* ========================== Private Helpers ============================== */
+
+/**
+ * @brief  True when the debugger has enabled ITM and this stimulus port.
+ */
+static inline int itm_port_enabled(uint32_t port)
+{
+    return ((ITM->TCR & ITM_TCR_ITMENA_Msk) != 0U) &&
+           ((ITM->TER & (1UL << port)) != 0U);
+}
+
+/**
+ * @brief  Wake the drain task from task or ISR context.
+ */
+static void itm_wake(void)
+{
+    if (itm_task_handle == NULL) {
+        return;                    /* Not created yet: it starts non-idle    */
+    }
+
+    if (xPortIsInsideInterrupt()) {
+        BaseType_t woken = pdFALSE;
+
+        vTaskNotifyGiveFromISR(itm_task_handle, &woken);
+        portYIELD_FROM_ISR(woken);
+    } else {
+        xTaskNotifyGive(itm_task_handle);
+    }
+}
+
+/**
+ * @brief  Move bytes from one FIFO to its stimulus port while the port
+ *         accepts them.
+ * @param  port  Port number, also the FIFO index.
+ * @return 1 if bytes are left because the port was busy, else 0.
+ */
+static uint32_t itm_drain_port(uint32_t port)
+{
+    itm_fifo_t *f    = &itm_fifo[port];
+    uint32_t    tail = f->tail;
+    uint32_t    head;
+
+    /* A writer that saw the FIFO non-empty before tail is stored sends no
+     * notify, so look at head again after storing it: the bytes of such a
+     * write must not wait for the next empty-to-non-empty write */
+    do {
+        while ((head = f->head) != tail) {
+            uint32_t avail = head - tail;
+
+            if (!itm_port_enabled(port)) {
+                tail = head;       /* Nobody listening: discard              */
+                break;
+            }
+            if (ITM->PORT[port].u32 == 0U) {
+                f->tail = tail;
+                return 1;          /* Stimulus FIFO full, try again later    */
+            }
+
+            /* One 32-bit write carries four characters in one SWO packet */
+            if (avail >= 4U) {
+                uint32_t word = (uint32_t)f->buf[tail & ITM_LOG_FIFO_MASK]
+                    | ((uint32_t)f->buf[(tail + 1U) & ITM_LOG_FIFO_MASK] << 8)
+                    | ((uint32_t)f->buf[(tail + 2U) & ITM_LOG_FIFO_MASK] << 16)
+                    | ((uint32_t)f->buf[(tail + 3U) & ITM_LOG_FIFO_MASK] << 24);
+
+                ITM->PORT[port].u32 = word;
+                tail           += 4U;
+                f->stats.sent  += 4U;
+            } else {
+                ITM->PORT[port].u8 = f->buf[tail & ITM_LOG_FIFO_MASK];
+                tail++;
+                f->stats.sent++;
+            }
+        }
+
+        f->tail = tail;
+    } while (f->head != tail);
+
+    return 0;
+}
+
+/**
+ * @brief  Drain task: empty every FIFO, then sleep until a write arrives.
+ * @param  param  (unused)
+ */
+static void task_itm(void *param)
+{
+    (void)param;
+
+    for (;;) {
+        uint32_t busy = 0;
+
+        for (uint32_t port = 0; port < ITM_LOG_PORT_COUNT; port++) {
+            busy |= itm_drain_port(port);
+        }
+
+        if (busy != 0U) {
+            vTaskDelay(1);         /* SWO behind: back off, do not spin      */
+        } else {
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+}
+
+/* ========================== Public API =================================== */
+
+void itm_log_init(void)
+{
+    BaseType_t status;
+
+    /* Lowest application priority: trace output never delays real work */
+    status = STATIC_TASK_CREATE(itm_task, task_itm, "itm_task", NULL, 1,
+                                &itm_task_handle);
+    configASSERT(status == pdPASS);
+}
+
+uint32_t itm_log_write(itm_log_port_t port, const void *data, uint32_t len)
+{
+    itm_fifo_t *f = &itm_fifo[port];
+    uint32_t    head;
+    uint32_t    fill;
+    uint32_t    first;
+    uint32_t    was_empty;
+    UBaseType_t mask;
+
+    configASSERT((uint32_t)port < ITM_LOG_PORT_COUNT);
+
+    if (!itm_port_enabled((uint32_t)port)) {
+        return len;
+    }
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+
+    head = f->head;
+    fill = head - f->tail;
+    if (len > APP_ITM_LOG_FIFO_SIZE - fill) {
+        f->stats.dropped += len;
+        f->stats.dropped_msgs++;
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+        return 0;
+    }
+
+    /* Copy in up to two pieces when the message wraps */
+    first = APP_ITM_LOG_FIFO_SIZE - (head & ITM_LOG_FIFO_MASK);
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&f->buf[head & ITM_LOG_FIFO_MASK], data, first);
+    memcpy(&f->buf[0], (const uint8_t *)data + first, len - first);
+
+    was_empty = (fill == 0U);
+    f->head   = head + len;
+    if (fill + len > f->stats.peak) {
+        f->stats.peak = fill + len;
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+
+    if (was_empty) {
+        itm_wake();
+    }
+    return len;
+}
+
+void itm_log_get_stats(itm_log_port_t port, itm_log_stats_t *out)
+{
+    UBaseType_t mask;
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    *out = itm_fifo[port].stats;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/**
+ * @brief  newlib output hook: printf and friends go to the console port
+ *         through the FIFO instead of spinning in syscalls.c.  Overrides
+ *         the weak _write there.
+ */
+int _write(int file, char *ptr, int len)
+{
+    (void)file;
+
+    (void)itm_log_write(ITM_LOG_PORT_CONSOLE, ptr, (uint32_t)len);
+    return len;                    /* Dropped text is counted, not retried   */
+}
+
+#endif /* APP_ITM_LOG */
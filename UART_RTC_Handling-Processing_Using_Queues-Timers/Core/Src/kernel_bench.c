@@ -0,0 +1,762 @@
+/**
+ ******************************************************************************
+ * @file           : kernel_bench.c
+ * @brief          : FreeRTOS kernel microbenchmarks (APP_BENCH_KERNEL).
+ *
+ * @description    : kbench_task runs each case APP_BENCH_KERNEL_SAMPLES
+ *                   times.  It keeps every sample and prints one row per
+ *                   case:
+ *
+ *                     # kernel_bench V11.1.0 cpu_hz=168000000 tick_hz=1000 ...
+ *                     # case              min      med      max
+ *                     ctx_yield            ..       ..       ..
+ *                     ...
+ *                     # end
+ *
+ *                   Values are CPU cycles, minus the cost of reading the
+ *                   counter.  The median is the column to compare:
+ *                   interrupts (the tick, peripherals) land inside some
+ *                   samples and only move the maximum.
+ *
+ *                   Cases that need a second task create it for that case
+ *                   and delete it afterwards.  Priorities are relative to
+ *                   configMAX_PRIORITIES:
+ *
+ *                     KB_PRIO_HIGH  max - 1   woken waiter (preempts)
+ *                     KB_PRIO_BENCH max - 2   kbench_task, yield peer
+ *                     KB_PRIO_LOW   idle + 1  mutex holder (inherits)
+ *
+ *                   So every "wake" case includes the switch into the
+ *                   woken task.  The timer cases include the timer service
+ *                   task's handling of the command whenever
+ *                   configTIMER_TASK_PRIORITY is above KB_PRIO_BENCH.
+ ******************************************************************************
+ */
+
+#include "kernel_bench.h"
+#include "app_config.h"
+
+#if APP_BENCH_KERNEL
+
+#include "dwt_cycles.h"
+#include "bench_stats.h"
+
+#include <stdio.h>                 /* printf -> ITM / host stdout            */
+#include <stdlib.h>                /* exit (APP_BENCH_KERNEL_EXIT)           */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+
+#if APP_STATIC_ALLOC
+#error "kernel_bench creates its helper tasks at run time: build it with APP_STATIC_ALLOC = 0"
+#endif
+
+/* ========================== Private Defines ============================== */
+#define KB_PRIO_HIGH        ( configMAX_PRIORITIES - 1U )
+#define KB_PRIO_BENCH       ( configMAX_PRIORITIES - 2U )
+#define KB_PRIO_LOW         ( tskIDLE_PRIORITY + 1U )
+
+#define KB_STACK_WORDS      256U   /* kbench_task: printf + sort             */
+#define KB_HELPER_WORDS     128U   /* Peer / waiter / holder tasks           */
+#define KB_FILLERS_MAX      16U    /* Extra ready tasks, switch_tasks rows    */
+
+/* kbench_task outranks itm_drain, so after each row it sleeps long
+ * enough for the drain task to empty the console FIFO */
+#define KB_ROW_GAP_MS       20U
+#define KB_BATCH_MAX        64U    /* Depth of kb_queue_batch, largest run   */
+
+/* ========================== Private Types ================================ */
+
+/**
+ * @brief  The struct payload for the queue cases: a typical small message.
+ */
+typedef struct {
+    uint32_t id;
+    uint32_t arg[7];
+} kb_msg_t;
+
+typedef struct {
+    const char *name;              /* Row label, no spaces                   */
+    void      (*run)(void);        /* Fills kb_samples                       */
+} kb_case_t;
+
+/* ========================== Private Data ================================= */
+static uint32_t          kb_samples[APP_BENCH_KERNEL_SAMPLES];
+static volatile uint32_t kb_count;         /* Samples recorded this case     */
+static uint32_t          kb_overhead;      /* bench_calibrate(), header line */
+static bench_stats_t     kb_stats;         /* Summary of the row printed     */
+static volatile uint32_t kb_stamp;         /* Cross-task start time          */
+static TaskHandle_t      kb_self;
+
+static QueueHandle_t     kb_queue_u8;
+static QueueHandle_t     kb_queue_msg;
+static QueueHandle_t     kb_queue_u32;
+#if APP_QUEUE_FAST_COPY
+static QueueHandle_t     kb_qfast_u8;      /* xQueueEnableFastCopy() queues  */
+static QueueHandle_t     kb_qfast_u32;
+#endif
+#if APP_QUEUE_BATCH
+static QueueHandle_t     kb_queue_batch;   /* KB_BATCH_MAX x uint8_t         */
+#endif
+static SemaphoreHandle_t kb_sem;
+static SemaphoreHandle_t kb_mutex;
+static TimerHandle_t     kb_timer;
+static volatile uint32_t kb_switch_start;  /* traceTASK_SWITCHED_OUT stamp   */
+static volatile int      kb_switch_armed;  /* Record switches into kb_self   */
+
+/* ========================== Sampling ===================================== */
+
+/**
+ * @brief  Store one sample, less the counter-read overhead.
+ *         Samples beyond APP_BENCH_KERNEL_SAMPLES are ignored, so a helper
+ *         task may keep recording while the case winds down.
+ */
+static void kb_record(uint32_t cycles)
+{
+    if (kb_count < APP_BENCH_KERNEL_SAMPLES) {
+        kb_samples[kb_count++] = bench_net(cycles);
+    }
+}
+
+/**
+ * @brief  Store one sample for a run of items timed together: the run's
+ *         cycles, less the counter-read overhead, per item (rounded).
+ */
+static void kb_record_per_item(uint32_t cycles, uint32_t items)
+{
+    if (kb_count < APP_BENCH_KERNEL_SAMPLES) {
+        kb_samples[kb_count++] = (bench_net(cycles) + items / 2U) / items;
+    }
+}
+
+static int kb_done(void)
+{
+    return kb_count >= APP_BENCH_KERNEL_SAMPLES;
+}
+
+/* ========================== Cases: Context Switch ======================== */
+
+static void kb_yield_peer(void *param)
+{
+    (void)param;
+
+    for (;;) {
+        kb_record(dwt_cycles_since(kb_stamp));
+        kb_stamp = dwt_cycles_now();
+        taskYIELD();
+    }
+}
+
+/**
+ * @brief  taskYIELD() between two ready tasks of equal priority: each
+ *         resume records the time since the other task yielded.
+ */
+static void kb_run_ctx_yield(void)
+{
+    BaseType_t   status;
+    TaskHandle_t peer;
+
+    status = xTaskCreate(kb_yield_peer, "kb_peer", KB_HELPER_WORDS, NULL,
+                         KB_PRIO_BENCH, &peer);
+    configASSERT(status == pdPASS);
+
+    kb_stamp = dwt_cycles_now();
+    taskYIELD();
+    while (!kb_done()) {
+        kb_record(dwt_cycles_since(kb_stamp));
+        kb_stamp = dwt_cycles_now();
+        taskYIELD();
+    }
+    vTaskDelete(peer);
+}
+
+/* ========================== Cases: Task Notifications ==================== */
+
+static void kb_notify_waiter(void *param)
+{
+    (void)param;
+
+    for (;;) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        kb_record(dwt_cycles_since(kb_stamp));
+    }
+}
+
+/**
+ * @brief  xTaskNotifyGive() to a blocked higher-priority task, up to the
+ *         moment that task returns from ulTaskNotifyTake().
+ */
+static void kb_run_notify_wake(void)
+{
+    BaseType_t   status;
+    TaskHandle_t waiter;
+
+    status = xTaskCreate(kb_notify_waiter, "kb_waiter", KB_HELPER_WORDS,
+                         NULL, KB_PRIO_HIGH, &waiter);
+    configASSERT(status == pdPASS);
+
+    while (!kb_done()) {
+        kb_stamp = dwt_cycles_now();
+        (void)xTaskNotifyGive(waiter);
+    }
+    vTaskDelete(waiter);
+}
+
+/**
+ * @brief  xTaskNotifyGive() with nobody waiting (no switch).
+ */
+static void kb_run_notify_give(void)
+{
+    while (!kb_done()) {
+        uint32_t start = dwt_cycles_now();
+
+        (void)xTaskNotifyGive(kb_self);
+        kb_record(dwt_cycles_since(start));
+        (void)ulTaskNotifyTake(pdTRUE, 0);
+    }
+}
+
+/**
+ * @brief  ulTaskNotifyTake() with a notification already pending.
+ */
+static void kb_run_notify_take(void)
+{
+    while (!kb_done()) {
+        uint32_t start;
+
+        (void)xTaskNotifyGive(kb_self);
+        start = dwt_cycles_now();
+        (void)ulTaskNotifyTake(pdTRUE, 0);
+        kb_record(dwt_cycles_since(start));
+    }
+}
+
+/* ========================== Cases: Queues ================================ */
+
+/**
+ * @brief  Time one xQueueSend() or one xQueueReceive() on a depth-1 queue,
+ *         with the other half done untimed (no task is waiting).
+ * @param  queue  One of the kb_queue_* / kb_qfast_* queues.
+ * @param  send   1 to time the send, 0 to time the receive.
+ */
+static void kb_queue_pair(QueueHandle_t queue, int send)
+{
+    kb_msg_t msg = { 0 };
+
+    while (!kb_done()) {
+        uint32_t start;
+
+        if (send) {
+            start = dwt_cycles_now();
+            (void)xQueueSend(queue, &msg, 0);
+            kb_record(dwt_cycles_since(start));
+            (void)xQueueReceive(queue, &msg, 0);
+        } else {
+            (void)xQueueSend(queue, &msg, 0);
+            start = dwt_cycles_now();
+            (void)xQueueReceive(queue, &msg, 0);
+            kb_record(dwt_cycles_since(start));
+        }
+        msg.id++;
+    }
+}
+
+static void kb_run_queue_send_u8(void)  { kb_queue_pair(kb_queue_u8, 1);  }
+static void kb_run_queue_recv_u8(void)  { kb_queue_pair(kb_queue_u8, 0);  }
+static void kb_run_queue_send_msg(void) { kb_queue_pair(kb_queue_msg, 1); }
+static void kb_run_queue_recv_msg(void) { kb_queue_pair(kb_queue_msg, 0); }
+static void kb_run_queue_send_u32(void) { kb_queue_pair(kb_queue_u32, 1); }
+static void kb_run_queue_recv_u32(void) { kb_queue_pair(kb_queue_u32, 0); }
+
+#if APP_QUEUE_FAST_COPY
+/* The same pairs on queues with typed item copies: compare each row with
+ * its queue_* counterpart above */
+static void kb_run_qfast_send_u8(void)  { kb_queue_pair(kb_qfast_u8, 1);  }
+static void kb_run_qfast_recv_u8(void)  { kb_queue_pair(kb_qfast_u8, 0);  }
+static void kb_run_qfast_send_u32(void) { kb_queue_pair(kb_qfast_u32, 1); }
+static void kb_run_qfast_recv_u32(void) { kb_queue_pair(kb_qfast_u32, 0); }
+#endif
+
+#if APP_QUEUE_BATCH
+/**
+ * @brief  Per-item cost of moving a run of n bytes through kb_queue_batch,
+ *         one xQueueSend() / xQueueReceive() per byte or one
+ *         xQueueSendMultiple() / xQueueReceiveMultiple() for the run.  The
+ *         other half is done untimed.  Each sample is the run's cycles / n.
+ * @param  multi  1 for the batch call, 0 for the per-item loop.
+ * @param  send   1 to time the send side, 0 to time the receive side.
+ * @param  n      Run length, 1..KB_BATCH_MAX.
+ */
+static void kb_queue_batch_run(int multi, int send, uint32_t n)
+{
+    uint8_t run[KB_BATCH_MAX] = { 0 };
+
+    while (!kb_done()) {
+        uint32_t start;
+
+        if (!send) {
+            (void)xQueueSendMultiple(kb_queue_batch, run, n, 0);
+        }
+
+        start = dwt_cycles_now();
+        if (multi && send) {
+            (void)xQueueSendMultiple(kb_queue_batch, run, n, 0);
+        } else if (multi) {
+            (void)xQueueReceiveMultiple(kb_queue_batch, run, n, 0);
+        } else {
+            for (uint32_t i = 0; i < n; i++) {
+                if (send) {
+                    (void)xQueueSend(kb_queue_batch, &run[i], 0);
+                } else {
+                    (void)xQueueReceive(kb_queue_batch, &run[i], 0);
+                }
+            }
+        }
+        kb_record_per_item(dwt_cycles_since(start), n);
+
+        if (send) {
+            (void)xQueueReceiveMultiple(kb_queue_batch, run, n, 0);
+        }
+        run[0]++;
+    }
+}
+
+static void kb_run_qloop_send_1(void)   { kb_queue_batch_run(0, 1, 1);  }
+static void kb_run_qloop_send_8(void)   { kb_queue_batch_run(0, 1, 8);  }
+static void kb_run_qloop_send_64(void)  { kb_queue_batch_run(0, 1, 64); }
+static void kb_run_qloop_recv_1(void)   { kb_queue_batch_run(0, 0, 1);  }
+static void kb_run_qloop_recv_8(void)   { kb_queue_batch_run(0, 0, 8);  }
+static void kb_run_qloop_recv_64(void)  { kb_queue_batch_run(0, 0, 64); }
+static void kb_run_qmulti_send_1(void)  { kb_queue_batch_run(1, 1, 1);  }
+static void kb_run_qmulti_send_8(void)  { kb_queue_batch_run(1, 1, 8);  }
+static void kb_run_qmulti_send_64(void) { kb_queue_batch_run(1, 1, 64); }
+static void kb_run_qmulti_recv_1(void)  { kb_queue_batch_run(1, 0, 1);  }
+static void kb_run_qmulti_recv_8(void)  { kb_queue_batch_run(1, 0, 8);  }
+static void kb_run_qmulti_recv_64(void) { kb_queue_batch_run(1, 0, 64); }
+#endif
+
+static void kb_queue_receiver(void *param)
+{
+    kb_msg_t msg;
+
+    (void)param;
+
+    for (;;) {
+        (void)xQueueReceive(kb_queue_msg, &msg, portMAX_DELAY);
+        kb_record(dwt_cycles_since(kb_stamp));
+    }
+}
+
+/**
+ * @brief  xQueueSend() of a kb_msg_t to a blocked higher-priority
+ *         receiver, up to the moment it returns from xQueueReceive().
+ */
+static void kb_run_queue_wake_msg(void)
+{
+    BaseType_t   status;
+    TaskHandle_t receiver;
+    kb_msg_t     msg = { 0 };
+
+    status = xTaskCreate(kb_queue_receiver, "kb_recv", KB_HELPER_WORDS,
+                         NULL, KB_PRIO_HIGH, &receiver);
+    configASSERT(status == pdPASS);
+
+    while (!kb_done()) {
+        kb_stamp = dwt_cycles_now();
+        (void)xQueueSend(kb_queue_msg, &msg, 0);
+        msg.id++;
+    }
+    vTaskDelete(receiver);
+}
+
+/* ========================== Cases: Semaphore and Mutex =================== */
+
+/**
+ * @brief  Time one give or one take of a semaphore/mutex nobody waits on.
+ * @param  sem   kb_sem or kb_mutex.
+ * @param  give  1 to time the give, 0 to time the take.
+ */
+static void kb_sem_pair(SemaphoreHandle_t sem, int give)
+{
+    while (!kb_done()) {
+        uint32_t start;
+
+        if (give) {
+            (void)xSemaphoreTake(sem, 0);
+            start = dwt_cycles_now();
+            (void)xSemaphoreGive(sem);
+            kb_record(dwt_cycles_since(start));
+        } else {
+            start = dwt_cycles_now();
+            (void)xSemaphoreTake(sem, 0);
+            kb_record(dwt_cycles_since(start));
+            (void)xSemaphoreGive(sem);
+        }
+    }
+}
+
+static void kb_run_sem_give(void)   { kb_sem_pair(kb_sem, 1);   }
+static void kb_run_sem_take(void)   { kb_sem_pair(kb_sem, 0);   }
+static void kb_run_mutex_give(void) { kb_sem_pair(kb_mutex, 1); }
+static void kb_run_mutex_take(void) { kb_sem_pair(kb_mutex, 0); }
+
+/**
+ * @brief  Low-priority owner of kb_mutex for kb_run_mutex_pi.  It is
+ *         preempted while holding the mutex and only gets to give it back
+ *         by inheriting kbench_task's priority.
+ */
+static void kb_pi_holder(void *param)
+{
+    (void)param;
+
+    for (;;) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        (void)xSemaphoreTake(kb_mutex, portMAX_DELAY);
+        (void)xTaskNotifyGive(kb_self);        /* kbench_task preempts here */
+
+        /* Running again means kbench_task is blocked on the mutex */
+        configASSERT(uxTaskPriorityGet(NULL) == KB_PRIO_BENCH);
+        (void)xSemaphoreGive(kb_mutex);
+    }
+}
+
+/**
+ * @brief  xSemaphoreTake() on a mutex held by a lower-priority task:
+ *         inherit, switch to the holder, its give (disinherit), switch back.
+ */
+static void kb_run_mutex_pi(void)
+{
+    BaseType_t   status;
+    TaskHandle_t holder;
+
+    status = xTaskCreate(kb_pi_holder, "kb_holder", KB_HELPER_WORDS, NULL,
+                         KB_PRIO_LOW, &holder);
+    configASSERT(status == pdPASS);
+
+    while (!kb_done()) {
+        uint32_t start;
+
+        (void)xTaskNotifyGive(holder);
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);  /* Holder owns it */
+
+        start = dwt_cycles_now();
+        (void)xSemaphoreTake(kb_mutex, portMAX_DELAY);
+        kb_record(dwt_cycles_since(start));
+        (void)xSemaphoreGive(kb_mutex);
+    }
+    vTaskDelete(holder);
+}
+
+/* ========================== Cases: Software Timers ======================= */
+
+static void kb_timer_callback(TimerHandle_t timer)
+{
+    (void)timer;
+}
+
+/**
+ * @brief  Time one xTimerStart() or one xTimerStop() of a dormant timer.
+ *         Blocks if the command queue is full, which only happens when the
+ *         timer task runs below kbench_task.
+ * @param  start_timed  1 to time the start, 0 to time the stop.
+ */
+static void kb_timer_pair(int start_timed)
+{
+    while (!kb_done()) {
+        uint32_t start;
+
+        if (start_timed) {
+            start = dwt_cycles_now();
+            (void)xTimerStart(kb_timer, portMAX_DELAY);
+            kb_record(dwt_cycles_since(start));
+            (void)xTimerStop(kb_timer, portMAX_DELAY);
+        } else {
+            (void)xTimerStart(kb_timer, portMAX_DELAY);
+            start = dwt_cycles_now();
+            (void)xTimerStop(kb_timer, portMAX_DELAY);
+            kb_record(dwt_cycles_since(start));
+        }
+    }
+}
+
+static void kb_run_timer_start(void) { kb_timer_pair(1); }
+static void kb_run_timer_stop(void)  { kb_timer_pair(0); }
+
+/* ========================== Cases: vTaskSwitchContext ==================== */
+
+/*
+ * traceTASK_SWITCHED_OUT / _IN (FreeRTOSConfig.h) bracket the stack check
+ * and taskSELECT_HIGHEST_PRIORITY_TASK().  Only switches back into
+ * kbench_task are recorded, so each sample is one selection that has to
+ * find kbench_task's priority after a higher-priority task blocked.
+ *
+ * The generic selection scans the ready lists down from the blocked
+ * task's priority, so its cost grows with the gap between the two.
+ * The CLZ selection reads the ready bitmap once, so it does not.
+ */
+
+void kernel_bench_switch_out(void)
+{
+    kb_switch_start = dwt_cycles_now();
+}
+
+void kernel_bench_switch_in(void)
+{
+    if (kb_switch_armed && xTaskGetCurrentTaskHandle() == kb_self) {
+        kb_record(dwt_cycles_since(kb_switch_start));
+    }
+}
+
+static void kb_switch_waiter(void *param)
+{
+    (void)param;
+
+    for (;;) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+static void kb_spin(void *param)
+{
+    (void)param;
+
+    for (;;) {
+    }
+}
+
+/**
+ * @brief  Wake a waiter `gap` priorities above kbench_task and time the
+ *         switch back when it blocks again.
+ * @param  gap      Priority distance; a case whose waiter would not fit
+ *                  under configMAX_PRIORITIES records nothing ("-" row).
+ * @param  fillers  Extra ready tasks at idle priority, present throughout.
+ */
+static void kb_switch_case(UBaseType_t gap, uint32_t fillers)
+{
+    BaseType_t   status;
+    TaskHandle_t waiter;
+    TaskHandle_t filler[KB_FILLERS_MAX];
+
+    if (KB_PRIO_LOW + gap > KB_PRIO_HIGH || fillers > KB_FILLERS_MAX) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < fillers; i++) {
+        status = xTaskCreate(kb_spin, "kb_fill", configMINIMAL_STACK_SIZE,
+                             NULL, tskIDLE_PRIORITY, &filler[i]);
+        configASSERT(status == pdPASS);
+    }
+
+    vTaskPrioritySet(NULL, KB_PRIO_LOW);
+    status = xTaskCreate(kb_switch_waiter, "kb_waiter", KB_HELPER_WORDS,
+                         NULL, KB_PRIO_LOW + gap, &waiter);
+    configASSERT(status == pdPASS);
+
+    kb_switch_armed = 1;
+    while (!kb_done()) {
+        (void)xTaskNotifyGive(waiter);
+    }
+    kb_switch_armed = 0;
+
+    vTaskDelete(waiter);
+    for (uint32_t i = 0; i < fillers; i++) {
+        vTaskDelete(filler[i]);
+    }
+    vTaskPrioritySet(NULL, KB_PRIO_BENCH);
+}
+
+static void kb_run_switch_gap1(void)    { kb_switch_case(1, 0);  }
+static void kb_run_switch_gap2(void)    { kb_switch_case(2, 0);  }
+static void kb_run_switch_gap4(void)    { kb_switch_case(4, 0);  }
+static void kb_run_switch_gap8(void)    { kb_switch_case(8, 0);  }
+static void kb_run_switch_gap16(void)   { kb_switch_case(16, 0); }
+static void kb_run_switch_gap30(void)   { kb_switch_case(30, 0); }
+
+/* Task count at the widest gap this configuration allows */
+static void kb_run_switch_tasks8(void)
+{
+    kb_switch_case(KB_PRIO_HIGH - KB_PRIO_LOW, 8);
+}
+
+static void kb_run_switch_tasks16(void)
+{
+    kb_switch_case(KB_PRIO_HIGH - KB_PRIO_LOW, 16);
+}
+
+/* ========================== Case Table =================================== */
+
+/* Order and names are the table's rows: append, never reorder, so diffs
+ * against older output stay line-for-line */
+static const kb_case_t kb_cases[] = {
+    { "ctx_yield",      kb_run_ctx_yield      },
+    { "notify_wake",    kb_run_notify_wake    },
+    { "notify_give",    kb_run_notify_give    },
+    { "notify_take",    kb_run_notify_take    },
+    { "queue_send_u8",  kb_run_queue_send_u8  },
+    { "queue_recv_u8",  kb_run_queue_recv_u8  },
+    { "queue_send_msg", kb_run_queue_send_msg },
+    { "queue_recv_msg", kb_run_queue_recv_msg },
+    { "queue_wake_msg", kb_run_queue_wake_msg },
+    { "sem_give",       kb_run_sem_give       },
+    { "sem_take",       kb_run_sem_take       },
+    { "mutex_give",     kb_run_mutex_give     },
+    { "mutex_take",     kb_run_mutex_take     },
+    { "mutex_pi",       kb_run_mutex_pi       },
+    { "timer_start",    kb_run_timer_start    },
+    { "timer_stop",     kb_run_timer_stop     },
+    { "switch_gap1",    kb_run_switch_gap1    },
+    { "switch_gap2",    kb_run_switch_gap2    },
+    { "switch_gap4",    kb_run_switch_gap4    },
+    { "switch_gap8",    kb_run_switch_gap8    },
+    { "switch_gap16",   kb_run_switch_gap16   },
+    { "switch_gap30",   kb_run_switch_gap30   },
+    { "switch_tasks8",  kb_run_switch_tasks8  },
+    { "switch_tasks16", kb_run_switch_tasks16 },
+    { "queue_send_u32", kb_run_queue_send_u32 },
+    { "queue_recv_u32", kb_run_queue_recv_u32 },
+#if APP_QUEUE_FAST_COPY
+    { "qfast_send_u8",  kb_run_qfast_send_u8  },
+    { "qfast_recv_u8",  kb_run_qfast_recv_u8  },
+    { "qfast_send_u32", kb_run_qfast_send_u32 },
+    { "qfast_recv_u32", kb_run_qfast_recv_u32 },
+#endif
+#if APP_QUEUE_BATCH
+    { "qloop_send_1",   kb_run_qloop_send_1   },
+    { "qloop_send_8",   kb_run_qloop_send_8   },
+    { "qloop_send_64",  kb_run_qloop_send_64  },
+    { "qloop_recv_1",   kb_run_qloop_recv_1   },
+    { "qloop_recv_8",   kb_run_qloop_recv_8   },
+    { "qloop_recv_64",  kb_run_qloop_recv_64  },
+    { "qmulti_send_1",  kb_run_qmulti_send_1  },
+    { "qmulti_send_8",  kb_run_qmulti_send_8  },
+    { "qmulti_send_64", kb_run_qmulti_send_64 },
+    { "qmulti_recv_1",  kb_run_qmulti_recv_1  },
+    { "qmulti_recv_8",  kb_run_qmulti_recv_8  },
+    { "qmulti_recv_64", kb_run_qmulti_recv_64 },
+#endif
+};
+
+/* ========================== Reporting ==================================== */
+
+static void kb_print_header(void)
+{
+    printf("# kernel_bench %s cpu_hz=%lu tick_hz=%lu max_prio=%lu "
+           "opt_sel=%d preempt=%d slicing=%d n=%lu overhead=%lu\n",
+           tskKERNEL_VERSION_NUMBER,
+           (unsigned long)SystemCoreClock,
+           (unsigned long)configTICK_RATE_HZ,
+           (unsigned long)configMAX_PRIORITIES,
+           configUSE_PORT_OPTIMISED_TASK_SELECTION,
+           configUSE_PREEMPTION,
+           configUSE_TIME_SLICING,
+           (unsigned long)APP_BENCH_KERNEL_SAMPLES,
+           (unsigned long)kb_overhead);
+    printf("# %-16s %8s %8s %8s\n", "case", "min", "med", "max");
+}
+
+static void kb_print_row(const char *name)
+{
+    bench_summarise(&kb_stats, kb_samples, kb_count);
+    if (kb_stats.count == 0U) {
+        /* Case does not apply to this configuration */
+        printf("%-18s %8s %8s %8s\n", name, "-", "-", "-");
+        return;
+    }
+    printf("%-18s %8lu %8lu %8lu\n", name, (unsigned long)kb_stats.min,
+           (unsigned long)kb_stats.med, (unsigned long)kb_stats.max);
+}
+
+/* ========================== Task ========================================= */
+
+/**
+ * @brief  Run every case once, print the table, then exit (host build,
+ *         APP_BENCH_KERNEL_EXIT) or delete itself.
+ * @param  param  (unused)
+ */
+static void kbench_task(void *param)
+{
+#if APP_QUEUE_FAST_COPY
+    BaseType_t fast_u8;
+    BaseType_t fast_u32;
+#endif
+
+    (void)param;
+
+    kb_self      = xTaskGetCurrentTaskHandle();
+    kb_queue_u8  = xQueueCreate(1, sizeof(uint8_t));
+    kb_queue_msg = xQueueCreate(1, sizeof(kb_msg_t));
+    kb_queue_u32 = xQueueCreate(1, sizeof(uint32_t));
+#if APP_QUEUE_FAST_COPY
+    kb_qfast_u8  = xQueueCreate(1, sizeof(uint8_t));
+    kb_qfast_u32 = xQueueCreate(1, sizeof(uint32_t));
+    configASSERT(kb_qfast_u8 != NULL && kb_qfast_u32 != NULL);
+    fast_u8  = xQueueEnableFastCopy(kb_qfast_u8);
+    fast_u32 = xQueueEnableFastCopy(kb_qfast_u32);
+    configASSERT(fast_u8 == pdPASS && fast_u32 == pdPASS);
+#endif
+#if APP_QUEUE_BATCH
+    kb_queue_batch = xQueueCreate(KB_BATCH_MAX, sizeof(uint8_t));
+    configASSERT(kb_queue_batch != NULL);
+#endif
+    kb_sem       = xSemaphoreCreateBinary();
+    kb_mutex     = xSemaphoreCreateMutex();
+    kb_timer     = xTimerCreate("kb_timer", pdMS_TO_TICKS(1000), pdFALSE,
+                                NULL, kb_timer_callback);
+    configASSERT(kb_queue_u8 != NULL && kb_queue_msg != NULL &&
+                 kb_queue_u32 != NULL &&
+                 kb_sem != NULL && kb_mutex != NULL && kb_timer != NULL);
+
+    /* Let the start-up work of the other tasks finish first */
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    kb_overhead = bench_calibrate();
+    kb_print_header();
+
+    for (uint32_t i = 0; i < sizeof(kb_cases) / sizeof(kb_cases[0]); i++) {
+        kb_count = 0;
+        kb_cases[i].run();
+        kb_print_row(kb_cases[i].name);
+        vTaskDelay(pdMS_TO_TICKS(KB_ROW_GAP_MS));
+    }
+    printf("# end\n");
+
+#if APP_BENCH_KERNEL_EXIT
+    exit(0);
+#endif
+
+    vQueueDelete(kb_queue_u8);
+    vQueueDelete(kb_queue_msg);
+    vQueueDelete(kb_queue_u32);
+#if APP_QUEUE_FAST_COPY
+    vQueueDelete(kb_qfast_u8);
+    vQueueDelete(kb_qfast_u32);
+#endif
+#if APP_QUEUE_BATCH
+    vQueueDelete(kb_queue_batch);
+#endif
+    vSemaphoreDelete(kb_sem);
+    vSemaphoreDelete(kb_mutex);
+    (void)xTimerDelete(kb_timer, portMAX_DELAY);
+    vTaskDelete(NULL);
+}
+
+void kernel_bench_init(void)
+{
+    BaseType_t status;
+
+    dwt_cycles_init();
+
+    status = xTaskCreate(kbench_task, "kbench_task", KB_STACK_WORDS,
+                         NULL, KB_PRIO_BENCH, NULL);
+    configASSERT(status == pdPASS);
+}
+
+#else  /* !APP_BENCH_KERNEL */
+
+void kernel_bench_init(void)
+{
+}
+
+#endif /* APP_BENCH_KERNEL */
@@ -0,0 +1,251 @@
+/**
+ ******************************************************************************
+ * @file           : led_pwm.c
+ * @brief          : TIM4 PWM LED effects engine fed by DMA (PD12-PD15).
+ *
+ * @description    : Playback data flow:
+ *
+ *                     frames[N] --DMA1 S0 Ch2 (circular)--> TIM4->DMAR
+ *                                                              |
+ *                              burst of 7 half-words           v
+ *                              PSC, ARR, (RCR), CCR1..CCR4 preload registers
+ *
+ *                   Every update event raises the TIM4_CH1 DMA request
+ *                   (CR2.CCDS = 1), so each PWM period loads the next frame
+ *                   into the preload registers and the following update
+ *                   makes it live.  One frame = one PWM period.
+ *
+ *                   ARR is fixed (255 steps of brightness); PSC sets how
+ *                   long the frame lasts.  A hold is one frame of up to
+ *                   ~200 ms (split if longer); a fade is a run of
+ *                   APP_LED_PWM_STEP_MS frames, which also keeps the PWM
+ *                   frequency of partial levels well above flicker.
+ *
+ *                   TIM4_UP would be the natural request but shares DMA1
+ *                   Stream6 with USART2_TX; TIM4_CH1 on Stream0 with CCDS
+ *                   gives the same timing on a free stream.
+ ******************************************************************************
+ */
+
+#include "led_pwm.h"
+#include "app_config.h"
+#include "FreeRTOS.h"              /* configASSERT                           */
+#include "task.h"
+
+/* ========================== Private Defines ============================== */
+
+/* ARR: 255 counts per period.  CCR = 255 is above ARR, i.e. always on */
+#define LED_PWM_TOP         254U
+
+/* One frame as written by the DMA burst starting at PSC */
+typedef struct {
+    uint16_t psc;                  /* Frame length: (psc + 1) * 255 ticks    */
+    uint16_t arr;                  /* Always LED_PWM_TOP                     */
+    uint16_t rcr;                  /* No repetition counter on TIM4; unused  */
+    uint16_t ccr[LED_PWM_CHANNELS];/* Compare values for CH1-CH4             */
+} led_pwm_frame_t;
+
+#define FRAME_HALFWORDS     (sizeof(led_pwm_frame_t) / sizeof(uint16_t))
+
+/* ========================== Private Data ================================= */
+static TIM_HandleTypeDef *led_htim;
+static uint32_t           psc_per_ms;  /* (PSC + 1) for a 1 ms frame         */
+static uint32_t           frame_count;
+static led_pwm_frame_t    frames[APP_LED_PWM_FRAMES];
+
+/* ========================== Private Helpers ============================== */
+
+/**
+ * @brief  Perceptual level (0..255) to compare value: gamma 2, so a
+ *         linear ramp of levels looks like a linear ramp of brightness.
+ */
+static uint16_t level_to_ccr(uint32_t level)
+{
+    return (uint16_t)((level * level + (LED_PWM_LEVEL_MAX - 1U))
+                      / LED_PWM_LEVEL_MAX);
+}
+
+/**
+ * @brief  Append one frame.
+ * @param  level     Four channel levels.
+ * @param  psc_plus  Frame length in prescaler counts (1..65536).
+ * @return 0 on success, 1 if the frame table is full.
+ */
+static int frame_put(const uint8_t *level, uint32_t psc_plus)
+{
+    led_pwm_frame_t *f;
+
+    if (frame_count >= APP_LED_PWM_FRAMES) {
+        return 1;
+    }
+
+    f      = &frames[frame_count++];
+    f->psc = (uint16_t)(psc_plus - 1U);
+    f->arr = LED_PWM_TOP;
+    f->rcr = 0;
+    for (uint32_t ch = 0; ch < LED_PWM_CHANNELS; ch++) {
+        f->ccr[ch] = level_to_ccr(level[ch]);
+    }
+    return 0;
+}
+
+/**
+ * @brief  Hold level[] for ms, in as few frames as PSC allows.
+ */
+static int frame_hold(const uint8_t *level, uint32_t ms)
+{
+    uint32_t total = ms * psc_per_ms;
+    uint32_t parts = (total + 0xFFFFU) / 0x10000U;
+
+    for (uint32_t i = 0; i < parts; i++) {
+        if (frame_put(level, total / parts) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  Ramp from[] to to[] over ms in APP_LED_PWM_STEP_MS frames.
+ *         The last frame lands exactly on to[].
+ */
+static int frame_fade(const uint8_t *from, const uint8_t *to, uint32_t ms)
+{
+    uint32_t steps = ms / APP_LED_PWM_STEP_MS;
+    uint8_t  level[LED_PWM_CHANNELS];
+
+    if (steps == 0U) {
+        steps = 1;
+    }
+
+    for (uint32_t i = 1; i <= steps; i++) {
+        for (uint32_t ch = 0; ch < LED_PWM_CHANNELS; ch++) {
+            int32_t delta = (int32_t)to[ch] - (int32_t)from[ch];
+
+            level[ch] = (uint8_t)(from[ch] + delta * (int32_t)i / (int32_t)steps);
+        }
+        if (frame_put(level, APP_LED_PWM_STEP_MS * psc_per_ms) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  Stop the DMA feed.  The timer keeps running with whatever
+ *         frame was live last.
+ */
+static void pwm_halt(void)
+{
+    DMA_HandleTypeDef *hdma = led_htim->hdma[TIM_DMA_ID_CC1];
+
+    __HAL_TIM_DISABLE_DMA(led_htim, TIM_DMA_CC1);
+    if (hdma->State == HAL_DMA_STATE_BUSY) {
+        (void)HAL_DMA_Abort(hdma);
+    }
+}
+
+/**
+ * @brief  Load a short all-off lead-in frame and start the circular DMA
+ *         over frames[0 .. frame_count).
+ */
+static void pwm_run(void)
+{
+    TIM_TypeDef *tim = led_htim->Instance;
+
+    __HAL_TIM_DISABLE(led_htim);
+
+    /* Lead-in: 255 ticks, LEDs off.  Its update pulls in frame 0 */
+    tim->PSC  = 0;
+    tim->ARR  = LED_PWM_TOP;
+    tim->CCR1 = 0;
+    tim->CCR2 = 0;
+    tim->CCR3 = 0;
+    tim->CCR4 = 0;
+    tim->EGR  = TIM_EGR_UG;
+
+    /* Rewriting DCR also restarts the burst at PSC */
+    tim->DCR  = TIM_DMABASE_PSC | TIM_DMABURSTLENGTH_7TRANSFERS;
+
+    /* No interrupts: the stream just loops over the table */
+    (void)HAL_DMA_Start(led_htim->hdma[TIM_DMA_ID_CC1], (uint32_t)frames,
+                        (uint32_t)&tim->DMAR, frame_count * FRAME_HALFWORDS);
+    __HAL_TIM_ENABLE_DMA(led_htim, TIM_DMA_CC1);
+    __HAL_TIM_ENABLE(led_htim);
+}
+
+/* ========================== Public API =================================== */
+
+void led_pwm_init(TIM_HandleTypeDef *htim)
+{
+    uint32_t tim_clk = HAL_RCC_GetPCLK1Freq();
+
+    /* APB1 timers run at twice PCLK1 whenever APB1 is divided */
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        tim_clk *= 2U;
+    }
+
+    led_htim   = htim;
+    psc_per_ms = tim_clk / 1000U / (LED_PWM_TOP + 1U);
+
+    configASSERT(APP_LED_PWM_STEP_MS * psc_per_ms <= 0x10000U);
+    configASSERT(APP_LED_PWM_FRAMES * FRAME_HALFWORDS <= 0xFFFFU);
+
+    /* CC1 DMA request on every update event rather than on the CC1 match,
+     * so frames keep coming whatever CCR1 holds (0 or above ARR included) */
+    SET_BIT(htim->Instance->CR2, TIM_CR2_CCDS);
+
+    HAL_TIM_PWM_Start(htim, TIM_CHANNEL_1);
+    HAL_TIM_PWM_Start(htim, TIM_CHANNEL_2);
+    HAL_TIM_PWM_Start(htim, TIM_CHANNEL_3);
+    HAL_TIM_PWM_Start(htim, TIM_CHANNEL_4);
+
+    led_pwm_stop();
+}
+
+uint32_t led_pwm_play(const led_pwm_key_t *keys, uint32_t count)
+{
+    const uint8_t *prev;
+    int            err = 0;
+
+    if (count == 0U) {
+        led_pwm_stop();
+        return 0;
+    }
+
+    pwm_halt();
+
+    /* The first keyframe fades from the last one, so the loop is seamless */
+    frame_count = 0;
+    prev        = keys[count - 1U].level;
+
+    for (uint32_t i = 0; i < count && err == 0; i++) {
+        if (keys[i].fade != 0U) {
+            err = frame_fade(prev, keys[i].level, keys[i].ms);
+        } else {
+            err = frame_hold(keys[i].level, keys[i].ms);
+        }
+        prev = keys[i].level;
+    }
+
+    if (err != 0 || frame_count == 0U) {
+        led_pwm_stop();
+        return 0;
+    }
+
+    pwm_run();
+    return frame_count;
+}
+
+void led_pwm_stop(void)
+{
+    TIM_TypeDef *tim = led_htim->Instance;
+
+    pwm_halt();
+
+    tim->CCR1 = 0;
+    tim->CCR2 = 0;
+    tim->CCR3 = 0;
+    tim->CCR4 = 0;
+    tim->EGR  = TIM_EGR_UG;        /* Apply now, not at the next update      */
+}
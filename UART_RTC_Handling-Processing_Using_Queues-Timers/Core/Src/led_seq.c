@@ -0,0 +1,129 @@
+/**
+ ******************************************************************************
+ * @file           : led_seq.c
+ * @brief          : Software LED pattern sequencer on one FreeRTOS timer
+ *                   (PD12-PD15 as GPIO outputs, APP_LED_PWM = 0).
+ *
+ * @description    : Everything runs in the timer daemon task:
+ *
+ *                     led_seq_play/stop --xTimerPendFunctionCall--> seq_load
+ *                                                                      |
+ *                     seq_timer expires --> seq_callback <-------------+
+ *                       GPIOD->BSRR = step.bsrr       re-arm with step.ms
+ *
+ *                   Loading a script and stepping through it are therefore
+ *                   serialised by the daemon itself: no critical section,
+ *                   and no stale expiry can run half of the old script
+ *                   against the new one.
+ *
+ *                   The timer is one-shot and re-armed from its own callback
+ *                   with xTimerChangePeriod(), which is how each step gets
+ *                   its own duration.  The daemon runs at the highest
+ *                   priority, so its command queue is empty whenever one of
+ *                   its own callbacks runs and the zero-wait re-arm cannot
+ *                   fail on a full queue.
+ ******************************************************************************
+ */
+
+#include "led_seq.h"
+#include "FreeRTOS.h"
+#include "timers.h"
+#include "static_alloc.h"
+
+/* ========================== Private Data ================================= */
+static TimerHandle_t          seq_timer;
+static const led_seq_step_t  *seq_steps;    /* NULL = stopped               */
+static uint32_t               seq_count;
+static uint32_t               seq_index;    /* Step currently shown         */
+STATIC_TIMER(led_seq);
+
+/* ========================== Private Helpers ============================== */
+
+/**
+ * @brief  Show one step and arm the timer for its duration.
+ *         Timer daemon context only.
+ */
+static void seq_show(const led_seq_step_t *step)
+{
+    TickType_t ticks = pdMS_TO_TICKS(step->ms);
+    BaseType_t status;
+
+    GPIOD->BSRR = step->bsrr;      /* All four pins in one atomic store      */
+
+    if (ticks == 0U) {
+        ticks = 1;                 /* A zero period is not allowed           */
+    }
+    status = xTimerChangePeriod(seq_timer, ticks, 0);
+    configASSERT(status == pdPASS);
+    (void)status;
+}
+
+/**
+ * @brief  Timer callback: advance to the next step, wrapping at the end.
+ * @param  xTimer  (unused) seq_timer.
+ */
+static void seq_callback(TimerHandle_t xTimer)
+{
+    (void)xTimer;
+
+    if (seq_steps == NULL) {
+        return;                    /* Stopped since this expiry was armed    */
+    }
+
+    seq_index++;
+    if (seq_index >= seq_count) {
+        seq_index = 0;
+    }
+    seq_show(&seq_steps[seq_index]);
+}
+
+/**
+ * @brief  Pended function: install a new script, or stop with NULL.
+ *         Stopping only drops the script; a pending expiry finds it gone
+ *         and does not re-arm, so no second command is needed.
+ * @param  steps  Script to play, or NULL to stop.
+ * @param  count  Number of steps.
+ */
+static void seq_load(void *steps, uint32_t count)
+{
+    seq_steps = (const led_seq_step_t *)steps;
+    seq_count = count;
+    seq_index = 0;
+
+    if (seq_steps == NULL) {
+        GPIOD->BSRR = LED_SEQ_BSRR(0x00U);
+        return;
+    }
+    seq_show(&seq_steps[0]);
+}
+
+/* ========================== Public API =================================== */
+
+void led_seq_init(void)
+{
+    seq_timer = STATIC_TIMER_CREATE(led_seq,
+                             "led_seq",           /* Debug name             */
+                             1,                   /* Set per step           */
+                             pdFALSE,             /* One-shot, re-armed     */
+                             NULL,                /* Timer ID: not needed   */
+                             seq_callback);
+    configASSERT(seq_timer != NULL);
+
+    GPIOD->BSRR = LED_SEQ_BSRR(0x00U);
+}
+
+uint32_t led_seq_play(const led_seq_step_t *steps, uint32_t count)
+{
+    if (steps == NULL || count == 0U) {
+        led_seq_stop();
+        return 0;
+    }
+
+    xTimerPendFunctionCall(seq_load, (void *)steps, count, portMAX_DELAY);
+    return count;
+}
+
+void led_seq_stop(void)
+{
+    xTimerPendFunctionCall(seq_load, NULL, 0, portMAX_DELAY);
+}
@@ -5,22 +5,25 @@
  * @brief          : FreeRTOS Menu-Driven Application for STM32F4 Discovery
  *
  * @description    : Interactive UART menu system with three features:
- *                   1. LED effects  — four toggle patterns on PD12-PD15
+ *                   1. LED effects  — blink, breathe and chase on PD12-PD15
  *                   2. RTC config   — set time, date, enable periodic report
  *                   3. Exit         — placeholder for shutdown logic
  *
  *                   Architecture:
- *                   +-----------+  notify   +------------+  notify   +---------+
- *                   | UART ISR  +---------->+  cmd_task   +---------->+ menu /  |
- *                   | (byte)    |  q_rx     | (parse)     |  (ptr)    | led/rtc |
- *                   +-----------+           +------------+           +---------+
- *                                                                        |
- *                                                                   q_print
- *                                                                        v
- *                                                                  +---------+
- *                                                                  |  print  |
- *                                                                  | (UART)  |
- *                                                                  +---------+
+ *                   +-----------+  stream   +----------------------------+
+ *                   | UART DMA  +---------->+          menu_ao           |
+ *                   | (burst)   |  rx       |  line assembly + menu HSM  |
+ *                   +-----+-----+           +--------------+-------------+
+ *                         | SIG_RX_READY    ^              |
+ *                         +-----------------+         q_print
+ *                                                          v
+ *                                                     +---------+
+ *                                                     |  print  |
+ *                                                     | (ring)  |
+ *                                                     +----+----+
+ *                                                          | DMA
+ *                                                          v
+ *                                                      USART2 TX
  *
  * @attention
  *
@@ -40,60 +43,79 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-#include <string.h>                /* memset, strcmp, strlen                   */
-#include <stdio.h>                 /* printf, sprintf                         */
+#include <string.h>                /* memset, memcpy                          */
 #include "FreeRTOS.h"              /* Core FreeRTOS definitions               */
 #include "task.h"                  /* xTaskCreate, xTaskNotify, etc.          */
 #include "queue.h"                 /* xQueueCreate, xQueueSend, etc.         */
 #include "timers.h"                /* xTimerCreate, xTimerStart, etc.        */
+#include "uart_dma.h"              /* DMA + IDLE-line UART receive path       */
+#include "app_bench.h"             /* DWT benchmark hooks (APP_BENCH_*)       */
+#include "kernel_bench.h"          /* Kernel microbenchmark suite             */
+#include "timer_bench.h"           /* Software timer scaling benchmark        */
+#include "isr_bench.h"             /* Interrupt-to-task latency benchmark     */
+#include "heap_bench.h"            /* Kernel heap latency / fragmentation     */
+#include "ccm_bench.h"             /* Main SRAM vs CCM RAM under DMA load     */
+#include "cpu_stats.h"             /* Run-time stats for the Task Monitor     */
+#include "dwt_cycles.h"            /* Cycle counter for benchmark timing      */
+#include "msg_pool.h"              /* Fixed-block messages for queue_print    */
+#include "cmd_dispatch.h"          /* Command table + perfect-hash lookup     */
+#include "ao.h"                    /* Active object: event queue + HSM        */
+#include "led_pwm.h"               /* TIM4 PWM + DMA LED effects engine       */
+#include "led_seq.h"               /* One-timer software LED sequencer        */
+#include "rtc_cache.h"             /* 1 Hz cached RTC snapshot + formatters   */
+#include "fmt_lite.h"              /* Reentrant snprintf subset (no newlib)   */
+#include "itm_log.h"               /* Non-blocking ITM FIFOs + drain task     */
+#include "static_alloc.h"          /* Static or heap kernel object storage    */
+#include "stack_sizes.h"           /* Task stack sizes (Tools/stack_size.py)  */
+#include "stack_prof.h"            /* Peak stack use reports (profile mode)   */
+#include "ccm_ram.h"               /* Heap regions in CCM RAM (APP_CCM_RAM)   */
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
 
-/**
- * @brief  Command packet received from the UART.
- *         The ISR fills queue_uart_rx one byte at a time; task_cmd_handler
- *         reassembles those bytes into this structure.
- */
-typedef struct {
-    uint8_t  payload[10];          /* ASCII characters (null-terminated)      */
-    uint32_t length;               /* Number of valid chars (excl. '\0')      */
-} uart_command_t;
-
 /**
  * @brief  Application state machine states.
- *         Only ONE state is active at any time; it decides which task
- *         receives the next parsed command from task_cmd_handler.
+ *         Each value names one leaf state of menu_ao (MENU_STATES) and
+ *         selects the rows of the command table that apply while it is
+ *         active.  Each RTC entry step is its own state, so the table alone
+ *         describes the whole dialogue.
  */
 typedef enum {
     STATE_MAIN_MENU = 0,           /* Top-level menu is displayed             */
     STATE_LED_EFFECT,              /* Waiting for LED effect selection        */
     STATE_RTC_MENU,                /* RTC sub-menu is displayed               */
-    STATE_RTC_TIME_CONFIG,         /* Collecting hh:mm:ss from user           */
-    STATE_RTC_DATE_CONFIG,         /* Collecting dd/mm/dow/yy from user       */
+    STATE_RTC_TIME_HOUR,           /* Time entry : hours (1-12)               */
+    STATE_RTC_TIME_MINUTE,         /* Time entry : minutes                    */
+    STATE_RTC_TIME_SECOND,         /* Time entry : seconds                    */
+    STATE_RTC_TIME_AMPM,           /* Time entry : AM(0) or PM(1)             */
+    STATE_RTC_DATE_DAY,            /* Date entry : day of month               */
+    STATE_RTC_DATE_MONTH,          /* Date entry : month                      */
+    STATE_RTC_DATE_WEEKDAY,        /* Date entry : weekday (1=Sun)            */
+    STATE_RTC_DATE_YEAR,           /* Date entry : year (0-99)                */
     STATE_RTC_REPORT,              /* Waiting for y/n to toggle reporting     */
+    STATE_COUNT                    /* Number of states (table size)           */
 } app_state_t;
 
+/**
+ * @brief  One leaf state of menu_ao (see MENU_STATES).
+ */
+typedef struct {
+    ao_state_t    base;            /* Parent + handler (must be first)        */
+    app_state_t   id;              /* Selects rows of the command table       */
+    const char   *prompt;          /* Printed on entry (NULL = none)          */
+    void        (*on_enter)(void); /* Extra entry action (NULL = none)        */
+} menu_state_t;
+
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
 
-/* ---------- Sub-state indices for multi-step RTC time entry --------------- */
-#define RTC_TIME_STEP_HOUR      0  /* First prompt  : enter hours             */
-#define RTC_TIME_STEP_MINUTE    1  /* Second prompt : enter minutes            */
-#define RTC_TIME_STEP_SECOND    2  /* Third prompt  : enter seconds            */
-#define RTC_TIME_STEP_AMPM      3  /* Fourth prompt : enter AM(0) or PM(1)    */
-
-/* ---------- Sub-state indices for multi-step RTC date entry --------------- */
-#define RTC_DATE_STEP_DAY       0  /* First prompt  : enter day of month      */
-#define RTC_DATE_STEP_MONTH     1  /* Second prompt : enter month              */
-#define RTC_DATE_STEP_WEEKDAY   2  /* Third prompt  : enter weekday (1=Sun)    */
-#define RTC_DATE_STEP_YEAR      3  /* Fourth prompt : enter year (0-99)        */
-
-/* ---------- Number of LEDs on the Discovery board (PD12-PD15) ------------ */
-#define LED_COUNT               4
+/* ---------- menu_ao signals ---------------------------------------------- */
+#define SIG_RX_READY            (AO_SIG_USER + 0U) /* New bytes (from the ISR) */
+#define SIG_CMD                 (AO_SIG_USER + 1U) /* One line in data[]      */
+#define SIG_RX_RESUME           (AO_SIG_USER + 2U) /* Parse on after a SIG_CMD */
 
 /* USER CODE END PD */
 
@@ -105,48 +127,125 @@ typedef enum {
 /* Private variables ---------------------------------------------------------*/
 RTC_HandleTypeDef  hrtc;           /* RTC peripheral handle (CubeMX)         */
 UART_HandleTypeDef huart2;         /* USART2 peripheral handle (CubeMX)      */
+DMA_HandleTypeDef  hdma_usart2_rx; /* USART2_RX on DMA1 Stream5 (CubeMX)     */
+DMA_HandleTypeDef  hdma_usart2_tx; /* USART2_TX on DMA1 Stream6 (CubeMX)     */
+#if APP_LED_PWM
+TIM_HandleTypeDef  htim4;          /* PWM on PD12-PD15 (TIM4 CH1-CH4)        */
+DMA_HandleTypeDef  hdma_tim4_ch1;  /* TIM4_CH1 on DMA1 Stream0: frame feed   */
+#endif
 
 /* USER CODE BEGIN PV */
 
 /* ========================== Task Handles ================================= */
-static TaskHandle_t  task_handle_cmd;       /* Command parser task           */
-static TaskHandle_t  task_handle_menu;      /* Main menu task                */
 static TaskHandle_t  task_handle_print;     /* UART transmit task            */
-static TaskHandle_t  task_handle_led;       /* LED effect task               */
-static TaskHandle_t  task_handle_rtc;       /* RTC configuration task        */
+
+/* ========================== Active Objects =============================== */
+static ao_t          menu_ao;               /* Whole menu FSM, one task      */
 
 /* ========================== Queue Handles ================================ */
+#if !APP_UART_RX_DMA
 static QueueHandle_t queue_uart_rx;         /* Raw bytes from UART ISR       */
-static QueueHandle_t queue_print;           /* String pointers -> print_task */
+#endif
+static QueueHandle_t queue_print;           /* msg_t handles -> print_task   */
 
 /* ========================== Timer Handles ================================ */
-static TimerHandle_t timer_led[LED_COUNT];  /* One software timer per effect */
 static TimerHandle_t timer_rtc_report;      /* Periodic RTC report timer     */
 
+/* ========================== Kernel Object Storage ======================== */
+/* Static with APP_STATIC_ALLOC = 1, taken from the heap at creation otherwise */
+STATIC_TASK(print_task, STACK_WORDS_PRINT_TASK); /* UART transmit task     */
+AO_STORAGE(menu_ao, 8, STACK_WORDS_MENU_AO); /* 8-event queue + task       */
+#if !APP_UART_RX_DMA
+STATIC_QUEUE(queue_uart_rx, 10, sizeof(char));
+#endif
+STATIC_QUEUE(queue_print, 10, sizeof(msg_t *));
+STATIC_TIMER(timer_rtc_report);
+
 /* ========================== Shared State ================================= */
+#if !APP_UART_RX_DMA
 static volatile uint8_t     uart_rx_byte;   /* Single-byte ISR receive buf   */
-static volatile app_state_t current_state = STATE_MAIN_MENU;  /* FSM state  */
-static volatile int         led_toggle_phase = 0; /* Alternates 0/1 each cb */
+#endif
+static ao_event_t           rx_line;        /* Line being assembled          */
+static uint8_t              rx_chunk[32];   /* One read from the RX path     */
+static size_t               rx_count;       /* Valid bytes in rx_chunk       */
+static size_t               rx_index;       /* Next byte to parse            */
+static volatile uint8_t     rx_post_pending;/* SIG_RX_READY already queued   */
+static uint8_t              rx_resume_pending;/* SIG_RX_RESUME queued          */
+static RTC_TimeTypeDef      rtc_new_time;   /* Fields collected by time entry */
+static RTC_DateTypeDef      rtc_new_date;   /* Fields collected by date entry */
 
 /* ========================== Constant Strings ============================= */
-static const char *MSG_INVALID = "\r\n  [!] Invalid input. Please try again.\r\n";
+static const char MSG_INVALID[] = "\r\n  [!] Invalid input. Please try again.\r\n";
+static const char MSG_SUCCESS[] = "\r\n  [OK] Configuration saved successfully.\r\n";
+
+static const char MSG_MAIN_MENU[] =
+    "\r\n"
+    "  +------------------------------------+\r\n"
+    "  |     STM32F4 Discovery  v1.0        |\r\n"
+    "  |          MAIN MENU                 |\r\n"
+    "  +------------------------------------+\r\n"
+    "  | [0]  LED Control Panel             |\r\n"
+    "  | [1]  Clock & Calendar Settings     |\r\n"
+    "  | [2]  Task Monitor (CPU / stack)    |\r\n"
+    "  | [3]  Exit                          |\r\n"
+    "  +------------------------------------+\r\n"
+    "  Select option >> ";
+
+static const char MSG_LED_MENU[] =
+    "\r\n"
+    "  +------------------------------------+\r\n"
+    "  |        LED CONTROL PANEL           |\r\n"
+    "  +------------------------------------+\r\n"
+    "  | [1]    Sync Blink   (all toggle)  |\r\n"
+    "  | [2]    Dual Sweep   (alt. pairs)  |\r\n"
+    "  | [3]    Wave Split   (top/bottom)  |\r\n"
+    "  | [4]    Cross Fade   (diagonal)    |\r\n"
+    "  | [5]    Breathe      (fade in/out) |\r\n"
+    "  | [6]    Chase        (fading tail) |\r\n"
+    "  | [none] All LEDs OFF               |\r\n"
+    "  +------------------------------------+\r\n"
+    "  Select effect >> ";
+
+static const char MSG_RTC_HEADER[] =
+    "\r\n"
+    "  +------------------------------------+\r\n"
+    "  |      CLOCK & CALENDAR SETTINGS     |\r\n"
+    "  +------------------------------------+\r\n";
+
+static const char MSG_RTC_OPTIONS[] =
+    "  | [0]  Set Time  (HH:MM:SS AM/PM)   |\r\n"
+    "  | [1]  Set Date  (DD/MM/DOW/YY)     |\r\n"
+    "  | [2]  Live Report on ITM Console    |\r\n"
+    "  | [3]  Back to Main Menu             |\r\n"
+    "  +------------------------------------+\r\n"
+    "  Select option >> ";
+
+static const char MSG_ENTER_HOUR[]    = "  Hour (1-12)    : ";
+static const char MSG_ENTER_MINUTE[]  = "  Minutes (0-59) : ";
+static const char MSG_ENTER_SECOND[]  = "  Seconds (0-59) : ";
+static const char MSG_ENTER_AMPM[]    = "  AM=0 / PM=1    : ";
+static const char MSG_ENTER_DAY[]     = "  Day (1-31)     : ";
+static const char MSG_ENTER_MONTH[]   = "  Month (1-12)   : ";
+static const char MSG_ENTER_WEEKDAY[] = "  Weekday (1-7, Sun=1) : ";
+static const char MSG_ENTER_YEAR[]    = "  Year (0-99)    : ";
+static const char MSG_REPORT_PROMPT[] = "  Enable live time report on ITM? (y/n) : ";
 
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_RTC_Init(void);
 static void MX_USART2_UART_Init(void);
+#if APP_LED_PWM
+static void MX_TIM4_Init(void);
+#endif
 
 /* USER CODE BEGIN PFP */
 
 /* --- FreeRTOS task entry points --- */
-static void task_main_menu(void *param);
-static void task_led_effect(void *param);
-static void task_rtc_config(void *param);
 static void task_print(void *param);
-static void task_cmd_handler(void *param);
 
 /* --- RTC helpers --- */
 static void     rtc_show_on_uart(void);
@@ -159,12 +258,16 @@ static int      rtc_validate(const RTC_TimeTypeDef *time,
 /* --- Utility --- */
 static uint8_t  ascii_to_number(const uint8_t *buf, int len);
 
-/* --- LED helpers --- */
-static void     led_write_pattern(uint8_t pattern);
-static void     led_stop_all_timers(void);
+/* --- Menu active object --- */
+static void     menu_rx_notify_from_isr(BaseType_t *woken);
+
+/* --- Print helpers --- */
+static void     print_send(msg_t *msg);
+static void     print_const(const char *text);
+static void     print_text(const char *text, size_t len);
+static void     print_stack_prof(const char *line, uint32_t len);
 
 /* --- Timer callbacks --- */
-static void     callback_led_effect(TimerHandle_t xTimer);
 static void     callback_rtc_report(TimerHandle_t xTimer);
 
 /* USER CODE END PFP */
@@ -199,84 +302,168 @@ void vApplicationMallocFailedHook(void)
     for (;;);                      /* Halt -- heap is full                    */
 }
 
-/* =========================================================================
- *  LED GPIO PIN MAP
- *  PD12 = green, PD13 = orange, PD14 = red, PD15 = blue
- * ========================================================================= */
-static const uint16_t LED_PINS[LED_COUNT] = {
-    GPIO_PIN_12, GPIO_PIN_13, GPIO_PIN_14, GPIO_PIN_15
-};
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
 
-/* =========================================================================
- *  LED HELPER FUNCTIONS
- * ========================================================================= */
+/* Idle and timer service task memory: with APP_STATIC_ALLOC there is no
+ * heap for vTaskStartScheduler() to take it from                          */
+STATIC_TASK(idle_task, configMINIMAL_STACK_SIZE);
+STATIC_TASK(timer_task, configTIMER_TASK_STACK_DEPTH);
 
 /**
- * @brief  Write all four LEDs at once using a 4-bit pattern.
- *         Bit 0 -> PD12, Bit 1 -> PD13, Bit 2 -> PD14, Bit 3 -> PD15.
- *         1 = ON, 0 = OFF.
- * @param  pattern  4-bit value controlling each LED.
+ * @brief  Supply the idle task's TCB and stack (configSUPPORT_STATIC_ALLOCATION).
  */
-static void led_write_pattern(uint8_t pattern)
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   configSTACK_DEPTH_TYPE *puxIdleTaskStackSize)
 {
-    for (int i = 0; i < LED_COUNT; i++) {
-        GPIO_PinState state = (pattern & (1 << i)) ? GPIO_PIN_SET
-                                                    : GPIO_PIN_RESET;
-        HAL_GPIO_WritePin(GPIOD, LED_PINS[i], state);
-    }
+    *ppxIdleTaskTCBBuffer   = STATIC_TASK_TCB(idle_task);
+    *ppxIdleTaskStackBuffer = STATIC_TASK_STACK(idle_task);
+    *puxIdleTaskStackSize   = kobj_idle_task_words;
 }
 
 /**
- * @brief  Stop all four LED effect software timers.
- *         Call this before starting a new effect to ensure only one runs.
+ * @brief  Supply the timer service task's TCB and stack.
  */
-static void led_stop_all_timers(void)
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                    StackType_t **ppxTimerTaskStackBuffer,
+                                    configSTACK_DEPTH_TYPE *puxTimerTaskStackSize)
 {
-    for (int i = 0; i < LED_COUNT; i++) {
-        xTimerStop(timer_led[i], portMAX_DELAY);
-    }
+    *ppxTimerTaskTCBBuffer   = STATIC_TASK_TCB(timer_task);
+    *ppxTimerTaskStackBuffer = STATIC_TASK_STACK(timer_task);
+    *puxTimerTaskStackSize   = kobj_timer_task_words;
 }
 
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+#if APP_LED_PWM
+
 /* =========================================================================
- *  TIMER CALLBACKS
+ *  LED EFFECT SCRIPTS
+ *  Keyframe levels in PD12 (green), PD13 (orange), PD14 (red), PD15 (blue)
+ *  order; led_pwm expands a script into PWM frames once and DMA loops it.
  * ========================================================================= */
+#define LED_ON                  LED_PWM_LEVEL_MAX
+
+/* Effects 1-4: the two complementary patterns, 500 ms each */
+static const led_pwm_key_t LED_FX_SYNC_BLINK[] = {
+    { { LED_ON, LED_ON, LED_ON, LED_ON }, 500, 0 },
+    { { 0,      0,      0,      0      }, 500, 0 },
+};
+
+static const led_pwm_key_t LED_FX_DUAL_SWEEP[] = {
+    { { LED_ON, 0,      LED_ON, 0      }, 500, 0 },
+    { { 0,      LED_ON, 0,      LED_ON }, 500, 0 },
+};
+
+static const led_pwm_key_t LED_FX_WAVE_SPLIT[] = {
+    { { LED_ON, LED_ON, 0,      0      }, 500, 0 },
+    { { 0,      0,      LED_ON, LED_ON }, 500, 0 },
+};
+
+static const led_pwm_key_t LED_FX_CROSS_FADE[] = {
+    { { 0,      LED_ON, LED_ON, 0      }, 500, 0 },
+    { { LED_ON, 0,      0,      LED_ON }, 500, 0 },
+};
+
+/* Effect 5: all four fade up, rest, fade down, rest */
+static const led_pwm_key_t LED_FX_BREATHE[] = {
+    { { LED_ON, LED_ON, LED_ON, LED_ON }, 600, 1 },
+    { { LED_ON, LED_ON, LED_ON, LED_ON }, 100, 0 },
+    { { 0,      0,      0,      0      }, 600, 1 },
+    { { 0,      0,      0,      0      }, 300, 0 },
+};
+
+/* Effect 6: one bright LED running round with a fading tail */
+static const led_pwm_key_t LED_FX_CHASE[] = {
+    { { LED_ON, 16,     0,      64     }, 150, 1 },
+    { { 64,     LED_ON, 16,     0      }, 150, 1 },
+    { { 0,      64,     LED_ON, 16     }, 150, 1 },
+    { { 16,     0,      64,     LED_ON }, 150, 1 },
+};
 
 /**
- * @brief  Software timer callback that drives LED effects.
- *
- *         Each of the four timers carries a unique ID (1-4) set via
- *         pvTimerGetTimerID().  The ID selects the blink pattern.
- *         led_toggle_phase alternates between two complementary patterns
- *         on each tick.
- *
- *         Effect patterns (PD12 PD13 PD14 PD15):
- *           Effect 1: all on  / all off           (simultaneous blink)
- *           Effect 2: 1 0 1 0 / 0 1 0 1           (alternate pairs)
- *           Effect 3: 1 1 0 0 / 0 0 1 1           (top-bottom swap)
- *           Effect 4: 0 1 1 0 / 1 0 0 1           (cross pattern)
- *
- * @param  xTimer  Handle of the timer that expired.
+ * @brief  One selectable effect: a keyframe script and its length.
  */
-static void callback_led_effect(TimerHandle_t xTimer)
-{
-    /* Retrieve effect ID (1-4) stored when the timer was created */
-    int effect_id = (int)(uint32_t)pvTimerGetTimerID(xTimer);
-
-    /* Two complementary 4-bit patterns per effect: [phase0, phase1] */
-    static const uint8_t patterns[4][2] = {
-        { 0x0F, 0x00 },           /* Effect 1: all on    <-> all off         */
-        { 0x05, 0x0A },           /* Effect 2: 12,14 on  <-> 13,15 on       */
-        { 0x03, 0x0C },           /* Effect 3: 12,13 on  <-> 14,15 on       */
-        { 0x06, 0x09 },           /* Effect 4: 13,14 on  <-> 12,15 on       */
-    };
-
-    /* Bounds-check the effect ID (must be 1-4) */
-    if (effect_id < 1 || effect_id > LED_COUNT) return;
-
-    /* Write the current phase pattern, then flip the phase flag */
-    led_write_pattern(patterns[effect_id - 1][led_toggle_phase]);
-    led_toggle_phase ^= 1;        /* Toggle between 0 and 1                  */
-}
+typedef struct {
+    const led_pwm_key_t *keys;
+    uint32_t             count;
+} led_effect_t;
+
+#define LED_EFFECT(script)      { script, sizeof(script) / sizeof(script[0]) }
+
+/* Indexed by the menu digit minus '1' */
+static const led_effect_t LED_EFFECTS[] = {
+    LED_EFFECT(LED_FX_SYNC_BLINK),
+    LED_EFFECT(LED_FX_DUAL_SWEEP),
+    LED_EFFECT(LED_FX_WAVE_SPLIT),
+    LED_EFFECT(LED_FX_CROSS_FADE),
+    LED_EFFECT(LED_FX_BREATHE),
+    LED_EFFECT(LED_FX_CHASE),
+};
+
+#else  /* !APP_LED_PWM */
+
+static const char MSG_LED_NEEDS_PWM[] =
+    "\r\n  [!] Fading effects need APP_LED_PWM = 1.\r\n";
+
+/* =========================================================================
+ *  LED SEQUENCER SCRIPTS
+ *  Pattern bit 0 = PD12 (green), 1 = PD13 (orange), 2 = PD14 (red),
+ *  3 = PD15 (blue).  led_seq shows each step with one BSRR store and
+ *  re-arms its single timer with the step's duration.
+ * ========================================================================= */
+
+/* Effects 1-4: the two complementary patterns, 500 ms each */
+static const led_seq_step_t LED_SEQ_SYNC_BLINK[] = {
+    LED_SEQ_STEP(0x0F, 500),       /* all on    */
+    LED_SEQ_STEP(0x00, 500),       /* all off   */
+};
+
+static const led_seq_step_t LED_SEQ_DUAL_SWEEP[] = {
+    LED_SEQ_STEP(0x05, 500),       /* 12,14 on  */
+    LED_SEQ_STEP(0x0A, 500),       /* 13,15 on  */
+};
+
+static const led_seq_step_t LED_SEQ_WAVE_SPLIT[] = {
+    LED_SEQ_STEP(0x03, 500),       /* 12,13 on  */
+    LED_SEQ_STEP(0x0C, 500),       /* 14,15 on  */
+};
+
+static const led_seq_step_t LED_SEQ_CROSS_FADE[] = {
+    LED_SEQ_STEP(0x06, 500),       /* 13,14 on  */
+    LED_SEQ_STEP(0x09, 500),       /* 12,15 on  */
+};
+
+/* Effect 6 without PWM: one LED running round, 150 ms each */
+static const led_seq_step_t LED_SEQ_CHASE[] = {
+    LED_SEQ_STEP(0x01, 150),
+    LED_SEQ_STEP(0x02, 150),
+    LED_SEQ_STEP(0x04, 150),
+    LED_SEQ_STEP(0x08, 150),
+};
+
+/**
+ * @brief  One selectable effect: a step script and its length.
+ *         steps = NULL marks an effect that needs PWM.
+ */
+typedef struct {
+    const led_seq_step_t *steps;
+    uint32_t              count;
+} led_effect_t;
+
+#define LED_EFFECT(script)      { script, sizeof(script) / sizeof(script[0]) }
+
+/* Indexed by the menu digit minus '1' */
+static const led_effect_t LED_EFFECTS[] = {
+    LED_EFFECT(LED_SEQ_SYNC_BLINK),
+    LED_EFFECT(LED_SEQ_DUAL_SWEEP),
+    LED_EFFECT(LED_SEQ_WAVE_SPLIT),
+    LED_EFFECT(LED_SEQ_CROSS_FADE),
+    { NULL, 0 },                   /* Breathe: fading needs PWM              */
+    LED_EFFECT(LED_SEQ_CHASE),
+};
+
+#endif /* APP_LED_PWM */
 
 /**
  * @brief  Periodic timer callback that prints current RTC time via ITM/SWO.
@@ -285,7 +472,11 @@ static void callback_led_effect(TimerHandle_t xTimer)
 static void callback_rtc_report(TimerHandle_t xTimer)
 {
     (void)xTimer;
+    uint32_t bench_start = dwt_cycles_now();
+
     rtc_show_on_itm();             /* Print time to SWO debug console         */
+
+    app_bench_rtc_report(dwt_cycles_since(bench_start));
 }
 
 /* =========================================================================
@@ -306,16 +497,157 @@ static uint8_t ascii_to_number(const uint8_t *buf, int len)
     return (uint8_t)(buf[0] - '0');
 }
 
+/* =========================================================================
+ *  PRINT HELPERS
+ *  Every UART message travels through queue_print as a msg_t handle.
+ *  print_task releases the block after handing the text to the UART.
+ * ========================================================================= */
+
+/**
+ * @brief  Queue a message block for print_task.  Ownership of the caller's
+ *         reference passes to print_task.
+ * @param  msg  Block from msg_alloc() or msg_wrap_const().
+ */
+static void print_send(msg_t *msg)
+{
+    xQueueSend(queue_print, &msg, portMAX_DELAY);
+}
+
+/**
+ * @brief  Queue a constant string (string literal or other static text).
+ *         The text is not copied, only wrapped in a pool block.
+ * @param  text  Null-terminated string with static lifetime.
+ */
+static void print_const(const char *text)
+{
+    print_send(msg_wrap_const(text, portMAX_DELAY));
+}
+
+/**
+ * @brief  Queue a copy of transient text (e.g. a stack buffer).
+ * @param  text  Bytes to send; need not be null-terminated.
+ * @param  len   Number of bytes, at most APP_MSG_POOL_BLOCK_SIZE.
+ */
+static void print_text(const char *text, size_t len)
+{
+    msg_t *msg = msg_alloc(portMAX_DELAY);
+
+    configASSERT(len <= sizeof(msg->data));
+    memcpy(msg->data, text, len);
+    msg->len = (uint16_t)len;
+    print_send(msg);
+}
+
+/**
+ * @brief  One stack_prof.c report line, to the UART console between the
+ *         menu's own lines.  Split over blocks when longer than one.
+ */
+static void print_stack_prof(const char *line, uint32_t len)
+{
+    while (len > 0U) {
+        uint32_t n = (len < APP_MSG_POOL_BLOCK_SIZE) ? len
+                                                     : APP_MSG_POOL_BLOCK_SIZE;
+
+        print_text(line, n);
+        line += n;
+        len  -= n;
+    }
+}
+
 /* =========================================================================
  *  RTC HELPER FUNCTIONS
  * ========================================================================= */
 
 /**
- * @brief  Print current RTC time and date via ITM/SWO (printf).
+ * @brief  Write raw bytes to the RTC report's ITM stimulus port.
+ *         Runs in the timer service task, so it must not wait on SWO.
+ */
+static void itm_write(const char *text, uint32_t len)
+{
+#if APP_ITM_LOG
+    /* Queued for itm_task; a full FIFO drops the line and counts it */
+    (void)itm_log_write(ITM_LOG_PORT_RTC, text, len);
+#else
+    /* Legacy: spin on stimulus port 0 for every character */
+    for (uint32_t i = 0; i < len; i++) {
+        ITM_SendChar((uint32_t)(uint8_t)text[i]);
+    }
+#endif
+}
+
+#if APP_RTC_CACHE
+
+static const char MSG_TIME_PREFIX[] = "\r\n  Current Time : ";
+static const char MSG_DATE_PREFIX[] = "\r\n  Current Date : ";
+
+/**
+ * @brief  Copy a constant string without its terminator.
+ * @return Position after the copied text.
+ */
+#define TEXT_PUT(dst, str)      ((char *)memcpy((dst), (str), sizeof(str) - 1U) \
+                                 + (sizeof(str) - 1U))
+
+/**
+ * @brief  Print the cached RTC time and date via ITM/SWO.
+ *         Used by the periodic report timer callback.  Reads the snapshot
+ *         published by the wakeup interrupt -- no HAL call, no printf.
+ */
+static void rtc_show_on_itm(void)
+{
+    rtc_cache_t now;
+    char        line[RTC_FMT_TIME_LEN + RTC_FMT_DATE_LEN + 2U];
+    char       *p = line;
+
+    rtc_cache_read(&now);
+
+    p += rtc_fmt_time(p, &now);
+    *p++ = '\t';
+    p += rtc_fmt_date(p, &now);
+    *p++ = '\n';
+    itm_write(line, (uint32_t)(p - line));
+}
+
+/**
+ * @brief  Print the cached RTC time and date over UART via the print queue.
+ *         Each line is formatted straight into its own pool block, so
+ *         back-to-back calls never overwrite text that print_task has not
+ *         sent yet.
+ */
+static void rtc_show_on_uart(void)
+{
+    rtc_cache_t now;
+    msg_t      *msg;
+    char       *p;
+
+    rtc_cache_read(&now);
+
+    /* Time line */
+    msg = msg_alloc(portMAX_DELAY);
+    p   = TEXT_PUT(msg->data, MSG_TIME_PREFIX);
+    p  += rtc_fmt_time(p, &now);
+    msg->len = (uint16_t)(p - msg->data);
+    print_send(msg);
+
+    /* Date line */
+    msg = msg_alloc(portMAX_DELAY);
+    p   = TEXT_PUT(msg->data, MSG_DATE_PREFIX);
+    p  += rtc_fmt_date(p, &now);
+    *p++ = '\r';
+    *p++ = '\n';
+    msg->len = (uint16_t)(p - msg->data);
+    print_send(msg);
+}
+
+#else  /* !APP_RTC_CACHE */
+
+/**
+ * @brief  Print current RTC time and date via ITM/SWO.
  *         Used by the periodic report timer callback.
  */
 static void rtc_show_on_itm(void)
 {
+    char            line[32];
+    int             len;
     RTC_TimeTypeDef rtc_time = {0};
     RTC_DateTypeDef rtc_date = {0};
 
@@ -328,22 +660,21 @@ static void rtc_show_on_itm(void)
                        ? "AM" : "PM";
 
     /* Print formatted time and date to ITM console */
-    printf("%02d:%02d:%02d [%s]\t%02d-%02d-%04d\n",
-           rtc_time.Hours, rtc_time.Minutes, rtc_time.Seconds, ampm,
-           rtc_date.Month, rtc_date.Date, 2000 + rtc_date.Year);
+    len = fmt_snprintf(line, sizeof(line), "%02d:%02d:%02d [%s]\t%02d-%02d-%04d\n",
+                       rtc_time.Hours, rtc_time.Minutes, rtc_time.Seconds, ampm,
+                       rtc_date.Month, rtc_date.Date, 2000 + rtc_date.Year);
+    itm_write(line, (uint32_t)len);
 }
 
 /**
  * @brief  Print current RTC time and date over UART via the print queue.
- *         Uses static buffers so the pointer remains valid until consumed.
+ *         Each line is formatted into its own pool block, so back-to-back
+ *         calls never overwrite text that print_task has not sent yet.
  */
 static void rtc_show_on_uart(void)
 {
-    /* Static buffers survive after this function returns */
-    static char time_buf[40];
-    static char date_buf[40];
-    static char *time_ptr = time_buf;
-    static char *date_ptr = date_buf;
+    msg_t *time_msg;
+    msg_t *date_msg;
 
     RTC_TimeTypeDef rtc_time = {0};
     RTC_DateTypeDef rtc_date = {0};
@@ -357,16 +688,22 @@ static void rtc_show_on_uart(void)
                        ? "AM" : "PM";
 
     /* Format and enqueue time string */
-    sprintf(time_buf, "\r\n  Current Time : %02d:%02d:%02d [%s]",
+    time_msg = msg_alloc(portMAX_DELAY);
+    time_msg->len = (uint16_t)fmt_snprintf(time_msg->data, sizeof(time_msg->data),
+            "\r\n  Current Time : %02d:%02d:%02d [%s]",
             rtc_time.Hours, rtc_time.Minutes, rtc_time.Seconds, ampm);
-    xQueueSend(queue_print, &time_ptr, portMAX_DELAY);
+    print_send(time_msg);
 
     /* Format and enqueue date string */
-    sprintf(date_buf, "\r\n  Current Date : %02d-%02d-%04d\r\n",
+    date_msg = msg_alloc(portMAX_DELAY);
+    date_msg->len = (uint16_t)fmt_snprintf(date_msg->data, sizeof(date_msg->data),
+            "\r\n  Current Date : %02d-%02d-%04d\r\n",
             rtc_date.Month, rtc_date.Date, 2000 + rtc_date.Year);
-    xQueueSend(queue_print, &date_ptr, portMAX_DELAY);
+    print_send(date_msg);
 }
 
+#endif /* APP_RTC_CACHE */
+
 /**
  * @brief  Apply a new time to the RTC hardware.
  * @param  time  Pointer to time struct with Hours, Minutes, Seconds,
@@ -378,6 +715,9 @@ static void rtc_apply_time(RTC_TimeTypeDef *time)
     time->DayLightSaving = RTC_DAYLIGHTSAVING_NONE;    /* No DST adjustment  */
     time->StoreOperation = RTC_STOREOPERATION_RESET;   /* Reset store flag   */
     HAL_RTC_SetTime(&hrtc, time, RTC_FORMAT_BIN);      /* Write to hardware  */
+#if APP_RTC_CACHE
+    rtc_cache_refresh();                               /* Show it right away */
+#endif
 }
 
 /**
@@ -387,6 +727,9 @@ static void rtc_apply_time(RTC_TimeTypeDef *time)
 static void rtc_apply_date(RTC_DateTypeDef *date)
 {
     HAL_RTC_SetDate(&hrtc, date, RTC_FORMAT_BIN);      /* Write to hardware  */
+#if APP_RTC_CACHE
+    rtc_cache_refresh();                               /* Show it right away */
+#endif
 }
 
 /**
@@ -417,501 +760,514 @@ static int rtc_validate(const RTC_TimeTypeDef *time,
 }
 
 /* =========================================================================
- *  FREERTOS TASKS
+ *  COMMAND HANDLERS
+ *  Called by menu_leaf() for the matching command-table row.  They only
+ *  act on the input; the table decides which state comes next.
  * ========================================================================= */
 
 /**
- * @brief  Main menu task.
- *
- *         Displays the top-level menu, waits for a single-digit command,
- *         and delegates to the LED or RTC task via task notifications.
- *         After the sub-task finishes, it notifies this task to re-display
- *         the menu.
- *
- * @param  param  (unused)
+ * @brief  LED panel "none": stop every effect and force the LEDs off.
  */
-static void task_main_menu(void *param)
+static void led_on_none(const uint8_t *text, uint32_t len)
 {
-    (void)param;
+    (void)text;
+    (void)len;
+#if APP_LED_PWM
+    led_pwm_stop();
+#else
+    led_seq_stop();
+#endif
+}
 
-    uint32_t       notification_value;       /* Holds pointer from notifier  */
-    uart_command_t *cmd;                     /* Points into cmd_handler's buf*/
-
-    const char *msg_menu =
-        "\r\n"
-        "  +------------------------------------+\r\n"
-        "  |     STM32F4 Discovery  v1.0        |\r\n"
-        "  |          MAIN MENU                 |\r\n"
-        "  +------------------------------------+\r\n"
-        "  | [0]  LED Control Panel             |\r\n"
-        "  | [1]  Clock & Calendar Settings     |\r\n"
-        "  | [2]  Exit                          |\r\n"
-        "  +------------------------------------+\r\n"
-        "  Select option >> ";
+/**
+ * @brief  LED panel "1".."6": replace the running effect.
+ */
+static void led_on_effect(const uint8_t *text, uint32_t len)
+{
+    uint32_t effect = (uint32_t)(text[0] - '1');
+
+    (void)len;
+#if APP_LED_PWM
+    uint32_t frames = led_pwm_play(LED_EFFECTS[effect].keys,
+                                   LED_EFFECTS[effect].count);
+
+    configASSERT(frames != 0U);    /* Script larger than APP_LED_PWM_FRAMES  */
+    (void)frames;
+#else
+    if (LED_EFFECTS[effect].steps == NULL) {
+        led_seq_stop();
+        print_const(MSG_LED_NEEDS_PWM);
+        return;
+    }
+    led_seq_play(LED_EFFECTS[effect].steps, LED_EFFECTS[effect].count);
+#endif
+}
 
-    for (;;) {
-        /* Display the main menu over UART */
-        xQueueSend(queue_print, &msg_menu, portMAX_DELAY);
-
-        /* Block until cmd_handler sends a parsed command via notification */
-        xTaskNotifyWait(0, 0, &notification_value, portMAX_DELAY);
-        cmd = (uart_command_t *)notification_value;
-
-        if (cmd->length == 1) {
-            int option = cmd->payload[0] - '0';  /* Convert ASCII to int    */
-
-            switch (option) {
-            case 0:
-                /* Hand control to the LED effect task */
-                current_state = STATE_LED_EFFECT;
-                xTaskNotify(task_handle_led, 0, eNoAction);
-                break;
-
-            case 1:
-                /* Hand control to the RTC configuration task */
-                current_state = STATE_RTC_MENU;
-                xTaskNotify(task_handle_rtc, 0, eNoAction);
-                break;
-
-            case 2:
-                /* Exit -- no shutdown action defined yet */
-                break;
-
-            default:
-                /* Unrecognised single digit */
-                xQueueSend(queue_print, &MSG_INVALID, portMAX_DELAY);
-                continue;          /* Re-display menu immediately            */
-            }
-        } else {
-            /* Multi-character input is invalid at the main menu */
-            xQueueSend(queue_print, &MSG_INVALID, portMAX_DELAY);
-            continue;              /* Re-display menu immediately            */
-        }
+/* --- RTC time entry: one field per prompt -------------------------------- */
+static void rtc_on_hour(const uint8_t *text, uint32_t len)
+{
+    rtc_new_time.Hours = ascii_to_number(text, (int)len);
+}
+
+static void rtc_on_minute(const uint8_t *text, uint32_t len)
+{
+    rtc_new_time.Minutes = ascii_to_number(text, (int)len);
+}
 
-        /* Block here until the sub-task finishes and notifies us back */
-        xTaskNotifyWait(0, 0, NULL, portMAX_DELAY);
+static void rtc_on_second(const uint8_t *text, uint32_t len)
+{
+    rtc_new_time.Seconds = ascii_to_number(text, (int)len);
+}
+
+/**
+ * @brief  Validate the collected time and write it to the RTC.
+ */
+static void rtc_commit_time(void)
+{
+    if (rtc_validate(&rtc_new_time, NULL) == 0) {
+        rtc_apply_time(&rtc_new_time);
+        print_const(MSG_SUCCESS);
+        rtc_show_on_uart();
+    } else {
+        print_const(MSG_INVALID);
     }
 }
 
+/* AM=0 / PM=1 -- any other answer misses the table and is rejected */
+static void rtc_on_am(const uint8_t *text, uint32_t len)
+{
+    (void)text;
+    (void)len;
+    rtc_new_time.TimeFormat = RTC_HOURFORMAT12_AM;
+    rtc_commit_time();
+}
+
+static void rtc_on_pm(const uint8_t *text, uint32_t len)
+{
+    (void)text;
+    (void)len;
+    rtc_new_time.TimeFormat = RTC_HOURFORMAT12_PM;
+    rtc_commit_time();
+}
+
+/* --- RTC date entry: one field per prompt -------------------------------- */
+static void rtc_on_day(const uint8_t *text, uint32_t len)
+{
+    rtc_new_date.Date = ascii_to_number(text, (int)len);
+}
+
+static void rtc_on_month(const uint8_t *text, uint32_t len)
+{
+    rtc_new_date.Month = ascii_to_number(text, (int)len);
+}
+
+static void rtc_on_weekday(const uint8_t *text, uint32_t len)
+{
+    rtc_new_date.WeekDay = ascii_to_number(text, (int)len);
+}
+
+/**
+ * @brief  Last date field: validate all four and write them to the RTC.
+ */
+static void rtc_on_year(const uint8_t *text, uint32_t len)
+{
+    rtc_new_date.Year = ascii_to_number(text, (int)len);
+
+    if (rtc_validate(NULL, &rtc_new_date) == 0) {
+        rtc_apply_date(&rtc_new_date);
+        print_const(MSG_SUCCESS);
+        rtc_show_on_uart();
+    } else {
+        print_const(MSG_INVALID);
+    }
+}
+
+/* --- RTC live report toggle ---------------------------------------------- */
+static void rtc_on_report_on(const uint8_t *text, uint32_t len)
+{
+    (void)text;
+    (void)len;
+    /* Start the report timer if not already running */
+    if (xTimerIsTimerActive(timer_rtc_report) == pdFALSE) {
+        xTimerStart(timer_rtc_report, portMAX_DELAY);
+    }
+}
+
+static void rtc_on_report_off(const uint8_t *text, uint32_t len)
+{
+    (void)text;
+    (void)len;
+    xTimerStop(timer_rtc_report, portMAX_DELAY);
+}
+
+/**
+ * @brief  Main menu "2": print the Task Monitor page (cpu_stats.c).
+ */
+static void top_on_show(const uint8_t *text, uint32_t len)
+{
+    (void)text;
+    (void)len;
+    cpu_stats_print(print_text);
+}
+
 /**
- * @brief  LED effect selection task.
+ * @brief  Entry action of STATE_RTC_MENU: header, current time, options.
+ */
+static void rtc_menu_show(void)
+{
+    print_const(MSG_RTC_HEADER);
+    rtc_show_on_uart();
+    print_const(MSG_RTC_OPTIONS);
+}
+
+/* =========================================================================
+ *  COMMAND TABLE
+ *  One row per accepted command.  Anything without a row is rejected with
+ *  MSG_INVALID and returns to the main menu.  Tokens are up to four chars;
+ *  CMD_ANY accepts any line (numeric data entry).  A hash collision between
+ *  rows is a compile error -- see cmd_dispatch.h.
+ * ========================================================================= */
+#define APP_CMD_TABLE(X)                                                                      \
+    /*  state                     token               handler            next state       */ \
+    X(STATE_MAIN_MENU,         ('0'),              NULL,              STATE_LED_EFFECT)       \
+    X(STATE_MAIN_MENU,         ('1'),              NULL,              STATE_RTC_MENU)         \
+    X(STATE_MAIN_MENU,         ('2'),              top_on_show,       STATE_MAIN_MENU)        \
+    X(STATE_MAIN_MENU,         ('3'),              NULL,              STATE_MAIN_MENU)        \
+    X(STATE_LED_EFFECT,        ('n','o','n','e'),  led_on_none,       STATE_MAIN_MENU)        \
+    X(STATE_LED_EFFECT,        ('1'),              led_on_effect,     STATE_MAIN_MENU)        \
+    X(STATE_LED_EFFECT,        ('2'),              led_on_effect,     STATE_MAIN_MENU)        \
+    X(STATE_LED_EFFECT,        ('3'),              led_on_effect,     STATE_MAIN_MENU)        \
+    X(STATE_LED_EFFECT,        ('4'),              led_on_effect,     STATE_MAIN_MENU)        \
+    X(STATE_LED_EFFECT,        ('5'),              led_on_effect,     STATE_MAIN_MENU)        \
+    X(STATE_LED_EFFECT,        ('6'),              led_on_effect,     STATE_MAIN_MENU)        \
+    X(STATE_RTC_MENU,          ('0'),              NULL,              STATE_RTC_TIME_HOUR)    \
+    X(STATE_RTC_MENU,          ('1'),              NULL,              STATE_RTC_DATE_DAY)     \
+    X(STATE_RTC_MENU,          ('2'),              NULL,              STATE_RTC_REPORT)       \
+    X(STATE_RTC_MENU,          ('3'),              NULL,              STATE_MAIN_MENU)        \
+    X(STATE_RTC_TIME_HOUR,     CMD_ANY,            rtc_on_hour,       STATE_RTC_TIME_MINUTE)  \
+    X(STATE_RTC_TIME_MINUTE,   CMD_ANY,            rtc_on_minute,     STATE_RTC_TIME_SECOND)  \
+    X(STATE_RTC_TIME_SECOND,   CMD_ANY,            rtc_on_second,     STATE_RTC_TIME_AMPM)    \
+    X(STATE_RTC_TIME_AMPM,     ('0'),              rtc_on_am,         STATE_MAIN_MENU)        \
+    X(STATE_RTC_TIME_AMPM,     ('1'),              rtc_on_pm,         STATE_MAIN_MENU)        \
+    X(STATE_RTC_DATE_DAY,      CMD_ANY,            rtc_on_day,        STATE_RTC_DATE_MONTH)   \
+    X(STATE_RTC_DATE_MONTH,    CMD_ANY,            rtc_on_month,      STATE_RTC_DATE_WEEKDAY) \
+    X(STATE_RTC_DATE_WEEKDAY,  CMD_ANY,            rtc_on_weekday,    STATE_RTC_DATE_YEAR)    \
+    X(STATE_RTC_DATE_YEAR,     CMD_ANY,            rtc_on_year,       STATE_MAIN_MENU)        \
+    X(STATE_RTC_REPORT,        ('y'),              rtc_on_report_on,  STATE_MAIN_MENU)        \
+    X(STATE_RTC_REPORT,        ('n'),              rtc_on_report_off, STATE_MAIN_MENU)
+
+CMD_TABLE_DEFINE(app_cmd_table, APP_CMD_TABLE);
+_Static_assert(STATE_COUNT <= CMD_STATES_MAX,
+               "CMD_KEY holds state + 1 in 4 bits: at most 15 states");
+
+/* =========================================================================
+ *  MENU ACTIVE OBJECT
  *
- *         Waits for a notification from the menu task, shows the LED
- *         sub-menu, reads the user's choice, starts the corresponding
- *         software timer, then returns control to the menu.
+ *  The whole menu runs on one task (menu_ao).  Its state hierarchy:
  *
- * @param  param  (unused)
+ *    S_MENU_TOP                 rejects unknown commands, assembles lines
+ *     +- MAIN, LED, RTC_MENU, REPORT
+ *     +- S_RTC_TIME             entry: clear the time being collected
+ *     |   +- HOUR, MINUTE, SECOND, AMPM
+ *     +- S_RTC_DATE             entry: clear the date being collected
+ *         +- DAY, MONTH, WEEKDAY, YEAR
+ *
+ *  Leaf states share menu_leaf(): print the prompt on entry, look each
+ *  SIG_CMD up in the command table and take the row's transition.  A line
+ *  with no row bubbles up to S_MENU_TOP, which rejects it.
+ * ========================================================================= */
+static ao_result_t menu_top(ao_t *me, const ao_state_t *self,
+                            const ao_event_t *e);
+static ao_result_t menu_rtc_time(ao_t *me, const ao_state_t *self,
+                                 const ao_event_t *e);
+static ao_result_t menu_rtc_date(ao_t *me, const ao_state_t *self,
+                                 const ao_event_t *e);
+static ao_result_t menu_leaf(ao_t *me, const ao_state_t *self,
+                             const ao_event_t *e);
+
+static const ao_state_t S_MENU_TOP = { NULL,        menu_top      };
+static const ao_state_t S_RTC_TIME = { &S_MENU_TOP, menu_rtc_time };
+static const ao_state_t S_RTC_DATE = { &S_MENU_TOP, menu_rtc_date };
+
+/* Leaf states, indexed by the app_state_t used in the command table */
+static const menu_state_t MENU_STATES[STATE_COUNT] = {
+    /* state                      parent        handler       id                      prompt             on_enter      */
+    [STATE_MAIN_MENU]        = { { &S_MENU_TOP, menu_leaf }, STATE_MAIN_MENU,        MSG_MAIN_MENU,     NULL          },
+    [STATE_LED_EFFECT]       = { { &S_MENU_TOP, menu_leaf }, STATE_LED_EFFECT,       MSG_LED_MENU,      NULL          },
+    [STATE_RTC_MENU]         = { { &S_MENU_TOP, menu_leaf }, STATE_RTC_MENU,         NULL,              rtc_menu_show },
+    [STATE_RTC_TIME_HOUR]    = { { &S_RTC_TIME, menu_leaf }, STATE_RTC_TIME_HOUR,    MSG_ENTER_HOUR,    NULL          },
+    [STATE_RTC_TIME_MINUTE]  = { { &S_RTC_TIME, menu_leaf }, STATE_RTC_TIME_MINUTE,  MSG_ENTER_MINUTE,  NULL          },
+    [STATE_RTC_TIME_SECOND]  = { { &S_RTC_TIME, menu_leaf }, STATE_RTC_TIME_SECOND,  MSG_ENTER_SECOND,  NULL          },
+    [STATE_RTC_TIME_AMPM]    = { { &S_RTC_TIME, menu_leaf }, STATE_RTC_TIME_AMPM,    MSG_ENTER_AMPM,    NULL          },
+    [STATE_RTC_DATE_DAY]     = { { &S_RTC_DATE, menu_leaf }, STATE_RTC_DATE_DAY,     MSG_ENTER_DAY,     NULL          },
+    [STATE_RTC_DATE_MONTH]   = { { &S_RTC_DATE, menu_leaf }, STATE_RTC_DATE_MONTH,   MSG_ENTER_MONTH,   NULL          },
+    [STATE_RTC_DATE_WEEKDAY] = { { &S_RTC_DATE, menu_leaf }, STATE_RTC_DATE_WEEKDAY, MSG_ENTER_WEEKDAY, NULL          },
+    [STATE_RTC_DATE_YEAR]    = { { &S_RTC_DATE, menu_leaf }, STATE_RTC_DATE_YEAR,    MSG_ENTER_YEAR,    NULL          },
+    [STATE_RTC_REPORT]       = { { &S_MENU_TOP, menu_leaf }, STATE_RTC_REPORT,       MSG_REPORT_PROMPT, NULL          },
+};
+
+/* Posted by the RX ISR, and by the line pump to itself (no payload) */
+static const ao_event_t EVT_RX_READY  = { SIG_RX_READY,  0, { 0 } };
+static const ao_event_t EVT_RX_RESUME = { SIG_RX_RESUME, 0, { 0 } };
+
+/**
+ * @brief  Read whatever the receive path has buffered, without blocking.
+ * @param  dst  Destination buffer.
+ * @param  max  Capacity of dst in bytes.
+ * @return Bytes copied (0 when drained).
  */
-static void task_led_effect(void *param)
+static size_t menu_rx_read(uint8_t *dst, size_t max)
 {
-    (void)param;
+#if APP_UART_RX_DMA
+    return uart_dma_rx_read(dst, max, 0);
+#elif APP_QUEUE_BATCH
+    /* One critical section for the whole burst, not one per byte */
+    return (size_t)xQueueReceiveMultiple(queue_uart_rx, dst, (UBaseType_t)max, 0);
+#else
+    size_t count = 0;
+
+    while (count < max &&
+           xQueueReceive(queue_uart_rx, &dst[count], 0) == pdTRUE) {
+        count++;
+    }
+    return count;
+#endif
+}
 
-    uint32_t       notification_value;
-    uart_command_t *cmd;
-
-    const char *msg_led =
-        "\r\n"
-        "  +------------------------------------+\r\n"
-        "  |        LED CONTROL PANEL           |\r\n"
-        "  +------------------------------------+\r\n"
-        "  | [1]    Sync Blink   (all toggle)  |\r\n"
-        "  | [2]    Dual Sweep   (alt. pairs)  |\r\n"
-        "  | [3]    Wave Split   (top/bottom)  |\r\n"
-        "  | [4]    Cross Fade   (diagonal)    |\r\n"
-        "  | [none] All LEDs OFF               |\r\n"
-        "  +------------------------------------+\r\n"
-        "  Select effect >> ";
+/**
+ * @brief  Assemble received bytes into command lines.
+ *
+ *         Stops at the first complete line and posts it as SIG_CMD,
+ *         followed by SIG_RX_RESUME to resume afterwards.  Each line is
+ *         therefore its own run-to-completion step and sees the state left
+ *         by the previous one, even when a burst holds several lines.
+ *
+ *         Over-long lines are truncated in data[] but len keeps the true
+ *         count, so every state rejects them.
+ */
+static void menu_rx_pump(ao_t *me)
+{
+    BaseType_t status;
 
     for (;;) {
-        /* Sleep until the menu task activates us */
-        xTaskNotifyWait(0, 0, NULL, portMAX_DELAY);
-
-        /* Display the LED effect sub-menu */
-        xQueueSend(queue_print, &msg_led, portMAX_DELAY);
-
-        /* Wait for the user's effect choice */
-        xTaskNotifyWait(0, 0, &notification_value, portMAX_DELAY);
-        cmd = (uart_command_t *)notification_value;
-
-        if (cmd->length <= 4) {
-            if (strcmp((char *)cmd->payload, "none") == 0) {
-                /* Turn off all LED effect timers */
-                led_stop_all_timers();
-                /* Force all four LEDs OFF immediately */
-                led_write_pattern(0x00);
-
-            } else if (strcmp((char *)cmd->payload, "1") == 0) {
-                /* Start effect 1: simultaneous blink */
-                led_stop_all_timers();
-                xTimerStart(timer_led[0], portMAX_DELAY);
-
-            } else if (strcmp((char *)cmd->payload, "2") == 0) {
-                /* Start effect 2: alternate pairs */
-                led_stop_all_timers();
-                xTimerStart(timer_led[1], portMAX_DELAY);
-
-            } else if (strcmp((char *)cmd->payload, "3") == 0) {
-                /* Start effect 3: top-bottom swap */
-                led_stop_all_timers();
-                xTimerStart(timer_led[2], portMAX_DELAY);
-
-            } else if (strcmp((char *)cmd->payload, "4") == 0) {
-                /* Start effect 4: cross pattern */
-                led_stop_all_timers();
-                xTimerStart(timer_led[3], portMAX_DELAY);
-
-            } else {
-                /* Recognised length but unknown command string */
-                xQueueSend(queue_print, &MSG_INVALID, portMAX_DELAY);
+        if (rx_index == rx_count) {
+            rx_count = menu_rx_read(rx_chunk, sizeof(rx_chunk));
+            rx_index = 0;
+            if (rx_count == 0U) {
+                return;            /* Drained -- wait for the next RX event  */
             }
-        } else {
-            /* Input too long for any valid LED command */
-            xQueueSend(queue_print, &MSG_INVALID, portMAX_DELAY);
         }
 
-        /* Return to the main menu */
-        current_state = STATE_MAIN_MENU;
-        xTaskNotify(task_handle_menu, 0, eNoAction);
+        while (rx_index < rx_count) {
+            uint8_t byte = rx_chunk[rx_index++];
+
+            if (byte != '\n') {
+                /* Keep room for the terminator; count overflow chars too */
+                if (rx_line.len < sizeof(rx_line.data) - 1U) {
+                    rx_line.data[rx_line.len] = byte;
+                }
+                if (rx_line.len < UINT16_MAX) {
+                    rx_line.len++;
+                }
+                continue;
+            }
+
+            /* Newline completes the command */
+            rx_line.data[(rx_line.len < sizeof(rx_line.data))
+                         ? rx_line.len : sizeof(rx_line.data) - 1U] = '\0';
+            rx_line.sig = SIG_CMD;
+
+            /* Never block on our own queue.  Until SIG_RX_RESUME has been
+             * handled no further line is posted, so at most one SIG_CMD and
+             * one SIG_RX_RESUME from here, plus one SIG_RX_READY from the
+             * ISR, are queued.  Should the queue still be full, the line is
+             * dropped, or the rest of the burst waits for the next ISR post */
+            status = ao_post(me, &rx_line, 0);
+            rx_line.len = 0;
+            if (status != pdTRUE) {
+                continue;
+            }
+            rx_resume_pending = (ao_post(me, &EVT_RX_RESUME, 0) == pdTRUE);
+            return;
+        }
     }
 }
 
 /**
- * @brief  RTC configuration task.
- *
- *         Handles the RTC sub-menu with four options:
- *           0 -- Configure time (hh, mm, ss entered sequentially)
- *           1 -- Configure date (dd, mm, weekday, yy entered sequentially)
- *           2 -- Enable/disable periodic time reporting via ITM
- *           3 -- Exit back to main menu
- *
- * @param  param  (unused)
+ * @brief  Root state: line assembly and the catch-all for invalid input.
  */
-static void task_rtc_config(void *param)
+static ao_result_t menu_top(ao_t *me, const ao_state_t *self,
+                            const ao_event_t *e)
 {
-    (void)param;
+    (void)self;
 
-    /* ---- Constant sub-menu strings ---- */
-    const char *msg_header =
-        "\r\n"
-        "  +------------------------------------+\r\n"
-        "  |      CLOCK & CALENDAR SETTINGS     |\r\n"
-        "  +------------------------------------+\r\n";
-
-    const char *msg_options =
-        "  | [0]  Set Time  (HH:MM:SS AM/PM)   |\r\n"
-        "  | [1]  Set Date  (DD/MM/DOW/YY)     |\r\n"
-        "  | [2]  Live Report on ITM Console    |\r\n"
-        "  | [3]  Back to Main Menu             |\r\n"
-        "  +------------------------------------+\r\n"
-        "  Select option >> ";
-
-    const char *msg_enter_hour    = "  Hour (1-12)    : ";
-    const char *msg_enter_minute  = "  Minutes (0-59) : ";
-    const char *msg_enter_second  = "  Seconds (0-59) : ";
-    const char *msg_enter_ampm    = "  AM=0 / PM=1    : ";
-    const char *msg_enter_day     = "  Day (1-31)     : ";
-    const char *msg_enter_month   = "  Month (1-12)   : ";
-    const char *msg_enter_weekday = "  Weekday (1-7, Sun=1) : ";
-    const char *msg_enter_year    = "  Year (0-99)    : ";
-    const char *msg_success       = "\r\n  [OK] Configuration saved successfully.\r\n";
-    const char *msg_report_prompt = "  Enable live time report on ITM? (y/n) : ";
-
-    uint32_t       notification_value;       /* Holds pointer from notifier  */
-    uart_command_t *cmd;                     /* Parsed command from user     */
-    int            rtc_sub_step = 0;         /* Tracks current config field  */
-
-    RTC_TimeTypeDef new_time;                /* Accumulates time fields      */
-    RTC_DateTypeDef new_date;                /* Accumulates date fields      */
+    switch (e->sig) {
+    case SIG_RX_READY:
+        rx_post_pending = 0;       /* Let the ISR post the next one          */
+        if (rx_resume_pending == 0U) {
+            menu_rx_pump(me);      /* Else SIG_RX_RESUME picks the bytes up  */
+        }
+        return AO_HANDLED;
 
-    for (;;) {
-        /* Sleep until the menu task activates us */
-        xTaskNotifyWait(0, 0, NULL, portMAX_DELAY);
+    case SIG_RX_RESUME:
+        rx_resume_pending = 0;
+        menu_rx_pump(me);
+        return AO_HANDLED;
 
-        /* Show RTC header, current time/date, and sub-menu options */
-        xQueueSend(queue_print, &msg_header, portMAX_DELAY);
-        rtc_show_on_uart();
-        xQueueSend(queue_print, &msg_options, portMAX_DELAY);
-
-        /* Process commands until we return to the main menu */
-        while (current_state != STATE_MAIN_MENU) {
-
-            /* Block until cmd_handler sends a command */
-            xTaskNotifyWait(0, 0, &notification_value, portMAX_DELAY);
-            cmd = (uart_command_t *)notification_value;
-
-            switch (current_state) {
-
-            /* ----------------------------------------------------------
-             *  RTC SUB-MENU: Choose time/date config or report toggle
-             * ---------------------------------------------------------- */
-            case STATE_RTC_MENU:
-                if (cmd->length == 1) {
-                    int choice = cmd->payload[0] - '0';
-                    switch (choice) {
-                    case 0:  /* Configure time */
-                        current_state = STATE_RTC_TIME_CONFIG;
-                        xQueueSend(queue_print, &msg_enter_hour, portMAX_DELAY);
-                        break;
-                    case 1:  /* Configure date */
-                        current_state = STATE_RTC_DATE_CONFIG;
-                        xQueueSend(queue_print, &msg_enter_day, portMAX_DELAY);
-                        break;
-                    case 2:  /* Toggle reporting */
-                        current_state = STATE_RTC_REPORT;
-                        xQueueSend(queue_print, &msg_report_prompt, portMAX_DELAY);
-                        break;
-                    case 3:  /* Exit to main menu */
-                        current_state = STATE_MAIN_MENU;
-                        break;
-                    default: /* Unknown option */
-                        current_state = STATE_MAIN_MENU;
-                        xQueueSend(queue_print, &MSG_INVALID, portMAX_DELAY);
-                        break;
-                    }
-                } else {
-                    /* Multi-char input invalid at RTC menu level */
-                    current_state = STATE_MAIN_MENU;
-                    xQueueSend(queue_print, &MSG_INVALID, portMAX_DELAY);
-                }
-                break;
-
-            /* ----------------------------------------------------------
-             *  TIME CONFIG: Collect hours -> minutes -> seconds -> AM/PM
-             * ---------------------------------------------------------- */
-            case STATE_RTC_TIME_CONFIG:
-                switch (rtc_sub_step) {
-                case RTC_TIME_STEP_HOUR:
-                    new_time.Hours = ascii_to_number(cmd->payload, cmd->length);
-                    rtc_sub_step = RTC_TIME_STEP_MINUTE;
-                    xQueueSend(queue_print, &msg_enter_minute, portMAX_DELAY);
-                    break;
-
-                case RTC_TIME_STEP_MINUTE:
-                    new_time.Minutes = ascii_to_number(cmd->payload, cmd->length);
-                    rtc_sub_step = RTC_TIME_STEP_SECOND;
-                    xQueueSend(queue_print, &msg_enter_second, portMAX_DELAY);
-                    break;
-
-                case RTC_TIME_STEP_SECOND:
-                    new_time.Seconds = ascii_to_number(cmd->payload, cmd->length);
-                    rtc_sub_step = RTC_TIME_STEP_AMPM;
-                    xQueueSend(queue_print, &msg_enter_ampm, portMAX_DELAY);
-                    break;
-
-                case RTC_TIME_STEP_AMPM: {
-                    /* User enters 0 for AM, 1 for PM */
-                    uint8_t ampm_val = ascii_to_number(cmd->payload, cmd->length);
-
-                    if (ampm_val == 0) {
-                        new_time.TimeFormat = RTC_HOURFORMAT12_AM;
-                    } else if (ampm_val == 1) {
-                        new_time.TimeFormat = RTC_HOURFORMAT12_PM;
-                    } else {
-                        /* Invalid AM/PM value -- reject everything */
-                        xQueueSend(queue_print, &MSG_INVALID, portMAX_DELAY);
-                        current_state = STATE_MAIN_MENU;
-                        rtc_sub_step = 0;
-                        break;
-                    }
-
-                    /* Validate all time fields, then apply or reject */
-                    if (rtc_validate(&new_time, NULL) == 0) {
-                        rtc_apply_time(&new_time);
-                        xQueueSend(queue_print, &msg_success, portMAX_DELAY);
-                        rtc_show_on_uart();
-                    } else {
-                        xQueueSend(queue_print, &MSG_INVALID, portMAX_DELAY);
-                    }
-
-                    /* Reset sub-step and return to main menu */
-                    current_state = STATE_MAIN_MENU;
-                    rtc_sub_step = 0;
-                    break;
-                }
+    case SIG_CMD:
+        /* No leaf accepted the line: reject it and start over */
+        print_const(MSG_INVALID);
+        return AO_TRAN(me, &MENU_STATES[STATE_MAIN_MENU].base);
 
-                default:
-                    break;
-                }
-                break;
-
-            /* ----------------------------------------------------------
-             *  DATE CONFIG: Collect day -> month -> weekday -> year
-             * ---------------------------------------------------------- */
-            case STATE_RTC_DATE_CONFIG:
-                switch (rtc_sub_step) {
-                case RTC_DATE_STEP_DAY:
-                    new_date.Date = ascii_to_number(cmd->payload, cmd->length);
-                    rtc_sub_step = RTC_DATE_STEP_MONTH;
-                    xQueueSend(queue_print, &msg_enter_month, portMAX_DELAY);
-                    break;
-
-                case RTC_DATE_STEP_MONTH:
-                    new_date.Month = ascii_to_number(cmd->payload, cmd->length);
-                    rtc_sub_step = RTC_DATE_STEP_WEEKDAY;
-                    xQueueSend(queue_print, &msg_enter_weekday, portMAX_DELAY);
-                    break;
-
-                case RTC_DATE_STEP_WEEKDAY:
-                    new_date.WeekDay = ascii_to_number(cmd->payload, cmd->length);
-                    rtc_sub_step = RTC_DATE_STEP_YEAR;
-                    xQueueSend(queue_print, &msg_enter_year, portMAX_DELAY);
-                    break;
-
-                case RTC_DATE_STEP_YEAR:
-                    new_date.Year = ascii_to_number(cmd->payload, cmd->length);
-
-                    /* Validate all four fields, then apply or reject */
-                    if (rtc_validate(NULL, &new_date) == 0) {
-                        rtc_apply_date(&new_date);
-                        xQueueSend(queue_print, &msg_success, portMAX_DELAY);
-                        rtc_show_on_uart();
-                    } else {
-                        xQueueSend(queue_print, &MSG_INVALID, portMAX_DELAY);
-                    }
-
-                    /* Reset sub-step and return to main menu */
-                    current_state = STATE_MAIN_MENU;
-                    rtc_sub_step = 0;
-                    break;
-
-                default:
-                    break;
-                }
-                break;
-
-            /* ----------------------------------------------------------
-             *  REPORT TOGGLE: 'y' starts periodic ITM output, 'n' stops
-             * ---------------------------------------------------------- */
-            case STATE_RTC_REPORT:
-                if (cmd->length == 1) {
-                    if (cmd->payload[0] == 'y') {
-                        /* Start the report timer if not already running */
-                        if (xTimerIsTimerActive(timer_rtc_report) == pdFALSE) {
-                            xTimerStart(timer_rtc_report, portMAX_DELAY);
-                        }
-                    } else if (cmd->payload[0] == 'n') {
-                        /* Stop the report timer */
-                        xTimerStop(timer_rtc_report, portMAX_DELAY);
-                    } else {
-                        xQueueSend(queue_print, &MSG_INVALID, portMAX_DELAY);
-                    }
-                } else {
-                    xQueueSend(queue_print, &MSG_INVALID, portMAX_DELAY);
-                }
-                current_state = STATE_MAIN_MENU;
-                break;
+    default:
+        return AO_HANDLED;
+    }
+}
 
-            default:
-                /* Unknown state -- break out to avoid infinite loop */
-                break;
+/**
+ * @brief  Time-entry composite: fields start from zero on each new entry.
+ */
+static ao_result_t menu_rtc_time(ao_t *me, const ao_state_t *self,
+                                 const ao_event_t *e)
+{
+    (void)me;
+    (void)self;
 
-            } /* end switch(current_state) */
+    if (e->sig == AO_SIG_ENTRY) {
+        memset(&rtc_new_time, 0, sizeof(rtc_new_time));
+        return AO_HANDLED;
+    }
+    return AO_UNHANDLED;
+}
 
-        } /* end while(current_state != STATE_MAIN_MENU) */
+/**
+ * @brief  Date-entry composite: fields start from zero on each new entry.
+ */
+static ao_result_t menu_rtc_date(ao_t *me, const ao_state_t *self,
+                                 const ao_event_t *e)
+{
+    (void)me;
+    (void)self;
 
-        /* Hand control back to the main menu task */
-        xTaskNotify(task_handle_menu, 0, eNoAction);
+    if (e->sig == AO_SIG_ENTRY) {
+        memset(&rtc_new_date, 0, sizeof(rtc_new_date));
+        return AO_HANDLED;
     }
+    return AO_UNHANDLED;
 }
 
 /**
- * @brief  UART print task.
- *
- *         Blocks on queue_print waiting for string pointers.  When a pointer
- *         arrives it transmits the entire string over USART2 using blocking
- *         HAL_UART_Transmit.
- *
- * @param  param  (unused)
+ * @brief  Shared handler of every leaf state: prompt on entry, then run
+ *         command lines through the command table.
  */
-static void task_print(void *param)
+static ao_result_t menu_leaf(ao_t *me, const ao_state_t *self,
+                             const ao_event_t *e)
 {
-    (void)param;
-    uint32_t *msg;
+    const menu_state_t *st = (const menu_state_t *)self;
+    const cmd_entry_t  *row;
 
-    for (;;) {
-        /* Wait indefinitely for a string pointer from any task */
-        xQueueReceive(queue_print, &msg, portMAX_DELAY);
+    switch (e->sig) {
+    case AO_SIG_ENTRY:
+        if (st->prompt != NULL) {
+            print_const(st->prompt);
+        }
+        if (st->on_enter != NULL) {
+            st->on_enter();
+        }
+        return AO_HANDLED;
+
+    case SIG_CMD: {
+#if APP_BENCH_CMD_DISPATCH
+        uint32_t bench_start = dwt_cycles_now();
+        uint32_t bench_lookup;
+#endif
+        row = cmd_lookup(&app_cmd_table, (uint8_t)st->id, e->data, e->len);
+#if APP_BENCH_CMD_DISPATCH
+        bench_lookup = dwt_cycles_since(bench_start);
+#endif
+        if (row != NULL && row->handler != NULL) {
+            row->handler(e->data, e->len);
+        }
+#if APP_BENCH_CMD_DISPATCH
+        app_bench_cmd_dispatch(bench_lookup, dwt_cycles_since(bench_start));
+#endif
+        app_bench_ao_command();
 
-        /* Transmit the null-terminated string over UART (blocking) */
-        HAL_UART_Transmit(&huart2,
-                          (uint8_t *)msg,
-                          strlen((char *)msg),
-                          HAL_MAX_DELAY);
+        if (row == NULL) {
+            return AO_UNHANDLED;   /* S_MENU_TOP rejects it                  */
+        }
+        return AO_TRAN(me, &MENU_STATES[row->next].base);
+    }
+
+    default:
+        return AO_UNHANDLED;
     }
 }
 
 /**
- * @brief  Command handler task.
+ * @brief  ISR side of the receive path: wake menu_ao to drain new bytes.
+ *         Posts at most one SIG_RX_READY until the AO has picked it up,
+ *         so a fast burst cannot fill the event queue.
+ * @param  woken  Accumulates the "higher priority task woken" flag.
+ */
+static void menu_rx_notify_from_isr(BaseType_t *woken)
+{
+    if (rx_post_pending == 0U &&
+        ao_post_from_isr(&menu_ao, &EVT_RX_READY, woken) == pdTRUE) {
+        rx_post_pending = 1;
+    }
+}
+
+/* =========================================================================
+ *  FREERTOS TASKS
+ * ========================================================================= */
+
+/**
+ * @brief  UART print task.
  *
- *         Woken by the UART ISR when '\n' is received.  Drains the raw
- *         byte queue (queue_uart_rx) into a uart_command_t struct, then
- *         routes it to the correct task based on current_state.
+ *         Blocks on queue_print waiting for message handles.  When one
+ *         arrives its text is copied into the DMA transmit ring, the block
+ *         is released back to the pool and the task goes straight back to
+ *         the queue; DMA drains the ring in the background.  The task
+ *         sleeps on a transfer-complete notification only if the ring is
+ *         full.
  *
- *         The command struct pointer is passed as the notification value
- *         so the receiving task can read the payload directly.
+ *         With APP_UART_TX_DMA = 0 it falls back to blocking
+ *         HAL_UART_Transmit, spinning on TXE for every byte.
  *
  * @param  param  (unused)
  */
-static void task_cmd_handler(void *param)
+static void task_print(void *param)
 {
     (void)param;
-
-    BaseType_t     notify_result;
-    uart_command_t cmd;                      /* Reused each iteration         */
+    msg_t *msg;
 
     for (;;) {
-        /* Block until the UART ISR signals that '\n' was received */
-        notify_result = xTaskNotifyWait(0, 0, NULL, portMAX_DELAY);
+        /* Wait indefinitely for a message handle from any task */
+        xQueueReceive(queue_print, &msg, portMAX_DELAY);
 
-        if (notify_result != pdTRUE) {
-            continue;              /* Spurious wake -- go back to sleep       */
-        }
+        size_t len = msg->len;
+#if APP_BENCH_UART_TX
+        uint32_t bench_start = dwt_cycles_now();
+#endif
 
-        /* Verify that bytes are actually waiting in the queue */
-        if (uxQueueMessagesWaiting(queue_uart_rx) == 0) {
-            continue;              /* Empty queue -- nothing to parse         */
-        }
+#if APP_UART_TX_DMA
+        /* Queue the string for DMA; returns once it is in the ring */
+        uart_dma_tx_write(msg->text, len, portMAX_DELAY);
+#else
+        /* Transmit the message text over UART (blocking) */
+        HAL_UART_Transmit(&huart2,
+                          (const uint8_t *)msg->text,
+                          len,
+                          HAL_MAX_DELAY);
+#endif
 
-        /* Drain bytes from the queue until we hit the newline delimiter */
-        uint8_t    byte;
-        uint8_t    index = 0;
-        BaseType_t status;
+#if APP_BENCH_UART_TX
+        app_bench_uart_tx_task(len, dwt_cycles_since(bench_start));
+#endif
 
-        do {
-            status = xQueueReceive(queue_uart_rx, &byte, 0);
-            if (status == pdTRUE) {
-                cmd.payload[index++] = byte;
-            }
-        } while (byte != '\n' && index < sizeof(cmd.payload));
-
-        /* Replace trailing '\n' with null terminator */
-        cmd.payload[index - 1] = '\0';
-        cmd.length = index - 1;   /* Length excludes the null terminator     */
-
-        /* Route the command to whichever task is currently active */
-        switch (current_state) {
-
-        case STATE_MAIN_MENU:
-            xTaskNotify(task_handle_menu,
-                        (uint32_t)&cmd,
-                        eSetValueWithOverwrite);
-            break;
-
-        case STATE_LED_EFFECT:
-            xTaskNotify(task_handle_led,
-                        (uint32_t)&cmd,
-                        eSetValueWithOverwrite);
-            break;
-
-        case STATE_RTC_MENU:       /* All RTC sub-states route to rtc task   */
-        case STATE_RTC_TIME_CONFIG:
-        case STATE_RTC_DATE_CONFIG:
-        case STATE_RTC_REPORT:
-            xTaskNotify(task_handle_rtc,
-                        (uint32_t)&cmd,
-                        eSetValueWithOverwrite);
-            break;
-        }
+        /* Text is in the ring (or sent) -- the block can be reused */
+        msg_release(msg);
     }
 }
 
@@ -941,71 +1297,121 @@ int main(void)
 
     /* Initialise all configured peripherals */
     MX_GPIO_Init();                /* LEDs on PD12-PD15, user button, etc.    */
+    MX_DMA_Init();                 /* DMA1 clock + stream IRQs (before UART)  */
     MX_RTC_Init();                 /* Real-time clock in 12-hour mode         */
-    MX_USART2_UART_Init();        /* UART2 at 115200 baud, 8N1               */
+    MX_USART2_UART_Init();        /* UART2 at APP_UART_BAUDRATE, 8N1         */
+#if APP_LED_PWM
+    MX_TIM4_Init();                /* PWM on PD12-PD15, frames via DMA        */
+#endif
 
     /* USER CODE BEGIN 2 */
     BaseType_t status;
 
-    /* ----- Create FreeRTOS tasks ----------------------------------------- */
-    /*  xTaskCreate( function,      name,         stack, param, prio, handle )
-     *               |              |             |words  |      |     |
-     *           entry point    debug label    RAM alloc  arg  level  ID     */
-
-    status = xTaskCreate(task_main_menu,   "menu_task",  250, NULL, 2,
-                         &task_handle_menu);
-    configASSERT(status == pdPASS);        /* Halt if creation failed         */
+    /* Heap regions before the first create (no-op unless APP_CCM_RAM).     */
+    ccm_ram_heap_init();
 
-    status = xTaskCreate(task_cmd_handler, "cmd_task",   250, NULL, 2,
-                         &task_handle_cmd);
-    configASSERT(status == pdPASS);
+#if APP_RTC_CACHE
+    /* 1 Hz wakeup interrupt keeps a decoded time/date snapshot current.     */
+    rtc_cache_init(&hrtc);
+#endif
 
-    status = xTaskCreate(task_print,       "print_task", 250, NULL, 2,
-                         &task_handle_print);
-    configASSERT(status == pdPASS);
+    /* ----- Create FreeRTOS tasks ----------------------------------------- */
+    /*  STATIC_TASK_CREATE( storage,   function,   name,   param, prio, handle )
+     *                      |          |           |        |      |     |
+     *          STATIC_TASK() above  entry point  label    arg  level  ID     */
 
-    status = xTaskCreate(task_led_effect,  "led_task",   250, NULL, 2,
-                         &task_handle_led);
-    configASSERT(status == pdPASS);
+    status = STATIC_TASK_CREATE(print_task, task_print, "print_task", NULL, 2,
+                                &task_handle_print);
+    configASSERT(status == pdPASS);        /* Halt if creation failed         */
 
-    status = xTaskCreate(task_rtc_config,  "rtc_task",   250, NULL, 2,
-                         &task_handle_rtc);
-    configASSERT(status == pdPASS);
+    /* The whole menu -- line assembly, main menu, LED panel and RTC
+     * dialogue -- is one active object: one task, one event queue.      */
+    ao_start(&menu_ao, "menu_ao", &MENU_STATES[STATE_MAIN_MENU].base,
+             AO_MEM(menu_ao), 2);
 
     /* ----- Create queues ------------------------------------------------- */
 
+#if !APP_UART_RX_DMA
     /* Raw byte queue: UART ISR enqueues one char at a time (max 10 bytes)   */
-    queue_uart_rx = xQueueCreate(10, sizeof(char));
+    queue_uart_rx = STATIC_QUEUE_CREATE(queue_uart_rx);
     configASSERT(queue_uart_rx != NULL);
-
-    /* Print queue: tasks enqueue pointers to null-terminated strings        */
-    queue_print = xQueueCreate(10, sizeof(size_t));
+#if APP_QUEUE_FAST_COPY
+    (void)xQueueEnableFastCopy(queue_uart_rx);
+#endif
+#endif
+
+    /* Print queue: tasks enqueue msg_t handles from the message pool        */
+    msg_pool_init();
+    queue_print = STATIC_QUEUE_CREATE(queue_print);
     configASSERT(queue_print != NULL);
+#if APP_QUEUE_FAST_COPY
+    /* msg_t pointers: one word store per message on the target            */
+    (void)xQueueEnableFastCopy(queue_print);
+#endif
 
     /* ----- Create software timers ---------------------------------------- */
 
-    /* Four LED effect timers -- each fires every 500 ms, auto-reload.
-     * Timer ID (1-4) tells the callback which blink pattern to use.         */
-    for (int i = 0; i < LED_COUNT; i++) {
-        timer_led[i] = xTimerCreate(
-            "led_timer",                      /* Debug name                   */
-            pdMS_TO_TICKS(500),               /* Period: 500 ms               */
-            pdTRUE,                           /* Auto-reload (repeating)      */
-            (void *)(i + 1),                  /* Timer ID = effect number 1-4 */
-            callback_led_effect);             /* Callback function            */
-    }
+#if APP_LED_PWM
+    /* LED effects play from TIM4 + DMA; no LED timers needed.               */
+    led_pwm_init(&htim4);
+#else
+    /* One sequencer timer plays every effect, re-armed per step.            */
+    led_seq_init();
+#endif
 
     /* RTC report timer -- fires every 1000 ms, prints time via ITM.         */
-    timer_rtc_report = xTimerCreate(
+    timer_rtc_report = STATIC_TIMER_CREATE(
+        timer_rtc_report,                     /* STATIC_TIMER() storage       */
         "rtc_report",                         /* Debug name                   */
         pdMS_TO_TICKS(1000),                  /* Period: 1 second             */
         pdTRUE,                               /* Auto-reload (repeating)      */
         NULL,                                 /* Timer ID: not needed         */
         callback_rtc_report);                 /* Callback function            */
 
-    /* ----- Start UART receive interrupt ---------------------------------- */
+    /* ----- ITM output drain task ----------------------------------------- */
+#if APP_ITM_LOG
+    itm_log_init();
+#endif
+
+    /* ----- Benchmark reporter (no-op unless an APP_BENCH_* is set) ------- */
+    app_bench_init();
+
+    /* ----- Kernel microbenchmarks (no-op unless APP_BENCH_KERNEL) -------- */
+    kernel_bench_init();
+
+    /* ----- Timer scaling benchmark (no-op unless APP_BENCH_TIMERS) ------- */
+    timer_bench_init();
+
+    /* ----- ISR-to-task latency benchmark (no-op unless APP_BENCH_ISR) ---- */
+    isr_bench_init();
+
+    /* ----- Heap latency benchmark (no-op unless APP_BENCH_HEAP) ---------- */
+    heap_bench_init();
+
+    /* ----- CCM RAM benchmark (no-op unless APP_BENCH_CCM) ----------------- */
+    ccm_bench_init();
+
+    /* ----- Task Monitor sampling (no-op unless APP_CPU_STATS) ------------ */
+    cpu_stats_init();
+
+    /* ----- Stack profile reports (no-op unless APP_STACK_PROFILE) -------- */
+    /* Idle priority: samples and prints while the menu has nothing to do.   */
+    status = stack_prof_start(print_stack_prof, tskIDLE_PRIORITY);
+    configASSERT(status == pdPASS);
+
+    /* ----- Start UART transmit engine ------------------------------------ */
+#if APP_UART_TX_DMA
+    uart_dma_tx_init(&huart2);
+#endif
+
+    /* ----- Start UART reception ------------------------------------------ */
+#if APP_UART_RX_DMA
+    /* Circular DMA into a ring; HT/TC/IDLE events feed menu_ao's stream.    */
+    uart_dma_rx_init(&huart2);
+#else
     /* Receive one byte at a time; the ISR callback re-arms itself.          */
     HAL_UART_Receive_IT(&huart2, (uint8_t *)&uart_rx_byte, 1);
+#endif
 
     /* ----- Launch the FreeRTOS scheduler --------------------------------- */
     /* This call never returns if everything is configured correctly.         */
@@ -1088,12 +1494,13 @@ static void MX_RTC_Init(void)
 
 /* =========================================================================
  *  USART2 INITIALISATION
- *  CubeMX generated -- 115200 baud, 8 data bits, no parity, 1 stop bit
+ *  CubeMX generated -- APP_UART_BAUDRATE (115200), 8 data bits, no parity,
+ *  1 stop bit
  * ========================================================================= */
 static void MX_USART2_UART_Init(void)
 {
     huart2.Instance          = USART2;
-    huart2.Init.BaudRate     = 115200;
+    huart2.Init.BaudRate     = APP_UART_BAUDRATE;
     huart2.Init.WordLength   = UART_WORDLENGTH_8B;
     huart2.Init.StopBits     = UART_STOPBITS_1;
     huart2.Init.Parity       = UART_PARITY_NONE;
@@ -1106,6 +1513,66 @@ static void MX_USART2_UART_Init(void)
     }
 }
 
+#if APP_LED_PWM
+/* =========================================================================
+ *  TIM4 INITIALISATION
+ *  PWM mode 1 on CH1-CH4 (PD12-PD15), ARR and CCR preload enabled.
+ *  led_pwm rewrites PSC / ARR / CCRx every period through DMA burst.
+ * ========================================================================= */
+static void MX_TIM4_Init(void)
+{
+    TIM_OC_InitTypeDef sConfigOC = {0};
+
+    htim4.Instance               = TIM4;
+    htim4.Init.Prescaler         = 0;
+    htim4.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    htim4.Init.Period            = 254;   /* 255 brightness steps          */
+    htim4.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    htim4.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+
+    if (HAL_TIM_PWM_Init(&htim4) != HAL_OK) {
+        Error_Handler();
+    }
+
+    sConfigOC.OCMode     = TIM_OCMODE_PWM1;
+    sConfigOC.Pulse      = 0;             /* LEDs off until an effect runs */
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+
+    if (HAL_TIM_PWM_ConfigChannel(&htim4, &sConfigOC, TIM_CHANNEL_1) != HAL_OK ||
+        HAL_TIM_PWM_ConfigChannel(&htim4, &sConfigOC, TIM_CHANNEL_2) != HAL_OK ||
+        HAL_TIM_PWM_ConfigChannel(&htim4, &sConfigOC, TIM_CHANNEL_3) != HAL_OK ||
+        HAL_TIM_PWM_ConfigChannel(&htim4, &sConfigOC, TIM_CHANNEL_4) != HAL_OK) {
+        Error_Handler();
+    }
+
+    HAL_TIM_MspPostInit(&htim4);          /* PD12-PD15 -> AF2 (TIM4)       */
+}
+#endif /* APP_LED_PWM */
+
+/* =========================================================================
+ *  DMA INITIALISATION
+ *  CubeMX generated -- DMA1 clock and stream interrupts.  The streams
+ *  themselves are configured in HAL_UART_MspInit (stm32f4xx_hal_msp.c).
+ *    DMA1 Stream5 / Channel 4 = USART2_RX (circular)
+ *    DMA1 Stream6 / Channel 4 = USART2_TX (normal, one chunk per transfer)
+ *    DMA1 Stream0 / Channel 2 = TIM4_CH1  (circular LED frames, no IRQ --
+ *                               configured in HAL_TIM_PWM_MspInit)
+ * ========================================================================= */
+static void MX_DMA_Init(void)
+{
+    /* DMA controller clock enable */
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    /* DMA1_Stream5_IRQn -- same priority as USART2 (FreeRTOS-safe, >= 5) */
+    HAL_NVIC_SetPriority(DMA1_Stream5_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream5_IRQn);
+
+    /* DMA1_Stream6_IRQn -- same priority as USART2 (FreeRTOS-safe, >= 5) */
+    HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+}
+
 /* =========================================================================
  *  GPIO INITIALISATION
  *  CubeMX generated
@@ -1245,19 +1712,42 @@ static void MX_GPIO_Init(void)
 
 /* USER CODE BEGIN 4 */
 
+#if APP_UART_RX_DMA
+
+/* =========================================================================
+ *  UART RECEIVE EVENT CALLBACK (runs in ISR context)
+ *
+ *  Called by the HAL on DMA half-transfer, transfer-complete and on the
+ *  USART IDLE line.  Size is the DMA write position inside the ring;
+ *  uart_dma copies everything new since the last event into the stream.
+ * ========================================================================= */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    BaseType_t woken = pdFALSE;
+
+    uart_dma_rx_event_isr(huart, Size);
+    if (huart->Instance == USART2) {
+        menu_rx_notify_from_isr(&woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+#else  /* !APP_UART_RX_DMA */
+
 /* =========================================================================
  *  UART RECEIVE COMPLETE CALLBACK (runs in ISR context)
  *
  *  Called by the HAL each time one byte arrives on USART2.
  *  The byte is pushed into queue_uart_rx.  When '\n' is received,
- *  task_cmd_handler is notified to parse the complete line.
+ *  menu_ao is posted SIG_RX_READY to assemble the complete line.
  *
  *  A short software delay provides basic debounce for noisy connections.
  * ========================================================================= */
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
     (void)huart;
-    uint8_t discard;
+    uint8_t    discard;
+    BaseType_t woken = pdFALSE;
 
     /* Brief software delay for debounce (~24 us at 168 MHz) */
     for (volatile uint32_t i = 0; i < 4000; i++);
@@ -1265,22 +1755,89 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
     if (!xQueueIsQueueFullFromISR(queue_uart_rx)) {
         /* Normal case: enqueue the received byte */
         xQueueSendFromISR(queue_uart_rx, (void *)&uart_rx_byte, NULL);
+        app_bench_uart_rx_bytes(1, 0);
     } else {
         /* Queue full: drop the oldest byte to make room, ensuring the
          * final '\n' delimiter is never lost */
         xQueueReceiveFromISR(queue_uart_rx, (void *)&discard, NULL);
         xQueueSendFromISR(queue_uart_rx, (void *)&uart_rx_byte, NULL);
+        app_bench_uart_rx_bytes(1, 1);
     }
 
-    /* If this byte is the newline delimiter, wake cmd_handler_task */
+    /* If this byte is the newline delimiter, wake menu_ao */
     if (uart_rx_byte == '\n') {
-        xTaskNotifyFromISR(task_handle_cmd, 0, eNoAction, NULL);
+        menu_rx_notify_from_isr(&woken);
     }
 
     /* Re-arm the UART to receive the next single byte via interrupt */
     HAL_UART_Receive_IT(&huart2, (uint8_t *)&uart_rx_byte, 1);
+    portYIELD_FROM_ISR(woken);
 }
 
+#endif /* APP_UART_RX_DMA */
+
+#if APP_RTC_CACHE
+
+/* =========================================================================
+ *  RTC WAKEUP CALLBACK (runs in ISR context)
+ *
+ *  Called by the HAL once per calendar second (wakeup timer on ck_spre).
+ *  rtc_cache decodes TR/DR once and publishes the new snapshot.
+ * ========================================================================= */
+void HAL_RTCEx_WakeUpTimerEventCallback(RTC_HandleTypeDef *hrtc)
+{
+    (void)hrtc;
+    rtc_cache_wakeup_isr();
+}
+
+#endif /* APP_RTC_CACHE */
+
+#if APP_UART_TX_DMA
+
+/* =========================================================================
+ *  UART TRANSMIT COMPLETE CALLBACK (runs in ISR context)
+ *
+ *  Called by the HAL when the last byte of a DMA chunk has left the shift
+ *  register.  uart_dma retires the chunk, chains the next one and wakes
+ *  print_task if it was waiting for ring space.
+ * ========================================================================= */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+#if APP_BENCH_UART_TX
+    uint32_t bench_start = dwt_cycles_now();
+#endif
+    uart_dma_tx_complete_isr(huart);
+#if APP_BENCH_UART_TX
+    app_bench_uart_tx_isr(dwt_cycles_since(bench_start));
+#endif
+}
+
+#endif /* APP_UART_TX_DMA */
+
+#if APP_UART_RX_DMA || APP_UART_TX_DMA
+
+/* =========================================================================
+ *  UART ERROR CALLBACK (runs in ISR context)
+ *
+ *  An overrun aborts the receive DMA, and a DMA error aborts the current
+ *  transmit chunk.  Restart whichever side stopped so the link recovers
+ *  without a reset; noise/framing errors leave both running.
+ * ========================================================================= */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance != USART2) {
+        return;
+    }
+#if APP_UART_RX_DMA
+    uart_dma_rx_restart();
+#endif
+#if APP_UART_TX_DMA
+    uart_dma_tx_recover();
+#endif
+}
+
+#endif /* APP_UART_RX_DMA || APP_UART_TX_DMA */
+
 /* USER CODE END 4 */
 
 /**
@@ -0,0 +1,183 @@
+/**
+ ******************************************************************************
+ * @file           : msg_pool.c
+ * @brief          : Fixed-block, reference-counted message pool.
+ *
+ * @description    : Blocks live in one static array and are chained into a
+ *                   singly linked free list.  A counting semaphore mirrors
+ *                   the number of free blocks, so a task can sleep until a
+ *                   block is returned while the list itself is only touched
+ *                   inside short critical sections:
+ *
+ *                     alloc   : take semaphore -> pop free_head
+ *                     release : --refs == 0    -> push free_head -> give
+ *
+ *                   Because the semaphore is taken before the pop, a pop
+ *                   always finds a block; the list never needs a retry loop.
+ ******************************************************************************
+ */
+
+#include "msg_pool.h"
+#include "app_config.h"
+
+#include <string.h>                /* strlen                                 */
+#include "task.h"
+#include "semphr.h"
+#include "static_alloc.h"
+
+/* ========================== Private Data ================================= */
+static msg_t              pool[APP_MSG_POOL_BLOCKS];   /* Block storage       */
+static msg_t             *free_head;                   /* Free-list head      */
+static SemaphoreHandle_t  free_count;                  /* Free blocks         */
+static volatile msg_pool_stats_t stats;
+STATIC_SEMAPHORE(msg_pool);                            /* free_count storage  */
+
+/* ========================== Private Helpers ============================== */
+
+/**
+ * @brief  Pop the free-list head and reset it for a new owner.
+ * @note   Caller holds one count of free_count and is in a critical section.
+ */
+static msg_t *pool_pop(void)
+{
+    msg_t *msg = free_head;
+
+    free_head = msg->next;
+    msg->next = NULL;
+    msg->text = msg->data;
+    msg->len  = 0;
+    msg->refs = 1;
+
+    stats.in_use++;
+    if (stats.in_use > stats.peak) {
+        stats.peak = stats.in_use;
+    }
+    return msg;
+}
+
+/**
+ * @brief  Drop one reference; push the block back when none remain.
+ * @note   Caller is in a critical section.
+ * @return pdTRUE if the block was freed (caller must give free_count).
+ */
+static BaseType_t pool_unref(msg_t *msg)
+{
+    configASSERT(msg->refs != 0U);
+
+    if (--msg->refs != 0U) {
+        return pdFALSE;
+    }
+
+    msg->next = free_head;
+    free_head = msg;
+    stats.in_use--;
+    return pdTRUE;
+}
+
+/* ========================== Public API =================================== */
+
+void msg_pool_init(void)
+{
+    for (uint32_t i = 0; i < APP_MSG_POOL_BLOCKS; i++) {
+        pool[i].next = (i + 1U < APP_MSG_POOL_BLOCKS) ? &pool[i + 1U] : NULL;
+        pool[i].refs = 0;
+    }
+    free_head    = &pool[0];
+    stats.blocks = APP_MSG_POOL_BLOCKS;
+
+    free_count = STATIC_SEMAPHORE_CREATE_COUNTING(msg_pool,
+                                                  APP_MSG_POOL_BLOCKS,
+                                                  APP_MSG_POOL_BLOCKS);
+    configASSERT(free_count != NULL);
+}
+
+msg_t *msg_alloc(TickType_t wait)
+{
+    msg_t *msg;
+
+    if (xSemaphoreTake(free_count, wait) != pdTRUE) {
+        taskENTER_CRITICAL();
+        stats.fails++;
+        taskEXIT_CRITICAL();
+        return NULL;
+    }
+
+    taskENTER_CRITICAL();
+    msg = pool_pop();
+    taskEXIT_CRITICAL();
+    return msg;
+}
+
+msg_t *msg_alloc_from_isr(void)
+{
+    msg_t     *msg = NULL;
+    UBaseType_t saved;
+
+    /* Taking a semaphore never unblocks a task, so no yield is needed */
+    saved = taskENTER_CRITICAL_FROM_ISR();
+    if (xSemaphoreTakeFromISR(free_count, NULL) == pdTRUE) {
+        msg = pool_pop();
+    } else {
+        stats.fails++;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+    return msg;
+}
+
+msg_t *msg_wrap_const(const char *text, TickType_t wait)
+{
+    msg_t *msg = msg_alloc(wait);
+
+    if (msg != NULL) {
+        size_t len = strlen(text);
+
+        configASSERT(len <= UINT16_MAX);
+        msg->text = text;
+        msg->len  = (uint16_t)len;
+    }
+    return msg;
+}
+
+void msg_ref(msg_t *msg)
+{
+    taskENTER_CRITICAL();
+    configASSERT(msg->refs != 0U && msg->refs != UINT8_MAX);
+    msg->refs++;
+    taskEXIT_CRITICAL();
+}
+
+void msg_release(msg_t *msg)
+{
+    BaseType_t freed;
+
+    taskENTER_CRITICAL();
+    freed = pool_unref(msg);
+    taskEXIT_CRITICAL();
+
+    if (freed == pdTRUE) {
+        xSemaphoreGive(free_count);
+    }
+}
+
+void msg_release_from_isr(msg_t *msg)
+{
+    BaseType_t  woken = pdFALSE;
+    BaseType_t  freed;
+    UBaseType_t saved;
+
+    saved = taskENTER_CRITICAL_FROM_ISR();
+    freed = pool_unref(msg);
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+
+    if (freed == pdTRUE) {
+        xSemaphoreGiveFromISR(free_count, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+void msg_pool_get_stats(msg_pool_stats_t *out)
+{
+    taskENTER_CRITICAL();
+    *out = stats;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,177 @@
+/**
+ ******************************************************************************
+ * @file           : rtc_cache.c
+ * @brief          : Cached RTC time/date, refreshed once per second by the
+ *                   RTC wakeup interrupt, plus fixed-width formatters.
+ *
+ * @description    : Publication is a sequence lock:
+ *
+ *                     writer: seq++ (odd), copy snapshot, seq++ (even)
+ *                     reader: sample seq, copy, retry if seq was odd or
+ *                             has moved since
+ *
+ *                   Writers are the wakeup ISR and rtc_cache_refresh(),
+ *                   which masks that ISR with a critical section, so there
+ *                   is never more than one writer.  A reader that overlaps
+ *                   a refresh retries once; at one refresh per second that
+ *                   is practically never.
+ *
+ *                   CR.BYPSHAD is set, so TR and DR are read straight from
+ *                   the calendar counters.  The shadow registers lag the
+ *                   counters by two RTCCLK cycles (~60 us on LSI) and the
+ *                   wakeup fires on the very same ck_spre edge, so a shadow
+ *                   read here could return the second that just ended.
+ *                   Counter reads are not latched against each other, hence
+ *                   TR is read twice around DR.
+ ******************************************************************************
+ */
+
+#include "rtc_cache.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* ========================== Private Data ================================= */
+static volatile uint32_t cache_seq;        /* Odd while a write is running  */
+static rtc_cache_t       cache;            /* Guarded by cache_seq          */
+static RTC_TypeDef      *rtc_regs;
+
+/* ========================== Private Helpers ============================== */
+
+/* Two BCD digits of a register field to binary */
+#define BCD_FIELD(reg, tens, units)                                           \
+    ((uint8_t)((((reg) & tens##_Msk) >> tens##_Pos) * 10U +                   \
+               (((reg) & units##_Msk) >> units##_Pos)))
+
+/**
+ * @brief  Read TR and DR as one consistent pair and decode them.
+ * @param  snap  Destination.
+ */
+static void cache_sample(rtc_cache_t *snap)
+{
+    uint32_t tr;
+    uint32_t dr;
+
+    /* A second tick between the two TR reads may also have moved DR */
+    do {
+        tr = rtc_regs->TR;
+        dr = rtc_regs->DR;
+    } while (tr != rtc_regs->TR);
+
+    snap->hours   = BCD_FIELD(tr, RTC_TR_HT,  RTC_TR_HU);
+    snap->minutes = BCD_FIELD(tr, RTC_TR_MNT, RTC_TR_MNU);
+    snap->seconds = BCD_FIELD(tr, RTC_TR_ST,  RTC_TR_SU);
+    snap->pm      = (uint8_t)((tr & RTC_TR_PM_Msk) >> RTC_TR_PM_Pos);
+    snap->day     = BCD_FIELD(dr, RTC_DR_DT,  RTC_DR_DU);
+    snap->month   = BCD_FIELD(dr, RTC_DR_MT,  RTC_DR_MU);
+    snap->weekday = (uint8_t)((dr & RTC_DR_WDU_Msk) >> RTC_DR_WDU_Pos);
+    snap->year    = BCD_FIELD(dr, RTC_DR_YT,  RTC_DR_YU);
+}
+
+/**
+ * @brief  Publish a snapshot.  The caller guarantees a single writer.
+ */
+static void cache_publish(const rtc_cache_t *snap)
+{
+    cache_seq++;                   /* Odd: readers will retry                */
+    __DMB();
+    cache = *snap;
+    __DMB();
+    cache_seq++;                   /* Even: snapshot complete                */
+}
+
+/**
+ * @brief  Two decimal digits, always two characters.
+ */
+static char *put2(char *dst, uint32_t value)
+{
+    uint32_t tens = (value * 205U) >> 11;   /* value / 10 for 0..99         */
+
+    dst[0] = (char)('0' + tens);
+    dst[1] = (char)('0' + (value - tens * 10U));
+    return dst + 2;
+}
+
+/* ========================== Public API =================================== */
+
+void rtc_cache_init(RTC_HandleTypeDef *hrtc)
+{
+    rtc_cache_t snap;
+
+    rtc_regs = hrtc->Instance;
+
+    /* Read the calendar counters directly (see the file header) */
+    __HAL_RTC_WRITEPROTECTION_DISABLE(hrtc);
+    SET_BIT(hrtc->Instance->CR, RTC_CR_BYPSHAD);
+    __HAL_RTC_WRITEPROTECTION_ENABLE(hrtc);
+
+    cache_sample(&snap);
+    cache_publish(&snap);
+
+    /* Counter 0 on ck_spre: one interrupt per calendar second */
+    if (HAL_RTCEx_SetWakeUpTimer_IT(hrtc, 0,
+                                    RTC_WAKEUPCLOCK_CK_SPRE_16BITS) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+void rtc_cache_refresh(void)
+{
+    rtc_cache_t snap;
+
+    /* The wakeup IRQ (priority 6) is masked, so it cannot write as well */
+    taskENTER_CRITICAL();
+    cache_sample(&snap);
+    cache_publish(&snap);
+    taskEXIT_CRITICAL();
+}
+
+void rtc_cache_wakeup_isr(void)
+{
+    rtc_cache_t snap;
+
+    cache_sample(&snap);
+    cache_publish(&snap);
+}
+
+void rtc_cache_read(rtc_cache_t *out)
+{
+    uint32_t seq;
+
+    do {
+        seq = cache_seq;
+        __DMB();
+        *out = cache;
+        __DMB();
+    } while ((seq & 1U) != 0U || seq != cache_seq);
+}
+
+uint32_t rtc_fmt_time(char *dst, const rtc_cache_t *t)
+{
+    char *p = dst;
+
+    p    = put2(p, t->hours);
+    *p++ = ':';
+    p    = put2(p, t->minutes);
+    *p++ = ':';
+    p    = put2(p, t->seconds);
+    *p++ = ' ';
+    *p++ = '[';
+    *p++ = t->pm ? 'P' : 'A';
+    *p++ = 'M';
+    *p++ = ']';
+    return (uint32_t)(p - dst);
+}
+
+uint32_t rtc_fmt_date(char *dst, const rtc_cache_t *t)
+{
+    char *p = dst;
+
+    p    = put2(p, t->month);
+    *p++ = '-';
+    p    = put2(p, t->day);
+    *p++ = '-';
+    *p++ = '2';
+    *p++ = '0';
+    p    = put2(p, t->year);
+    return (uint32_t)(p - dst);
+}
@@ -22,6 +22,10 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "app_bench.h"
+#include "cpu_stats.h"
+#include "dwt_cycles.h"
+#include "isr_bench.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -55,6 +59,9 @@ extern void button_interrupt_handler(void);
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern RTC_HandleTypeDef hrtc;
+extern DMA_HandleTypeDef hdma_usart2_rx;
+extern DMA_HandleTypeDef hdma_usart2_tx;
 extern UART_HandleTypeDef huart2;
 extern TIM_HandleTypeDef htim6;
 
@@ -160,17 +167,95 @@ void DebugMon_Handler(void)
 /* please refer to the startup file (startup_stm32f4xx.s).                    */
 /******************************************************************************/
 
+#if APP_RTC_CACHE
+/**
+  * @brief This function handles RTC wake-up interrupt through EXTI line 22.
+  */
+void RTC_WKUP_IRQHandler(void)
+{
+  /* USER CODE BEGIN RTC_WKUP_IRQn 0 */
+#if APP_CPU_STATS
+  uint32_t cpu_start = dwt_cycles_now();
+#endif
+  /* USER CODE END RTC_WKUP_IRQn 0 */
+  HAL_RTCEx_WakeUpTimerIRQHandler(&hrtc);
+  /* USER CODE BEGIN RTC_WKUP_IRQn 1 */
+#if APP_CPU_STATS
+  cpu_stats_isr(CPU_ISR_RTC_WKUP, dwt_cycles_since(cpu_start));
+#endif
+  /* USER CODE END RTC_WKUP_IRQn 1 */
+}
+#endif
+
+/**
+  * @brief This function handles DMA1 stream5 global interrupt.
+  */
+void DMA1_Stream5_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Stream5_IRQn 0 */
+#if APP_BENCH_UART_RX
+  uint32_t bench_start = dwt_cycles_now();
+#endif
+#if APP_CPU_STATS
+  uint32_t cpu_start = dwt_cycles_now();
+#endif
+  /* USER CODE END DMA1_Stream5_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart2_rx);
+  /* USER CODE BEGIN DMA1_Stream5_IRQn 1 */
+#if APP_BENCH_UART_RX
+  app_bench_uart_rx_isr(dwt_cycles_since(bench_start));
+#endif
+#if APP_CPU_STATS
+  cpu_stats_isr(CPU_ISR_DMA_RX, dwt_cycles_since(cpu_start));
+#endif
+  /* USER CODE END DMA1_Stream5_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 stream6 global interrupt.
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Stream6_IRQn 0 */
+#if APP_BENCH_UART_TX
+  uint32_t bench_start = dwt_cycles_now();
+#endif
+#if APP_CPU_STATS
+  uint32_t cpu_start = dwt_cycles_now();
+#endif
+  /* USER CODE END DMA1_Stream6_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart2_tx);
+  /* USER CODE BEGIN DMA1_Stream6_IRQn 1 */
+#if APP_BENCH_UART_TX
+  app_bench_uart_tx_isr(dwt_cycles_since(bench_start));
+#endif
+#if APP_CPU_STATS
+  cpu_stats_isr(CPU_ISR_DMA_TX, dwt_cycles_since(cpu_start));
+#endif
+  /* USER CODE END DMA1_Stream6_IRQn 1 */
+}
+
 /**
   * @brief This function handles USART2 global interrupt.
   */
 void USART2_IRQHandler(void)
 {
   /* USER CODE BEGIN USART2_IRQn 0 */
-
+#if APP_BENCH_UART_RX
+  uint32_t bench_start = dwt_cycles_now();
+#endif
+#if APP_CPU_STATS
+  uint32_t cpu_start = dwt_cycles_now();
+#endif
   /* USER CODE END USART2_IRQn 0 */
   HAL_UART_IRQHandler(&huart2);
   /* USER CODE BEGIN USART2_IRQn 1 */
-
+#if APP_BENCH_UART_RX
+  app_bench_uart_rx_isr(dwt_cycles_since(bench_start));
+#endif
+#if APP_CPU_STATS
+  cpu_stats_isr(CPU_ISR_USART2, dwt_cycles_since(cpu_start));
+#endif
   /* USER CODE END USART2_IRQn 1 */
 }
 
@@ -189,5 +274,14 @@ void TIM6_DAC_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+#if APP_BENCH_ISR
+/**
+  * @brief This function handles TIM7 global interrupt (isr_bench signal source).
+  */
+void TIM7_IRQHandler(void)
+{
+  isr_bench_timer_irq();
+}
+#endif
 
 /* USER CODE END 1 */
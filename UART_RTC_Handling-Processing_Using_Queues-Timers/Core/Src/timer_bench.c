@@ -0,0 +1,290 @@
+/**
+ ******************************************************************************
+ * @file           : timer_bench.c
+ * @brief          : Software timer scaling benchmark (APP_BENCH_TIMERS).
+ *
+ * @description    : tbench_task grows a population of auto-reload timers
+ *                   from 10 to APP_BENCH_TIMERS_MAX (x10 per row) and
+ *                   prints one row per population:
+ *
+ *                     # timer_bench V11.1.0 backend=list cpu_hz=... ...
+ *                     # timers     start     stop   expire
+ *                     10              ..       ..       ..
+ *                     ...
+ *                     # end
+ *
+ *                   start / stop  median CPU cycles of xTimerStart() /
+ *                                 xTimerStop() on one extra "probe" timer,
+ *                                 minus the cost of reading the counter.
+ *                                 The timer service task outranks
+ *                                 tbench_task, so each sample includes the
+ *                                 command being carried out.  The probe's
+ *                                 period is longer than any other timer's,
+ *                                 which is the sorted list's worst case.
+ *                   expire        timer service task cycles per callback
+ *                                 over TB_WINDOW_MS (run-time stats, so "-"
+ *                                 with APP_CPU_STATS = 0), less what the
+ *                                 demo's own timers cost in the same window
+ *                                 with no benchmark timers running.  It
+ *                                 includes re-filing the auto-reload timer.
+ *
+ *                   Timer i runs every TB_PERIOD_MIN_MS + i ms.  Expiry times
+ *                   are spread out, and the callback rate grows only with
+ *                   the log of the population: 10,000 timers fire about
+ *                   3,000 times a second, which the sorted list can still
+ *                   keep up with.
+ ******************************************************************************
+ */
+
+#include "timer_bench.h"
+#include "app_config.h"
+
+#if APP_BENCH_TIMERS
+
+#include "dwt_cycles.h"
+#include "bench_stats.h"
+
+#include <stdio.h>                 /* printf -> ITM / host stdout            */
+#include <stdlib.h>                /* exit (APP_BENCH_TIMERS_EXIT)           */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#if APP_STATIC_ALLOC
+#error "timer_bench creates its timers at run time: build it with APP_STATIC_ALLOC = 0"
+#endif
+
+/* ========================== Private Defines ============================== */
+#define TB_PRIO_BENCH       ( configMAX_PRIORITIES - 2U )
+#define TB_STACK_WORDS      256U   /* tbench_task: printf + sort             */
+
+#define TB_SAMPLES          64U    /* Start / stop samples per row           */
+#define TB_PERIOD_MIN_MS    500U   /* Period of the first benchmark timer    */
+#define TB_WINDOW_MS        2000U  /* Expiry measurement window             */
+
+/* Longer than every benchmark timer, so a sorted list files it last */
+#define TB_PROBE_MS         ( 2U * ( TB_PERIOD_MIN_MS + APP_BENCH_TIMERS_MAX ) )
+
+/* tbench_task outranks itm_drain, so after each row it sleeps long
+ * enough for the drain task to empty the console FIFO */
+#define TB_ROW_GAP_MS       20U
+
+#if ( configTIMER_TASK_PRIORITY <= ( configMAX_PRIORITIES - 2 ) )
+#error "timer_bench needs the timer service task above tbench_task"
+#endif
+
+/* ========================== Private Data ================================= */
+static TimerHandle_t     tb_timers[APP_BENCH_TIMERS_MAX];
+static uint32_t          tb_count;          /* Benchmark timers running      */
+static TimerHandle_t     tb_probe;
+static uint32_t          tb_start[TB_SAMPLES];
+static uint32_t          tb_stop[TB_SAMPLES];
+static uint32_t          tb_overhead;       /* bench_calibrate(), header     */
+static bench_stats_t     tb_start_stats;
+static bench_stats_t     tb_stop_stats;
+static volatile uint32_t tb_fired;          /* Benchmark callbacks so far    */
+
+/* ========================== Callbacks ==================================== */
+
+static void tb_callback(TimerHandle_t timer)
+{
+    (void)timer;
+    tb_fired++;
+}
+
+static void tb_probe_callback(TimerHandle_t timer)
+{
+    (void)timer;                   /* Stopped long before it could fire      */
+}
+
+/* ========================== Measurement ================================== */
+
+/**
+ * @brief  Create and start benchmark timers until n are running.
+ * @return 1 if all n run, 0 if the heap ran out first.
+ */
+static int tb_grow(uint32_t n)
+{
+    while (tb_count < n) {
+        TickType_t period = pdMS_TO_TICKS(TB_PERIOD_MIN_MS + tb_count);
+        TimerHandle_t timer = xTimerCreate("tb", period, pdTRUE, NULL,
+                                           tb_callback);
+
+        if (timer == NULL) {
+            return 0;
+        }
+        (void)xTimerStart(timer, portMAX_DELAY);
+        tb_timers[tb_count++] = timer;
+    }
+    return 1;
+}
+
+/**
+ * @brief  Time TB_SAMPLES start / stop pairs on the probe timer.
+ */
+static void tb_measure_start_stop(void)
+{
+    for (uint32_t i = 0; i < TB_SAMPLES; i++) {
+        uint32_t start;
+
+        start = dwt_cycles_now();
+        (void)xTimerStart(tb_probe, 0);
+        tb_start[i] = bench_net(dwt_cycles_since(start));
+
+        start = dwt_cycles_now();
+        (void)xTimerStop(tb_probe, 0);
+        tb_stop[i] = bench_net(dwt_cycles_since(start));
+    }
+}
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+/**
+ * @brief  Run-time cycles the timer service task used over TB_WINDOW_MS.
+ *         The service task is blocked whenever tbench_task runs, so its
+ *         counter is up to date when read.
+ * @param  fired  Receives the benchmark callbacks in the window.
+ */
+static uint64_t tb_service_cycles(uint32_t *fired)
+{
+    TaskHandle_t service = xTimerGetTimerDaemonTaskHandle();
+    uint64_t     before  = ulTaskGetRunTimeCounter(service);
+    uint32_t     first   = tb_fired;
+
+    vTaskDelay(pdMS_TO_TICKS(TB_WINDOW_MS));
+
+    *fired = tb_fired - first;
+    return ulTaskGetRunTimeCounter(service) - before;
+}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+
+/* ========================== Report ======================================= */
+
+static void tb_print_header(void)
+{
+    printf("# timer_bench %s backend=%s cpu_hz=%lu tick_hz=%lu "
+           "timer_prio=%lu n=%lu overhead=%lu\n",
+           tskKERNEL_VERSION_NUMBER,
+           (configUSE_TIMER_WHEEL == 1) ? "wheel" : "list",
+           (unsigned long)SystemCoreClock,
+           (unsigned long)configTICK_RATE_HZ,
+           (unsigned long)configTIMER_TASK_PRIORITY,
+           (unsigned long)TB_SAMPLES,
+           (unsigned long)tb_overhead);
+    printf("# %-8s %8s %8s %8s\n", "timers", "start", "stop", "expire");
+}
+
+/**
+ * @brief  Print one row.
+ * @param  expire  Cycles per callback, or UINT32_MAX for "-".
+ */
+static void tb_print_row(uint32_t expire)
+{
+    bench_summarise(&tb_start_stats, tb_start, TB_SAMPLES);
+    bench_summarise(&tb_stop_stats, tb_stop, TB_SAMPLES);
+
+    if (expire == UINT32_MAX) {
+        printf("%-10lu %8lu %8lu %8s\n", (unsigned long)tb_count,
+               (unsigned long)tb_start_stats.med,
+               (unsigned long)tb_stop_stats.med, "-");
+    } else {
+        printf("%-10lu %8lu %8lu %8lu\n", (unsigned long)tb_count,
+               (unsigned long)tb_start_stats.med,
+               (unsigned long)tb_stop_stats.med,
+               (unsigned long)expire);
+    }
+}
+
+/* ========================== Task ========================================= */
+
+/**
+ * @brief  Measure every population, print the table, delete the timers,
+ *         then exit (host build, APP_BENCH_TIMERS_EXIT) or delete itself.
+ * @param  param  (unused)
+ */
+static void tbench_task(void *param)
+{
+    uint32_t size = 10U;
+    uint32_t expire = UINT32_MAX;
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    uint32_t fired;
+    uint64_t background;
+#endif
+
+    (void)param;
+
+    tb_probe = xTimerCreate("tb_probe", pdMS_TO_TICKS(TB_PROBE_MS), pdFALSE,
+                            NULL, tb_probe_callback);
+    configASSERT(tb_probe != NULL);
+
+    /* Let the start-up work of the other tasks finish first */
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    tb_overhead = bench_calibrate();
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    background = tb_service_cycles(&fired);
+#endif
+    tb_print_header();
+
+    for (;;) {
+        uint32_t n = (size < APP_BENCH_TIMERS_MAX) ? size : APP_BENCH_TIMERS_MAX;
+
+        if (!tb_grow(n)) {
+            printf("# heap full at %lu timers\n", (unsigned long)tb_count);
+            break;
+        }
+
+        /* Until the first timers have been re-filed at least once */
+        vTaskDelay(pdMS_TO_TICKS(2U * TB_PERIOD_MIN_MS));
+
+        tb_measure_start_stop();
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+        {
+            uint64_t busy = tb_service_cycles(&fired);
+
+            busy   = (busy > background) ? busy - background : 0U;
+            expire = (fired != 0U) ? (uint32_t)(busy / fired) : UINT32_MAX;
+        }
+#endif
+        tb_print_row(expire);
+        vTaskDelay(pdMS_TO_TICKS(TB_ROW_GAP_MS));
+
+        if (n == APP_BENCH_TIMERS_MAX) {
+            break;
+        }
+        size *= 10U;
+    }
+    printf("# end\n");
+
+#if APP_BENCH_TIMERS_EXIT
+    exit(0);
+#endif
+
+    while (tb_count > 0U) {
+        (void)xTimerDelete(tb_timers[--tb_count], portMAX_DELAY);
+    }
+    (void)xTimerDelete(tb_probe, portMAX_DELAY);
+    vTaskDelete(NULL);
+}
+
+/* ========================== Public API =================================== */
+
+void timer_bench_init(void)
+{
+    BaseType_t status;
+
+    dwt_cycles_init();
+
+    status = xTaskCreate(tbench_task, "tbench_task", TB_STACK_WORDS,
+                         NULL, TB_PRIO_BENCH, NULL);
+    configASSERT(status == pdPASS);
+}
+
+#else  /* !APP_BENCH_TIMERS */
+
+void timer_bench_init(void)
+{
+}
+
+#endif /* APP_BENCH_TIMERS */
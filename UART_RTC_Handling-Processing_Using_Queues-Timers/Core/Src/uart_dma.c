@@ -0,0 +1,335 @@
+/**
+ ******************************************************************************
+ * @file           : uart_dma.c
+ * @brief          : DMA-driven USART2 receive and transmit paths.
+ *
+ * @description    : Receive data flow:
+ *
+ *                   USART2_RX --DMA1 S5 (circular)--> rx_dma_buf[N]
+ *                                                        |
+ *                          HT / TC / IDLE event (ISR)    |  copy new span
+ *                                                        v
+ *                                                 rx_stream (stream buffer)
+ *                                                        |
+ *                                                        v
+ *                                                     menu_ao
+ *
+ *                   The DMA never stops, so no byte is lost between events.
+ *                   rx_last_pos remembers how far the ISR has consumed; on
+ *                   each event the span [rx_last_pos, pos) is pushed into
+ *                   the stream buffer (in two pieces if it wraps).
+ *
+ *                   Transmit data flow:
+ *
+ *                   print_task --memcpy--> tx_ring[N] --DMA1 S6--> USART2_TX
+ *                                             ^                      |
+ *                                             +-- TxCplt ISR: advance tail,
+ *                                                 start next contiguous chunk
+ *
+ *                   tx_head / tx_tail are free-running; (head - tail) is the
+ *                   fill level.  A chunk never crosses the end of the ring,
+ *                   so a wrapped backlog goes out as two transfers.
+ ******************************************************************************
+ */
+
+#include "uart_dma.h"
+#include "app_config.h"
+#include "app_bench.h"
+
+#include <string.h>                /* memcpy                                 */
+#include "task.h"
+#include "semphr.h"
+#include "stream_buffer.h"
+#include "static_alloc.h"
+
+#if APP_UART_RX_DMA
+
+/* ========================== Private Data ================================= */
+static UART_HandleTypeDef   *rx_huart;                       /* Bound UART     */
+static uint8_t               rx_dma_buf[APP_UART_RX_DMA_BUF_SIZE]; /* DMA ring */
+static uint16_t              rx_last_pos;                    /* ISR read index */
+static StreamBufferHandle_t  rx_stream;                      /* ISR -> task    */
+static volatile uart_dma_rx_stats_t rx_stats;
+STATIC_STREAM_BUFFER(uart_rx_stream, APP_UART_RX_STREAM_SIZE);
+
+/* ========================== Private Helpers ============================== */
+
+/**
+ * @brief  Push one contiguous span of the DMA ring into the stream buffer.
+ * @param  data   Start of the span inside rx_dma_buf.
+ * @param  len    Span length in bytes.
+ * @param  woken  Accumulates the "higher priority task woken" flag.
+ */
+static void rx_push_span(const uint8_t *data, size_t len, BaseType_t *woken)
+{
+    size_t sent = xStreamBufferSendFromISR(rx_stream, data, len, woken);
+
+    rx_stats.bytes   += sent;
+    rx_stats.dropped += len - sent;
+    app_bench_uart_rx_bytes(sent, len - sent);
+}
+
+/**
+ * @brief  (Re)start circular reception to idle.  Resets the read index
+ *         because the HAL restarts the DMA at the top of the ring.
+ */
+static void rx_arm(void)
+{
+    rx_last_pos = 0;
+
+    if (HAL_UARTEx_ReceiveToIdle_DMA(rx_huart, rx_dma_buf,
+                                     sizeof(rx_dma_buf)) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+/* ========================== Public API =================================== */
+
+void uart_dma_rx_init(UART_HandleTypeDef *huart)
+{
+    rx_huart  = huart;
+
+    /* Trigger level 1: a blocking reader wakes as soon as any byte is
+     * available.  menu_ao reads with no wait after its SIG_RX_READY.    */
+    rx_stream = STATIC_STREAM_BUFFER_CREATE(uart_rx_stream, 1);
+    configASSERT(rx_stream != NULL);
+
+    rx_arm();
+}
+
+void uart_dma_rx_restart(void)
+{
+    /* Non-blocking errors (noise, framing) leave the DMA running; only a
+     * blocking error (overrun) aborts reception and returns RxState to READY */
+    if (rx_huart->RxState != HAL_UART_STATE_READY) {
+        return;
+    }
+
+    rx_stats.restarts++;
+    rx_arm();
+}
+
+size_t uart_dma_rx_read(uint8_t *dst, size_t max, TickType_t wait)
+{
+    return xStreamBufferReceive(rx_stream, dst, max, wait);
+}
+
+void uart_dma_rx_event_isr(UART_HandleTypeDef *huart, uint16_t pos)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (huart != rx_huart) {
+        return;
+    }
+
+    rx_stats.events++;
+
+    if (pos != rx_last_pos) {
+        if (pos > rx_last_pos) {
+            /* Linear span -- DMA has not wrapped since the last event */
+            rx_push_span(&rx_dma_buf[rx_last_pos], pos - rx_last_pos, &woken);
+        } else {
+            /* Wrapped -- tail of the ring first, then the head */
+            rx_push_span(&rx_dma_buf[rx_last_pos],
+                         sizeof(rx_dma_buf) - rx_last_pos, &woken);
+            rx_push_span(&rx_dma_buf[0], pos, &woken);
+        }
+        /* pos == size on transfer-complete: next span starts at index 0 */
+        rx_last_pos = (pos == sizeof(rx_dma_buf)) ? 0 : pos;
+    }
+
+    portYIELD_FROM_ISR(woken);
+}
+
+void uart_dma_rx_get_stats(uart_dma_rx_stats_t *out)
+{
+    taskENTER_CRITICAL();
+    *out = rx_stats;
+    taskEXIT_CRITICAL();
+}
+
+#endif /* APP_UART_RX_DMA */
+
+#if APP_UART_TX_DMA
+
+#if (APP_UART_TX_RING_SIZE & (APP_UART_TX_RING_SIZE - 1U)) != 0U || \
+    APP_UART_TX_RING_SIZE > 65535U
+#error "APP_UART_TX_RING_SIZE must be a power of two no larger than 65535"
+#endif
+
+#define TX_RING_MASK   (APP_UART_TX_RING_SIZE - 1U)
+
+/* Longest a producer sleeps on a full ring before it looks at the DMA again */
+#define TX_RETRY_TICKS pdMS_TO_TICKS(10)
+
+/* ========================== TX Private Data ============================== */
+static UART_HandleTypeDef   *tx_huart;                       /* Bound UART     */
+static uint8_t               tx_ring[APP_UART_TX_RING_SIZE]; /* DMA source     */
+static volatile uint32_t     tx_head;        /* Free-running write index       */
+static volatile uint32_t     tx_tail;        /* Free-running DMA read index    */
+static volatile uint16_t     tx_inflight;    /* Bytes in current DMA, 0 = idle */
+static TaskHandle_t volatile tx_waiter;      /* Producer sleeping for space    */
+static SemaphoreHandle_t     tx_mutex;       /* One producer in the ring       */
+static volatile uart_dma_tx_stats_t tx_stats;
+STATIC_SEMAPHORE(uart_tx_mutex);
+
+/* ========================== TX Private Helpers =========================== */
+
+/**
+ * @brief  Start a DMA transfer for the oldest contiguous span of the ring,
+ *         unless one is already running or the ring is empty.
+ * @note   Caller must be in a critical section or in the UART/DMA ISR.
+ */
+static void tx_kick(void)
+{
+    uint32_t pending = tx_head - tx_tail;
+    uint32_t offset  = tx_tail & TX_RING_MASK;
+    uint32_t chunk   = APP_UART_TX_RING_SIZE - offset;  /* Up to ring end    */
+
+    if (tx_inflight != 0U || pending == 0U) {
+        return;
+    }
+
+    if (chunk > pending) {
+        chunk = pending;
+    }
+
+    tx_inflight = (uint16_t)chunk;
+
+    if (HAL_UART_Transmit_DMA(tx_huart, &tx_ring[offset],
+                              (uint16_t)chunk) == HAL_OK) {
+        tx_stats.chunks++;
+    } else {
+        /* UART busy: no completion will come for this chunk.  The next
+         * write, a producer waiting for space or the error callback
+         * kicks again */
+        tx_inflight = 0U;
+        tx_stats.start_fails++;
+    }
+}
+
+/* ========================== TX Public API ================================ */
+
+void uart_dma_tx_init(UART_HandleTypeDef *huart)
+{
+    tx_huart = huart;
+
+    tx_mutex = STATIC_SEMAPHORE_CREATE_MUTEX(uart_tx_mutex);
+    configASSERT(tx_mutex != NULL);
+}
+
+size_t uart_dma_tx_write(const void *data, size_t len, TickType_t wait)
+{
+    const uint8_t *src     = data;
+    size_t         written = 0;
+    TimeOut_t      timeout;
+
+    vTaskSetTimeOutState(&timeout);
+
+    if (xSemaphoreTake(tx_mutex, wait) != pdTRUE) {
+        return 0;
+    }
+
+    while (written < len) {
+        uint32_t space;
+
+        /* Sample free space and register as waiter atomically, so a
+         * completion that frees space right now cannot be missed */
+        taskENTER_CRITICAL();
+        space = APP_UART_TX_RING_SIZE - (tx_head - tx_tail);
+        if (space == 0U) {
+            tx_waiter = xTaskGetCurrentTaskHandle();
+        }
+        taskEXIT_CRITICAL();
+
+        if (space == 0U) {
+            tx_stats.waits++;
+            if (xTaskCheckForTimeOut(&timeout, &wait) == pdTRUE) {
+                tx_waiter = NULL;
+                break;             /* Timed out with the ring still full     */
+            }
+            /* Sleep until a transfer-complete interrupt frees space.  If
+             * the last start was refused none will come, so wake now and
+             * then and start the DMA from here */
+            ulTaskNotifyTakeIndexed(UART_DMA_TX_NOTIFY_INDEX, pdTRUE,
+                                    (wait < TX_RETRY_TICKS) ? wait
+                                                            : TX_RETRY_TICKS);
+            tx_waiter = NULL;
+
+            taskENTER_CRITICAL();
+            tx_kick();
+            taskEXIT_CRITICAL();
+            continue;
+        }
+
+        /* Copy as much as fits, in up to two pieces around the ring end */
+        uint32_t count  = (len - written < space) ? (uint32_t)(len - written)
+                                                  : space;
+        uint32_t offset = tx_head & TX_RING_MASK;
+        uint32_t first  = APP_UART_TX_RING_SIZE - offset;
+
+        if (first > count) {
+            first = count;
+        }
+        memcpy(&tx_ring[offset], &src[written], first);
+        memcpy(&tx_ring[0], &src[written + first], count - first);
+
+        /* Publish the bytes and start the DMA if it is idle */
+        taskENTER_CRITICAL();
+        tx_head += count;
+        if (tx_head - tx_tail > tx_stats.peak) {
+            tx_stats.peak = tx_head - tx_tail;
+        }
+        tx_kick();
+        taskEXIT_CRITICAL();
+
+        written += count;
+    }
+
+    xSemaphoreGive(tx_mutex);
+    return written;
+}
+
+void uart_dma_tx_complete_isr(UART_HandleTypeDef *huart)
+{
+    BaseType_t   woken = pdFALSE;
+    TaskHandle_t waiter;
+
+    if (huart != tx_huart) {
+        return;
+    }
+
+    /* Retire the finished chunk and chain the next one immediately */
+    tx_tail        += tx_inflight;
+    tx_stats.bytes += tx_inflight;
+    tx_inflight     = 0U;
+    tx_kick();
+
+    /* Space was freed -- wake a producer blocked on a full ring */
+    waiter = tx_waiter;
+    if (waiter != NULL) {
+        vTaskNotifyGiveIndexedFromISR(waiter, UART_DMA_TX_NOTIFY_INDEX, &woken);
+    }
+
+    portYIELD_FROM_ISR(woken);
+}
+
+void uart_dma_tx_recover(void)
+{
+    /* A DMA error ends the transfer with gState back at READY; resend the
+     * aborted chunk from the unchanged tail.  With nothing in flight this
+     * starts bytes whose earlier start was refused */
+    if (tx_huart->gState == HAL_UART_STATE_READY) {
+        tx_inflight = 0U;
+        tx_kick();
+    }
+}
+
+void uart_dma_tx_get_stats(uart_dma_tx_stats_t *out)
+{
+    taskENTER_CRITICAL();
+    *out = tx_stats;
+    taskEXIT_CRITICAL();
+}
+
+#endif /* APP_UART_TX_DMA */
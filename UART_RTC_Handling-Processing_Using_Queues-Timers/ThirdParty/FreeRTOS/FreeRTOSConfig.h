@@ -26,6 +26,11 @@
 extern uint32_t SystemCoreClock;
 #endif
 
+/* Application feature switches (APP_*) that some settings below follow */
+#include "app_config.h"
+/* Stack size of every task in words (Host/Tools/stack_size.py writes it) */
+#include "stack_sizes.h"
+
 /* ============================================================
  *  SECTION 1 — SCHEDULER
  * ============================================================ */
@@ -56,10 +61,18 @@ extern uint32_t SystemCoreClock;
  *  SECTION 3 — TASK PRIORITIES
  * ============================================================ */
 
-/* Total number of priority levels available — gives you levels 0, 1, 2, 3, 4
- Level 0 is reserved for the FreeRTOS Idle task, your tasks use levels 1 to 4
- Do not set this larger than needed — each extra level wastes a small amount of RAM */
-#define configMAX_PRIORITIES                    ( 5 )
+/* Total number of priority levels available — gives you levels 0 to 31
+ Level 0 is reserved for the FreeRTOS Idle task, your tasks use levels 1 to 31
+ Each level costs one 20-byte ready list (640 bytes for 32); with the optimised
+ selection below, picking the next task costs the same at any level count */
+#define configMAX_PRIORITIES                    ( 32 )
+
+/* 1 = The port keeps one "ready" bit per priority and finds the highest set bit
+     with a single CLZ instruction (Cortex-M4; __builtin_clz on the host port),
+     so a context switch costs the same for 2 or 32 priorities in use
+ 0 = Generic C: scan the ready lists down one priority at a time
+ The port's portmacro.h rejects 1 with more than 32 priorities at compile time */
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
 
 /* ============================================================
  *  SECTION 4 — MEMORY (STACK AND HEAP)
@@ -67,14 +80,40 @@ extern uint32_t SystemCoreClock;
 
 /* Minimum stack size for any task, measured in WORDS not bytes
  On STM32 (32-bit CPU): 1 word = 4 bytes, so 128 words = 512 bytes
- This is the bare minimum — give your own tasks 256 or 512 words each */
-#define configMINIMAL_STACK_SIZE                ( ( unsigned short ) 128 )
+ This is also the idle task's stack — give your own tasks 256 or 512 words each
+ Set by STACK_WORDS_IDLE_TASK in stack_sizes.h */
+#define configMINIMAL_STACK_SIZE                ( ( unsigned short ) STACK_WORDS_IDLE_TASK )
 
 /* Total RAM pool given to FreeRTOS for tasks, queues, semaphores and timers
  STM32F4 has 192 KB RAM total — starting with 50 KB for FreeRTOS is safe
  If you get a malloc failed error or crash at startup → increase this number */
 #define configTOTAL_HEAP_SIZE                   ( ( size_t ) ( 50 * 1024 ) )
 
+/* Which of the two allocators in portable/MemMang is compiled
+ 0 = heap_4: first fit, malloc/free walk the free list
+ 1 = heap_tlsf: two-level segregated fit, malloc/free take constant time
+     however fragmented the heap gets (~400 bytes of list heads)
+ Set by APP_HEAP_TLSF in app_config.h */
+#define configUSE_HEAP_TLSF                     APP_HEAP_TLSF
+
+/* How the heap above is laid out
+ 0 = One array in main SRAM (heap_4 or heap_tlsf)
+ 1 = heap_5: APP_CCM_HEAP_SIZE bytes of it in the 64 KB CCM RAM, the rest
+     in main SRAM, first fit from the CCM end so task stacks and TCBs go
+     there first.  CCM is CPU only: nothing from pvPortMalloc() may be
+     given to DMA.  Set by APP_CCM_RAM in app_config.h */
+#define configUSE_HEAP_5                        APP_CCM_RAM
+
+/* Where the kernel objects' memory comes from
+ Static = xTaskCreateStatic() and friends with storage the application
+          declares (static_alloc.h), plus the idle and timer task memory
+          callbacks in main.c
+ Dynamic = pvPortMalloc() from the heap above
+ APP_STATIC_ALLOC = 1 builds static only: no heap is linked and
+ configTOTAL_HEAP_SIZE is unused.  Set by APP_STATIC_ALLOC in app_config.h */
+#define configSUPPORT_STATIC_ALLOCATION         APP_STATIC_ALLOC
+#define configSUPPORT_DYNAMIC_ALLOCATION        ( !APP_STATIC_ALLOC )
+
 /* ============================================================
  *  SECTION 5 — TASK SETTINGS
  * ============================================================ */
@@ -91,6 +130,11 @@ extern uint32_t SystemCoreClock;
  Prevents Idle task from wasting CPU time — always keep this as 1 */
 #define configIDLE_SHOULD_YIELD                 1
 
+/* Number of independent notification slots per task (index 0, 1, ...)
+ Index 0 is left to the default xTaskNotify API; index 1 is used by the
+ UART DMA transmit engine to wake a producer when the TX ring has space */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2
+
 /* ============================================================
  *  SECTION 6 — FREERTOS FEATURES SWITCH ON OR OFF
  * ============================================================ */
@@ -125,10 +169,29 @@ extern uint32_t SystemCoreClock;
  10 slots is more than enough for beginner projects */
 #define configTIMER_QUEUE_LENGTH                10
 
+/* How the timer service task keeps the timers that are running (timers.c)
+ 0 = One sorted list, the stock kernel: starting a timer walks the list to
+     find its place, so it gets slower as more timers run
+ 1 = Timing wheel: start, stop and expire take the same time with 10 or
+     10,000 timers running, for ~3.2 KB of extra RAM
+ Set by APP_TIMER_WHEEL in app_config.h */
+#define configUSE_TIMER_WHEEL                   APP_TIMER_WHEEL
+
 /* Stack size in WORDS for the timer service task
- MINIMAL_STACK_SIZE x 2 = 256 words = 1024 bytes, enough for simple callbacks
- Increase this if your timer callbacks use sprintf, floating point, or call many functions */
-#define configTIMER_TASK_STACK_DEPTH            ( configMINIMAL_STACK_SIZE * 2 )
+ 256 words = 1024 bytes to start with, enough for simple callbacks
+ Increase this if your timer callbacks use sprintf, floating point, or call many functions
+ Set by STACK_WORDS_TIMER_TASK in stack_sizes.h */
+#define configTIMER_TASK_STACK_DEPTH            STACK_WORDS_TIMER_TASK
+
+/* Typed 1, 2 and 4 byte item copies for the queues that ask for them with
+ xQueueEnableFastCopy() (queue.c); the others keep memcpy()
+ Set by APP_QUEUE_FAST_COPY in app_config.h */
+#define configUSE_QUEUE_FAST_COPY               APP_QUEUE_FAST_COPY
+
+/* xQueueSendMultiple() / xQueueReceiveMultiple(): move a run of items under
+ one critical section (queue.c)
+ Set by APP_QUEUE_BATCH in app_config.h */
+#define configUSE_QUEUE_BATCH                   APP_QUEUE_BATCH
 
 /* Enable the trace facility so debugger tools can inspect task states and timing
  Required by FreeRTOS+Trace and Segger SystemView — almost no runtime overhead
@@ -154,6 +217,11 @@ extern uint32_t SystemCoreClock;
  You must write this function — keep at 2 during all development and testing */
 #define configCHECK_FOR_STACK_OVERFLOW          2
 
+/* 1 = Keep the top address of each stack in its TCB, so that
+ uxTaskGetSystemState() reports stack sizes to the stack profiler (stack_prof.c)
+ Set by APP_STACK_PROFILE in app_config.h */
+#define configRECORD_STACK_HIGH_ADDRESS         APP_STACK_PROFILE
+
 /* ============================================================
  *  SECTION 8 — HOOKS YOU DO NOT NEED YET — LEAVE ALL OFF
  * ============================================================ */
@@ -168,9 +236,10 @@ extern uint32_t SystemCoreClock;
 #define configUSE_TICK_HOOK                     0
 
 /* Run-time statistics — measures how much CPU time each task consumes
- Requires a separate high-speed hardware timer to work correctly
- leave OFF (0) until you are comfortable with FreeRTOS */
-#define configGENERATE_RUN_TIME_STATS           0
+ Requires a counter much faster than the tick: this project uses the DWT cycle
+ counter (168 counts per microsecond), see RUN-TIME STATS CLOCK at the end
+ Switched by APP_CPU_STATS in app_config.h together with the Task Monitor page */
+#define configGENERATE_RUN_TIME_STATS           APP_CPU_STATS
 
 /* Application task tags — attach a custom integer value to any task for your own use
  Rarely needed in normal projects — leave OFF (0) */
@@ -308,6 +377,44 @@ extern uint32_t SystemCoreClock;
 /* SysTick interrupt — fires every 1 ms or whatever you set configTICK_RATE_HZ to and drives the FreeRTOS internal tick counter */
 #define xPortSysTickHandler SysTick_Handler
 
+/* ============================================================
+ *  APPLICATION TRACE HOOKS
+ * ============================================================ */
+
+/* APP_BENCH_AO counts context switches to report switches per command.
+ APP_BENCH_KERNEL times vTaskSwitchContext: SWITCHED_OUT runs before the
+ stack check and task selection, SWITCHED_IN right after */
+#if APP_BENCH_AO
+extern volatile uint32_t app_bench_switches;
+#endif
+#if APP_BENCH_KERNEL
+void kernel_bench_switch_out(void);
+void kernel_bench_switch_in(void);
+#define traceTASK_SWITCHED_OUT()    kernel_bench_switch_out()
+#endif
+
+#if APP_BENCH_AO && APP_BENCH_KERNEL
+#define traceTASK_SWITCHED_IN()     do { app_bench_switches++; kernel_bench_switch_in(); } while (0)
+#elif APP_BENCH_AO
+#define traceTASK_SWITCHED_IN()     ( app_bench_switches++ )
+#elif APP_BENCH_KERNEL
+#define traceTASK_SWITCHED_IN()     kernel_bench_switch_in()
+#endif
+
+/* ============================================================
+ *  RUN-TIME STATS CLOCK
+ * ============================================================ */
+
+/* The DWT cycle counter wraps every ~25 s at 168 MHz, so cpu_stats.c widens
+ it to 64 bits and the kernel keeps each task's total in a 64-bit counter */
+#if configGENERATE_RUN_TIME_STATS
+void     cpu_stats_clock_start(void);
+uint64_t cpu_stats_clock(void);
+#define configRUN_TIME_COUNTER_TYPE                 uint64_t
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    cpu_stats_clock_start()
+#define portGET_RUN_TIME_COUNTER_VALUE()            cpu_stats_clock()
+#endif
+
 /*  include fot SEGGER SystemView FreeRTOS patch header for real-time task tracing */
 //#include "SEGGER_SYSVIEW_FreeRTOS.h"
 #endif /* FREERTOS_CONFIG_H */
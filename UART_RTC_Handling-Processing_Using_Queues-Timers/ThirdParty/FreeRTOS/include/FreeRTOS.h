@@ -2719,6 +2719,25 @@
     #define configUSE_QUEUE_SETS    0
 #endif
 
+/* Set configUSE_QUEUE_FAST_COPY to 1 to compile typed 1, 2 and 4 byte item
+ * copies into queue.c.  A queue uses them once xQueueEnableFastCopy() has
+ * been called on it; every other queue keeps the memcpy() path. */
+#ifndef configUSE_QUEUE_FAST_COPY
+    #define configUSE_QUEUE_FAST_COPY    0
+#endif
+
+/* Set configUSE_HEAP_TLSF to 1 to build portable/MemMang/heap_tlsf.c in
+ * place of heap_4.c, when both are in the build. */
+#ifndef configUSE_HEAP_TLSF
+    #define configUSE_HEAP_TLSF    0
+#endif
+
+/* Set configUSE_QUEUE_BATCH to 1 to compile xQueueSendMultiple(),
+ * xQueueReceiveMultiple() and their FromISR versions into queue.c. */
+#ifndef configUSE_QUEUE_BATCH
+    #define configUSE_QUEUE_BATCH    0
+#endif
+
 #ifndef portTASK_USES_FLOATING_POINT
     #define portTASK_USES_FLOATING_POINT()
 #endif
@@ -3228,6 +3247,10 @@ typedef struct xSTATIC_QUEUE
         uint8_t ucDummy6;
     #endif
 
+    #if ( configUSE_QUEUE_FAST_COPY == 1 )
+        uint8_t ucDummy10;
+    #endif
+
     #if ( configUSE_QUEUE_SETS == 1 )
         void * pvDummy7;
     #endif
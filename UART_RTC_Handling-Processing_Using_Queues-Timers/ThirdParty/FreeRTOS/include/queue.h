@@ -1595,6 +1595,59 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
     const char * pcQueueGetName( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
 #endif
 
+/*
+ * Give a queue of 1, 2 or 4 byte items typed item copies: each send and
+ * receive then moves an item with one load and one store instead of a
+ * memcpy() call.  Only available when configUSE_QUEUE_FAST_COPY is 1.
+ *
+ * Call it once, after creating the queue and before it is used.
+ *
+ * @param xQueue The handle of the queue.
+ *
+ * @return pdPASS if the queue now uses typed copies.  pdFAIL, and the queue
+ * keeps memcpy(), if its item size is not 1, 2 or 4 bytes or a statically
+ * allocated storage area is not aligned to the item size.
+ */
+#if ( configUSE_QUEUE_FAST_COPY == 1 )
+    BaseType_t xQueueEnableFastCopy( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Send or receive up to uxItems / uxMaxItems items in one call: the items
+ * are copied under a single critical section, and the call yields (or sets
+ * *pxHigherPriorityTaskWoken) at most once however many items it moves.
+ * Only available when configUSE_QUEUE_BATCH is 1.
+ *
+ * pvItems / pvBuffer is an array of items of the queue's item size.  Items
+ * are always sent to the back of the queue.  Sending stops when the queue
+ * is full and receiving when it is empty.  If no item can be moved at all,
+ * the task versions block for up to xTicksToWait for the first one (as
+ * xQueueSend() / xQueueReceive() would) and then move whatever else fits
+ * without blocking again.
+ *
+ * Not for semaphores, mutexes or queues that are members of a queue set.
+ *
+ * @return The number of items sent or received, 0 to uxItems / uxMaxItems.
+ */
+#if ( configUSE_QUEUE_BATCH == 1 )
+    UBaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                                    const void * const pvItems,
+                                    const UBaseType_t uxItems,
+                                    TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+    UBaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                           const void * const pvItems,
+                                           const UBaseType_t uxItems,
+                                           BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+    UBaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                       void * const pvBuffer,
+                                       const UBaseType_t uxMaxItems,
+                                       TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+    UBaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                              void * const pvBuffer,
+                                              const UBaseType_t uxMaxItems,
+                                              BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Generic version of the function used to create a queue using dynamic memory
  * allocation.  This is called by other functions and macros that create other
@@ -0,0 +1,802 @@
+/*
+ * FreeRTOS Kernel V11.1.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A two-level segregated fit (TLSF) implementation of pvPortMalloc() and
+ * vPortFree(), built in place of heap_4.c when configUSE_HEAP_TLSF is 1.
+ *
+ * Free blocks are kept in one list per size class.  The first level splits
+ * sizes by power of two, the second splits each power of two into
+ * heapSL_INDEX_COUNT equal ranges, and one bitmap per level records which
+ * lists are non-empty.  pvPortMalloc() finds a class that is large enough
+ * with two find-first-set operations and takes the head of its list;
+ * vPortFree() merges the block with its free physical neighbours (found
+ * through the block headers, not by walking a list) and pushes the result
+ * onto its class list.  Neither walks anything, so both take the same time
+ * however fragmented the heap is.
+ *
+ * An allocated block keeps a two word header, as in heap_4.c, but the words
+ * are the size and a pointer to the previous physical block.  The price is
+ * the list heads, and up to one size class of internal waste: a request is
+ * rounded up to the next class so that any block in the list found is
+ * large enough.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Nothing to build in a static-only kernel (no heap at all). */
+#if ( configUSE_HEAP_TLSF == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+#if ( configENABLE_HEAP_PROTECTOR == 1 )
+    #error configENABLE_HEAP_PROTECTOR is not implemented by heap_tlsf.c
+#endif
+
+#if ( configUSE_HEAP_5 == 1 )
+    #error heap_tlsf.c manages one region; configUSE_HEAP_5 (APP_CCM_RAM) needs heap_5.c
+#endif
+
+#ifndef configHEAP_CLEAR_MEMORY_ON_FREE
+    #define configHEAP_CLEAR_MEMORY_ON_FREE    0
+#endif
+
+/* Blocks are never larger than 2^configHEAP_TLSF_FL_INDEX_MAX bytes, which
+ * sets the number of first level classes.  17 (128 KB) covers all of the
+ * STM32F407's main SRAM.  A larger heap is split into several blocks. */
+#ifndef configHEAP_TLSF_FL_INDEX_MAX
+    #define configHEAP_TLSF_FL_INDEX_MAX    17
+#endif
+
+/* log2 of portBYTE_ALIGNMENT: block sizes are multiples of it. */
+#if ( portBYTE_ALIGNMENT == 32 )
+    #define heapALIGN_LOG2    5
+#elif ( portBYTE_ALIGNMENT == 16 )
+    #define heapALIGN_LOG2    4
+#elif ( portBYTE_ALIGNMENT == 8 )
+    #define heapALIGN_LOG2    3
+#elif ( portBYTE_ALIGNMENT == 4 )
+    #define heapALIGN_LOG2    2
+#else
+    #error heap_tlsf.c does not support this portBYTE_ALIGNMENT
+#endif
+
+/* Second level: each power of two is split into 8 lists. */
+#define heapSL_INDEX_COUNT_LOG2    3
+#define heapSL_INDEX_COUNT         ( 1U << heapSL_INDEX_COUNT_LOG2 )
+
+/* Blocks below heapSMALL_BLOCK_SIZE all share first level 0, where the
+ * second level steps by portBYTE_ALIGNMENT. */
+#define heapFL_INDEX_SHIFT         ( heapSL_INDEX_COUNT_LOG2 + heapALIGN_LOG2 )
+#define heapSMALL_BLOCK_SIZE       ( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+#define heapFL_INDEX_COUNT         ( configHEAP_TLSF_FL_INDEX_MAX - heapFL_INDEX_SHIFT + 1 )
+
+#if ( heapFL_INDEX_COUNT > 32 ) || ( heapFL_INDEX_COUNT < 2 )
+    #error configHEAP_TLSF_FL_INDEX_MAX is out of range
+#endif
+
+/* Largest block, including its header. */
+#define heapMAXIMUM_BLOCK_SIZE     ( ( ( size_t ) 1 << configHEAP_TLSF_FL_INDEX_MAX ) - ( size_t ) portBYTE_ALIGNMENT )
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE          ( ( size_t ) 8 )
+
+/* Max value that fits in a size_t type. */
+#define heapSIZE_MAX               ( ~( ( size_t ) 0 ) )
+
+/* Check if multiplying a and b will result in overflow. */
+#define heapMULTIPLY_WILL_OVERFLOW( a, b )     ( ( ( a ) > 0 ) && ( ( b ) > ( heapSIZE_MAX / ( a ) ) ) )
+
+/* Check if adding a and b will result in overflow. */
+#define heapADD_WILL_OVERFLOW( a, b )          ( ( a ) > ( heapSIZE_MAX - ( b ) ) )
+
+/* As in heap_4.c, the MSB of xBlockSize is set while the block belongs to the
+ * application.  The end marker is a zero size block that is always
+ * allocated, so no block ever merges past the end of the heap. */
+#define heapBLOCK_ALLOCATED_BITMASK    ( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 ) )
+#define heapBLOCK_SIZE( pxBlock )                ( ( pxBlock )->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK )
+#define heapBLOCK_IS_ALLOCATED( pxBlock )        ( ( ( pxBlock )->xBlockSize & heapBLOCK_ALLOCATED_BITMASK ) != 0 )
+#define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock )->xBlockSize |= heapBLOCK_ALLOCATED_BITMASK )
+#define heapFREE_BLOCK( pxBlock )                ( ( pxBlock )->xBlockSize &= ~heapBLOCK_ALLOCATED_BITMASK )
+
+/*-----------------------------------------------------------*/
+
+/* Allocate the memory for the heap. */
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+
+/* The application writer has already defined the array used for the RTOS
+* heap - probably so it can be placed in a special segment or address. */
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* Every block, free or allocated, starts with this header.  The two free list
+ * links are only valid while the block is free: in an allocated block they are
+ * the first bytes handed to the application. */
+typedef struct A_TLSF_BLOCK
+{
+    struct A_TLSF_BLOCK * pxPrevPhysBlock; /**< The block just below this one in memory, NULL for the first. */
+    size_t xBlockSize;                     /**< Size of the whole block including this header. */
+    struct A_TLSF_BLOCK * pxNextFreeBlock; /**< The next block in the same size class list. */
+    struct A_TLSF_BLOCK * pxPrevFreeBlock; /**< The previous block in the same size class list. */
+} TlsfBlock_t;
+
+/* Assert that a heap block pointer is within the heap bounds. */
+#define heapVALIDATE_BLOCK_POINTER( pxBlock )                          \
+    configASSERT( ( ( uint8_t * ) ( pxBlock ) >= &( ucHeap[ 0 ] ) ) && \
+                  ( ( uint8_t * ) ( pxBlock ) <= &( ucHeap[ configTOTAL_HEAP_SIZE - 1 ] ) ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add a free block to, or take it off, the list of its size class and keep
+ * both bitmaps in step.
+ */
+static void prvInsertFreeBlock( TlsfBlock_t * pxBlock ) PRIVILEGED_FUNCTION;
+static void prvRemoveFreeBlock( TlsfBlock_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The part of the header an allocated block keeps, rounded up so that the
+ * memory returned is correctly aligned. */
+static const size_t xHeapStructSize = ( offsetof( TlsfBlock_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* A free block must hold the whole header, free list links included. */
+static const size_t xMinimumBlockSize = ( sizeof( TlsfBlock_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* One bit per first level class with any free block, and per class one bit
+ * per non-empty second level list. */
+PRIVILEGED_DATA static uint32_t ulFirstLevelBitmap = 0U;
+PRIVILEGED_DATA static uint8_t ucSecondLevelBitmap[ heapFL_INDEX_COUNT ];
+PRIVILEGED_DATA static TlsfBlock_t * pxFreeLists[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+
+/* The first block in memory, and the end marker. */
+PRIVILEGED_DATA static TlsfBlock_t * pxHeapStart = NULL;
+PRIVILEGED_DATA static TlsfBlock_t * pxEnd = NULL;
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+ * number of free bytes remaining, but says nothing about fragmentation. */
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
+
+/*-----------------------------------------------------------*/
+
+#ifndef portFORCE_INLINE
+    #define portFORCE_INLINE    inline
+#endif
+
+/* Index of the highest and of the lowest set bit.  The argument is never 0. */
+#if defined( __GNUC__ )
+    #define heapFLS( ulValue )    ( ( UBaseType_t ) ( 31 - __builtin_clz( ( unsigned int ) ( ulValue ) ) ) )
+    #define heapFFS( ulValue )    ( ( UBaseType_t ) __builtin_ctz( ( unsigned int ) ( ulValue ) ) )
+#else
+    static UBaseType_t prvFls( uint32_t ulValue )
+    {
+        UBaseType_t uxBit = 0U;
+
+        while( ( ulValue >>= 1 ) != 0U )
+        {
+            uxBit++;
+        }
+
+        return uxBit;
+    }
+
+    #define heapFLS( ulValue )    prvFls( ( uint32_t ) ( ulValue ) )
+    #define heapFFS( ulValue )    prvFls( ( uint32_t ) ( ulValue ) & ( 0U - ( uint32_t ) ( ulValue ) ) )
+#endif
+
+/*
+ * The class a free block of xSize bytes is filed under.
+ */
+static portFORCE_INLINE void prvMappingInsert( size_t xSize,
+                                               UBaseType_t * puxFirst,
+                                               UBaseType_t * puxSecond )
+{
+    if( xSize < heapSMALL_BLOCK_SIZE )
+    {
+        *puxFirst = 0U;
+        *puxSecond = ( UBaseType_t ) ( xSize >> heapALIGN_LOG2 );
+    }
+    else
+    {
+        const UBaseType_t uxBit = heapFLS( xSize );
+
+        *puxSecond = ( UBaseType_t ) ( ( xSize >> ( uxBit - heapSL_INDEX_COUNT_LOG2 ) ) ^ heapSL_INDEX_COUNT );
+        *puxFirst = uxBit - ( heapFL_INDEX_SHIFT - 1U );
+    }
+}
+
+/*
+ * The first class whose every block holds xSize bytes: round up to the next
+ * class boundary, then map.
+ */
+static portFORCE_INLINE void prvMappingSearch( size_t xSize,
+                                               UBaseType_t * puxFirst,
+                                               UBaseType_t * puxSecond )
+{
+    if( xSize >= heapSMALL_BLOCK_SIZE )
+    {
+        xSize += ( ( size_t ) 1 << ( heapFLS( xSize ) - heapSL_INDEX_COUNT_LOG2 ) ) - 1U;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    prvMappingInsert( xSize, puxFirst, puxSecond );
+}
+
+/*
+ * Head of the first non-empty list at or above class (uxFirst, uxSecond), or
+ * NULL.  Updates the indices to the list found.
+ */
+static portFORCE_INLINE TlsfBlock_t * prvFindSuitableBlock( UBaseType_t * puxFirst,
+                                                            UBaseType_t * puxSecond )
+{
+    UBaseType_t uxFirst = *puxFirst;
+    uint32_t ulMap;
+
+    if( uxFirst >= ( UBaseType_t ) heapFL_INDEX_COUNT )
+    {
+        return NULL;
+    }
+
+    ulMap = ( uint32_t ) ucSecondLevelBitmap[ uxFirst ] & ( ~0U << *puxSecond );
+
+    if( ulMap == 0U )
+    {
+        /* Nothing in this power of two: take any list in a higher one. */
+        ulMap = ( uxFirst + 1U < 32U ) ? ( ulFirstLevelBitmap & ( ~0U << ( uxFirst + 1U ) ) ) : 0U;
+
+        if( ulMap == 0U )
+        {
+            return NULL;
+        }
+
+        uxFirst = heapFFS( ulMap );
+        ulMap = ucSecondLevelBitmap[ uxFirst ];
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    *puxFirst = uxFirst;
+    *puxSecond = heapFFS( ulMap );
+
+    return pxFreeLists[ uxFirst ][ *puxSecond ];
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    TlsfBlock_t * pxBlock = NULL;
+    TlsfBlock_t * pxNewBlock;
+    void * pvReturn = NULL;
+    size_t xAdditionalRequiredSize;
+    UBaseType_t uxFirst, uxSecond;
+
+    if( xWantedSize > 0 )
+    {
+        /* The wanted size must be increased so it can contain the block
+         * header in addition to the requested amount of bytes. */
+        if( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize ) == 0 )
+        {
+            xWantedSize += xHeapStructSize;
+
+            /* Ensure that blocks are always aligned to the required number
+             * of bytes. */
+            if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+            {
+                /* Byte alignment required. */
+                xAdditionalRequiredSize = portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+
+                if( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 )
+                {
+                    xWantedSize += xAdditionalRequiredSize;
+                }
+                else
+                {
+                    xWantedSize = 0;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* The block must be able to hold the free list links once it is
+             * freed again. */
+            if( ( xWantedSize != 0 ) && ( xWantedSize < xMinimumBlockSize ) )
+            {
+                xWantedSize = xMinimumBlockSize;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            xWantedSize = 0;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    vTaskSuspendAll();
+    {
+        /* If this is the first call to malloc then the heap will require
+         * initialisation to setup the free lists. */
+        if( pxEnd == NULL )
+        {
+            prvHeapInit();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) && ( xWantedSize <= heapMAXIMUM_BLOCK_SIZE ) )
+        {
+            prvMappingSearch( xWantedSize, &uxFirst, &uxSecond );
+            pxBlock = prvFindSuitableBlock( &uxFirst, &uxSecond );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( pxBlock != NULL )
+        {
+            heapVALIDATE_BLOCK_POINTER( pxBlock );
+            configASSERT( pxBlock->xBlockSize >= xWantedSize );
+
+            prvRemoveFreeBlock( pxBlock );
+
+            /* If the block is larger than required it can be split into two,
+             * and the remainder filed under its own class. */
+            if( ( pxBlock->xBlockSize - xWantedSize ) >= xMinimumBlockSize )
+            {
+                TlsfBlock_t * pxNext = ( TlsfBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize );
+
+                pxNewBlock = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                configASSERT( ( ( ( size_t ) pxNewBlock ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+                pxNewBlock->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                pxNewBlock->pxPrevPhysBlock = pxBlock;
+                pxNext->pxPrevPhysBlock = pxNewBlock;
+                pxBlock->xBlockSize = xWantedSize;
+
+                prvInsertFreeBlock( pxNewBlock );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+            if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+            {
+                xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* The block is being returned - it is allocated and owned by the
+             * application. */
+            heapALLOCATE_BLOCK( pxBlock );
+            pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+            xNumberOfSuccessfulAllocations++;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMALLOC( pvReturn, xWantedSize );
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    uint8_t * puc = ( uint8_t * ) pv;
+    TlsfBlock_t * pxBlock;
+    TlsfBlock_t * pxNeighbour;
+
+    if( pv != NULL )
+    {
+        /* The memory being freed will have the block header immediately
+         * before it. */
+        puc -= xHeapStructSize;
+
+        /* This casting is to keep the compiler from issuing warnings. */
+        pxBlock = ( void * ) puc;
+
+        heapVALIDATE_BLOCK_POINTER( pxBlock );
+        configASSERT( heapBLOCK_IS_ALLOCATED( pxBlock ) != 0 );
+
+        if( heapBLOCK_IS_ALLOCATED( pxBlock ) != 0 )
+        {
+            /* The block is being returned to the heap - it is no longer
+             * allocated. */
+            heapFREE_BLOCK( pxBlock );
+            #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+            {
+                ( void ) memset( puc + xHeapStructSize, 0, pxBlock->xBlockSize - xHeapStructSize );
+            }
+            #endif
+
+            vTaskSuspendAll();
+            {
+                xFreeBytesRemaining += pxBlock->xBlockSize;
+                traceFREE( pv, pxBlock->xBlockSize );
+
+                /* Merge with the block below, if it is free and the result is
+                 * not too large for the first level classes. */
+                pxNeighbour = pxBlock->pxPrevPhysBlock;
+
+                if( ( pxNeighbour != NULL ) && ( heapBLOCK_IS_ALLOCATED( pxNeighbour ) == 0 ) &&
+                    ( ( pxNeighbour->xBlockSize + pxBlock->xBlockSize ) <= heapMAXIMUM_BLOCK_SIZE ) )
+                {
+                    prvRemoveFreeBlock( pxNeighbour );
+                    pxNeighbour->xBlockSize += pxBlock->xBlockSize;
+                    pxBlock = pxNeighbour;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* And with the block above.  The end marker is always
+                 * allocated, so this stops at the end of the heap. */
+                pxNeighbour = ( TlsfBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize );
+
+                if( ( heapBLOCK_IS_ALLOCATED( pxNeighbour ) == 0 ) &&
+                    ( ( pxNeighbour->xBlockSize + pxBlock->xBlockSize ) <= heapMAXIMUM_BLOCK_SIZE ) )
+                {
+                    prvRemoveFreeBlock( pxNeighbour );
+                    pxBlock->xBlockSize += pxNeighbour->xBlockSize;
+                    pxNeighbour = ( TlsfBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxNeighbour->pxPrevPhysBlock = pxBlock;
+                prvInsertFreeBlock( pxBlock );
+                xNumberOfSuccessfulFrees++;
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
+{
+    TlsfBlock_t * pxBlock;
+    TlsfBlock_t * pxPrevious = NULL;
+    portPOINTER_SIZE_TYPE uxAddress, uxEndAddress;
+    size_t xSize;
+
+    /* Ensure the heap starts on a correctly aligned boundary. */
+    uxAddress = ( portPOINTER_SIZE_TYPE ) ucHeap;
+
+    if( ( uxAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+    {
+        uxAddress += ( portBYTE_ALIGNMENT - 1 );
+        uxAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+    }
+
+    /* pxEnd marks the end of the heap: a zero size allocated block that
+     * takes the header space at the top. */
+    uxEndAddress = ( portPOINTER_SIZE_TYPE ) ucHeap + ( portPOINTER_SIZE_TYPE ) configTOTAL_HEAP_SIZE;
+    uxEndAddress -= ( portPOINTER_SIZE_TYPE ) xHeapStructSize;
+    uxEndAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+
+    pxHeapStart = ( TlsfBlock_t * ) uxAddress;
+    xFreeBytesRemaining = ( size_t ) 0U;
+
+    /* Normally one free block covers the whole heap.  A heap larger than
+     * heapMAXIMUM_BLOCK_SIZE starts as several. */
+    while( uxAddress < uxEndAddress )
+    {
+        xSize = ( size_t ) ( uxEndAddress - uxAddress );
+
+        if( xSize > heapMAXIMUM_BLOCK_SIZE )
+        {
+            xSize = heapMAXIMUM_BLOCK_SIZE;
+
+            /* Never leave a tail too small to be a block. */
+            if( ( size_t ) ( uxEndAddress - uxAddress ) - xSize < xMinimumBlockSize )
+            {
+                xSize -= xMinimumBlockSize;
+            }
+        }
+        else if( xSize < xMinimumBlockSize )
+        {
+            /* Cannot happen with the one block split above, but a heap this
+             * small has nothing to offer anyway. */
+            break;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxBlock = ( TlsfBlock_t * ) uxAddress;
+        pxBlock->pxPrevPhysBlock = pxPrevious;
+        pxBlock->xBlockSize = xSize;
+        prvInsertFreeBlock( pxBlock );
+
+        xFreeBytesRemaining += xSize;
+        pxPrevious = pxBlock;
+        uxAddress += ( portPOINTER_SIZE_TYPE ) xSize;
+    }
+
+    pxEnd = ( TlsfBlock_t * ) uxAddress;
+    pxEnd->pxPrevPhysBlock = pxPrevious;
+    pxEnd->xBlockSize = 0;
+    heapALLOCATE_BLOCK( pxEnd );
+
+    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( TlsfBlock_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxFirst, uxSecond;
+    TlsfBlock_t * pxHead;
+
+    prvMappingInsert( pxBlock->xBlockSize, &uxFirst, &uxSecond );
+    configASSERT( uxFirst < ( UBaseType_t ) heapFL_INDEX_COUNT );
+
+    pxHead = pxFreeLists[ uxFirst ][ uxSecond ];
+    pxBlock->pxNextFreeBlock = pxHead;
+    pxBlock->pxPrevFreeBlock = NULL;
+
+    if( pxHead != NULL )
+    {
+        pxHead->pxPrevFreeBlock = pxBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    pxFreeLists[ uxFirst ][ uxSecond ] = pxBlock;
+    ulFirstLevelBitmap |= ( 1UL << uxFirst );
+    ucSecondLevelBitmap[ uxFirst ] |= ( uint8_t ) ( 1U << uxSecond );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( TlsfBlock_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxFirst, uxSecond;
+    TlsfBlock_t * const pxNext = pxBlock->pxNextFreeBlock;
+    TlsfBlock_t * const pxPrev = pxBlock->pxPrevFreeBlock;
+
+    prvMappingInsert( pxBlock->xBlockSize, &uxFirst, &uxSecond );
+
+    if( pxNext != NULL )
+    {
+        pxNext->pxPrevFreeBlock = pxPrev;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( pxPrev != NULL )
+    {
+        pxPrev->pxNextFreeBlock = pxNext;
+    }
+    else
+    {
+        /* It was the head: the list may now be empty. */
+        pxFreeLists[ uxFirst ][ uxSecond ] = pxNext;
+
+        if( pxNext == NULL )
+        {
+            ucSecondLevelBitmap[ uxFirst ] &= ( uint8_t ) ~( 1U << uxSecond );
+
+            if( ucSecondLevelBitmap[ uxFirst ] == 0U )
+            {
+                ulFirstLevelBitmap &= ~( 1UL << uxFirst );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    TlsfBlock_t * pxBlock;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+    vTaskSuspendAll();
+    {
+        /* pxHeapStart will be NULL if the heap has not been initialised.  The
+         * heap is initialised automatically when the first allocation is
+         * made.  The walk is over every block, not just the free ones, so it
+         * is linear - statistics are not on the allocation path. */
+        for( pxBlock = pxHeapStart; ( pxBlock != NULL ) && ( pxBlock != pxEnd );
+             pxBlock = ( TlsfBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + heapBLOCK_SIZE( pxBlock ) ) )
+        {
+            if( heapBLOCK_IS_ALLOCATED( pxBlock ) == 0 )
+            {
+                xBlocks++;
+
+                if( pxBlock->xBlockSize > xMaxSize )
+                {
+                    xMaxSize = pxBlock->xBlockSize;
+                }
+
+                if( pxBlock->xBlockSize < xMinSize )
+                {
+                    xMinSize = pxBlock->xBlockSize;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Reset the state in this file. This state is normally initialized at start up.
+ * This function must be called by the application before restarting the
+ * scheduler.
+ */
+void vPortHeapResetState( void )
+{
+    pxHeapStart = NULL;
+    pxEnd = NULL;
+
+    ulFirstLevelBitmap = 0U;
+    ( void ) memset( ucSecondLevelBitmap, 0, sizeof( ucSecondLevelBitmap ) );
+    ( void ) memset( pxFreeLists, 0, sizeof( pxFreeLists ) );
+
+    xFreeBytesRemaining = ( size_t ) 0U;
+    xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+    xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+    xNumberOfSuccessfulFrees = ( size_t ) 0U;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_HEAP_TLSF */
@@ -125,6 +125,10 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
         uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the memory used by the queue was statically allocated to ensure no attempt is made to free the memory. */
     #endif
 
+    #if ( configUSE_QUEUE_FAST_COPY == 1 )
+        uint8_t ucFastCopy; /**< 1, 2 or 4 once xQueueEnableFastCopy() has given the queue typed item copies, 0 for memcpy(). */
+    #endif
+
     #if ( configUSE_QUEUE_SETS == 1 )
         struct QueueDefinition * pxQueueSetContainer;
     #endif
@@ -210,6 +214,28 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
 static void prvCopyDataFromQueue( Queue_t * const pxQueue,
                                   void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_QUEUE_FAST_COPY == 1 )
+
+    #ifndef portFORCE_INLINE
+        #define portFORCE_INLINE    inline
+    #endif
+
+/*
+ * Copies one item between the queue storage area and a caller's buffer:
+ * a fixed-size memcpy() that compiles to a single load and store for queues
+ * set up by xQueueEnableFastCopy(), a memcpy() of uxItemSize for the rest.
+ */
+    static portFORCE_INLINE void prvCopyItem( const Queue_t * const pxQueue,
+                                              void * pvDest,
+                                              const void * pvSource );
+
+#else
+
+    #define prvCopyItem( pxQueue, pvDest, pvSource ) \
+    ( void ) memcpy( ( void * ) ( pvDest ), ( pvSource ), ( size_t ) ( pxQueue )->uxItemSize )
+
+#endif /* configUSE_QUEUE_FAST_COPY */
+
 #if ( configUSE_QUEUE_SETS == 1 )
 
 /*
@@ -599,6 +625,12 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
     }
     #endif /* configUSE_TRACE_FACILITY */
 
+    #if ( configUSE_QUEUE_FAST_COPY == 1 )
+    {
+        pxNewQueue->ucFastCopy = 0U;
+    }
+    #endif /* configUSE_QUEUE_FAST_COPY */
+
     #if ( configUSE_QUEUE_SETS == 1 )
     {
         pxNewQueue->pxQueueSetContainer = NULL;
@@ -2132,6 +2164,339 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_BATCH == 1 )
+
+    UBaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                                    const void * const pvItems,
+                                    const UBaseType_t uxItems,
+                                    TickType_t xTicksToWait )
+    {
+        Queue_t * const pxQueue = xQueue;
+        const int8_t * pcItem = ( const int8_t * ) pvItems;
+        UBaseType_t uxSent = 0U;
+        UBaseType_t uxCount;
+        BaseType_t xYieldRequired = pdFALSE;
+
+        configASSERT( pxQueue );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( !( ( pvItems == NULL ) && ( uxItems != ( UBaseType_t ) 0U ) ) );
+
+        #if ( configUSE_QUEUE_SETS == 1 )
+        {
+            /* One queue set event per item is not batched, so a queue that is
+             * a set member uses the single item functions. */
+            configASSERT( pxQueue->pxQueueSetContainer == NULL );
+        }
+        #endif
+
+        taskENTER_CRITICAL();
+        {
+            /* Move as many items as fit in one pass. */
+            uxCount = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+            if( uxCount > uxItems )
+            {
+                uxCount = uxItems;
+            }
+
+            for( uxSent = 0U; uxSent < uxCount; uxSent++ )
+            {
+                traceQUEUE_SEND( pxQueue );
+                ( void ) prvCopyDataToQueue( pxQueue, pcItem, queueSEND_TO_BACK );
+                pcItem += pxQueue->uxItemSize;
+            }
+
+            /* Unblock one waiting receiver per item sent, while there are
+             * any, but yield at most once for the whole batch. */
+            for( uxCount = 0U; uxCount < uxSent; uxCount++ )
+            {
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                {
+                    break;
+                }
+
+                if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                {
+                    xYieldRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            if( xYieldRequired != pdFALSE )
+            {
+                queueYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        /* Queue full: block for room for the first item the usual way, then
+         * send whatever else fits without blocking again. */
+        if( ( uxSent == 0U ) && ( uxItems != 0U ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+        {
+            if( xQueueGenericSend( xQueue, pvItems, xTicksToWait, queueSEND_TO_BACK ) == pdPASS )
+            {
+                uxSent = 1U + xQueueSendMultiple( xQueue, pcItem + pxQueue->uxItemSize, uxItems - 1U, 0 );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        return uxSent;
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                           const void * const pvItems,
+                                           const UBaseType_t uxItems,
+                                           BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        Queue_t * const pxQueue = xQueue;
+        const int8_t * pcItem = ( const int8_t * ) pvItems;
+        UBaseType_t uxSent;
+        UBaseType_t uxCount;
+        UBaseType_t uxSavedInterruptStatus;
+
+        configASSERT( pxQueue );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( !( ( pvItems == NULL ) && ( uxItems != ( UBaseType_t ) 0U ) ) );
+
+        #if ( configUSE_QUEUE_SETS == 1 )
+        {
+            configASSERT( pxQueue->pxQueueSetContainer == NULL );
+        }
+        #endif
+
+        /* See xQueueGenericSendFromISR(). */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+        {
+            uxCount = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+            if( uxCount > uxItems )
+            {
+                uxCount = uxItems;
+            }
+
+            for( uxSent = 0U; uxSent < uxCount; uxSent++ )
+            {
+                traceQUEUE_SEND_FROM_ISR( pxQueue );
+                ( void ) prvCopyDataToQueue( pxQueue, pcItem, queueSEND_TO_BACK );
+                pcItem += pxQueue->uxItemSize;
+            }
+
+            if( uxSent == 0U )
+            {
+                traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+            }
+            else if( pxQueue->cTxLock == queueUNLOCKED )
+            {
+                for( uxCount = 0U; uxCount < uxSent; uxCount++ )
+                {
+                    if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                    {
+                        break;
+                    }
+
+                    if( ( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE ) &&
+                        ( pxHigherPriorityTaskWoken != NULL ) )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            else
+            {
+                /* The task that unlocks the queue wakes one receiver per
+                 * item posted while it was locked. */
+                for( uxCount = 0U; uxCount < uxSent; uxCount++ )
+                {
+                    const int8_t cTxLock = pxQueue->cTxLock;
+
+                    prvIncrementQueueTxLock( pxQueue, cTxLock );
+                }
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        return uxSent;
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                       void * const pvBuffer,
+                                       const UBaseType_t uxMaxItems,
+                                       TickType_t xTicksToWait )
+    {
+        Queue_t * const pxQueue = xQueue;
+        int8_t * pcItem = ( int8_t * ) pvBuffer;
+        UBaseType_t uxReceived = 0U;
+        UBaseType_t uxCount;
+        BaseType_t xYieldRequired = pdFALSE;
+
+        configASSERT( pxQueue );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( !( ( pvBuffer == NULL ) && ( uxMaxItems != ( UBaseType_t ) 0U ) ) );
+
+        taskENTER_CRITICAL();
+        {
+            uxCount = pxQueue->uxMessagesWaiting;
+
+            if( uxCount > uxMaxItems )
+            {
+                uxCount = uxMaxItems;
+            }
+
+            for( uxReceived = 0U; uxReceived < uxCount; uxReceived++ )
+            {
+                prvCopyDataFromQueue( pxQueue, pcItem );
+                traceQUEUE_RECEIVE( pxQueue );
+                pcItem += pxQueue->uxItemSize;
+            }
+
+            pxQueue->uxMessagesWaiting -= uxReceived;
+
+            /* Unblock one waiting sender per slot freed, while there are
+             * any, but yield at most once for the whole batch. */
+            for( uxCount = 0U; uxCount < uxReceived; uxCount++ )
+            {
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                {
+                    break;
+                }
+
+                if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                {
+                    xYieldRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            if( xYieldRequired != pdFALSE )
+            {
+                queueYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        /* Queue empty: block for the first item the usual way, then take
+         * whatever else has arrived without blocking again. */
+        if( ( uxReceived == 0U ) && ( uxMaxItems != 0U ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+        {
+            if( xQueueReceive( xQueue, pvBuffer, xTicksToWait ) == pdPASS )
+            {
+                uxReceived = 1U + xQueueReceiveMultiple( xQueue, pcItem + pxQueue->uxItemSize, uxMaxItems - 1U, 0 );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        return uxReceived;
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                              void * const pvBuffer,
+                                              const UBaseType_t uxMaxItems,
+                                              BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        Queue_t * const pxQueue = xQueue;
+        int8_t * pcItem = ( int8_t * ) pvBuffer;
+        UBaseType_t uxReceived;
+        UBaseType_t uxCount;
+        UBaseType_t uxSavedInterruptStatus;
+
+        configASSERT( pxQueue );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( !( ( pvBuffer == NULL ) && ( uxMaxItems != ( UBaseType_t ) 0U ) ) );
+
+        /* See xQueueGenericSendFromISR(). */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+        {
+            uxCount = pxQueue->uxMessagesWaiting;
+
+            if( uxCount > uxMaxItems )
+            {
+                uxCount = uxMaxItems;
+            }
+
+            for( uxReceived = 0U; uxReceived < uxCount; uxReceived++ )
+            {
+                traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+                prvCopyDataFromQueue( pxQueue, pcItem );
+                pcItem += pxQueue->uxItemSize;
+            }
+
+            pxQueue->uxMessagesWaiting -= uxReceived;
+
+            if( uxReceived == 0U )
+            {
+                traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+            }
+            else if( pxQueue->cRxLock == queueUNLOCKED )
+            {
+                for( uxCount = 0U; uxCount < uxReceived; uxCount++ )
+                {
+                    if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    {
+                        break;
+                    }
+
+                    if( ( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE ) &&
+                        ( pxHigherPriorityTaskWoken != NULL ) )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            else
+            {
+                /* The task that unlocks the queue wakes one sender per item
+                 * removed while it was locked. */
+                for( uxCount = 0U; uxCount < uxReceived; uxCount++ )
+                {
+                    const int8_t cRxLock = pxQueue->cRxLock;
+
+                    prvIncrementQueueRxLock( pxQueue, cRxLock );
+                }
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        return uxReceived;
+    }
+
+#endif /* configUSE_QUEUE_BATCH */
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,
                               void * const pvBuffer )
 {
@@ -2360,6 +2725,41 @@ UBaseType_t uxQueueGetQueueLength( QueueHandle_t xQueue ) /* PRIVILEGED_FUNCTION
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_FAST_COPY == 1 )
+
+    BaseType_t xQueueEnableFastCopy( QueueHandle_t xQueue ) /* PRIVILEGED_FUNCTION */
+    {
+        Queue_t * const pxQueue = xQueue;
+        UBaseType_t uxItemSize;
+        BaseType_t xReturn = pdFAIL;
+
+        configASSERT( pxQueue );
+
+        uxItemSize = pxQueue->uxItemSize;
+
+        /* Only queues proper: a semaphore or mutex has no items to copy. */
+        if( ( ( uxItemSize == 1U ) || ( uxItemSize == 2U ) || ( uxItemSize == 4U ) ) &&
+            ( ( ( portPOINTER_SIZE_TYPE ) pxQueue->pcHead & ( portPOINTER_SIZE_TYPE ) ( uxItemSize - 1U ) ) == 0U ) )
+        {
+            taskENTER_CRITICAL();
+            {
+                pxQueue->ucFastCopy = ( uint8_t ) uxItemSize;
+            }
+            taskEXIT_CRITICAL();
+
+            xReturn = pdPASS;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_QUEUE_FAST_COPY */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_MUTEXES == 1 )
 
     static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const Queue_t * const pxQueue )
@@ -2387,6 +2787,40 @@ UBaseType_t uxQueueGetQueueLength( QueueHandle_t xQueue ) /* PRIVILEGED_FUNCTION
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_FAST_COPY == 1 )
+
+    static portFORCE_INLINE void prvCopyItem( const Queue_t * const pxQueue,
+                                              void * pvDest,
+                                              const void * pvSource )
+    {
+        /* The items are the caller's objects (handles, structs), so they
+         * are not read or written through a uint16_t or uint32_t lvalue,
+         * which strict aliasing would let the compiler reorder or drop.  A
+         * memcpy() of a constant size compiles to one LDRH/STRH or LDR/STR
+         * on the Cortex-M4 all the same. */
+        switch( pxQueue->ucFastCopy )
+        {
+            case 1U:
+                *( ( uint8_t * ) pvDest ) = *( ( const uint8_t * ) pvSource );
+                break;
+
+            case 2U:
+                ( void ) memcpy( pvDest, pvSource, 2U );
+                break;
+
+            case 4U:
+                ( void ) memcpy( pvDest, pvSource, 4U );
+                break;
+
+            default:
+                ( void ) memcpy( pvDest, pvSource, ( size_t ) pxQueue->uxItemSize );
+                break;
+        }
+    }
+
+#endif /* configUSE_QUEUE_FAST_COPY */
+/*-----------------------------------------------------------*/
+
 static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
                                       const void * pvItemToQueue,
                                       const BaseType_t xPosition )
@@ -2417,7 +2851,7 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
     }
     else if( xPosition == queueSEND_TO_BACK )
     {
-        ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, ( size_t ) pxQueue->uxItemSize );
+        prvCopyItem( pxQueue, pxQueue->pcWriteTo, pvItemToQueue );
         pxQueue->pcWriteTo += pxQueue->uxItemSize;
 
         if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )
@@ -2431,7 +2865,7 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
     }
     else
     {
-        ( void ) memcpy( ( void * ) pxQueue->u.xQueue.pcReadFrom, pvItemToQueue, ( size_t ) pxQueue->uxItemSize );
+        prvCopyItem( pxQueue, pxQueue->u.xQueue.pcReadFrom, pvItemToQueue );
         pxQueue->u.xQueue.pcReadFrom -= pxQueue->uxItemSize;
 
         if( pxQueue->u.xQueue.pcReadFrom < pxQueue->pcHead )
@@ -2486,7 +2920,7 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue,
             mtCOVERAGE_TEST_MARKER();
         }
 
-        ( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( size_t ) pxQueue->uxItemSize );
+        prvCopyItem( pxQueue, pvBuffer, pxQueue->u.xQueue.pcReadFrom );
     }
 }
 /*-----------------------------------------------------------*/
@@ -65,6 +65,38 @@
         #define configTIMER_SERVICE_TASK_NAME    "Tmr Svc"
     #endif
 
+/* Set configUSE_TIMER_WHEEL to 1 in FreeRTOSConfig.h to keep active timers in
+ * a hierarchical timing wheel instead of the two sorted lists.  Starting,
+ * stopping and expiring a timer is then O(1) in the number of active timers,
+ * where the lists walk to the insertion point on every start and reload. */
+    #ifndef configUSE_TIMER_WHEEL
+        #define configUSE_TIMER_WHEEL    0
+    #endif
+
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+        #if ( configTICK_TYPE_WIDTH_IN_BITS != TICK_TYPE_WIDTH_32_BITS )
+            #error configUSE_TIMER_WHEEL requires a 32-bit TickType_t.
+        #endif
+
+/* Five levels of 32 slots.  Level n holds timers due within 32^(n+1) ticks
+ * and each of its slots spans 32^n ticks, so the wheel covers 2^25 ticks
+ * (9.3 hours at 1 kHz).  Timers due later wait in a "far" list that is
+ * re-sorted into the wheel once per 2^25 ticks. */
+        #define tmrWHEEL_BITS         ( 5U )
+        #define tmrWHEEL_SLOTS        ( 1U << tmrWHEEL_BITS )
+        #define tmrWHEEL_MASK         ( tmrWHEEL_SLOTS - 1U )
+        #define tmrWHEEL_LEVELS       ( 5U )
+        #define tmrWHEEL_RANGE_BITS   ( tmrWHEEL_BITS * tmrWHEEL_LEVELS )
+
+/* Index of the lowest set bit of a non-zero 32-bit value (RBIT + CLZ on
+ * Cortex-M3 and up). */
+        #ifndef tmrWHEEL_CTZ
+            #define tmrWHEEL_CTZ( ulBits )    ( ( UBaseType_t ) __builtin_ctz( ulBits ) )
+        #endif
+
+    #endif /* configUSE_TIMER_WHEEL */
+
     #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
 
 /* The core affinity assigned to the timer service task on SMP systems.
@@ -140,10 +172,22 @@
  * xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
  * breaks some kernel aware debuggers, and debuggers that reply on removing the
  * static qualifier. */
-    PRIVILEGED_DATA static List_t xActiveTimerList1;
-    PRIVILEGED_DATA static List_t xActiveTimerList2;
-    PRIVILEGED_DATA static List_t * pxCurrentTimerList;
-    PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+    #if ( configUSE_TIMER_WHEEL == 0 )
+        PRIVILEGED_DATA static List_t xActiveTimerList1;
+        PRIVILEGED_DATA static List_t xActiveTimerList2;
+        PRIVILEGED_DATA static List_t * pxCurrentTimerList;
+        PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+    #else
+
+/* The timing wheel used instead of the lists above.  Slots are unsorted;
+ * ulTimerWheelMap has one bit per non-empty slot so the next slot to visit
+ * is found without scanning.  xTimerWheelTime is the tick up to which the
+ * wheel has been processed.  Only the timer service task accesses these. */
+        PRIVILEGED_DATA static List_t xTimerWheel[ tmrWHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+        PRIVILEGED_DATA static uint32_t ulTimerWheelMap[ tmrWHEEL_LEVELS ];
+        PRIVILEGED_DATA static List_t xTimerWheelFar;
+        PRIVILEGED_DATA static TickType_t xTimerWheelTime = ( TickType_t ) 0U;
+    #endif /* configUSE_TIMER_WHEEL */
 
 /* A queue that is used to send commands to the timer service task. */
     PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
@@ -192,14 +236,26 @@
  * An active timer has reached its expire time.  Reload the timer if it is an
  * auto-reload timer, then call its callback.
  */
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
-                                        const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+    #if ( configUSE_TIMER_WHEEL == 0 )
+        static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+                                            const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+    #endif
+
+/*
+ * The part of prvProcessExpiredTimer() that follows taking the timer out of
+ * the active timers, shared with the timing wheel.
+ */
+    static void prvExpireTimer( Timer_t * const pxTimer,
+                                const TickType_t xExpiredTime,
+                                const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
 /*
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
  */
-    static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+    #if ( configUSE_TIMER_WHEEL == 0 )
+        static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+    #endif
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -232,6 +288,21 @@
                                        void * const pvTimerID,
                                        TimerCallbackFunction_t pxCallbackFunction,
                                        Timer_t * pxNewTimer ) PRIVILEGED_FUNCTION;
+
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+/*
+ * Timing wheel operations.  Insert files a timer by the expiry time held in
+ * its list item, remove takes it out of whichever slot holds it, and advance
+ * runs every slot due up to xTimeNow: cascading higher-level slots down and
+ * expiring the timers of level 0.
+ */
+        static void prvWheelInsert( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+        static void prvWheelRemove( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+        static BaseType_t prvWheelIsEmpty( void ) PRIVILEGED_FUNCTION;
+        static TickType_t prvWheelTicksToNextEvent( void ) PRIVILEGED_FUNCTION;
+        static void prvWheelAdvance( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     BaseType_t xTimerCreateTimerTask( void )
@@ -715,6 +786,8 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_WHEEL == 0 )
+
     static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow )
     {
@@ -728,11 +801,21 @@
 
         ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
 
+        prvExpireTimer( pxTimer, xNextExpireTime, xTimeNow );
+    }
+
+    #endif /* configUSE_TIMER_WHEEL == 0 */
+/*-----------------------------------------------------------*/
+
+    static void prvExpireTimer( Timer_t * const pxTimer,
+                                const TickType_t xExpiredTime,
+                                const TickType_t xTimeNow )
+    {
         /* If the timer is an auto-reload timer then calculate the next
          * expiry time and re-insert the timer in the list of active timers. */
         if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
         {
-            prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+            prvReloadTimer( pxTimer, xExpiredTime, xTimeNow );
         }
         else
         {
@@ -779,6 +862,47 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+    static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+                                            BaseType_t xListWasEmpty )
+    {
+        TickType_t xTimeNow;
+
+        vTaskSuspendAll();
+        {
+            xTimeNow = xTaskGetTickCount();
+
+            /* The wheel's next event is due when at least as many ticks have
+             * passed since xTimerWheelTime as it lies ahead of it.  Measuring
+             * both from xTimerWheelTime makes the test immune to the tick
+             * count overflowing, so no list switch is needed. */
+            if( ( xListWasEmpty == pdFALSE ) &&
+                ( ( TickType_t ) ( xTimeNow - xTimerWheelTime ) >= ( TickType_t ) ( xNextExpireTime - xTimerWheelTime ) ) )
+            {
+                ( void ) xTaskResumeAll();
+                prvWheelAdvance( xTimeNow );
+            }
+            else
+            {
+                /* Block until the next event or a command, whichever comes
+                 * first.  An empty wheel waits for a command only. */
+                vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    taskYIELD_WITHIN_API();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+    }
+
+    #else /* configUSE_TIMER_WHEEL */
+
     static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
                                             BaseType_t xListWasEmpty )
     {
@@ -839,30 +963,44 @@
             }
         }
     }
+
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
     {
         TickType_t xNextExpireTime;
 
-        /* Timers are listed in expiry time order, with the head of the list
-         * referencing the task that will expire first.  Obtain the time at which
-         * the timer with the nearest expiry time will expire.  If there are no
-         * active timers then just set the next expire time to 0.  That will cause
-         * this task to unblock when the tick count overflows, at which point the
-         * timer lists will be switched and the next expiry time can be
-         * re-assessed.  */
-        *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
-
-        if( *pxListWasEmpty == pdFALSE )
+        #if ( configUSE_TIMER_WHEEL == 1 )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            /* The "expire time" is that of the wheel's next event, which may
+             * only cascade timers to a lower level.  With no active timers it
+             * is not used. */
+            *pxListWasEmpty = prvWheelIsEmpty();
+            xNextExpireTime = xTimerWheelTime + prvWheelTicksToNextEvent();
         }
-        else
+        #else
         {
-            /* Ensure the task unblocks when the tick count rolls over. */
-            xNextExpireTime = ( TickType_t ) 0U;
+            /* Timers are listed in expiry time order, with the head of the list
+             * referencing the task that will expire first.  Obtain the time at which
+             * the timer with the nearest expiry time will expire.  If there are no
+             * active timers then just set the next expire time to 0.  That will cause
+             * this task to unblock when the tick count overflows, at which point the
+             * timer lists will be switched and the next expiry time can be
+             * re-assessed.  */
+            *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+
+            if( *pxListWasEmpty == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            }
+            else
+            {
+                /* Ensure the task unblocks when the tick count rolls over. */
+                xNextExpireTime = ( TickType_t ) 0U;
+            }
         }
+        #endif /* configUSE_TIMER_WHEEL */
 
         return xNextExpireTime;
     }
@@ -871,21 +1009,32 @@
     static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
     {
         TickType_t xTimeNow;
-        PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U;
 
         xTimeNow = xTaskGetTickCount();
 
-        if( xTimeNow < xLastTime )
-        {
-            prvSwitchTimerLists();
-            *pxTimerListsWereSwitched = pdTRUE;
-        }
-        else
+        #if ( configUSE_TIMER_WHEEL == 1 )
         {
+            /* The wheel measures every time relative to xTimerWheelTime, so
+             * an overflowing tick count needs no special handling. */
             *pxTimerListsWereSwitched = pdFALSE;
         }
+        #else
+        {
+            PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U;
+
+            if( xTimeNow < xLastTime )
+            {
+                prvSwitchTimerLists();
+                *pxTimerListsWereSwitched = pdTRUE;
+            }
+            else
+            {
+                *pxTimerListsWereSwitched = pdFALSE;
+            }
 
-        xLastTime = xTimeNow;
+            xLastTime = xTimeNow;
+        }
+        #endif /* configUSE_TIMER_WHEEL */
 
         return xTimeNow;
     }
@@ -901,35 +1050,54 @@
         listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
         listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
 
-        if( xNextExpiryTime <= xTimeNow )
+        #if ( configUSE_TIMER_WHEEL == 1 )
         {
-            /* Has the expiry time elapsed between the command to start/reset a
-             * timer was issued, and the time the command was processed? */
+            /* The expiry time is xCommandTime plus one period, so it has
+             * passed exactly when a whole period has elapsed since the
+             * command.  Otherwise it lies ahead of xTimeNow, which is never
+             * behind xTimerWheelTime. */
             if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks )
             {
-                /* The time between a command being issued and the command being
-                 * processed actually exceeds the timers period.  */
                 xProcessTimerNow = pdTRUE;
             }
             else
             {
-                vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                prvWheelInsert( pxTimer );
             }
         }
-        else
+        #else
         {
-            if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+            if( xNextExpiryTime <= xTimeNow )
             {
-                /* If, since the command was issued, the tick count has overflowed
-                 * but the expiry time has not, then the timer must have already passed
-                 * its expiry time and should be processed immediately. */
-                xProcessTimerNow = pdTRUE;
+                /* Has the expiry time elapsed between the command to start/reset a
+                 * timer was issued, and the time the command was processed? */
+                if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks )
+                {
+                    /* The time between a command being issued and the command being
+                     * processed actually exceeds the timers period.  */
+                    xProcessTimerNow = pdTRUE;
+                }
+                else
+                {
+                    vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                }
             }
             else
             {
-                vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+                {
+                    /* If, since the command was issued, the tick count has overflowed
+                     * but the expiry time has not, then the timer must have already passed
+                     * its expiry time and should be processed immediately. */
+                    xProcessTimerNow = pdTRUE;
+                }
+                else
+                {
+                    vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                }
             }
         }
+        #endif /* configUSE_TIMER_WHEEL */
 
         return xProcessTimerNow;
     }
@@ -977,7 +1145,15 @@
                 if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE )
                 {
                     /* The timer is in a list, remove it. */
-                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    #if ( configUSE_TIMER_WHEEL == 1 )
+                    {
+                        prvWheelRemove( pxTimer );
+                    }
+                    #else
+                    {
+                        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    }
+                    #endif
                 }
                 else
                 {
@@ -994,6 +1170,17 @@
                  *  pre-empted the timer daemon task after the xTimeNow value was set). */
                 xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
 
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                {
+                    /* An empty wheel is not advanced, so bring its time up to
+                     * date before timers are filed relative to it. */
+                    if( prvWheelIsEmpty() != pdFALSE )
+                    {
+                        xTimerWheelTime = xTimeNow;
+                    }
+                }
+                #endif /* configUSE_TIMER_WHEEL */
+
                 switch( xMessage.xMessageID )
                 {
                     case tmrCOMMAND_START:
@@ -1083,6 +1270,8 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_WHEEL == 0 )
+
     static void prvSwitchTimerLists( void )
     {
         TickType_t xNextExpireTime;
@@ -1106,6 +1295,199 @@
         pxCurrentTimerList = pxOverflowTimerList;
         pxOverflowTimerList = pxTemp;
     }
+
+    #endif /* configUSE_TIMER_WHEEL == 0 */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+    static void prvWheelInsert( Timer_t * const pxTimer )
+    {
+        const TickType_t xExpiryTime = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+        const TickType_t xDelta = xExpiryTime - xTimerWheelTime;
+        UBaseType_t uxLevel;
+        UBaseType_t uxSlot;
+
+        /* Level n takes the timers due in less than 32^(n+1) ticks.  Its slot
+         * is picked by the expiry time's own bits, so the slot comes round
+         * exactly when the timer has to move down a level, or expire. */
+        for( uxLevel = 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+        {
+            if( ( xDelta >> ( tmrWHEEL_BITS * ( uxLevel + 1U ) ) ) == ( TickType_t ) 0U )
+            {
+                break;
+            }
+        }
+
+        if( uxLevel < tmrWHEEL_LEVELS )
+        {
+            uxSlot = ( UBaseType_t ) ( xExpiryTime >> ( tmrWHEEL_BITS * uxLevel ) ) & tmrWHEEL_MASK;
+            vListInsertEnd( &( xTimerWheel[ uxLevel ][ uxSlot ] ), &( pxTimer->xTimerListItem ) );
+            ulTimerWheelMap[ uxLevel ] |= ( 1UL << uxSlot );
+        }
+        else
+        {
+            vListInsertEnd( &xTimerWheelFar, &( pxTimer->xTimerListItem ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWheelRemove( Timer_t * const pxTimer )
+    {
+        List_t * const pxList = listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+        UBaseType_t uxIndex;
+
+        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+
+        if( ( pxList != &xTimerWheelFar ) && ( listLIST_IS_EMPTY( pxList ) != pdFALSE ) )
+        {
+            uxIndex = ( UBaseType_t ) ( pxList - &( xTimerWheel[ 0 ][ 0 ] ) );
+            ulTimerWheelMap[ uxIndex / tmrWHEEL_SLOTS ] &= ~( 1UL << ( uxIndex & tmrWHEEL_MASK ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvWheelIsEmpty( void )
+    {
+        UBaseType_t uxLevel;
+        uint32_t ulMaps = 0UL;
+
+        for( uxLevel = 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+        {
+            ulMaps |= ulTimerWheelMap[ uxLevel ];
+        }
+
+        return ( ( ulMaps == 0UL ) && ( listLIST_IS_EMPTY( &xTimerWheelFar ) != pdFALSE ) ) ? pdTRUE : pdFALSE;
+    }
+/*-----------------------------------------------------------*/
+
+    static TickType_t prvWheelTicksToNextEvent( void )
+    {
+        const TickType_t xTime = xTimerWheelTime;
+        TickType_t xNext = ( TickType_t ) 0U;
+        TickType_t xTicks;
+        TickType_t xBlock;
+        UBaseType_t uxLevel;
+        UBaseType_t uxShift;
+        uint32_t ulMap;
+
+        /* Level n visits slot s when the time, counted in blocks of 32^n
+         * ticks, reaches a block whose low five bits are s.  Rotating the
+         * map to start just after the current block makes the lowest set bit
+         * the number of blocks until the next occupied slot. */
+        for( uxLevel = 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+        {
+            ulMap = ulTimerWheelMap[ uxLevel ];
+
+            if( ulMap != 0UL )
+            {
+                uxShift = tmrWHEEL_BITS * uxLevel;
+                xBlock = xTime >> uxShift;
+                ulMap = ( ulMap >> ( ( xBlock + 1U ) & tmrWHEEL_MASK ) ) |
+                        ( ulMap << ( ( tmrWHEEL_SLOTS - ( ( xBlock + 1U ) & tmrWHEEL_MASK ) ) & tmrWHEEL_MASK ) );
+                xTicks = ( ( xBlock + tmrWHEEL_CTZ( ulMap ) + 1U ) << uxShift ) - xTime;
+
+                if( ( xNext == ( TickType_t ) 0U ) || ( xTicks < xNext ) )
+                {
+                    xNext = xTicks;
+                }
+            }
+        }
+
+        /* The far list is re-filed each time the whole wheel turns over. */
+        if( listLIST_IS_EMPTY( &xTimerWheelFar ) == pdFALSE )
+        {
+            xTicks = ( ( ( xTime >> tmrWHEEL_RANGE_BITS ) + 1U ) << tmrWHEEL_RANGE_BITS ) - xTime;
+
+            if( ( xNext == ( TickType_t ) 0U ) || ( xTicks < xNext ) )
+            {
+                xNext = xTicks;
+            }
+        }
+
+        return xNext;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWheelAdvance( const TickType_t xTimeNow )
+    {
+        TickType_t xTicks;
+        TickType_t xTime;
+        UBaseType_t uxLevel;
+        UBaseType_t uxCount;
+        List_t * pxList;
+        Timer_t * pxTimer;
+
+        for( ; ; )
+        {
+            xTicks = prvWheelTicksToNextEvent();
+
+            if( ( xTicks == ( TickType_t ) 0U ) || ( xTicks > ( TickType_t ) ( xTimeNow - xTimerWheelTime ) ) )
+            {
+                /* Nothing else is due: no slot is visited before xTimeNow. */
+                xTimerWheelTime = xTimeNow;
+                break;
+            }
+
+            xTime = xTimerWheelTime + xTicks;
+            xTimerWheelTime = xTime;
+
+            /* Cascade: when the time crosses a block boundary of level n, the
+             * slot of level n for the new block moves down, re-filed relative
+             * to xTime.  Level 1 goes first so that timers dropping from a
+             * higher level never land in a slot already emptied this tick.
+             * The far list is re-filed at every 2^25 boundary. */
+            for( uxLevel = 1U; uxLevel <= tmrWHEEL_LEVELS; uxLevel++ )
+            {
+                if( ( xTime & ( ( ( TickType_t ) 1U << ( tmrWHEEL_BITS * uxLevel ) ) - 1U ) ) != ( TickType_t ) 0U )
+                {
+                    break;
+                }
+
+                if( uxLevel < tmrWHEEL_LEVELS )
+                {
+                    pxList = &( xTimerWheel[ uxLevel ][ ( xTime >> ( tmrWHEEL_BITS * uxLevel ) ) & tmrWHEEL_MASK ] );
+                }
+                else
+                {
+                    pxList = &xTimerWheelFar;
+                }
+
+                /* Count first: a far timer may be filed back into the far
+                 * list. */
+                for( uxCount = listCURRENT_LIST_LENGTH( pxList ); uxCount > 0U; uxCount-- )
+                {
+                    /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                    /* coverity[misra_c_2012_rule_11_5_violation] */
+                    pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxList );
+                    prvWheelRemove( pxTimer );
+                    prvWheelInsert( pxTimer );
+                }
+            }
+
+            /* Expire every timer in level 0's slot for xTime.  Reloaded
+             * timers are due at least one tick later, so they land in another
+             * slot or level. */
+            pxList = &( xTimerWheel[ 0 ][ xTime & tmrWHEEL_MASK ] );
+
+            while( listLIST_IS_EMPTY( pxList ) == pdFALSE )
+            {
+                /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxList );
+                prvWheelRemove( pxTimer );
+                prvExpireTimer( pxTimer, xTime, xTimeNow );
+            }
+        }
+    }
+
+    #endif /* configUSE_TIMER_WHEEL == 1 */
 /*-----------------------------------------------------------*/
 
     static void prvCheckForValidListAndQueue( void )
@@ -1117,10 +1499,29 @@
         {
             if( xTimerQueue == NULL )
             {
-                vListInitialise( &xActiveTimerList1 );
-                vListInitialise( &xActiveTimerList2 );
-                pxCurrentTimerList = &xActiveTimerList1;
-                pxOverflowTimerList = &xActiveTimerList2;
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                {
+                    UBaseType_t uxLevel;
+                    UBaseType_t uxSlot;
+
+                    for( uxLevel = 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+                    {
+                        for( uxSlot = 0U; uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+                        {
+                            vListInitialise( &( xTimerWheel[ uxLevel ][ uxSlot ] ) );
+                        }
+                    }
+
+                    vListInitialise( &xTimerWheelFar );
+                }
+                #else
+                {
+                    vListInitialise( &xActiveTimerList1 );
+                    vListInitialise( &xActiveTimerList2 );
+                    pxCurrentTimerList = &xActiveTimerList1;
+                    pxOverflowTimerList = &xActiveTimerList2;
+                }
+                #endif /* configUSE_TIMER_WHEEL */
 
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {